@@ -0,0 +1,34 @@
+// ############################
+// #    BUGSY-CORE BATTERY    #
+// ############################
+//
+// Continuous measurement of the battery voltage
+//
+// The ADC samples `PIN_VOLTAGE_MEAS` in continuous mode, the DMA fills the driver's buffer without any CPU involvement.
+// A low priority task on the protocol CPU averages every `BATTERY_OVERSAMPLING` samples and runs them through an IIR
+// filter, so the main loop only has to read the filtered value.
+
+# pragma once
+
+# include <bugsy/battery.hpp>
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace battery {
+        /// The battery state derived in the last `update()`
+        extern bugsy::BatteryState state;
+
+        // Events
+            /// @brief Configures the ADC and starts the sampling task, should be called in `setup()`
+            void setup();
+
+            /// @brief Updates `state` from the filtered voltage and the current movement, should be called in `loop()`
+            void update();
+        //
+
+        /// @brief The filtered battery voltage in millivolts
+        uint16_t voltage();
+    }
+}
@@ -22,13 +22,25 @@
     /// Duty pin for moving the right chain backward
     # define PIN_CHAIN_RIGHT_BW 25
 
-    /* Servo pins */
-    /// Duty pin for the head Servo
-    # define PIN_SERVO_HEAD 0
+    /* Chain encoder pins (quadrature, counted by the PCNT peripheral) */
+    # define PIN_CHAIN_LEFT_ENC_A 32
+    # define PIN_CHAIN_LEFT_ENC_B 33
+    # define PIN_CHAIN_RIGHT_ENC_A 13
+    # define PIN_CHAIN_RIGHT_ENC_B 14
+
+    /* Servo channels (outputs of the servo driver board) */
+    /// Channel of the head servo
+    # define SERVO_CHANNEL_HEAD 0
+
+    /* Emergency stop */
+    /// Emergency stop line driven by the trader, high while driving is allowed. Pulled down, so a missing or resetting
+    /// trader stops the robot as well
+    # define PIN_ESTOP 4
 
     /* Peripheral */
-    /// Voltage measurement pin, connected to the battery using a voltage divider
-    # define PIN_VOLTAGE_MEAS 0
+    /// Voltage measurement pin, connected to the battery using a voltage divider. Has to be an ADC1 pin, as ADC2 is
+    /// blocked by the WiFi and can not be sampled continuously
+    # define PIN_VOLTAGE_MEAS 34
 
     /* UART connections */
     # define PIN_UART_TRADER_RX 18
@@ -40,6 +52,18 @@
 
 /// The I2C address of the servo driver board
 # define SERVO_DRIVER_ADDR 0x40
+/// I2C clock for the servo driver board in Hz (fast mode)
+# define SERVO_I2C_CLOCK 400000
+/// PWM frequency of the servo signals in Hz
+# define SERVO_FREQ 50
+/// Pulse width in microseconds at 0 degrees
+# define SERVO_PULSE_MIN 500
+/// Pulse width in microseconds at 180 degrees
+# define SERVO_PULSE_MAX 2500
+/// Interval in milliseconds the servo task updates the trajectories at, one period of the servo signal
+# define SERVO_UPDATE_INTERVAL 20
+/// Amount of servo commands that can be queued until new commands are rejected
+# define SERVO_QUEUE_SIZE 8
 
 /* EEPROM */
 /// Starting address of the EEPROM configuration
@@ -48,12 +72,67 @@
 /* Buffers */
 /// Size of the buffer to parse incomming messages from (including null-terminator)
 # define PARSE_BUFFER_SIZE 48
+/// Size of the receive buffer of the RPi UART, holds a window of firmware update chunks (`OTA_WINDOW_RPI`)
+# define UART_RPI_RX_BUFFER_SIZE 1024
+
+/* Reception */
+/// Size of the receive ring of each remote, has to be a power of 2 and hold a window of firmware update chunks
+# define RX_RING_SIZE 1024
+/// Bursts a receive ring keeps apart, further bursts are dropped until the loop caught up. Has to divide 256
+# define RX_BURSTS 8
+/// Pause on a UART line in microseconds that ends a burst of bytes, and with it a command
+# define RX_GAP_US 200
+/// Time in milliseconds after which an incomplete firmware update chunk is taken anyway (and dropped)
+# define RX_STALE_TIMEOUT 5
 
 /* Baud rates */
 /// Baud rate used for the debug UART connection on the USB Port
 # define UART_CORE_DEBUG_BAUD 115200
-/// Baud rate between the core and the Pi
-# define UART_PI_BAUD 250000
+
+/* Battery */
+/// Resistance of the upper part of the voltage divider (battery to `PIN_VOLTAGE_MEAS`) in kOhm
+# define BATTERY_DIVIDER_HIGH 100
+/// Resistance of the lower part of the voltage divider (`PIN_VOLTAGE_MEAS` to ground) in kOhm
+# define BATTERY_DIVIDER_LOW 33
+/// Sample rate of the continuous ADC conversion in Hz (minimum of the ESP32 digital controller)
+# define BATTERY_SAMPLE_RATE 20000
+/// Amount of samples averaged into one measurement
+# define BATTERY_OVERSAMPLING 256
+/// Strength of the IIR filter applied to the measurements, the filter weights a new measurement with `1 / 2^shift`
+# define BATTERY_FILTER_SHIFT 3
+
+/* Power */
+/// CPU clock in MHz at the full power level
+# define POWER_FULL_CPU_FREQ 240
+/// CPU clock in MHz at the reduced power level, the lowest clock that keeps Bluetooth and the UARTs (80 MHz APB) running
+# define POWER_REDUCED_CPU_FREQ 80
+
+/* Speed control */
+/// Hardware timer triggering the control ticks
+# define SPEED_TIMER 0
+/// Counter limit of the PCNT units, the counters wrap to `0` at +/- this value
+# define SPEED_PCNT_LIMIT 30000
+/// Glitch filter of the PCNT units in APB clock cycles (80 MHz), pulses shorter than this are ignored
+# define SPEED_PCNT_FILTER 100
+
+/* Jobs */
+/// Amount of maintenance jobs that can be queued until new ones are rejected
+# define JOBS_QUEUE_SIZE 4
+/// Amount of finished jobs whose state can still be queried, has to be a power of 2
+# define JOBS_HISTORY 16
+
+/* Firmware update */
+/// Amount of chunks the writer task can queue until further chunks are dropped (and sent again by the client)
+# define OTA_QUEUE_SIZE 8
+/// Slots of the queue kept free for the requests preparing, finishing and aborting an update
+# define OTA_QUEUE_RESERVED 2
+/// Chunks the RPi may send before asking for the status, has to fit into `UART_RPI_RX_BUFFER_SIZE` and `RX_RING_SIZE`
+# define OTA_WINDOW_RPI 7
+/// Chunks a Bluetooth remote may send before asking for the status, kept small as the SPP link stalls on its
+/// acknowledgements
+# define OTA_WINDOW_BT 3
+/// Size of the blocks read back from the partition to verify the image
+# define OTA_VERIFY_BLOCK_SIZE 512
 
 /* Misc */
 /// Amount of time a movement is held active before running out, working as a kind of failssafe for
@@ -7,10 +7,15 @@
 
 namespace bugsy_core {
     namespace config {
+        /// Guards the parts of the configuration written outside of the loop (WiFi credentials by the jobs), the loop
+        /// takes it to copy them
+        extern portMUX_TYPE mux;
+
         /// @brief Loads the current configuration from the EEPROM
         void load();
 
-        /// @brief Stores the current configuration in the EEPROM
-        void save();
+        /// @brief Stores the given configuration in the EEPROM and commits it to the flash, blocks until written
+        /// @return Whether the flash write succeeded
+        bool save(const bugsy::Configuration* config);
     }
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+// ##########################
+// #    BUGSY-CORE ESTOP    #
+// ##########################
+//
+// Emergency stop line from the trader, bypassing the UARTs and the command parsing
+//
+// The trader pulls `PIN_ESTOP` low as soon as its obstacle sensor fires. The falling edge interrupts the core, the ISR
+// only notifies the emergency stop task, which has the highest priority on the loop CPU and turns the motors off right
+// away. The worst case is therefore bounded by the longest critical section plus a context switch, independent of what
+// the loop or the UARTs are doing. The time from the edge until the motors are off is measured for every stop.
+//
+// The stop stays engaged until the line is released, the loop then drops the movement that was active, so it does not
+// resume once the line is released.
+
+# pragma once
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace estop {
+        // Events
+            /// @brief Configures the line and starts the emergency stop task, should be called in `setup()`
+            void setup();
+
+            /// @brief Clears the movement while engaged and releases the stop once the line is released, should be called
+            /// in `loop()`
+            void update();
+        //
+
+        /// @brief Whether the emergency stop is engaged, movements are rejected
+        bool active();
+
+        /// @brief Copies the current state and latency statistics
+        bugsy::EStopStats stats();
+    }
+}
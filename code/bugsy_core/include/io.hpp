@@ -27,9 +27,6 @@ namespace bugsy_core {
             extern HardwareSerial* rpi_serial;
         // 
 
-        /// General buffer for parsing incomming data
-        extern char parse_buffer [PARSE_BUFFER_SIZE];
-
         /// Whether or not the communication to the trader MCU has been established
         extern bugsy::TraderState trader_state;
         /// Timestamp of the last state update from the trader
@@ -37,7 +34,8 @@ namespace bugsy_core {
         /// Whether or not the communication
         extern bool rpi_ready;
 
-        /// Parses a command for the given `buffer` and writes the output to the given `SystemAddr`
+        /// Parses a command for the given `buffer` and writes the output to the given `SystemAddr`, maintenance commands
+        /// are only queued as jobs (see `jobs.hpp`)
         /// @param remotes The remotes to write the output to
         /// @param buffer The buffer to read the data from
         /// @param len The command length
@@ -47,10 +45,18 @@ namespace bugsy_core {
             /// @brief SETUP everything concering the IO module, should be called in `setup()`
             void setup();
 
-            /// @brief Handle the inputs received by the serials, should be called in `loop()` 
+            /// @brief Receives the commands from the serials, should be called in `loop()` before `dispatch()`
             void handle();
+
+            /// @brief Parses all commands received in this loop iteration, the control commands first (see
+            /// `bugsy::CommandClass`) and the rest in the order of their arrival. Should be called in `loop()` after all
+            /// remotes have been handled
+            void dispatch();
         //
 
+        /// @brief Takes the next frame received from `src` (see `rx::take()`), parsed by the next `dispatch()`
+        void receive(bugsy::Remote src);
+
         // Writing
             /// @brief Write some bytes to the given `SystemAddr`
             /// @param remotes The remotes to write the output to
@@ -63,12 +69,23 @@ namespace bugsy_core {
             /// @param buffer The string buffer to write
             void write_str(bugsy::Remote remotes, const char* buffer);
 
-            /// @brief Write an object to the given `SystemAddr`
-            /// @tparam T The type of the object
+            /// @brief Write a single byte (a state, a flag or an enum) to the given `SystemAddr`
+            /// @param remotes The remotes to write the output to
+            /// @param value The byte to write
+            void write_u8(bugsy::Remote remotes, uint8_t value);
+
+            /// @brief Write a 16 bit value in little endian to the given `SystemAddr`
+            /// @param remotes The remotes to write the output to
+            /// @param value The value to write
+            void write_u16(bugsy::Remote remotes, uint16_t value);
+
+            /// @brief Write a message encoded with its builder `B` (see `bugsy/messages.hpp`) to the given `SystemAddr`,
+            /// independent of the layout of `T`
+            /// @tparam B The builder of the message
             /// @param remotes The remotes to write the output to
-            /// @param obj A pointer to the object to write
-            template<typename T>
-            void write_obj(bugsy::Remote remotes, T* obj);
+            /// @param obj The object to write
+            template<typename B, typename T>
+            void write_msg(bugsy::Remote remotes, const T& obj);
         // 
     }
 }
\ No newline at end of file
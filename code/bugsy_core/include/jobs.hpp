@@ -0,0 +1,35 @@
+// #########################
+// #    BUGSY-CORE JOBS    #
+// #########################
+//
+// Background jobs for the maintenance commands (see `bugsy::CommandClass::MAINTENANCE`)
+//
+// Flash writes and remote reconfigurations take milliseconds up to seconds, handled inline they would delay every
+// movement and stop received after them. The loop only validates the command, queues a job and answers with a
+// `bugsy::JobTicket`. A low priority task on the protocol CPU runs the jobs one after another, the state of the last
+// `JOBS_HISTORY` jobs can be queried with `bugsy::Command::GetJobState`.
+
+# pragma once
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace jobs {
+        // Events
+            /// @brief Creates the job queue and starts the job task, should be called in `setup()`
+            void setup();
+        //
+
+        /// @brief Queues a maintenance command, does not block
+        /// @param cmd The command, has to be of the class `bugsy::CommandClass::MAINTENANCE`
+        /// @param args The arguments of the command, copied into the job
+        /// @param len The length of the arguments
+        /// @return The ticket of the job, `bugsy::JobState::REJECTED` if the arguments are invalid or the queue is full
+        bugsy::JobTicket submit(bugsy::Command cmd, const char* args, size_t len);
+
+        /// @brief The state of the job with the given ID, `bugsy::JobState::UNKNOWN` if the job is too old or unknown
+        bugsy::JobState state(uint8_t id);
+    }
+}
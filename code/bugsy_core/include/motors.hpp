@@ -2,8 +2,10 @@
 
 # include <inttypes.h>
 
-# include <Adafruit_PWMServoDriver.h>
+# include <bugsy/clock.hpp>
 # include <bugsy/core.hpp>
+# include <bugsy/link.hpp>
+# include <bugsy/mailbox.hpp>
 # include <sylo/types.hpp>
 
 /// Everything concering the core MCU of the bugsy robot
@@ -21,9 +23,12 @@ namespace bugsy_core {
         extern uint32_t stamp;
         /// The duration the current movement is valid, `0` means no movement is currently active
         extern bugsy::MoveDuration duration;
-
-        /// The servo driver board
-        extern Adafruit_PWMServoDriver servo_driver;
+        /// Movements received by the commands, only the newest one is applied by `update()`
+        extern bugsy::mailbox::Mailbox mailbox;
+        /// Movements scheduled for a given time (in microseconds), handed to the mailbox by `update()` once due
+        extern bugsy::clock::Schedule schedule;
+        /// Link statistics of the remotes sending movements, decide the failsafe window of their movements
+        extern bugsy::link::Monitor links;
 
         /// Setup all the motors and drivers required for movements
         void setup();
@@ -32,20 +37,34 @@ namespace bugsy_core {
         /// @return The timestamp
         uint32_t lasts_until();
 
-        /// Apply the given movement to the driver
+        /// Apply the given movement to the driver, or hand its speeds to the speed control when running closed-loop
         /// @param new_move The new movement to be applied to the pins
         void apply_to_pins(const bugsy::Movement* new_move);
 
-        /// Apply a new movement for the given duration
+        /// Writes signed duties (negative values drive backwards) to the motor pins
+        ///
+        /// The loop and the speed control task both write the pins, the write is dropped if `closed_loop` does not match
+        /// the current mode, so a late write of the other side can not override it
+        /// @param closed_loop Whether the duties are calculated by the speed control
+        void write_pins(int16_t left, int16_t right, bool closed_loop);
+
+        /// Switches between open-loop duties and the closed-loop speed control
+        void set_closed_loop(bool closed_loop);
+
+        /// Turns the motors off and drops all pin writes until released, used by the emergency stop
+        /// @param halted `true` to halt, `false` to release
+        void halt(bool halted);
+
+        /// Apply a new movement for the given duration, ignored while the emergency stop is engaged
         /// @param new_move The new movement to be applied
         /// @param duration The duration of the new movement until the failsafe activates
         void apply(const bugsy::Movement* new_move, bugsy::MoveDuration duration);
 
-        /// Writes all movements to the drivers and motors
+        /// Applies the scheduled movements that are due and the newest movement of the mailbox, writes all movements to the drivers and motors
         /// @return Whether a main movement is currently active or not
         bool update();
 
-        /// Stop all movements currently active
+        /// Stop all movements currently active, including the one waiting in the mailbox and the scheduled ones
         void stop();
     }
 }
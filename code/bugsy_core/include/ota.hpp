@@ -0,0 +1,51 @@
+// ########################
+// #    BUGSY-CORE OTA    #
+// ########################
+//
+// Firmware updates over the command protocol (see `bugsy/ota.hpp`)
+//
+// The loop only checks the chunks and queues them. A low priority task on the protocol CPU erases the inactive app
+// partition, writes the chunks, reads the image back to verify its CRC-32 and switches the boot partition, so the loop
+// never waits for the flash.
+//
+// Erasing and writing the flash disables the caches of both CPUs, every task not running from IRAM stalls meanwhile,
+// the movements included. The partition is therefore erased one sector (4 KB) at a time, a movement is delayed by at
+// most one sector erase (typically 45 ms, up to a few hundred in the worst case) or the write of one chunk.
+
+# pragma once
+
+# include <bugsy/core.hpp>
+# include <bugsy/ota.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace ota {
+        // Events
+            /// @brief Creates the write queue and starts the writer task, should be called in `setup()`
+            void setup();
+        //
+
+        /// @brief Starts an update (`bugsy::Command::OtaBegin`) or resumes the one of the same image, does not block
+        /// @return The status, `bugsy::OtaState::ERASING` until the partition has been erased
+        bugsy::OtaStatus begin(bugsy::Remote src, const bugsy::OtaImage& image);
+
+        /// @brief Checks a chunk (`bugsy::Command::OtaChunk`) and queues it for the writer, does not block
+        /// @param args The arguments of the command
+        /// @param len The length of the arguments
+        void chunk(bugsy::Remote src, const uint8_t* args, size_t len);
+
+        /// @brief Verifies the image once all chunks have been received (`bugsy::Command::OtaFinish`), does not block
+        /// @param restart Whether to restart into the image once it has been verified
+        bugsy::OtaStatus finish(bool restart);
+
+        /// @brief Cancels the update (`bugsy::Command::OtaAbort`)
+        bugsy::OtaStatus abort();
+
+        /// @brief The status of the update
+        bugsy::OtaStatus status();
+
+        /// @brief Whether `src` is streaming chunks, its other commands are dropped then
+        bool owns(bugsy::Remote src);
+    }
+}
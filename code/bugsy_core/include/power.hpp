@@ -0,0 +1,47 @@
+// ##########################
+// #    BUGSY-CORE POWER    #
+// ##########################
+//
+// Idle power management, applies the decisions of the shared `bugsy::power::Governor` to the ESP32
+//
+// At the reduced level the CPU clock is lowered to `POWER_REDUCED_CPU_FREQ` and the loop waits in `rx::wait()`, during
+// which the idle task halts the CPU. The wait ends early once bytes arrive on a UART or over Bluetooth, otherwise after
+// the planned sleep. Light sleep is not used, as the Bluetooth Classic controller has to stay active for the remotes to
+// be able to wake the robot.
+//
+// The reported wake-up latency is the time from receiving a movement (the stamp of its frame) until `move::update()`
+// applied it, so it covers the wake-up, the clock switch and the rest of the loop iteration.
+
+# pragma once
+
+# include <bugsy/power.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace power {
+        /// The governor deciding about the power level
+        extern bugsy::power::Governor governor;
+
+        // Events
+            /// @brief Starts at the full power level, should be called in `setup()`
+            void setup();
+
+            /// @brief Plans and performs the idle sleep, should be called at the end of `loop()`
+            void update();
+        //
+
+        /// @brief Marks activity, restores the full power level right away (before the command is executed)
+        ///
+        /// Only called for movements, the periodic polls of the trader and the RPi are answered at the reduced level
+        void activity();
+
+        /// @brief Marks a movement received and handed to the mailbox, like `activity()`
+        /// @param stamp The time the frame of the movement has been received at in microseconds
+        void received(uint32_t stamp);
+
+        /// @brief Records the latency of the received movement once the mailbox has been applied by `move::update()`
+        /// @param scheduled Whether a scheduled movement due meanwhile superseded it, no latency is recorded then
+        void applied(bool scheduled);
+    }
+}
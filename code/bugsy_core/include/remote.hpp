@@ -27,6 +27,9 @@ namespace bugsy_core {
 
             /// @brief Stops the bluetooth serial
             void stop_bt(); 
+
+            /// @brief Writes to the bluetooth serial, the bytes are dropped while the remotes are reconfigured
+            void write_bt(const uint8_t* buffer, size_t len);
         //
 
         // WiFi
@@ -47,7 +50,8 @@ namespace bugsy_core {
         // 
 
         // General events
-            /// @brief Configures the Bugsy to use the new set of remotes `new_remotes` provided
+            /// @brief Configures the Bugsy to use the new set of remotes `new_remotes` provided, blocks until the remotes
+            /// have been started, may be called by the jobs while the loop is running
             void configure(bugsy::Remote new_remotes);
 
             /// @brief Stops all the remotes 
@@ -0,0 +1,46 @@
+// #######################
+// #    BUGSY-CORE RX    #
+// #######################
+//
+// Event driven reception of the serials (USB, trader, RPi) and the Bluetooth serial
+//
+// The UART driver calls back once a pause on the line ended a burst of bytes (its receive timeout), the Bluetooth stack
+// calls back with every packet. The callbacks run in the tasks of the drivers, copy the bytes into the receive ring of
+// the remote and notify the loop, which takes complete frames out of the rings without ever waiting for the serials.
+// While idle the loop blocks in `wait()` and is woken by the first byte received.
+
+# pragma once
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace rx {
+        // Events
+            /// @brief Registers the receive callbacks of the serials, should be called in `setup()` by the loop task
+            /// once the serials have been started
+            void setup();
+        //
+
+        /// @brief Receive callback of the Bluetooth serial, registered whenever it is started
+        void on_bt_data(const uint8_t* data, size_t len);
+
+        /// @brief Sets the pause ending a frame on the UART of `src` to `RX_GAP_US`, has to be called whenever its baud
+        /// rate changed
+        void set_gap(bugsy::Remote src, uint32_t baud);
+
+        /// @brief Takes the next frame received from `src`, does not block
+        ///
+        /// A frame is a burst of bytes up to `PARSE_BUFFER_SIZE` bytes, firmware update chunks are taken by their fixed
+        /// length instead (see `bugsy/ota.hpp`). Neither exceeds `max`. Bytes and bursts dropped by the callbacks are
+        /// logged here
+        /// @param stamp Receives the time the frame arrived at in microseconds
+        /// @return The length of the frame, `0` if there is no complete frame
+        size_t take(bugsy::Remote src, char* frame, size_t max, uint32_t* stamp);
+
+        /// @brief Sleeps up to `ms` milliseconds, ends right away once bytes have been received
+        /// @return Whether bytes have been received
+        bool wait(uint32_t ms);
+    }
+}
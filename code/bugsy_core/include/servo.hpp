@@ -0,0 +1,35 @@
+// ##########################
+// #    BUGSY-CORE SERVO    #
+// ##########################
+//
+// Servos driven by the PCA9685 servo driver board
+//
+// Commands only queue new trajectories, a background task on the protocol CPU interpolates them once every servo period
+// and writes all changed channels to the driver board in a single burst transaction (the PCA9685 auto-increments its
+// register address), so the I2C bus never blocks the main loop and the chain motors.
+
+# pragma once
+
+# include <Adafruit_PWMServoDriver.h>
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace servo {
+        /// The servo driver board, only used for the setup, the updates are written directly
+        extern Adafruit_PWMServoDriver driver;
+
+        // Events
+            /// @brief Sets up the driver board and starts the servo task, should be called in `setup()`
+            void setup();
+        //
+
+        /// @brief Queues a new trajectory for a servo, does not block
+        /// @return `false` if the movement is invalid or the queue is full
+        bool move(const bugsy::ServoMove* servo_move);
+
+        /// @brief The current angle of the given servo in 0.1 degrees
+        uint16_t angle(bugsy::Servo servo);
+    }
+}
@@ -0,0 +1,32 @@
+// ##########################
+// #    BUGSY-CORE SPEED    #
+// ##########################
+//
+// Closed-loop speed control of the chains, runs the shared `bugsy::speed::Controller` at a fixed rate
+//
+// The PCNT peripheral counts the quadrature edges of both chain encoders in hardware. A hardware timer fires every
+// control tick and notifies the control task, which has the highest priority on the loop CPU after the emergency stop
+// and therefore preempts the loop right away. The task reads the counters, runs the controllers and writes the duties
+// (the LEDC driver can not be called from an interrupt). Movements only set the target speeds.
+
+# pragma once
+
+# include <bugsy/core.hpp>
+# include <bugsy/speed.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace speed {
+        // Events
+            /// @brief Configures the encoder counters and starts the control timer and task, should be called in `setup()`
+            void setup();
+        //
+
+        /// @brief Sets the target speeds of the chains in mm/s, picked up by the next control tick
+        void set_targets(int16_t left, int16_t right);
+
+        /// @brief Copies the current state and statistics of the controllers
+        bugsy::SpeedStats stats();
+    }
+}
@@ -0,0 +1,56 @@
+// #########################
+// #    BUGSY-CORE UART    #
+// #########################
+//
+// Baud rates of the UART links to the trader and the RPi, negotiated by them (see `bugsy/baud.hpp`)
+//
+// Both links start at their base rate. A rate proposed by the other MCU is applied right after the answer to the
+// proposal has left the UART and returns to the previous rate if it is not confirmed in time. Framing and parity errors
+// reported by the UART driver and unknown commands count as receive errors, a burst of them makes the link fall back to
+// its base rate, as does a trader that timed out.
+
+# pragma once
+
+# include <bugsy/baud.hpp>
+# include <bugsy/core.hpp>
+
+# include "bugsy_core.hpp"
+
+namespace bugsy_core {
+    namespace uart {
+        // Events
+            /// @brief Starts the UARTs of the trader and the RPi at their base rates, called by `io::setup()`
+            void setup();
+
+            /// @brief Returns to the previous rate where a proposal has not been confirmed in time and counts the errors
+            /// reported by the UART driver, should be called in `loop()`
+            void update();
+        //
+
+        /// @brief Handles a rate proposed by `src` (`Command::ProposeBaud`), apply it with `apply()` after answering
+        /// @return Whether the link of `src` supports the rate
+        bool propose(bugsy::Remote src, uint32_t baud);
+
+        /// @brief Switches the UART of `src` to the rate of its link, waits until everything written has been sent
+        void apply(bugsy::Remote src);
+
+        /// @brief Checks a test frame of `src` (`Command::BaudTest`)
+        /// @param answer Receives the answer if the frame is intact (`BUGSY_BAUD_TEST_SIZE` bytes)
+        /// @return Whether the frame is intact and should be answered
+        bool test(bugsy::Remote src, const uint8_t* frame, size_t len, uint8_t* answer);
+
+        /// @brief Keeps the rate proposed by `src` (`Command::ConfirmBaud`)
+        /// @return Whether a proposal was pending
+        bool confirm(bugsy::Remote src);
+
+        /// @brief Records a receive error of the link of `src`, ignored for remotes without a negotiated link
+        void error(bugsy::Remote src);
+
+        /// @brief Returns the link of `src` to its base rate
+        void fallback(bugsy::Remote src);
+
+        /// @brief The rate and error counters of the link of `src`
+        /// @return Zeroed statistics for remotes without a negotiated link
+        bugsy::BaudStats stats(bugsy::Remote src);
+    }
+}
@@ -0,0 +1,117 @@
+# include "battery.hpp"
+
+// External libraries
+# include <driver/adc.h>
+# include <esp_adc_cal.h>
+
+// Local headers
+# include "motors.hpp"
+
+/// Bytes read from the DMA buffer at once, one oversampled measurement
+# define BATTERY_READ_SIZE (BATTERY_OVERSAMPLING * SOC_ADC_DIGI_RESULT_BYTES)
+
+namespace bugsy_core {
+    namespace battery {
+        bugsy::BatteryState state = { 0, 0, 0xFF };
+
+        /// Filtered voltage in millivolts with 8 fractional bits, `0` until the first measurement. Written by the
+        /// sampling task only, 32-bit accesses are atomic on the ESP32
+        static volatile uint32_t filtered = 0;
+
+        /// Calibration of the ADC stored in the eFuses
+        static esp_adc_cal_characteristics_t adc_chars;
+
+        static void sample_task(void*) {
+            static uint8_t buffer [BATTERY_READ_SIZE];
+
+            while (true) {
+                uint32_t len = 0;
+
+                if (adc_digi_read_bytes(buffer, BATTERY_READ_SIZE, &len, portMAX_DELAY) != ESP_OK) {
+                    continue;
+                }
+
+                uint32_t sum = 0, count = 0;
+
+                for (uint32_t i = 0; i < len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                    const adc_digi_output_data_t* data = (const adc_digi_output_data_t*)(buffer + i);
+                    sum += data->type1.data;
+                    count++;
+                }
+
+                if (!count) {
+                    continue;
+                }
+
+                // Averaging before the calibration keeps the extra resolution of the oversampling
+                uint32_t pin_mv = esp_adc_cal_raw_to_voltage(sum / count, &adc_chars);
+                uint32_t sample = ((pin_mv * (BATTERY_DIVIDER_HIGH + BATTERY_DIVIDER_LOW)) / BATTERY_DIVIDER_LOW) << 8;
+
+                uint32_t current = filtered;
+
+                if (current) {
+                    filtered = current - (current >> BATTERY_FILTER_SHIFT) + (sample >> BATTERY_FILTER_SHIFT);
+                } else {
+                    filtered = sample;
+                }
+            }
+        }
+
+        void setup() {
+            adc1_channel_t channel = (adc1_channel_t)digitalPinToAnalogChannel(PIN_VOLTAGE_MEAS);
+
+            esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adc_chars);
+
+            adc_digi_init_config_t init_config = { };
+            init_config.max_store_buf_size = BATTERY_READ_SIZE * 4;
+            init_config.conv_num_each_intr = BATTERY_READ_SIZE;
+            init_config.adc1_chan_mask = BIT(channel);
+            init_config.adc2_chan_mask = 0;
+
+            adc_digi_pattern_config_t pattern = { };
+            pattern.atten = ADC_ATTEN_DB_11;
+            pattern.channel = channel;
+            pattern.unit = 0;
+            pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+            adc_digi_configuration_t config = { };
+            config.conv_limit_en = true;
+            config.conv_limit_num = 250;
+            config.pattern_num = 1;
+            config.adc_pattern = &pattern;
+            config.sample_freq_hz = BATTERY_SAMPLE_RATE;
+            config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+            config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+            if ((adc_digi_initialize(&init_config) != ESP_OK)
+                || (adc_digi_controller_configure(&config) != ESP_OK)
+                || (adc_digi_start() != ESP_OK)
+            ) {
+                log_errorln("> [ERROR] Failed to start the battery measurement!");
+                return;
+            }
+
+            // The loop runs on CPU 1, the sampling stays out of its way on CPU 0
+            xTaskCreatePinnedToCore(sample_task, "battery", 2048, nullptr, 1, nullptr, 0);
+        }
+
+        void update() {
+            uint16_t mv = voltage();
+
+            // No measurement yet, do not limit anything
+            if (!mv) {
+                return;
+            }
+
+            // The duty actually applied to the motors, which has already been limited
+            uint16_t duty_sum = (uint16_t)bugsy::battery::limit_duty(move::move.chain_left_duty, state.duty_limit)
+                + bugsy::battery::limit_duty(move::move.chain_right_duty, state.duty_limit);
+
+            state = bugsy::battery::state(mv, duty_sum);
+        }
+
+        uint16_t voltage() {
+            return (uint16_t)(filtered >> 8);
+        }
+    }
+}
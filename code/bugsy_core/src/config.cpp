@@ -3,6 +3,9 @@
 // External libraries
 # include <EEPROM.h>
 # include <bugsy/core.hpp>
+# include <bugsy/drive.hpp>
+# include <bugsy/link.hpp>
+# include <bugsy/speed.hpp>
 
 // Local headers
 # include "motors.hpp"
@@ -11,6 +14,8 @@ using bugsy::Configuration;
 
 namespace bugsy_core {
     namespace config {
+        portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
         void load() {
             // Seting up EEPROM
             EEPROM.begin(sizeof(Configuration));
@@ -20,10 +25,29 @@ namespace bugsy_core {
             // Load values
             configuration.wifi_ssid[BUGSY_WIFI_CRED_BUFFER_SIZE - 1] = 0;        // Adding null terminator to string for safety reasons
             configuration.wifi_password[BUGSY_WIFI_CRED_BUFFER_SIZE - 1] = 0;    // Adding null terminator to string for safety reasons
+
+            // Configurations stored before the drive calibration existed leave garbage (or `0xFF`) in its place
+            if (!bugsy::drive::valid(configuration.drive)) {
+                log_debug("(drive calibration reset) ");
+                configuration.drive = bugsy::drive::DEFAULT_CALIBRATION;
+            }
+
+            if (!bugsy::speed::valid(configuration.speed_gains)) {
+                log_debug("(speed gains reset) ");
+                configuration.speed_gains = bugsy::speed::DEFAULT_GAINS;
+            }
+
+            if (!bugsy::link::valid(configuration.failsafe)) {
+                log_debug("(failsafe reset) ");
+                configuration.failsafe = bugsy::link::DEFAULT_FAILSAFE;
+            }
         }
 
-        void save() {
-            EEPROM.writeBytes(EEPROM_START_ADDR, &configuration, sizeof(Configuration));
+        bool save(const Configuration* config) {
+            EEPROM.writeBytes(EEPROM_START_ADDR, config, sizeof(Configuration));
+
+            // Only the commit actually writes the flash
+            return EEPROM.commit();
         }
     }
 }
\ No newline at end of file
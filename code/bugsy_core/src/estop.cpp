@@ -0,0 +1,124 @@
+# include "estop.hpp"
+
+// Local headers
+# include "motors.hpp"
+
+namespace bugsy_core {
+    namespace estop {
+        /// Set by the task only, cleared by the loop only, both with `latch` taken
+        static volatile bool engaged = false;
+        /// Serializes engaging (task) and releasing (loop)
+        static SemaphoreHandle_t latch = nullptr;
+
+        /// Time of the last edge of the line, written by the ISR
+        static volatile uint32_t edge_stamp = 0;
+
+        /// Statistics, guarded by `stats_mux`
+        static bugsy::EStopStats stats_data = { };
+        static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+        static TaskHandle_t task = nullptr;
+
+        static void IRAM_ATTR on_edge() {
+            edge_stamp = micros();
+
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(task, &woken);
+
+            if (woken) {
+                portYIELD_FROM_ISR();
+            }
+        }
+
+        static void estop_task(void*) {
+            while (true) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+                // The level decides, a bouncing line may notify more than once
+                if (digitalRead(PIN_ESTOP) == HIGH) {
+                    continue;
+                }
+
+                // Motors off first, the bookkeeping can wait
+                move::halt(true);
+                uint32_t latency = micros() - edge_stamp;
+
+                // Halting again under the latch, the loop might have released in between
+                xSemaphoreTake(latch, portMAX_DELAY);
+                move::halt(true);
+                bool triggered = !engaged;
+                engaged = true;
+                xSemaphoreGive(latch);
+
+                if (!triggered) {
+                    continue;
+                }
+
+                portENTER_CRITICAL(&stats_mux);
+                stats_data.triggers++;
+                stats_data.latency_last = (latency > UINT16_MAX) ? UINT16_MAX : (uint16_t)latency;
+
+                if (stats_data.latency_last > stats_data.latency_max) {
+                    stats_data.latency_max = stats_data.latency_last;
+                }
+
+                if (latency > BUGSY_ESTOP_MAX_LATENCY) {
+                    stats_data.violations++;
+                }
+
+                stats_data.active = 1;
+                portEXIT_CRITICAL(&stats_mux);
+            }
+        }
+
+        void setup() {
+            latch = xSemaphoreCreateMutex();
+            pinMode(PIN_ESTOP, INPUT_PULLDOWN);
+
+            // Highest priority on the loop CPU, preempts the loop and the speed control
+            xTaskCreatePinnedToCore(estop_task, "estop", 2048, nullptr, configMAX_PRIORITIES - 1, &task, 1);
+            attachInterrupt(digitalPinToInterrupt(PIN_ESTOP), on_edge, FALLING);
+
+            // The line might already be asserted (or the trader not running yet)
+            if (digitalRead(PIN_ESTOP) == LOW) {
+                xTaskNotifyGive(task);
+            }
+        }
+
+        void update() {
+            if (!engaged) {
+                return;
+            }
+
+            xSemaphoreTake(latch, portMAX_DELAY);
+
+            // Drop the movement that was active (or arrived) while engaged
+            move::stop();
+
+            if (digitalRead(PIN_ESTOP) == HIGH) {
+                engaged = false;
+                move::halt(false);
+
+                portENTER_CRITICAL(&stats_mux);
+                stats_data.active = 0;
+                portEXIT_CRITICAL(&stats_mux);
+
+                log_infoln("> Emergency stop released!");
+            }
+
+            xSemaphoreGive(latch);
+        }
+
+        bool active() {
+            return engaged;
+        }
+
+        bugsy::EStopStats stats() {
+            portENTER_CRITICAL(&stats_mux);
+            bugsy::EStopStats copy = stats_data;
+            portEXIT_CRITICAL(&stats_mux);
+
+            return copy;
+        }
+    }
+}
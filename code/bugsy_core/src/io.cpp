@@ -1,12 +1,32 @@
+# include <bugsy/batch.hpp>
+# include <bugsy/baud.hpp>
 # include <bugsy/core.hpp>
 # include <bugsy/defines.hpp>
+# include <bugsy/drive.hpp>
+# include <bugsy/link.hpp>
+# include <bugsy/messages.hpp>
+# include <bugsy/ota.hpp>
+# include <bugsy/speed.hpp>
 # include <bugsy/trader.hpp>
 
+# include "battery.hpp"
+# include "estop.hpp"
 # include "bugsy_core.hpp"
 # include "config.hpp"
 # include "io.hpp"
+# include "jobs.hpp"
 # include "motors.hpp"
+# include "ota.hpp"
+# include "power.hpp"
 # include "remote.hpp"
+# include "rx.hpp"
+# include "servo.hpp"
+# include "speed.hpp"
+# include "uart.hpp"
+
+# if BUGSY_BATCH_FRAME_SIZE > PARSE_BUFFER_SIZE
+    # error "The parse buffer has to hold a whole batch frame!"
+# endif
 
 using bugsy::Command;
 using bugsy::CoreState;
@@ -21,13 +41,58 @@ namespace bugsy_core {
         HardwareSerial* trader_serial = &Serial1;
         HardwareSerial* rpi_serial = &Serial2;
 
-        char parse_buffer [PARSE_BUFFER_SIZE];
+        /// Size of the frame buffers, a firmware update chunk is longer than the other commands
+        static const size_t FRAME_BUFFER_SIZE = (bugsy::ota::FRAME_SIZE > PARSE_BUFFER_SIZE) ? bugsy::ota::FRAME_SIZE : PARSE_BUFFER_SIZE;
+
+        /// A command received but not parsed yet
+        struct Frame {
+            Remote src;
+            /// Time the first bytes were received at in microseconds
+            uint32_t stamp;
+            size_t len;
+            char data [FRAME_BUFFER_SIZE];
+        };
+
+        /// Commands received in the current loop iteration in the order of their arrival, at most one per source (USB,
+        /// trader, RPi, Bluetooth)
+        static Frame frames [4];
+        static uint8_t frame_count = 0;
+
+        /// Receive time of the frame being parsed
+        static uint32_t frame_stamp = 0;
+
+        /// Collects the answers while a batch is parsed, `nullptr` otherwise
+        static bugsy::batch::Writer* capture = nullptr;
 
         TraderState trader_state = TraderState::DISCONNECTED;
         unsigned long trader_stamp = 0;
         bool rpi_ready = false;
 
 
+        /// Splits the arguments of `Move` and `Drive` into the optional `MoveStamp` and the payload of `size` bytes
+        /// @return The payload, `nullptr` if the length matches neither form
+        static const char* unstamp(const char* args, size_t len, size_t size, bugsy::MoveStamp* stamp, bool* stamped) {
+            *stamped = (len == (bugsy::msg::MoveStampView::SIZE + size));
+
+            if (*stamped) {
+                *stamp = bugsy::msg::MoveStampView(args, len).get();
+                return args + bugsy::msg::MoveStampView::SIZE;
+            }
+
+            return (len == size) ? args : nullptr;
+        }
+
+        /// Hands a movement to the mailbox, applied by the next `move::update()`
+        static void post_move(Remote src, const bugsy::MoveStamp* stamp, const Movement& new_move) {
+            // Late and out of order movements count as well, they tell about the link
+            move::links.arrival(src, stamp, millis());
+
+            if (move::mailbox.post(src, stamp, new_move, millis())) {
+                // Back to full speed before the movement is applied
+                power::received(frame_stamp);
+            }
+        }
+
         void parse_cmd(Remote src, const char* buffer, size_t len) {
             // Check if a valid command length has been provided
             if (len == 0) {
@@ -35,10 +100,16 @@ namespace bugsy_core {
                 return;
             }
 
-            Command cmd = *(Command*)buffer;
+            Command cmd = (Command)buffer[0];
             const char* arg_bytes = buffer + sizeof(Command);
             size_t arg_len = len - sizeof(Command);
 
+            // Anything else from a remote streaming firmware chunks is most likely a shifted chunk (see `bugsy/ota.hpp`)
+            if (!bugsy::ota::is_update(cmd) && ota::owns(src)) {
+                log_errorln("> [ERROR] Command dropped during firmware update!");
+                return;
+            }
+
             switch (cmd) {
                 case Command::Test:
                     log_infoln("> Test command called!");
@@ -54,20 +125,333 @@ namespace bugsy_core {
 
                     break;
 
+                case Command::Batch: {
+                    if (capture) {
+                        log_errorln("> [Command::Batch] Batches can not be nested!");
+                        return;
+                    }
+
+                    // Total length of the answers in front
+                    static uint8_t answer [1 + BUGSY_BATCH_ANSWER_SIZE];
+                    bugsy::batch::Writer writer(answer + 1, BUGSY_BATCH_ANSWER_SIZE);
+                    bugsy::batch::Reader reader((const uint8_t*)arg_bytes, arg_len);
+
+                    const uint8_t* entry;
+                    size_t entry_len;
+
+                    capture = &writer;
+
+                    while (reader.next(&entry, &entry_len)) {
+                        writer.begin();
+
+                        if ((entry_len == 0) || (entry_len == bugsy::batch::NO_ANSWER) || ((Command)entry[0] == Command::Batch)) {
+                            writer.drop();
+                        } else {
+                            io::parse_cmd(src, (const char*)entry, entry_len);
+                        }
+
+                        writer.end();
+                    }
+
+                    capture = nullptr;
+
+                    if (reader.truncated()) {
+                        log_errorln("> [Command::Batch] Truncated batch!");
+                    }
+
+                    answer[0] = (uint8_t)writer.size();
+                    io::write(src, answer, writer.size() + 1);
+                    break;
+                }
+
                 case Command::GetState:
-                    io::write_obj(src, &state);
+                    io::write_u8(src, (uint8_t)state);
                     break;
 
-                case Command::Move:
-                    // Check if the data has a valid size
-                    if (arg_len == sizeof(Movement)) { 
-                        move::apply((Movement*)arg_bytes, configuration.move_dur);
-                        bugsy_core::state = CoreState::DRIVING;
+                case Command::GetBattery:
+                    io::write_msg<bugsy::msg::BatteryStateBuilder>(src, battery::state);
+                    break;
+
+                case Command::GetPowerStats:
+                    io::write_msg<bugsy::msg::PowerStatsBuilder>(src, power::governor.stats);
+                    break;
+
+                case Command::GetEStopStats: {
+                    bugsy::EStopStats stats = estop::stats();
+                    io::write_msg<bugsy::msg::EStopStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::SyncClock: {
+                    if ((arg_len != sizeof(uint32_t)) && (arg_len != (2 * sizeof(uint32_t)))) {
+                        log_error("> [Command::SyncClock] Bad clock sync size!");
+                        return;
+                    }
+
+                    bugsy::ClockSample sample;
+                    sample.client_send = bugsy::msg::wire::get_u32((const uint8_t*)arg_bytes);
+                    sample.core_receive = frame_stamp;
+                    sample.core_send = micros();
+
+                    io::write_msg<bugsy::msg::ClockSampleBuilder>(src, sample);
+
+                    // The client reports the round trip of its previous exchange
+                    if (arg_len == (2 * sizeof(uint32_t))) {
+                        move::links.report_rtt(src, bugsy::msg::wire::get_u32((const uint8_t*)arg_bytes + sizeof(uint32_t)));
+                    }
+
+                    break;
+                }
+
+                case Command::GetLinkStats: {
+                    if (arg_len != sizeof(Remote)) {
+                        log_error("> [Command::GetLinkStats] Bad remote size!");
+                        return;
+                    }
+
+                    bugsy::LinkStats stats = move::links.stats((Remote)arg_bytes[0], configuration.failsafe, configuration.move_dur);
+                    io::write_msg<bugsy::msg::LinkStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::GetFailsafeConfig:
+                    io::write_msg<bugsy::msg::FailsafeConfigBuilder>(src, configuration.failsafe);
+                    break;
+
+                case Command::ProposeBaud: {
+                    if (arg_len != sizeof(uint32_t)) {
+                        log_error("> [Command::ProposeBaud] Bad baud rate size!");
+                        return;
+                    }
+
+                    // The answer of a batch would be sent after the switch
+                    uint8_t accepted = !capture && uart::propose(src, bugsy::msg::wire::get_u32((const uint8_t*)arg_bytes));
+                    io::write_u8(src, accepted);
+
+                    // Switches after the answer went out, a rejected proposal leaves the rate as it is
+                    if (accepted) {
+                        uart::apply(src);
+                    }
+
+                    break;
+                }
+
+                case Command::BaudTest: {
+                    uint8_t answer [BUGSY_BAUD_TEST_SIZE];
+
+                    // Broken frames stay unanswered, the client counts them as failed
+                    if (uart::test(src, (const uint8_t*)arg_bytes, arg_len, answer)) {
+                        io::write(src, answer, sizeof(answer));
+                    }
+
+                    break;
+                }
+
+                case Command::ConfirmBaud: {
+                    uint8_t confirmed = uart::confirm(src);
+                    io::write_u8(src, confirmed);
+                    break;
+                }
+
+                case Command::GetBaudStats: {
+                    if (arg_len != sizeof(Remote)) {
+                        log_error("> [Command::GetBaudStats] Bad remote size!");
+                        return;
+                    }
+
+                    bugsy::BaudStats stats = uart::stats((Remote)arg_bytes[0]);
+                    io::write_msg<bugsy::msg::BaudStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::SetFailsafeConfig: {
+                    bugsy::msg::FailsafeConfigView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::SetFailsafeConfig] Bad failsafe config size!");
+                        return;
+                    }
+
+                    bugsy::FailsafeConfig failsafe = view.get();
+
+                    if (bugsy::link::valid(failsafe)) {
+                        configuration.failsafe = failsafe;
                     } else {
+                        log_errorln("> [Command::SetFailsafeConfig] Invalid failsafe config rejected!");
+                    }
+
+                    break;
+                }
+
+                case Command::Move: {
+                    bugsy::MoveStamp stamp;
+                    bool stamped;
+                    const char* payload = unstamp(arg_bytes, arg_len, bugsy::msg::MovementView::SIZE, &stamp, &stamped);
+
+                    // Check if the data has a valid size
+                    if (!payload) {
                         log_trace("> [Command::Move] Bad movement command with length: ");
                         log_traceln(arg_len);
+                        break;
+                    }
+
+                    Movement new_move = bugsy::msg::MovementView(payload, bugsy::msg::MovementView::SIZE).get();
+
+                    post_move(src, stamped ? &stamp : nullptr, new_move);
+                    break;
+                }
+
+                case Command::Stop:
+                    move::stop();
+                    bugsy_core::state = CoreState::STANDBY;
+                    break;
+
+                case Command::GetMovement:
+                    io::write_msg<bugsy::msg::MovementBuilder>(src, move::move);
+                    break;
+
+                case Command::MoveServo: {
+                    bugsy::msg::ServoMoveView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::MoveServo] Bad servo movement size!");
+                        return;
+                    }
+
+                    bugsy::ServoMove servo_move = view.get();
+
+                    if (!servo::move(&servo_move)) {
+                        log_errorln("> [Command::MoveServo] Servo movement rejected!");
                     }
+
                     break;
+                }
+
+                case Command::GetServo: {
+                    if (arg_len != sizeof(bugsy::Servo)) {
+                        log_error("> [Command::GetServo] Bad servo size!");
+                        return;
+                    }
+
+                    uint16_t angle = servo::angle((bugsy::Servo)arg_bytes[0]);
+                    io::write_u16(src, angle);
+                    break;
+                }
+
+                case Command::Drive: {
+                    bugsy::MoveStamp stamp;
+                    bool stamped;
+                    const char* payload = unstamp(arg_bytes, arg_len, bugsy::msg::VelocityView::SIZE, &stamp, &stamped);
+
+                    if (!payload) {
+                        log_trace("> [Command::Drive] Bad velocity command with length: ");
+                        log_traceln(arg_len);
+                        break;
+                    }
+
+                    bugsy::Velocity vel = bugsy::msg::VelocityView(payload, bugsy::msg::VelocityView::SIZE).get();
+
+                    post_move(src, stamped ? &stamp : nullptr, bugsy::drive::to_movement(vel, configuration.drive));
+                    break;
+                }
+
+                case Command::ScheduleMove: {
+                    bugsy::msg::ScheduledMoveView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::ScheduleMove] Bad scheduled movement size!");
+                        return;
+                    }
+
+                    bugsy::ScheduledMove scheduled = view.get();
+
+                    if (move::schedule.add(src, scheduled.at, scheduled.move, micros())) {
+                        power::activity();
+                    }
+
+                    break;
+                }
+
+                case Command::ScheduleDrive: {
+                    bugsy::msg::ScheduledVelocityView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::ScheduleDrive] Bad scheduled velocity size!");
+                        return;
+                    }
+
+                    bugsy::ScheduledVelocity scheduled = view.get();
+
+                    // Converted right away, a later calibration change does not affect it
+                    Movement new_move = bugsy::drive::to_movement(scheduled.vel, configuration.drive);
+
+                    if (move::schedule.add(src, scheduled.at, new_move, micros())) {
+                        power::activity();
+                    }
+
+                    break;
+                }
+
+                case Command::GetScheduleStats:
+                    io::write_msg<bugsy::msg::ScheduleStatsBuilder>(src, move::schedule.stats);
+                    break;
+
+                case Command::GetMoveStats:
+                    io::write_msg<bugsy::msg::MoveStatsBuilder>(src, move::mailbox.stats);
+                    break;
+
+                case Command::GetDriveCalibration:
+                    io::write_msg<bugsy::msg::DriveCalibrationBuilder>(src, configuration.drive);
+                    break;
+
+                case Command::SetDriveCalibration: {
+                    bugsy::msg::DriveCalibrationView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::SetDriveCalibration] Bad calibration size!");
+                        return;
+                    }
+
+                    bugsy::DriveCalibration cal = view.get();
+
+                    if (bugsy::drive::valid(cal)) {
+                        configuration.drive = cal;
+                    } else {
+                        log_errorln("> [Command::SetDriveCalibration] Invalid calibration rejected!");
+                    }
+
+                    break;
+                }
+
+                case Command::GetSpeedStats: {
+                    bugsy::SpeedStats stats = speed::stats();
+                    io::write_msg<bugsy::msg::SpeedStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::GetSpeedGains:
+                    io::write_msg<bugsy::msg::SpeedGainsBuilder>(src, configuration.speed_gains);
+                    break;
+
+                case Command::SetSpeedGains: {
+                    bugsy::msg::SpeedGainsView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::SetSpeedGains] Bad gains size!");
+                        return;
+                    }
+
+                    bugsy::SpeedGains gains = view.get();
+
+                    if (!bugsy::speed::valid(gains)) {
+                        log_errorln("> [Command::SetSpeedGains] Invalid gains rejected!");
+                        break;
+                    }
+
+                    configuration.speed_gains = gains;
+                    move::set_closed_loop(gains.enabled);
+                    break;
+                }
 
                 case Command::SetTraderState:
                     // Check if the data has a valid size
@@ -77,8 +461,8 @@ namespace bugsy_core {
                     }
 
                     // Update local trader state and send the core state back
-                    trader_state = *(bugsy::TraderState*)arg_bytes;
-                    io::write_obj(src, &state);
+                    trader_state = (TraderState)arg_bytes[0];
+                    io::write_u8(src, (uint8_t)state);
                     trader_stamp = millis();
 
                     if (trader_state == bugsy::TraderState::ACTIVE) {
@@ -88,22 +472,37 @@ namespace bugsy_core {
                     break;
 
                 case Command::GetTraderState:
-                    io::write_obj(src, &io::trader_state);
+                    io::write_u8(src, (uint8_t)io::trader_state);
                     break;
 
                 case Command::PublishPrimarySensorData:
-                    if (arg_len != sizeof(bugsy::PrimarySensorData)) {
+                    if (arg_len != bugsy::msg::PrimarySensorDataView::SIZE) {
                         log_error("> [Command::PublishPrimarySensorData] Bad sensor data size!");
                         return;
                     }
 
-                    primary_sensor_data = *(bugsy::PrimarySensorData*)arg_bytes;
+                    primary_sensor_data = bugsy::msg::PrimarySensorDataView(arg_bytes, arg_len).get();
                     trader_stamp = millis();
 
                     break;
 
                 case Command::GetPrimarySensorData:
-                    io::write_obj(src, &primary_sensor_data);
+                    io::write_msg<bugsy::msg::PrimarySensorDataBuilder>(src, primary_sensor_data);
+                    break;
+
+                case Command::PublishSecondarySensorData:
+                    if (arg_len != bugsy::msg::SecondarySensorDataView::SIZE) {
+                        log_error("> [Command::PublishSecondarySensorData] Bad sensor data size!");
+                        return;
+                    }
+
+                    secondary_sensor_data = bugsy::msg::SecondarySensorDataView(arg_bytes, arg_len).get();
+                    trader_stamp = millis();
+
+                    break;
+
+                case Command::GetSecondarySensorData:
+                    io::write_msg<bugsy::msg::SecondarySensorDataBuilder>(src, secondary_sensor_data);
                     break;
 
                 case Command::SetRPiReady:
@@ -112,94 +511,169 @@ namespace bugsy_core {
                     break;
 
                 case Command::IsRPiReady:
-                    io::write_obj(src, &io::rpi_ready);
+                    io::write_u8(src, io::rpi_ready);
                     break;
 
                 case Command::Remotes:
-                    io::write_obj(src, &remotes);
+                    io::write_u8(src, (uint8_t)remotes);
                     break;
 
-                case Command::RemoteConfigure: {
-                    if (arg_len < sizeof(Remote)) {
-                        log_error("> [ERROR] Command too short for parsing `Remote`");
+                case Command::OtaBegin: {
+                    bugsy::msg::OtaImageView view(arg_bytes, arg_len);
+
+                    if (arg_len != view.SIZE) {
+                        log_error("> [Command::OtaBegin] Bad image size!");
                         return;
                     }
-                    Remote new_mode = *(Remote*)arg_bytes;
-                    // TODO: Add reconfiguration
+
+                    bugsy::OtaStatus status = ota::begin(src, view.get());
+                    io::write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
                     break;
                 }
-                case Command::SaveConfig:
-                    log_info("> Saving configuration ... ");
-                    config::save();
-                    log_infoln("done!");
+
+                case Command::OtaChunk:
+                    // Not answered, the client asks for the status after a window of chunks
+                    ota::chunk(src, (const uint8_t*)arg_bytes, arg_len);
+                    break;
+
+                case Command::GetOtaStatus: {
+                    bugsy::OtaStatus status = ota::status();
+                    io::write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
+                    break;
+                }
+
+                case Command::OtaFinish: {
+                    if (arg_len != sizeof(uint8_t)) {
+                        log_error("> [Command::OtaFinish] Bad restart flag size!");
+                        return;
+                    }
+
+                    bugsy::OtaStatus status = ota::finish(arg_bytes[0] != 0);
+                    io::write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
                     break;
+                }
 
-                case Command::GetWiFiSSID:
-                    io::write_str(src, configuration.wifi_ssid);
+                case Command::OtaAbort: {
+                    bugsy::OtaStatus status = ota::abort();
+                    io::write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
                     break;
+                }
 
+                // Maintenance, answered with the ticket of the job right away
+                case Command::RemoteConfigure:
+                case Command::SaveConfig:
                 case Command::SetWiFiSSID:
-                    if (len == 1) {
-                        configuration.wifi_ssid[0] = 0;
-                    } else {
-                        strncpy(configuration.wifi_ssid, buffer + 1, BUGSY_WIFI_CRED_BUFFER_SIZE - 1);
-                        configuration.wifi_ssid[BUGSY_WIFI_CRED_BUFFER_SIZE - 1] = 0;
+                case Command::SetWiFiPwd: {
+                    bugsy::JobTicket ticket = jobs::submit(cmd, arg_bytes, arg_len);
+                    io::write_msg<bugsy::msg::JobTicketBuilder>(src, ticket);
+                    break;
+                }
+
+                case Command::GetJobState: {
+                    if (arg_len != sizeof(uint8_t)) {
+                        log_error("> [Command::GetJobState] Bad job ID size!");
+                        return;
                     }
-                    log_info("> New WIFI SSID set: '");
-                    log_info(configuration.wifi_ssid);
-                    log_infoln("'");
+
+                    bugsy::JobState job_state = jobs::state((uint8_t)arg_bytes[0]);
+                    io::write_u8(src, (uint8_t)job_state);
+                    break;
+                }
+
+                case Command::GetWiFiSSID: {
+                    // A job might be writing the SSID
+                    char ssid [BUGSY_WIFI_CRED_BUFFER_SIZE];
+
+                    portENTER_CRITICAL(&config::mux);
+                    memcpy(ssid, configuration.wifi_ssid, BUGSY_WIFI_CRED_BUFFER_SIZE);
+                    portEXIT_CRITICAL(&config::mux);
+
+                    io::write_str(src, ssid);
                     break;
+                }
 
                 default:
                     log_error("> [ERROR] Command not found! ID: ");
                     log_errorln((uint8_t)cmd);
+
+                    // Most likely garbage received at a rate the wiring can not handle
+                    uart::error(src);
                     break;
             }
         }
 
         void setup() {
-            trader_serial->begin(BUGSY_UART_CORE_TO_TRADER_BAUD, SERIAL_8N1, PIN_UART_TRADER_RX, PIN_UART_TRADER_TX);
-            trader_serial->setTimeout(5);
+            uart::setup();
+            rx::setup();
+        }
 
-            rpi_serial->begin(UART_PI_BAUD);
-            rpi_serial->setTimeout(5);
-        }   
+        void receive(Remote src) {
+            if (frame_count >= (sizeof(frames) / sizeof(Frame))) {
+                return;
+            }
 
-        void handle() {
-            // Read UARTS
-            if (usb_serial->available()) {
-                io::parse_cmd(
-                    Remote::USB,
-                    io::parse_buffer,
-                    io::usb_serial->readBytes(io::parse_buffer, PARSE_BUFFER_SIZE)
-                );
+            Frame& frame = frames[frame_count];
+            frame.src = src;
+            frame.len = rx::take(src, frame.data, FRAME_BUFFER_SIZE, &frame.stamp);
+
+            if (frame.len) {
+                frame_count++;
             }
+        }
+
+        /// The class of a frame, a batch takes the class of its most urgent command
+        static bugsy::CommandClass frame_class(const Frame& frame) {
+            if ((Command)frame.data[0] == Command::Batch) {
+                return bugsy::batch::batch_class((const uint8_t*)frame.data + 1, frame.len - 1);
+            }
+
+            return bugsy::command_class((Command)frame.data[0]);
+        }
 
-            if (trader_serial->available()) {
-                io::parse_cmd(
-                    Remote::TRADER,
-                    io::parse_buffer,
-                    io::trader_serial->readBytes(io::parse_buffer, PARSE_BUFFER_SIZE)
-                );
+        void dispatch() {
+            // Control commands first, so a movement or stop never waits for the other commands of this iteration
+            for (uint8_t i = 0; i < frame_count; i++) {
+                if (frames[i].len && (frame_class(frames[i]) == bugsy::CommandClass::CONTROL)) {
+                    frame_stamp = frames[i].stamp;
+                    io::parse_cmd(frames[i].src, frames[i].data, frames[i].len);
+                    frames[i].len = 0;
+                }
             }
 
-            if (rpi_serial->available()) {
-                io::parse_cmd(
-                    Remote::RPI,
-                    io::parse_buffer,
-                    io::rpi_serial->readBytes(io::parse_buffer, PARSE_BUFFER_SIZE)
-                );
+            for (uint8_t i = 0; i < frame_count; i++) {
+                if (frames[i].len) {
+                    frame_stamp = frames[i].stamp;
+                    io::parse_cmd(frames[i].src, frames[i].data, frames[i].len);
+                }
             }
 
+            frame_count = 0;
+        }
+
+        void handle() {
+            // Read UARTS
+            io::receive(Remote::USB);
+            io::receive(Remote::TRADER);
+            io::receive(Remote::RPI);
+
             // Set the trader to disconnected if the last update extends the duration
             if ((millis() > (trader_stamp + BUGSY_TRADER_MIN_UPDATES)) && (trader_state != TraderState::DISCONNECTED)){
                 trader_state = TraderState::DISCONNECTED;
                 log_error("> [bugsy_core::io::handle()] Trader disconnected through timeout!");
+
+                // The trader starts over at the base rate once it reconnects
+                uart::fallback(Remote::TRADER);
             }
         }
 
         // Writing
             void write(Remote addr, const uint8_t* buffer, size_t len) {
+                // Answers of the commands of a batch are sent together
+                if (capture) {
+                    capture->append(buffer, len);
+                    return;
+                }
+
                 if ((uint8_t)addr & (uint8_t)Remote::TRADER) {
                     io::trader_serial->write(buffer, len);
                 }
@@ -210,7 +684,7 @@ namespace bugsy_core {
 
                 // Remotes
                 if (remote::has_bt(addr)) {
-                    remote::bt_serial.write(buffer, len);
+                    remote::write_bt(buffer, len);
                 }
             }
 
@@ -218,9 +692,21 @@ namespace bugsy_core {
                 write(remotes, (const uint8_t*)buffer, strlen(buffer) + 1);
             }
 
-            template<typename T>
-            void write_obj(Remote remotes, T* obj) {
-                write(remotes, (const uint8_t*)obj, sizeof(T));
+            void write_u8(Remote remotes, uint8_t value) {
+                write(remotes, &value, sizeof(uint8_t));
+            }
+
+            void write_u16(Remote remotes, uint16_t value) {
+                uint8_t buffer [sizeof(uint16_t)];
+                bugsy::msg::wire::put_u16(buffer, value);
+                write(remotes, buffer, sizeof(buffer));
+            }
+
+            template<typename B, typename T>
+            void write_msg(Remote remotes, const T& obj) {
+                uint8_t buffer [B::SIZE];
+                B(buffer, sizeof(buffer)).set(obj);
+                write(remotes, buffer, sizeof(buffer));
             }
         // 
     }
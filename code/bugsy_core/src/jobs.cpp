@@ -0,0 +1,157 @@
+# include "jobs.hpp"
+
+// Local headers
+# include "config.hpp"
+# include "remote.hpp"
+
+using bugsy::Command;
+using bugsy::JobState;
+using bugsy::JobTicket;
+using bugsy::Remote;
+
+namespace bugsy_core {
+    namespace jobs {
+        struct Job {
+            uint8_t id;
+            Command cmd;
+            union {
+                /// Snapshot taken when the job is queued, later changes are saved by the next `SaveConfig`
+                bugsy::Configuration config;
+                Remote remotes;
+                char credential [BUGSY_WIFI_CRED_BUFFER_SIZE];
+            };
+        };
+
+        /// States of the last jobs, indexed by the lower bits of the ID and guarded by `history_mux`
+        static struct {
+            uint8_t id;
+            JobState state;
+        } history [JOBS_HISTORY] = { };
+        static portMUX_TYPE history_mux = portMUX_INITIALIZER_UNLOCKED;
+
+        /// Only accessed by the loop
+        static uint8_t last_id = 0;
+
+        static QueueHandle_t queue = nullptr;
+
+        static void set_state(uint8_t id, JobState state) {
+            portENTER_CRITICAL(&history_mux);
+            history[id & (JOBS_HISTORY - 1)].id = id;
+            history[id & (JOBS_HISTORY - 1)].state = state;
+            portEXIT_CRITICAL(&history_mux);
+        }
+
+        static bool run(Job& job) {
+            switch (job.cmd) {
+                case Command::SaveConfig:
+                    return config::save(&job.config);
+
+                case Command::RemoteConfigure:
+                    remote::configure(job.remotes);
+                    return true;
+
+                case Command::SetWiFiSSID:
+                case Command::SetWiFiPwd: {
+                    char* target = (job.cmd == Command::SetWiFiSSID) ? configuration.wifi_ssid : configuration.wifi_password;
+
+                    portENTER_CRITICAL(&config::mux);
+                    memcpy(target, job.credential, BUGSY_WIFI_CRED_BUFFER_SIZE);
+                    portEXIT_CRITICAL(&config::mux);
+
+                    // Reconnect with the new credentials
+                    if (remote::wifi_active) {
+                        remote::stop_wifi();
+                        return remote::start_wifi() == bugsy::CoreError::None;
+                    }
+
+                    return true;
+                }
+
+                default:
+                    return false;
+            }
+        }
+
+        static void job_task(void*) {
+            Job job;
+
+            while (true) {
+                xQueueReceive(queue, &job, portMAX_DELAY);
+
+                set_state(job.id, JobState::RUNNING);
+                bool success = run(job);
+                set_state(job.id, success ? JobState::DONE : JobState::FAILED);
+
+                log_debug("> Job ");
+                log_debug(job.id);
+                log_debugln(success ? " done!" : " failed!");
+            }
+        }
+
+        void setup() {
+            queue = xQueueCreate(JOBS_QUEUE_SIZE, sizeof(Job));
+
+            // Lowest priority on the protocol CPU, the jobs may take as long as they need
+            xTaskCreatePinnedToCore(job_task, "jobs", 4096, nullptr, 1, nullptr, 0);
+        }
+
+        JobTicket submit(Command cmd, const char* args, size_t len) {
+            // The ID `0` is never handed out, so a zeroed answer never matches a job
+            last_id = (last_id == UINT8_MAX) ? 1 : (last_id + 1);
+
+            Job job;
+            job.id = last_id;
+            job.cmd = cmd;
+
+            JobTicket ticket = { job.id, JobState::QUEUED };
+
+            switch (cmd) {
+                case Command::SaveConfig:
+                    portENTER_CRITICAL(&config::mux);
+                    job.config = configuration;
+                    portEXIT_CRITICAL(&config::mux);
+                    break;
+
+                case Command::RemoteConfigure:
+                    if (len < sizeof(Remote)) {
+                        log_errorln("> [jobs::submit()] Command too short for parsing `Remote`");
+                        ticket.state = JobState::REJECTED;
+                        break;
+                    }
+
+                    job.remotes = (Remote)args[0];
+                    break;
+
+                case Command::SetWiFiSSID:
+                case Command::SetWiFiPwd:
+                    // An empty argument clears the credential
+                    memset(job.credential, 0, BUGSY_WIFI_CRED_BUFFER_SIZE);
+                    memcpy(job.credential, args, (len < (BUGSY_WIFI_CRED_BUFFER_SIZE - 1)) ? len : (BUGSY_WIFI_CRED_BUFFER_SIZE - 1));
+                    break;
+
+                default:
+                    ticket.state = JobState::REJECTED;
+                    break;
+            }
+
+            // Recorded before queueing, the task might pick the job up right away
+            set_state(ticket.id, ticket.state);
+
+            if ((ticket.state == JobState::QUEUED) && (xQueueSend(queue, &job, 0) != pdTRUE)) {
+                log_errorln("> [jobs::submit()] Job queue full!");
+                ticket.state = JobState::REJECTED;
+                set_state(ticket.id, ticket.state);
+            }
+
+            return ticket;
+        }
+
+        JobState state(uint8_t id) {
+            portENTER_CRITICAL(&history_mux);
+            JobState found = (history[id & (JOBS_HISTORY - 1)].id == id) ? history[id & (JOBS_HISTORY - 1)].state : JobState::UNKNOWN;
+            portEXIT_CRITICAL(&history_mux);
+
+            return (id == 0) ? JobState::UNKNOWN : found;
+        }
+    }
+}
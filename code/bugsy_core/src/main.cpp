@@ -6,20 +6,32 @@
 
 # include <bugsy/core.hpp>
 # include <bugsy/defines.hpp>
+# include <bugsy/drive.hpp>
+# include <bugsy/link.hpp>
+# include <bugsy/speed.hpp>
 
 // Local headers
 # include "bugsy_core.hpp"
 
+# include "battery.hpp"
 # include "config.hpp"
+# include "estop.hpp"
 # include "io.hpp"
+# include "jobs.hpp"
 # include "motors.hpp"
+# include "ota.hpp"
+# include "power.hpp"
 # include "remote.hpp"
+# include "servo.hpp"
+# include "speed.hpp"
+# include "uart.hpp"
 
 using bugsy::Configuration;
 using bugsy::CoreState;
 using bugsy::MoveMode;
 using bugsy::PrimarySensorData;
 using bugsy::Remote;
+using bugsy::SecondarySensorData;
 
 // Define global events
 namespace bugsy_core {
@@ -30,10 +42,14 @@ namespace bugsy_core {
         /* saved_remote_mode: */    Remote::NONE,
         /* move_dur: */             BUGSY_DEFAULT_MOVE_DUR,
         /* wifi_ssid: */            "",
-        /* wifi_pwd: */             ""
+        /* wifi_pwd: */             "",
+        /* drive: */                bugsy::drive::DEFAULT_CALIBRATION,
+        /* speed_gains: */          bugsy::speed::DEFAULT_GAINS,
+        /* failsafe: */             bugsy::link::DEFAULT_FAILSAFE
     };
 
     PrimarySensorData primary_sensor_data;
+    SecondarySensorData secondary_sensor_data;
 
     MoveMode move_mode = MoveMode::EXPLORE;
 }
@@ -89,6 +105,33 @@ void setup() {
         log_debug("| > Setting up motor ctrl ... ");
         bugsy_core::move::setup();
         log_debugln("done!");
+
+        log_debug("| > Arming emergency stop ... ");
+        bugsy_core::estop::setup();
+        log_debugln("done!");
+
+        log_debug("| > Starting speed control ... ");
+        bugsy_core::speed::setup();
+        bugsy_core::move::set_closed_loop(bugsy_core::configuration.speed_gains.enabled);
+        log_debugln("done!");
+
+        log_debug("| > Setting up servos ... ");
+        bugsy_core::servo::setup();
+        log_debugln("done!");
+
+        log_debug("| > Starting battery measurement ... ");
+        bugsy_core::battery::setup();
+        log_debugln("done!");
+
+        bugsy_core::power::setup();
+
+        log_debug("| > Starting job task ... ");
+        bugsy_core::jobs::setup();
+        log_debugln("done!");
+
+        log_debug("| > Starting update task ... ");
+        bugsy_core::ota::setup();
+        log_debugln("done!");
     //
 
     // TRADER & RPI LAYER
@@ -107,10 +150,17 @@ void setup() {
 void loop() {
     bugsy_core::io::handle();
     bugsy_core::remote::handle();
+    bugsy_core::io::dispatch();
+    bugsy_core::uart::update();
+    bugsy_core::battery::update();
+    bugsy_core::estop::update();
 
     if (bugsy_core::move::update()) {
         bugsy_core::state = CoreState::DRIVING; 
     } else {
         bugsy_core::state = CoreState::STANDBY;
     }
+
+    // Sleeps if nothing is to do
+    bugsy_core::power::update();
 }
\ No newline at end of file
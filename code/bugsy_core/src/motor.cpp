@@ -3,7 +3,11 @@
 // External libraries
 
 // Local headers
+# include "battery.hpp"
 # include "bugsy_core.hpp"
+# include "estop.hpp"
+# include "power.hpp"
+# include "speed.hpp"
 
 using bugsy::Movement;
 using bugsy::MoveDuration;
@@ -13,8 +17,24 @@ namespace bugsy_core {
         Movement move = MOVEMENT_NONE;
         uint32_t stamp = 0;
         MoveDuration duration = 0;
+        bugsy::mailbox::Mailbox mailbox;
+        bugsy::clock::Schedule schedule;
+        bugsy::link::Monitor links;
+
+        /// The duty limit of the battery the pins have last been written with
+        static uint8_t applied_limit = 0xFF;
+
+        /// Whether the speed control drives the pins, only changed with `pins_mutex` taken
+        static bool closed_loop = false;
+        /// Whether the emergency stop halted the motors, only changed with `pins_mutex` taken
+        static bool halted = false;
+        /// Serializes the pin writes of the loop and the speed control task
+        static SemaphoreHandle_t pins_mutex = nullptr;
 
         void setup() {
+            pins_mutex = xSemaphoreCreateMutex();
+
+
             // Output pins for motor controller
             pinMode(PIN_CHAIN_LEFT_FW, OUTPUT);
             pinMode(PIN_CHAIN_LEFT_BW, OUTPUT);
@@ -25,35 +45,97 @@ namespace bugsy_core {
             stop();
         }
 
-        void stop() {
+        /// Ends the current movement only, the scheduled ones stay
+        static void end() {
             apply_to_pins(&MOVEMENT_NONE);
             duration = 0;
             move = MOVEMENT_NONE;
         }
 
+        void stop() {
+            mailbox.clear();
+            schedule.clear();
+            end();
+        }
+
         uint32_t lasts_until() {
             return stamp + duration;
         }
 
         void apply_to_pins(const Movement* new_move) {
-            if ((bool)new_move->chain_left_dir) {
-                analogWrite(PIN_CHAIN_LEFT_BW, 0);
-                analogWrite(PIN_CHAIN_LEFT_FW, new_move->chain_left_duty);
-            } else {
-                analogWrite(PIN_CHAIN_LEFT_FW, 0);
-                analogWrite(PIN_CHAIN_LEFT_BW, new_move->chain_left_duty);
+            applied_limit = battery::state.duty_limit;
+
+            // The speed control applies the duty limit itself
+            if (closed_loop) {
+                int16_t left, right;
+                bugsy::speed::targets_of(*new_move, configuration.drive, &left, &right);
+                speed::set_targets(left, right);
+                return;
             }
 
-            if ((bool)new_move->chain_right_dir) {
-                analogWrite(PIN_CHAIN_RIGHT_BW, 0);
-                analogWrite(PIN_CHAIN_RIGHT_FW, new_move->chain_right_duty);
-            } else {
+            // Scale down the duty as the battery sags
+            int16_t left_duty = bugsy::battery::limit_duty(new_move->chain_left_duty, applied_limit);
+            int16_t right_duty = bugsy::battery::limit_duty(new_move->chain_right_duty, applied_limit);
+
+            write_pins(
+                (bool)new_move->chain_left_dir ? left_duty : -left_duty,
+                (bool)new_move->chain_right_dir ? right_duty : -right_duty,
+                false
+            );
+        }
+
+        void write_pins(int16_t left, int16_t right, bool closed_loop) {
+            xSemaphoreTake(pins_mutex, portMAX_DELAY);
+
+            if (!halted && (closed_loop == move::closed_loop)) {
+                if (left >= 0) {
+                    analogWrite(PIN_CHAIN_LEFT_BW, 0);
+                    analogWrite(PIN_CHAIN_LEFT_FW, left);
+                } else {
+                    analogWrite(PIN_CHAIN_LEFT_FW, 0);
+                    analogWrite(PIN_CHAIN_LEFT_BW, -left);
+                }
+
+                if (right >= 0) {
+                    analogWrite(PIN_CHAIN_RIGHT_BW, 0);
+                    analogWrite(PIN_CHAIN_RIGHT_FW, right);
+                } else {
+                    analogWrite(PIN_CHAIN_RIGHT_FW, 0);
+                    analogWrite(PIN_CHAIN_RIGHT_BW, -right);
+                }
+            }
+
+            xSemaphoreGive(pins_mutex);
+        }
+
+        void set_closed_loop(bool closed_loop) {
+            xSemaphoreTake(pins_mutex, portMAX_DELAY);
+            move::closed_loop = closed_loop;
+            xSemaphoreGive(pins_mutex);
+
+            // Hand the current movement over to the new mode
+            apply_to_pins(&move);
+        }
+
+        void halt(bool halted) {
+            xSemaphoreTake(pins_mutex, portMAX_DELAY);
+            move::halted = halted;
+
+            if (halted) {
+                analogWrite(PIN_CHAIN_LEFT_FW, 0);
+                analogWrite(PIN_CHAIN_LEFT_BW, 0);
                 analogWrite(PIN_CHAIN_RIGHT_FW, 0);
-                analogWrite(PIN_CHAIN_RIGHT_BW, new_move->chain_right_duty);
+                analogWrite(PIN_CHAIN_RIGHT_BW, 0);
             }
+
+            xSemaphoreGive(pins_mutex);
         }
 
         void apply(const Movement* new_move, MoveDuration duration) {
+            if (estop::active()) {
+                return;
+            }
+
             apply_to_pins(new_move);
 
             move::move = *new_move;
@@ -62,10 +144,29 @@ namespace bugsy_core {
         }
 
         bool update() {
+            bugsy::Remote src;
+            Movement new_move;
+            bool scheduled = false;
+
+            while (schedule.due(micros(), &src, &new_move)) {
+                mailbox.post(src, nullptr, new_move, millis());
+                scheduled = true;
+            }
+
+            if (mailbox.take(&new_move, &src)) {
+                apply(&new_move, links.window(src, configuration.failsafe, configuration.move_dur));
+                power::applied(scheduled);
+            }
+
             if (duration) {
                 if (lasts_until() < millis()) {
-                    stop();
+                    end();
                 } else {
+                    // Follow the duty limit of the battery during long movements
+                    if (applied_limit != battery::state.duty_limit) {
+                        apply_to_pins(&move);
+                    }
+
                     return true;
                 }
             }
@@ -0,0 +1,354 @@
+# include "ota.hpp"
+
+# include <esp_ota_ops.h>
+# include <esp_partition.h>
+# include <esp_system.h>
+
+// Local headers
+# include "motors.hpp"
+
+using bugsy::OtaImage;
+using bugsy::OtaState;
+using bugsy::OtaStatus;
+using bugsy::Remote;
+
+namespace bugsy_core {
+    namespace ota {
+        enum class Step : uint8_t {
+            /// Erases the partition for the image of the session
+            PREPARE,
+            WRITE,
+            /// Verifies the image of the session and makes it the boot partition
+            FINISH,
+            ABORT
+        };
+
+        struct Request {
+            Step step;
+            /// The session the request belongs to, requests of replaced sessions are skipped
+            uint8_t session;
+            bool restart;
+            uint16_t index;
+            uint16_t len;
+            uint8_t data [BUGSY_OTA_CHUNK_SIZE];
+        };
+
+        /// The session and its ID, accessed by the loop and the writer task and guarded by `mux`
+        static bugsy::ota::Session session;
+        static uint8_t session_id = 0;
+        static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+        static QueueHandle_t queue = nullptr;
+
+        /// Only accessed by the writer task
+        static const esp_partition_t* partition = nullptr;
+        static esp_ota_handle_t handle = 0;
+        static bool handle_open = false;
+
+        /// Sets the state of a session, unless it has been replaced in the meantime
+        static void set_state(uint8_t id, OtaState state) {
+            portENTER_CRITICAL(&mux);
+
+            if (id == session_id) {
+                session.set_state(state);
+            }
+
+            portEXIT_CRITICAL(&mux);
+        }
+
+        static void close() {
+            if (handle_open) {
+                esp_ota_abort(handle);
+                handle_open = false;
+            }
+        }
+
+        static bool prepare(uint32_t size) {
+            close();
+            partition = esp_ota_get_next_update_partition(nullptr);
+
+            if (!partition) {
+                log_errorln("> [ota::prepare()] No update partition!");
+                return false;
+            }
+
+            if (size > partition->size) {
+                log_errorln("> [ota::prepare()] Image too large for the update partition!");
+                return false;
+            }
+
+            // Erased below, `esp_ota_begin()` would erase the whole image at once with the caches of both CPUs disabled
+            esp_err_t err = esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &handle);
+
+            if (err != ESP_OK) {
+                log_error("> [ota::prepare()] Opening the partition failed: ");
+                log_errorln(esp_err_to_name(err));
+                return false;
+            }
+
+            handle_open = true;
+
+            // One sector at a time, the movement tasks run in between
+            for (uint32_t offset = 0; offset < size; offset += SPI_FLASH_SEC_SIZE) {
+                err = esp_partition_erase_range(partition, offset, SPI_FLASH_SEC_SIZE);
+
+                if (err != ESP_OK) {
+                    log_error("> [ota::prepare()] Erasing failed: ");
+                    log_errorln(esp_err_to_name(err));
+                    close();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static bool verify(const OtaImage& image) {
+            uint8_t block [OTA_VERIFY_BLOCK_SIZE];
+            uint32_t crc = 0;
+
+            // Read back, so a chunk the flash did not take fails here and not at the next boot
+            for (uint32_t offset = 0; offset < image.size; offset += sizeof(block)) {
+                size_t len = ((image.size - offset) < sizeof(block)) ? (image.size - offset) : sizeof(block);
+
+                if (esp_partition_read(partition, offset, block, len) != ESP_OK) {
+                    return false;
+                }
+
+                crc = bugsy::crc::crc32(block, len, crc);
+            }
+
+            if (crc != image.crc) {
+                log_errorln("> [ota::verify()] CRC mismatch!");
+                return false;
+            }
+
+            // Closes the handle either way, checks the image header as well
+            handle_open = false;
+            return (esp_ota_end(handle) == ESP_OK) && (esp_ota_set_boot_partition(partition) == ESP_OK);
+        }
+
+        static void run(Request& req) {
+            portENTER_CRITICAL(&mux);
+            bool current = (req.session == session_id);
+            OtaImage image = session.image();
+            OtaState state = session.state();
+            portEXIT_CRITICAL(&mux);
+
+            switch (req.step) {
+                case Step::PREPARE:
+                    if (current) {
+                        set_state(req.session, prepare(image.size) ? OtaState::RECEIVING : OtaState::FAILED);
+                    }
+
+                    break;
+
+                case Step::WRITE: {
+                    if (!current || !handle_open) {
+                        break;
+                    }
+
+                    esp_err_t err = esp_ota_write_with_offset(handle, req.data, req.len, (uint32_t)req.index * BUGSY_OTA_CHUNK_SIZE);
+
+                    if (err != ESP_OK) {
+                        log_error("> [ota::run()] Write failed: ");
+                        log_errorln(esp_err_to_name(err));
+
+                        close();
+                        set_state(req.session, OtaState::FAILED);
+                        break;
+                    }
+
+                    portENTER_CRITICAL(&mux);
+
+                    if (req.session == session_id) {
+                        session.written(req.len);
+                    }
+
+                    portEXIT_CRITICAL(&mux);
+                    break;
+                }
+
+                case Step::FINISH:
+                    if (!current) {
+                        break;
+                    }
+
+                    // Finishing a verified image again only restarts
+                    if (state == OtaState::VERIFYING) {
+                        state = verify(image) ? OtaState::READY : OtaState::FAILED;
+                        set_state(req.session, state);
+
+                        log_infoln((state == OtaState::READY) ? "> Firmware update verified!" : "> Firmware update failed!");
+                    }
+
+                    if ((state == OtaState::READY) && req.restart) {
+                        // Time for the client to fetch the status
+                        vTaskDelay(pdMS_TO_TICKS(BUGSY_OTA_RESTART_DELAY));
+
+                        log_infoln("> Restarting into the new firmware ...");
+                        move::halt(true);
+                        esp_restart();
+                    }
+
+                    break;
+
+                case Step::ABORT:
+                    close();
+                    break;
+            }
+        }
+
+        static void ota_task(void*) {
+            Request req;
+
+            while (true) {
+                xQueueReceive(queue, &req, portMAX_DELAY);
+                run(req);
+            }
+        }
+
+        /// Queues a request controlling the session, these may use the reserved slots of the queue
+        static bool control(Step step, uint8_t id, bool restart) {
+            Request req;
+            req.step = step;
+            req.session = id;
+            req.restart = restart;
+
+            if (xQueueSend(queue, &req, 0) != pdTRUE) {
+                log_errorln("> [ota::control()] Update queue full!");
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Chunks the remote may send before asking for the status, limited by its receive buffer
+        static uint8_t window_of(Remote src) {
+            switch (src) {
+                case Remote::RPI:
+                    return OTA_WINDOW_RPI;
+
+                case Remote::BLUETOOTH:
+                    return OTA_WINDOW_BT;
+
+                default:
+                    return 1;
+            }
+        }
+
+        void setup() {
+            queue = xQueueCreate(OTA_QUEUE_SIZE + OTA_QUEUE_RESERVED, sizeof(Request));
+
+            // Same level as the jobs, erasing and writing the flash may take as long as it needs
+            xTaskCreatePinnedToCore(ota_task, "ota", 4096, nullptr, 1, nullptr, 0);
+        }
+
+        OtaStatus begin(Remote src, const OtaImage& image) {
+            uint32_t now = millis();
+
+            portENTER_CRITICAL(&mux);
+            bool resumed = session.begin(image, src, now, window_of(src));
+
+            if (!resumed) {
+                session_id++;
+            }
+
+            uint8_t id = session_id;
+            OtaState state = session.state();
+            portEXIT_CRITICAL(&mux);
+
+            if (!resumed && (state == OtaState::ERASING) && !control(Step::PREPARE, id, false)) {
+                set_state(id, OtaState::FAILED);
+            }
+
+            log_info("> Firmware update ");
+            log_info(resumed ? "resumed" : "started");
+            log_info(" by remote ");
+            log_infoln((uint8_t)src);
+
+            return status();
+        }
+
+        void chunk(Remote src, const uint8_t* args, size_t len) {
+            uint32_t now = millis();
+            Request req;
+            req.step = Step::WRITE;
+
+            portENTER_CRITICAL(&mux);
+            req.len = session.accept(src, args, len, now, &req.index);
+            req.session = session_id;
+            portEXIT_CRITICAL(&mux);
+
+            if (!req.len) {
+                return;
+            }
+
+            memcpy(req.data, args + (2 * sizeof(uint16_t)), req.len);
+
+            // The client sends dropped chunks again, so a full queue only costs a retransmission
+            bool queued = (uxQueueSpacesAvailable(queue) > OTA_QUEUE_RESERVED) && (xQueueSend(queue, &req, 0) == pdTRUE);
+
+            portENTER_CRITICAL(&mux);
+
+            if (req.session == session_id) {
+                if (queued) {
+                    session.receive(req.index);
+                } else {
+                    session.drop();
+                }
+            }
+
+            portEXIT_CRITICAL(&mux);
+        }
+
+        OtaStatus finish(bool restart) {
+            portENTER_CRITICAL(&mux);
+            bool ready = (session.state() == OtaState::READY);
+            bool complete = (session.state() == OtaState::RECEIVING) && session.complete();
+
+            if (complete) {
+                session.set_state(OtaState::VERIFYING);
+            }
+
+            uint8_t id = session_id;
+            portEXIT_CRITICAL(&mux);
+
+            if ((ready || complete) && !control(Step::FINISH, id, restart) && complete) {
+                set_state(id, OtaState::FAILED);
+            }
+
+            return status();
+        }
+
+        OtaStatus abort() {
+            portENTER_CRITICAL(&mux);
+            session.set_state(OtaState::IDLE);
+            uint8_t id = ++session_id;
+            portEXIT_CRITICAL(&mux);
+
+            control(Step::ABORT, id, false);
+            log_infoln("> Firmware update aborted!");
+
+            return status();
+        }
+
+        OtaStatus status() {
+            portENTER_CRITICAL(&mux);
+            OtaStatus copy = session.get();
+            portEXIT_CRITICAL(&mux);
+
+            return copy;
+        }
+
+        bool owns(Remote src) {
+            uint32_t now = millis();
+
+            portENTER_CRITICAL(&mux);
+            bool owned = session.owns(src, now);
+            portEXIT_CRITICAL(&mux);
+
+            return owned;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+# include "power.hpp"
+
+// Local headers
+# include "motors.hpp"
+# include "rx.hpp"
+
+using bugsy::power::Level;
+
+namespace bugsy_core {
+    namespace power {
+        bugsy::power::Governor governor;
+
+        /// Receive time of the movement waiting in the mailbox in microseconds, and whether there is one
+        static uint32_t received_stamp = 0;
+        static bool received_pending = false;
+
+        /// Applies the current level of the governor
+        static void apply_level() {
+            setCpuFrequencyMhz((governor.level() == Level::REDUCED) ? POWER_REDUCED_CPU_FREQ : POWER_FULL_CPU_FREQ);
+        }
+
+        void setup() {
+            setCpuFrequencyMhz(POWER_FULL_CPU_FREQ);
+        }
+
+        void update() {
+            bool level_changed = false;
+            uint32_t now = millis();
+            uint32_t deadline = move::duration ? move::lasts_until() : (now + BUGSY_POWER_MAX_SLEEP);
+            uint32_t at;
+
+            // Scheduled movements keep the full clock, switching it when they are due would make them late
+            bool scheduled = move::schedule.next(&at);
+
+            if (scheduled) {
+                int32_t ahead = (int32_t)(at - micros());
+                uint32_t due = now + ((ahead > 0) ? ((uint32_t)ahead / 1000) : 0);
+
+                if ((int32_t)(due - deadline) < 0) {
+                    deadline = due;
+                }
+            }
+
+            uint32_t sleep = governor.plan(now, (move::duration != 0) || scheduled, deadline, &level_changed);
+
+            if (level_changed) {
+                apply_level();
+            }
+
+            if (sleep) {
+                uint32_t start = micros();
+                // Ends early once a remote sent something
+                rx::wait(sleep);
+
+                governor.record_sleep((micros() - start) / 1000);
+            }
+        }
+
+        void activity() {
+            if (governor.activity(millis())) {
+                apply_level();
+            }
+        }
+
+        void received(uint32_t stamp) {
+            // A newer movement replaces the one in the mailbox, and so does its stamp
+            received_stamp = stamp;
+            received_pending = true;
+
+            activity();
+        }
+
+        void applied(bool scheduled) {
+            // A scheduled movement superseding the received one is late by plan, not by the wake-up
+            if (received_pending && !scheduled) {
+                governor.record_latency(micros() - received_stamp);
+            }
+
+            received_pending = false;
+        }
+    }
+}
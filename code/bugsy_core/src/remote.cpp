@@ -6,6 +6,7 @@
 // Local headers
 # include "config.hpp"
 # include "io.hpp"
+# include "rx.hpp"
 
 using bugsy::Remote;
 
@@ -16,21 +17,37 @@ namespace bugsy_core {
 
             bool bt_active = false;
 
+            /// Held while the bluetooth serial is started or stopped, the loop only tries to take it and skips the
+            /// bluetooth if it is busy
+            static SemaphoreHandle_t bt_lock = nullptr;
+
             bool has_bt(Remote _remotes) {
                 return (bool)(((uint8_t)_remotes) & ((uint8_t)Remote::BLUETOOTH));
             }
 
             void start_bt() {
+                bt_serial.onData(rx::on_bt_data);
                 bt_serial.begin(BUGSY_DEVICE_NAME);
-                bt_serial.setTimeout(5);
 
                 bt_active = true;
             }
 
             void stop_bt() {
+                bt_active = false;
+
                 bt_serial.end();
+            }
 
-                bt_active = false;
+            void write_bt(const uint8_t* buffer, size_t len) {
+                if (!bt_lock || (xSemaphoreTake(bt_lock, 0) != pdTRUE)) {
+                    return;
+                }
+
+                if (bt_active) {
+                    bt_serial.write(buffer, len);
+                }
+
+                xSemaphoreGive(bt_lock);
             }
         // 
 
@@ -56,6 +73,13 @@ namespace bugsy_core {
         // 
 
         void configure(Remote mode) {
+            // First called by the setup, before any other task uses the remotes
+            if (!bt_lock) {
+                bt_lock = xSemaphoreCreateMutex();
+            }
+
+            xSemaphoreTake(bt_lock, portMAX_DELAY);
+
             // Calculate differences between currently active modes
                 // Find out where differences are between the current mode and the requested one
                 Remote action_req = (Remote)((uint8_t)mode ^ (uint8_t)remotes);
@@ -84,6 +108,8 @@ namespace bugsy_core {
             }
 
             remotes = mode;
+
+            xSemaphoreGive(bt_lock);
         }
 
         void stop_all() {
@@ -94,15 +120,16 @@ namespace bugsy_core {
         }
 
         void handle() {
-            if (has_bt()) {
-                if (bt_serial.available()) {
-                    io::parse_cmd(
-                        Remote::BLUETOOTH,
-                        io::parse_buffer,
-                        bt_serial.readBytes(io::parse_buffer, PARSE_BUFFER_SIZE)
-                    );
-                }
+            // Skipped while a job reconfigures the remotes
+            if (!bt_lock || (xSemaphoreTake(bt_lock, 0) != pdTRUE)) {
+                return;
+            }
+
+            if (has_bt() && bt_active) {
+                io::receive(Remote::BLUETOOTH);
             }
+
+            xSemaphoreGive(bt_lock);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+# include "rx.hpp"
+
+# include <bugsy/ota.hpp>
+
+// Local headers
+# include "io.hpp"
+# include "remote.hpp"
+
+using bugsy::Command;
+using bugsy::Remote;
+
+# if (RX_RING_SIZE & (RX_RING_SIZE - 1)) != 0
+    # error "The receive rings have to be a power of 2 in size!"
+# endif
+
+# if (256 % RX_BURSTS) != 0
+    # error "The amount of bursts has to divide 256, the burst positions are bytes!"
+# endif
+
+namespace bugsy_core {
+    namespace rx {
+        /// Receive ring of a remote, filled by the task of its driver and emptied by the loop. The positions only ever
+        /// grow and are taken modulo the size, they are handed over with `mux` taken
+        struct Ring {
+            uint8_t data [RX_RING_SIZE];
+
+            /// Positions of the next byte written and read
+            uint32_t head;
+            uint32_t tail;
+
+            /// Ends of the bursts not taken completely yet and the times they were received at in microseconds
+            struct {
+                uint32_t end;
+                uint32_t stamp;
+            } bursts [RX_BURSTS];
+            uint8_t burst_head;
+            uint8_t burst_tail;
+
+            /// Bytes dropped as the ring was full and bursts dropped as the loop was `RX_BURSTS` bursts behind, only
+            /// written by the driver
+            uint32_t overruns;
+            uint32_t dropped;
+            /// Overruns and dropped bursts already reported by the loop
+            uint32_t overruns_seen;
+            uint32_t dropped_seen;
+
+            portMUX_TYPE mux;
+        };
+
+        /// The rings of USB, trader, RPi and Bluetooth
+        static Ring rings [4];
+
+        /// Limits of the receive timeout of the UART in symbols
+        static const uint32_t GAP_MIN_SYMBOLS = 2;
+        static const uint32_t GAP_MAX_SYMBOLS = 92;
+
+        /// The task running `loop()`, notified by the callbacks
+        static TaskHandle_t loop_task = nullptr;
+
+        static Ring* ring_of(Remote src) {
+            switch (src) {
+                case Remote::USB: return &rings[0];
+                case Remote::TRADER: return &rings[1];
+                case Remote::RPI: return &rings[2];
+                case Remote::BLUETOOTH: return &rings[3];
+                default: return nullptr;
+            }
+        }
+
+        static HardwareSerial* serial_of(Remote src) {
+            switch (src) {
+                case Remote::USB: return io::usb_serial;
+                case Remote::TRADER: return io::trader_serial;
+                case Remote::RPI: return io::rpi_serial;
+                default: return nullptr;
+            }
+        }
+
+        // A burst is copied into the ring by any amount of `append()`s and handed over to the loop by `commit()`, both are
+        // called by the task of the driver only
+
+        /// Copies bytes of the burst being received behind `end`, the bytes are not visible to the loop yet
+        /// @return The new end of the burst
+        static uint32_t append(Ring& ring, uint32_t end, const uint8_t* data, size_t len) {
+            portENTER_CRITICAL(&ring.mux);
+            uint32_t free = RX_RING_SIZE - (end - ring.tail);
+            portEXIT_CRITICAL(&ring.mux);
+
+            if (len > free) {
+                ring.overruns += len - free;
+                len = free;
+            }
+
+            // The loop never reads past `head`, the bytes can be copied without the lock
+            for (size_t i = 0; i < len; i++) {
+                ring.data[(end + i) & (RX_RING_SIZE - 1)] = data[i];
+            }
+
+            return end + len;
+        }
+
+        /// Hands the burst ending at `end` over to the loop
+        static void commit(Ring& ring, uint32_t end) {
+            // Not set up yet
+            if (!loop_task || (end == ring.head)) {
+                return;
+            }
+
+            portENTER_CRITICAL(&ring.mux);
+
+            // Merged into the last burst, the commands would be taken as one frame and the next one cut off
+            if ((uint8_t)(ring.burst_head - ring.burst_tail) >= RX_BURSTS) {
+                ring.overruns += end - ring.head;
+                ring.dropped++;
+                portEXIT_CRITICAL(&ring.mux);
+                return;
+            }
+
+            ring.bursts[ring.burst_head % RX_BURSTS].end = end;
+            ring.bursts[ring.burst_head % RX_BURSTS].stamp = micros();
+            ring.burst_head++;
+            ring.head = end;
+            portEXIT_CRITICAL(&ring.mux);
+
+            xTaskNotifyGive(loop_task);
+        }
+
+        /// Moves all bytes the UART of `src` holds into its ring as one burst, called by the event task of the driver
+        static void drain(Remote src) {
+            HardwareSerial* serial = serial_of(src);
+            Ring& ring = *ring_of(src);
+            uint8_t buffer [64];
+            size_t len;
+
+            // Only the driver moves `head`
+            uint32_t end = ring.head;
+
+            while ((len = serial->available()) > 0) {
+                len = serial->read(buffer, (len < sizeof(buffer)) ? len : sizeof(buffer));
+                end = append(ring, end, buffer, len);
+            }
+
+            commit(ring, end);
+        }
+
+        static void on_usb_data() { drain(Remote::USB); }
+
+        static void on_trader_data() { drain(Remote::TRADER); }
+
+        static void on_rpi_data() { drain(Remote::RPI); }
+
+        void setup() {
+            for (Ring& ring : rings) {
+                ring.mux = portMUX_INITIALIZER_UNLOCKED;
+            }
+
+            loop_task = xTaskGetCurrentTaskHandle();
+
+            // Only called once the line paused, so a callback hands over whole frames
+            io::usb_serial->onReceive(on_usb_data, true);
+            io::trader_serial->onReceive(on_trader_data, true);
+            io::rpi_serial->onReceive(on_rpi_data, true);
+
+            set_gap(Remote::USB, UART_CORE_DEBUG_BAUD);
+            set_gap(Remote::TRADER, BUGSY_UART_CORE_TO_TRADER_BAUD);
+            set_gap(Remote::RPI, BUGSY_UART_CORE_TO_RPI_BAUD);
+        }
+
+        void on_bt_data(const uint8_t* data, size_t len) {
+            // Every packet is a burst, a client writes a command at once
+            Ring& ring = *ring_of(Remote::BLUETOOTH);
+            commit(ring, append(ring, ring.head, data, len));
+        }
+
+        void set_gap(Remote src, uint32_t baud) {
+            HardwareSerial* serial = serial_of(src);
+
+            if (!serial) {
+                return;
+            }
+
+            // The timeout of the UART is counted in symbols of 10 bits
+            uint32_t symbols = (uint32_t)(((uint64_t)RX_GAP_US * baud) / 10000000);
+            symbols = (symbols < GAP_MIN_SYMBOLS) ? GAP_MIN_SYMBOLS : ((symbols > GAP_MAX_SYMBOLS) ? GAP_MAX_SYMBOLS : symbols);
+
+            serial->setRxTimeout((uint8_t)symbols);
+        }
+
+        size_t take(Remote src, char* frame, size_t max, uint32_t* stamp) {
+            Ring* ring = ring_of(src);
+
+            if (!ring) {
+                return 0;
+            }
+
+            portENTER_CRITICAL(&ring->mux);
+            uint32_t head = ring->head;
+            bool burst = (ring->burst_head != ring->burst_tail);
+            uint32_t burst_end = ring->bursts[ring->burst_tail % RX_BURSTS].end;
+            uint32_t burst_stamp = ring->bursts[ring->burst_tail % RX_BURSTS].stamp;
+            uint32_t last_stamp = ring->bursts[(uint8_t)(ring->burst_head - 1) % RX_BURSTS].stamp;
+            portEXIT_CRITICAL(&ring->mux);
+
+            if ((ring->overruns != ring->overruns_seen) || (ring->dropped != ring->dropped_seen)) {
+                log_error("> [rx::take()] Receive ring overrun of remote ");
+                log_error((uint8_t)src);
+                log_error(": ");
+                log_error(ring->overruns - ring->overruns_seen);
+                log_error(" bytes, ");
+                log_error(ring->dropped - ring->dropped_seen);
+                log_errorln(" bursts dropped");
+
+                ring->overruns_seen = ring->overruns;
+                ring->dropped_seen = ring->dropped;
+            }
+
+            uint32_t avail = head - ring->tail;
+
+            if (!avail || !burst) {
+                return 0;
+            }
+
+            size_t len;
+            size_t copy;
+
+            if ((Command)ring->data[ring->tail & (RX_RING_SIZE - 1)] == Command::OtaChunk) {
+                // The chunks of a window are sent back to back and may be split up into bursts anywhere, a chunk that
+                // stays incomplete is taken anyway and dropped by its length
+                if ((avail < bugsy::ota::FRAME_SIZE) && ((micros() - last_stamp) < (RX_STALE_TIMEOUT * 1000))) {
+                    return 0;
+                }
+
+                len = (avail < bugsy::ota::FRAME_SIZE) ? avail : bugsy::ota::FRAME_SIZE;
+                copy = len;
+            } else {
+                // A burst too long for any command is taken as a whole and fails its size check, the rest of it would
+                // be parsed from a wrong offset
+                len = burst_end - ring->tail;
+                copy = (len < PARSE_BUFFER_SIZE) ? len : PARSE_BUFFER_SIZE;
+            }
+
+            copy = (copy < max) ? copy : max;
+
+            for (size_t i = 0; i < copy; i++) {
+                frame[i] = (char)ring->data[(ring->tail + i) & (RX_RING_SIZE - 1)];
+            }
+
+            *stamp = burst_stamp;
+
+            portENTER_CRITICAL(&ring->mux);
+            ring->tail += len;
+
+            // Bursts taken completely
+            while ((ring->burst_head != ring->burst_tail) && ((int32_t)(ring->bursts[ring->burst_tail % RX_BURSTS].end - ring->tail) <= 0)) {
+                ring->burst_tail++;
+            }
+
+            portEXIT_CRITICAL(&ring->mux);
+            return copy;
+        }
+
+        bool wait(uint32_t ms) {
+            return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms)) != 0;
+        }
+    }
+}
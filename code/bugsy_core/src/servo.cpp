@@ -0,0 +1,148 @@
+# include "servo.hpp"
+
+// External libraries
+# include <Wire.h>
+
+using bugsy::Servo;
+using bugsy::ServoMove;
+using bugsy::SERVO_COUNT;
+
+/// Register of the first output (LED0_ON_L), every output has 4 registers (ON_L, ON_H, OFF_L, OFF_H)
+# define PCA9685_LED0 0x06
+
+namespace bugsy_core {
+    namespace servo {
+        Adafruit_PWMServoDriver driver (SERVO_DRIVER_ADDR);
+
+        /// Driver board channel of every servo
+        static const uint8_t CHANNELS [SERVO_COUNT] = { SERVO_CHANNEL_HEAD };
+
+        /// A linear trajectory, only accessed by the servo task
+        struct Trajectory {
+            uint16_t from;
+            uint16_t to;
+            uint32_t start;
+            uint16_t duration;
+        };
+
+        static Trajectory trajectories [SERVO_COUNT];
+
+        /// Current angles, written by the servo task only
+        static volatile uint16_t angles [SERVO_COUNT];
+        /// Angles last written to the driver board, `UINT16_MAX` forces a write
+        static uint16_t written [SERVO_COUNT];
+
+        static QueueHandle_t queue = nullptr;
+
+        /// Converts an angle into the PWM off-tick of the driver board
+        static uint16_t angle_to_ticks(uint16_t angle) {
+            uint32_t pulse = SERVO_PULSE_MIN + (((uint32_t)(SERVO_PULSE_MAX - SERVO_PULSE_MIN) * angle) / bugsy::SERVO_ANGLE_MAX);
+            return (uint16_t)((pulse * 4096 * SERVO_FREQ) / 1000000);
+        }
+
+        /// Writes the channels `first` to `last` (inclusive) in a single transaction
+        static void write_burst(uint8_t first, uint8_t last, const uint16_t* ticks) {
+            Wire.beginTransmission(SERVO_DRIVER_ADDR);
+            Wire.write(PCA9685_LED0 + (4 * first));
+
+            for (uint8_t ch = first; ch <= last; ch++) {
+                // Every pulse starts at tick 0
+                Wire.write(0);
+                Wire.write(0);
+                Wire.write(ticks[ch] & 0xFF);
+                Wire.write(ticks[ch] >> 8);
+            }
+
+            Wire.endTransmission();
+        }
+
+        static void servo_task(void*) {
+            // Indexed by channel, so a range of channels can be written at once
+            static uint16_t ticks [16];
+            TickType_t wake = xTaskGetTickCount();
+
+            while (true) {
+                uint32_t now = millis();
+
+                // Apply all queued movements, starting from the current angle
+                ServoMove servo_move;
+                while (xQueueReceive(queue, &servo_move, 0) == pdTRUE) {
+                    Trajectory& traj = trajectories[(uint8_t)servo_move.servo];
+                    traj.from = angles[(uint8_t)servo_move.servo];
+                    traj.to = servo_move.angle;
+                    traj.start = now;
+                    traj.duration = servo_move.duration;
+                }
+
+                uint8_t first = 0xFF, last = 0;
+
+                for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+                    const Trajectory& traj = trajectories[i];
+                    uint32_t elapsed = now - traj.start;
+                    uint16_t angle = traj.to;
+
+                    if (elapsed < traj.duration) {
+                        angle = traj.from + (int16_t)(((int32_t)(traj.to - traj.from) * (int32_t)elapsed) / traj.duration);
+                    }
+
+                    angles[i] = angle;
+
+                    if (angle != written[i]) {
+                        written[i] = angle;
+                        ticks[CHANNELS[i]] = angle_to_ticks(angle);
+
+                        if (CHANNELS[i] < first) {
+                            first = CHANNELS[i];
+                        }
+
+                        if (CHANNELS[i] > last) {
+                            last = CHANNELS[i];
+                        }
+                    }
+                }
+
+                if (first <= last) {
+                    // Channels between changed ones are rewritten with their current ticks
+                    write_burst(first, last, ticks);
+                }
+
+                vTaskDelayUntil(&wake, pdMS_TO_TICKS(SERVO_UPDATE_INTERVAL));
+            }
+        }
+
+        void setup() {
+            Wire.begin();
+            Wire.setClock(SERVO_I2C_CLOCK);
+
+            // Also enables the register auto-increment required for the bursts
+            driver.begin();
+            driver.setPWMFreq(SERVO_FREQ);
+
+            // Center all servos
+            for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+                trajectories[i] = { bugsy::SERVO_ANGLE_MAX / 2, bugsy::SERVO_ANGLE_MAX / 2, 0, 0 };
+                angles[i] = bugsy::SERVO_ANGLE_MAX / 2;
+                written[i] = UINT16_MAX;
+            }
+
+            queue = xQueueCreate(SERVO_QUEUE_SIZE, sizeof(ServoMove));
+            xTaskCreatePinnedToCore(servo_task, "servo", 2048, nullptr, 1, nullptr, 0);
+        }
+
+        bool move(const ServoMove* servo_move) {
+            if (((uint8_t)servo_move->servo >= SERVO_COUNT) || (servo_move->angle > bugsy::SERVO_ANGLE_MAX) || !queue) {
+                return false;
+            }
+
+            return xQueueSend(queue, servo_move, 0) == pdTRUE;
+        }
+
+        uint16_t angle(Servo servo) {
+            if ((uint8_t)servo >= SERVO_COUNT) {
+                return 0;
+            }
+
+            return angles[(uint8_t)servo];
+        }
+    }
+}
@@ -0,0 +1,135 @@
+# include "speed.hpp"
+
+// External libraries
+# include <driver/pcnt.h>
+
+// Local headers
+# include "battery.hpp"
+# include "motors.hpp"
+
+namespace bugsy_core {
+    namespace speed {
+        /// Only accessed by the control task
+        static bugsy::speed::Controller controller;
+
+        /// Target speeds of the left (lower half) and right (upper half) chain, packed so they are written atomically
+        static volatile uint32_t targets = 0;
+
+        /// Copy of the controller statistics for the loop, guarded by `stats_mux`
+        static bugsy::SpeedStats stats_copy = { };
+        static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+        static TaskHandle_t task = nullptr;
+        static hw_timer_t* timer = nullptr;
+
+        /// Counter values of the last tick
+        static int16_t last_count [2] = { 0, 0 };
+
+        static void IRAM_ATTR on_tick() {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(task, &woken);
+
+            if (woken) {
+                portYIELD_FROM_ISR();
+            }
+        }
+
+        /// Configures a PCNT unit to count all four edges of a quadrature encoder
+        static void setup_counter(pcnt_unit_t unit, int pin_a, int pin_b) {
+            pcnt_config_t config = { };
+            config.unit = unit;
+            config.counter_h_lim = SPEED_PCNT_LIMIT;
+            config.counter_l_lim = -SPEED_PCNT_LIMIT;
+
+            // Channel 0 counts the edges of A, the level of B gives the direction
+            config.channel = PCNT_CHANNEL_0;
+            config.pulse_gpio_num = pin_a;
+            config.ctrl_gpio_num = pin_b;
+            config.pos_mode = PCNT_COUNT_DEC;
+            config.neg_mode = PCNT_COUNT_INC;
+            config.lctrl_mode = PCNT_MODE_REVERSE;
+            config.hctrl_mode = PCNT_MODE_KEEP;
+            pcnt_unit_config(&config);
+
+            // Channel 1 counts the edges of B, the level of A gives the direction
+            config.channel = PCNT_CHANNEL_1;
+            config.pulse_gpio_num = pin_b;
+            config.ctrl_gpio_num = pin_a;
+            config.pos_mode = PCNT_COUNT_INC;
+            config.neg_mode = PCNT_COUNT_DEC;
+            pcnt_unit_config(&config);
+
+            pcnt_set_filter_value(unit, SPEED_PCNT_FILTER);
+            pcnt_filter_enable(unit);
+
+            pcnt_counter_pause(unit);
+            pcnt_counter_clear(unit);
+            pcnt_counter_resume(unit);
+        }
+
+        /// Edges counted since the last tick
+        static int32_t read_edges(pcnt_unit_t unit) {
+            int16_t count = 0;
+            pcnt_get_counter_value(unit, &count);
+
+            int32_t delta = (int32_t)count - last_count[unit];
+            last_count[unit] = count;
+
+            // The counter restarts at `0` once it reaches a limit
+            if (delta > (SPEED_PCNT_LIMIT / 2)) {
+                delta -= SPEED_PCNT_LIMIT;
+            } else if (delta < -(SPEED_PCNT_LIMIT / 2)) {
+                delta += SPEED_PCNT_LIMIT;
+            }
+
+            return delta;
+        }
+
+        static void control_task(void*) {
+            while (true) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+                uint32_t stamp = micros();
+                uint32_t packed = targets;
+                controller.set_targets((int16_t)(packed & 0xFFFF), (int16_t)(packed >> 16));
+
+                int16_t left, right;
+                controller.step(stamp, read_edges(PCNT_UNIT_0), read_edges(PCNT_UNIT_1),
+                    configuration.drive, configuration.speed_gains, battery::state.duty_limit, &left, &right);
+
+                // Ignored while the motors are driven open-loop
+                move::write_pins(left, right, true);
+
+                portENTER_CRITICAL(&stats_mux);
+                stats_copy = controller.stats;
+                portEXIT_CRITICAL(&stats_mux);
+            }
+        }
+
+        void setup() {
+            setup_counter(PCNT_UNIT_0, PIN_CHAIN_LEFT_ENC_A, PIN_CHAIN_LEFT_ENC_B);
+            setup_counter(PCNT_UNIT_1, PIN_CHAIN_RIGHT_ENC_A, PIN_CHAIN_RIGHT_ENC_B);
+
+            // Same CPU as the loop, which is preempted for the (short) tick. Only the emergency stop ranks higher
+            xTaskCreatePinnedToCore(control_task, "speed", 2048, nullptr, configMAX_PRIORITIES - 2, &task, 1);
+
+            // 1 MHz timer clock, the alarm reloads every tick
+            timer = timerBegin(SPEED_TIMER, 80, true);
+            timerAttachInterrupt(timer, on_tick, true);
+            timerAlarmWrite(timer, bugsy::speed::TICK_PERIOD, true);
+            timerAlarmEnable(timer);
+        }
+
+        void set_targets(int16_t left, int16_t right) {
+            targets = (uint32_t)(uint16_t)left | ((uint32_t)(uint16_t)right << 16);
+        }
+
+        bugsy::SpeedStats stats() {
+            portENTER_CRITICAL(&stats_mux);
+            bugsy::SpeedStats copy = stats_copy;
+            portEXIT_CRITICAL(&stats_mux);
+
+            return copy;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+# include "uart.hpp"
+
+// Local headers
+# include "io.hpp"
+# include "rx.hpp"
+
+using bugsy::Remote;
+
+namespace bugsy_core {
+    namespace uart {
+        /// A negotiated link and the UART it runs on
+        struct Link {
+            Remote remote;
+            HardwareSerial** serial;
+            bugsy::baud::Port port;
+
+            /// The rate the UART currently runs at
+            uint32_t applied;
+
+            /// Errors reported by the UART driver, written by its event task
+            volatile uint32_t driver_errors;
+            /// Driver errors already counted by the port
+            uint32_t driver_seen;
+        };
+
+        static Link links [] = {
+            { Remote::TRADER, &io::trader_serial, bugsy::baud::Port(BUGSY_UART_CORE_TO_TRADER_BAUD, BUGSY_UART_CORE_TO_TRADER_MAX_BAUD),
+                BUGSY_UART_CORE_TO_TRADER_BAUD, 0, 0 },
+            { Remote::RPI, &io::rpi_serial, bugsy::baud::Port(BUGSY_UART_CORE_TO_RPI_BAUD, BUGSY_UART_CORE_TO_RPI_MAX_BAUD),
+                BUGSY_UART_CORE_TO_RPI_BAUD, 0, 0 }
+        };
+
+        static Link* link_of(Remote src) {
+            for (Link& link : links) {
+                if (link.remote == src) {
+                    return &link;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /// Only errors caused by a bad rate or bad wiring count, full buffers are a matter of the loop
+        static bool is_line_error(hardwareSerial_error_t error) {
+            return (error == UART_FRAME_ERROR) || (error == UART_PARITY_ERROR) || (error == UART_BREAK_ERROR);
+        }
+
+        static void on_trader_error(hardwareSerial_error_t error) {
+            if (is_line_error(error)) {
+                links[0].driver_errors++;
+            }
+        }
+
+        static void on_rpi_error(hardwareSerial_error_t error) {
+            if (is_line_error(error)) {
+                links[1].driver_errors++;
+            }
+        }
+
+        void setup() {
+            io::trader_serial->begin(BUGSY_UART_CORE_TO_TRADER_BAUD, SERIAL_8N1, PIN_UART_TRADER_RX, PIN_UART_TRADER_TX);
+            io::trader_serial->onReceiveError(on_trader_error);
+
+            // Has to be set before the UART is started
+            io::rpi_serial->setRxBufferSize(UART_RPI_RX_BUFFER_SIZE);
+            io::rpi_serial->begin(BUGSY_UART_CORE_TO_RPI_BAUD);
+            io::rpi_serial->onReceiveError(on_rpi_error);
+        }
+
+        void apply(Remote src) {
+            Link* link = link_of(src);
+
+            if (!link || (link->applied == link->port.rate())) {
+                return;
+            }
+
+            // The answer that led to the switch still has to go out at the old rate
+            (*link->serial)->flush();
+            (*link->serial)->updateBaudRate(link->port.rate());
+            link->applied = link->port.rate();
+            rx::set_gap(src, link->applied);
+
+            log_info("> [uart] Link to remote ");
+            log_info((uint8_t)src);
+            log_info(" now at ");
+            log_info(link->applied);
+            log_infoln(" baud");
+        }
+
+        void update() {
+            for (Link& link : links) {
+                uint32_t driver_errors = link.driver_errors;
+
+                while (link.driver_seen != driver_errors) {
+                    link.driver_seen++;
+                    link.port.error(millis());
+                }
+
+                link.port.update(millis());
+                apply(link.remote);
+            }
+        }
+
+        bool propose(Remote src, uint32_t baud) {
+            Link* link = link_of(src);
+            return link && link->port.propose(baud, millis());
+        }
+
+        bool test(Remote src, const uint8_t* frame, size_t len, uint8_t* answer) {
+            Link* link = link_of(src);
+            return link && link->port.test(frame, len, answer);
+        }
+
+        bool confirm(Remote src) {
+            Link* link = link_of(src);
+            return link && link->port.confirm();
+        }
+
+        void error(Remote src) {
+            Link* link = link_of(src);
+
+            if (link && link->port.error(millis())) {
+                log_errorln("> [uart] Error burst, link falls back to its base rate!");
+                apply(src);
+            }
+        }
+
+        void fallback(Remote src) {
+            Link* link = link_of(src);
+
+            if (link && link->port.fallback()) {
+                apply(src);
+            }
+        }
+
+        bugsy::BaudStats stats(Remote src) {
+            Link* link = link_of(src);
+            return link ? link->port.stats : bugsy::BaudStats { };
+        }
+    }
+}
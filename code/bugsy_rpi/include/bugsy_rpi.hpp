@@ -0,0 +1,68 @@
+// #####################
+// #    BUGSY - RPI    #
+// #####################
+//
+// Software for the Raspberry Pi Zero of the Bugsy robot, handling everything that is too expensive for the MCUs
+
+# pragma once
+
+# include <inttypes.h>
+# include <iostream>
+
+# include <bugsy/core.hpp>
+# include <bugsy/defines.hpp>
+# include <bugsy/trader.hpp>
+
+/* LOGGING */
+    // Same logging interface as the one of `sylo/logging.hpp` used on the MCUs
+    # define log_error(msg) (std::cerr << msg)
+    # define log_errorln(msg) (std::cerr << msg << std::endl)
+    # define log_info(msg) (std::cout << msg)
+    # define log_infoln(msg) (std::cout << msg << std::endl)
+    # define log_debug(msg) (std::cout << msg)
+    # define log_debugln(msg) (std::cout << msg << std::endl)
+    # define log_trace(msg) (std::cout << msg)
+    # define log_traceln(msg) (std::cout << msg << std::endl)
+//
+
+/* DEVICES */
+/// Serial device connected to the core MCU
+# define BUGSY_RPI_CORE_DEVICE "/dev/serial0"
+/// Time in milliseconds to wait for a response of the core
+# define BUGSY_RPI_CORE_TIMEOUT 20
+
+/* TELEMETRY */
+/// Name of the shared memory object the telemetry is published to (`/dev/shm/bugsy_telemetry`)
+# define BUGSY_RPI_TELEMETRY_SHM "/bugsy_telemetry"
+/// Amount of frames stored in the telemetry ring, has to be a power of two
+# define BUGSY_RPI_TELEMETRY_SLOTS 256
+/// Time interval in milliseconds between two telemetry polls of the core
+# define BUGSY_RPI_TELEMETRY_INTERVAL 50
+/// Attempts of a reader to copy a telemetry slot until it gives up, a publish takes less than a microsecond
+# define BUGSY_RPI_TELEMETRY_READ_RETRIES 1000
+
+/* MAPPING */
+/// Edge length of a cell of the occupancy grid in mm
+# define BUGSY_RPI_MAP_CELL_SIZE 50
+/// Edge length of a tile of the occupancy grid in cells as a power of 2 (16 x 16 cells, 256 bytes)
+# define BUGSY_RPI_MAP_TILE_BITS 4
+
+/* PLANNING */
+/// Distance in mm the planned paths keep from occupied cells, half the width of the robot plus some margin
+# define BUGSY_RPI_PLAN_ROBOT_RADIUS 120
+/// Length of the steps a trajectory is streamed to the core in (µs), shorter than the failsafe window of a movement
+# define BUGSY_RPI_PLAN_STREAM_INTERVAL 100000
+/// Steps of a trajectory scheduled on the core ahead of time, at most half of `BUGSY_SCHEDULE_SIZE`, so a new
+/// trajectory can override all of them
+# define BUGSY_RPI_PLAN_STREAM_AHEAD 3
+/// Time a streamed step needs at least to reach the core (µs)
+# define BUGSY_RPI_PLAN_STREAM_LEAD 20000
+
+/// Everything concerning the RPi of the bugsy robot
+namespace bugsy_rpi {
+    /// Microseconds since an arbitrary, monotonic starting point
+    uint64_t micros();
+
+    /// Milliseconds since an arbitrary, monotonic starting point
+    uint64_t millis();
+}
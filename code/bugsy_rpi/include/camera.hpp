@@ -0,0 +1,302 @@
+// ##########################
+// #    BUGSY-RPI CAMERA    #
+// ##########################
+//
+// Frame pipeline: A `Source` captures frames into pooled buffers, the `Stage`s (downscaling, JPEG encoding) run on a
+// thread pool and the results are handed to `Sink`s (network senders). Frames are only ever passed on as `FrameRef`
+// handles, image data is written once per stage and never copied in between.
+
+# pragma once
+
+# include <atomic>
+# include <inttypes.h>
+# include <mutex>
+# include <stdio.h>
+# include <string>
+# include <thread>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+# include "frame.hpp"
+# include "thread_pool.hpp"
+
+/* CAMERA */
+/// Default capture width in pixels
+# define BUGSY_RPI_CAMERA_WIDTH 640
+/// Default capture height in pixels
+# define BUGSY_RPI_CAMERA_HEIGHT 480
+/// Default capture rate in frames per second
+# define BUGSY_RPI_CAMERA_FPS 30
+/// Amount of buffers per pool, limits the amount of frames in flight
+# define BUGSY_RPI_CAMERA_BUFFERS 8
+/// Default JPEG quality (0-100)
+# define BUGSY_RPI_CAMERA_JPEG_QUALITY 75
+/// Default TCP port the JPEG stream is served on
+# define BUGSY_RPI_CAMERA_PORT 5600
+
+namespace bugsy_rpi {
+    namespace camera {
+        /// Frame rate and latency statistics of a pipeline stage, safe to update from multiple threads
+        class Metrics {
+        public:
+            /// Statistics since the previous `report()`
+            struct Report {
+                double fps;
+                double latency_avg_ms;
+                double latency_max_ms;
+                uint64_t frames;
+                uint64_t dropped;
+            };
+
+            Metrics() : last_stamp(micros()) { }
+
+            /// @brief Records a processed frame that took `latency` microseconds
+            void record(uint64_t latency);
+
+            /// @brief Records a frame that had to be dropped
+            void drop();
+
+            /// @brief Returns the statistics since the last call and starts a new period, only call from one thread
+            Report report();
+
+        private:
+            std::atomic<uint64_t> frames { 0 };
+            std::atomic<uint64_t> dropped { 0 };
+            std::atomic<uint64_t> latency_sum { 0 };
+            std::atomic<uint64_t> latency_max { 0 };
+
+            uint64_t last_frames = 0;
+            uint64_t last_dropped = 0;
+            uint64_t last_latency_sum = 0;
+            uint64_t last_stamp;
+        };
+
+        // Sources
+            /// Interface of all frame sources
+            class Source {
+            public:
+                virtual ~Source() = default;
+
+                virtual const char* name() const = 0;
+
+                /// @brief Starts capturing
+                virtual bool start() = 0;
+
+                /// @brief Stops capturing, frames still referenced stay valid
+                virtual void stop() = 0;
+
+                /// @brief Blocks until the next frame has been captured
+                /// @return An empty handle if the capture failed or no buffer was free
+                virtual FrameRef capture() = 0;
+            };
+
+            /// Video4Linux2 camera, frames are the driver's mmap buffers themselves and are requeued once released
+            class V4L2Source : public Source {
+            public:
+                V4L2Source(const char* device, uint32_t width, uint32_t height, uint32_t buffers = BUGSY_RPI_CAMERA_BUFFERS);
+                ~V4L2Source();
+
+                const char* name() const override { return "v4l2"; }
+                bool start() override;
+                void stop() override;
+                FrameRef capture() override;
+
+            private:
+                void requeue(uint32_t id);
+
+                std::string device;
+                uint32_t width;
+                uint32_t height;
+                uint32_t stride = 0;
+                uint32_t buffer_count;
+
+                int fd = -1;
+                std::vector<uint8_t*> mappings;
+                std::vector<size_t> mapping_sizes;
+                std::unique_ptr<FramePool> pool;
+                uint32_t sequence = 0;
+            };
+
+            /// Generates a moving YUYV test pattern at a fixed rate, for testing without camera
+            class SyntheticSource : public Source {
+            public:
+                SyntheticSource(uint32_t width, uint32_t height, uint32_t fps = BUGSY_RPI_CAMERA_FPS);
+
+                const char* name() const override { return "synthetic"; }
+                bool start() override;
+                void stop() override { }
+                FrameRef capture() override;
+
+            protected:
+                /// Blocks until the next frame is due
+                void pace();
+
+                uint32_t width;
+                uint32_t height;
+                uint32_t interval;
+
+                FramePool pool;
+                uint32_t sequence = 0;
+                uint64_t next_stamp = 0;
+            };
+
+            /// Plays back a file of raw, concatenated YUYV frames in a loop at a fixed rate
+            class FileSource : public SyntheticSource {
+            public:
+                FileSource(const char* path, uint32_t width, uint32_t height, uint32_t fps = BUGSY_RPI_CAMERA_FPS);
+                ~FileSource();
+
+                const char* name() const override { return "file"; }
+                bool start() override;
+                void stop() override;
+                FrameRef capture() override;
+
+            private:
+                std::string path;
+                FILE* file = nullptr;
+            };
+        //
+
+        // Stages
+            /// A processing step of the pipeline, called from multiple worker threads at once
+            class Stage {
+            public:
+                explicit Stage(const char* name) : stage_name(name) { }
+                virtual ~Stage() = default;
+
+                const char* name() const { return this->stage_name; }
+
+                /// @brief Processes the input `frame`
+                /// @return The resulting frame, an empty handle drops the frame
+                virtual FrameRef process(const FrameRef& frame) = 0;
+
+                Metrics metrics;
+
+            private:
+                const char* stage_name;
+            };
+
+            /// Shrinks YUYV frames by an integer `factor` using a box filter
+            class Downscale : public Stage {
+            public:
+                Downscale(uint32_t factor, uint32_t max_width, uint32_t max_height, size_t buffers = BUGSY_RPI_CAMERA_BUFFERS);
+
+                FrameRef process(const FrameRef& frame) override;
+
+            private:
+                uint32_t factor;
+                FramePool pool;
+            };
+
+            /// Compresses YUYV frames to JPEG using libjpeg
+            class JpegEncoder : public Stage {
+            public:
+                JpegEncoder(int quality, uint32_t max_width, uint32_t max_height, size_t buffers = BUGSY_RPI_CAMERA_BUFFERS);
+
+                FrameRef process(const FrameRef& frame) override;
+
+            private:
+                int quality;
+                FramePool pool;
+            };
+        //
+
+        // Sinks
+            /// Receiver of the final frames of a pipeline
+            class Sink {
+            public:
+                virtual ~Sink() = default;
+
+                /// @brief Hands a frame to the sink, called from the pipeline workers one frame at a time
+                virtual void send(const FrameRef& frame) = 0;
+            };
+
+            /// Header sent in front of every frame by the `TcpSink`, all fields little endian
+            struct __attribute__((packed)) StreamHeader {
+                /// Always `STREAM_MAGIC`
+                uint32_t magic;
+                /// Size of the frame data following the header
+                uint32_t size;
+                uint32_t sequence;
+                uint16_t width;
+                uint16_t height;
+                /// `PixelFormat` of the data
+                uint8_t format;
+                /// Capture timestamp of the frame in microseconds
+                uint64_t stamp;
+            };
+
+            /// Magic value of the `StreamHeader` ("BGCM")
+            static constexpr uint32_t STREAM_MAGIC = 0x4D434742;
+
+            /// Streams frames to a single TCP client, written straight from the frame buffer
+            ///
+            /// Frames are dropped instead of queued while the client cannot keep up, so the stream never lags behind
+            class TcpSink : public Sink {
+            public:
+                explicit TcpSink(uint16_t port = BUGSY_RPI_CAMERA_PORT);
+                ~TcpSink();
+
+                /// @brief Starts listening for a client
+                bool start();
+                void stop();
+
+                void send(const FrameRef& frame) override;
+
+                Metrics metrics;
+
+            private:
+                void accept_client();
+
+                uint16_t port;
+                int server_fd = -1;
+                int client_fd = -1;
+            };
+        //
+
+        /// Connects a source, the stages and the sinks
+        class Pipeline {
+        public:
+            Pipeline(Source* source, ThreadPool* workers);
+            ~Pipeline();
+
+            /// @brief Appends a stage, stages are executed in the order they have been added
+            void add_stage(Stage* stage);
+
+            void add_sink(Sink* sink);
+
+            /// @brief Starts the source and the capture thread
+            bool start();
+
+            /// @brief Stops capturing and waits for all frames in flight
+            void stop();
+
+            /// @brief Logs the statistics of all stages since the last call
+            void log_metrics();
+
+            /// Frames taken from the source, latency is the time `capture()` blocked
+            Metrics capture_metrics;
+            /// Frames handed to the sinks, latency is the total time since the capture
+            Metrics delivery_metrics;
+
+        private:
+            void capture_loop();
+            void process(FrameRef frame);
+
+            Source* source;
+            ThreadPool* workers;
+            std::vector<Stage*> stages;
+            std::vector<Sink*> sinks;
+
+            std::thread capture_thread;
+            std::atomic<bool> running { false };
+            std::atomic<uint32_t> in_flight { 0 };
+
+            /// Serializes the sinks, workers may finish frames in parallel
+            std::mutex delivery_mutex;
+            /// Sequence of the newest delivered frame, older frames finishing later are dropped
+            uint32_t delivered_sequence = 0;
+            bool delivered_any = false;
+        };
+    }
+}
@@ -0,0 +1,133 @@
+// ##########################
+// #    BUGSY-RPI FRAMES    #
+// ##########################
+//
+// Preallocated, reference counted image buffers shared between the stages of the camera pipeline
+
+# pragma once
+
+# include <atomic>
+# include <functional>
+# include <inttypes.h>
+# include <memory>
+# include <vector>
+
+namespace bugsy_rpi {
+    namespace camera {
+        /// Pixel formats supported by the pipeline
+        enum class PixelFormat : uint8_t {
+            /// Packed YUV 4:2:2, two bytes per pixel (`Y0 U Y1 V`), the default output of most USB and CSI cameras
+            YUYV = 0x01,
+            /// JPEG compressed image, `FrameInfo::size` is the size of the compressed data
+            JPEG = 0x10
+        };
+
+        /// Metadata of a frame
+        struct FrameInfo {
+            uint32_t width;
+            uint32_t height;
+            /// Bytes per row, `0` for compressed formats
+            uint32_t stride;
+            PixelFormat format;
+
+            /// Sequence number assigned by the source, kept by all stages
+            uint32_t sequence;
+            /// Capture timestamp in microseconds (see `bugsy_rpi::micros()`), kept by all stages
+            uint64_t stamp;
+
+            /// Amount of bytes used in the buffer
+            size_t size;
+        };
+
+        class FramePool;
+
+        /// A buffer of a `FramePool`, only accessed through `FrameRef` handles
+        struct FrameBuffer {
+            FrameInfo info;
+
+            uint8_t* data;
+            size_t capacity;
+
+            /// Amount of `FrameRef`s pointing to this buffer, `0` means the buffer is free
+            std::atomic<uint32_t> refs;
+            FramePool* pool;
+            uint32_t id;
+        };
+
+        /// Reference counted handle to a `FrameBuffer`, the buffer returns to its pool once the last handle is dropped
+        ///
+        /// Copying a handle never copies the image data, so frames can be handed to multiple stages and senders
+        class FrameRef {
+        public:
+            FrameRef() = default;
+            /// Takes over one reference that has already been counted for the `buffer`
+            explicit FrameRef(FrameBuffer* buffer) : buffer(buffer) { }
+
+            FrameRef(const FrameRef& other);
+            FrameRef(FrameRef&& other) noexcept;
+            FrameRef& operator=(const FrameRef& other);
+            FrameRef& operator=(FrameRef&& other) noexcept;
+            ~FrameRef();
+
+            /// Drops the reference, releasing the buffer if it was the last one
+            void reset();
+
+            FrameBuffer* get() const { return this->buffer; }
+            FrameBuffer* operator->() const { return this->buffer; }
+            explicit operator bool() const { return this->buffer != nullptr; }
+
+        private:
+            FrameBuffer* buffer = nullptr;
+        };
+
+        /// A fixed set of buffers allocated once, acquiring and releasing buffers is lock free
+        ///
+        /// The pool has to outlive all `FrameRef`s pointing to its buffers
+        class FramePool {
+        public:
+            /// Called with the buffer id once the last reference of a buffer has been dropped
+            typedef std::function<void(uint32_t)> ReleaseHandler;
+
+            /// @brief Allocates `count` buffers of `capacity` bytes each in one block
+            FramePool(size_t count, size_t capacity);
+
+            /// @brief Uses externally managed memory (e.g. V4L2 mmap buffers), one buffer per `storage` entry
+            /// @param on_release Handler called once a buffer is released, e.g. to hand it back to the driver
+            FramePool(const std::vector<uint8_t*>& storage, size_t capacity, ReleaseHandler on_release);
+
+            FramePool(const FramePool&) = delete;
+            FramePool& operator=(const FramePool&) = delete;
+
+            /// @brief Takes a free buffer from the pool
+            /// @return An empty handle if all buffers are in use
+            FrameRef acquire();
+
+            /// @brief Marks the externally filled buffer `id` as in use and returns a handle to it
+            FrameRef adopt(uint32_t id);
+
+            size_t count() const { return this->buffer_count; }
+
+            size_t capacity() const { return this->buffer_capacity; }
+
+            /// @brief Amount of `acquire()` calls that failed because all buffers were in use
+            uint64_t exhausted() const { return this->exhausted_count.load(std::memory_order_relaxed); }
+
+            /// @brief Hands the buffer back to the pool, called by the last `FrameRef`
+            void release(FrameBuffer* buffer);
+
+        private:
+            void init(size_t count, size_t capacity);
+
+            std::unique_ptr<uint8_t[]> memory;
+            std::unique_ptr<FrameBuffer[]> buffers;
+            size_t buffer_count = 0;
+            size_t buffer_capacity = 0;
+
+            /// Rotating start index for searching free buffers
+            std::atomic<uint32_t> next { 0 };
+            std::atomic<uint64_t> exhausted_count { 0 };
+
+            ReleaseHandler on_release;
+        };
+    }
+}
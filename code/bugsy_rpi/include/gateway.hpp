@@ -0,0 +1,252 @@
+// ###########################
+// #    BUGSY-RPI GATEWAY    #
+// ###########################
+//
+// Connects a base station to a whole fleet of robots
+//
+// Every robot is reached through a `Link` (serial, pty, TCP or an in-process simulated core) and addressed by the
+// `RobotId` it has been added with. A single event loop (epoll) serves all links: Requests are queued per robot and
+// sent one at a time, as the core frames commands only by the pause after them and answers without any framing. The
+// gateway polls the state and battery of every robot in the background and keeps the latest values as fleet telemetry.
+//
+// Clients either call `Gateway::submit()` in-process (from any thread) or connect over TCP and exchange
+// `ClientRequest` / `ClientResponse` frames.
+
+# pragma once
+
+# include <atomic>
+# include <deque>
+# include <functional>
+# include <inttypes.h>
+# include <map>
+# include <memory>
+# include <mutex>
+# include <queue>
+# include <string>
+# include <vector>
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_rpi.hpp"
+
+/* GATEWAY */
+/// Default TCP port clients connect to
+# define BUGSY_GATEWAY_PORT 5700
+/// Time in milliseconds a robot has to answer a request
+# define BUGSY_GATEWAY_TIMEOUT 50
+/// Time in milliseconds between a request without an answer and the next one, the core frames commands by this pause
+# define BUGSY_GATEWAY_FRAME_GAP 6
+/// Time in milliseconds between two telemetry polls of every robot
+# define BUGSY_GATEWAY_POLL_INTERVAL 100
+/// Maximum amount of requests queued per robot
+# define BUGSY_GATEWAY_QUEUE_SIZE 64
+/// Maximum amount of bytes buffered for a TCP client before it is dropped
+# define BUGSY_GATEWAY_CLIENT_BUFFER (1 << 20)
+
+namespace bugsy_rpi {
+    namespace gateway {
+        /// Address of a robot in the fleet, assigned in the order the robots have been added
+        typedef uint16_t RobotId;
+
+        /// `RobotId` of client requests asking for the telemetry of the whole fleet
+        static constexpr RobotId FLEET = 0xFFFF;
+
+        /// Result of a request
+        enum class Status : uint8_t {
+            OK = 0x00,
+            /// The robot did not answer in time
+            TIMEOUT = 0x01,
+            /// No robot with the given ID
+            UNKNOWN_ROBOT = 0x02,
+            /// Too many requests are queued for the robot
+            QUEUE_FULL = 0x03,
+            /// The link to the robot is broken
+            DISCONNECTED = 0x04
+        };
+
+        /// Latest known values of a robot
+        struct __attribute__((packed)) RobotTelemetry {
+            /// Time of the last successful poll in microseconds (`micros()`), `0` if never polled
+            uint64_t stamp;
+            bugsy::CoreState state;
+            bugsy::BatteryState battery;
+            /// Requests completed and timed out
+            uint32_t requests;
+            uint32_t timeouts;
+            /// Whether the link is still open
+            uint8_t connected;
+        };
+
+        /// Header of a request sent by a TCP client, followed by `len` command bytes
+        struct __attribute__((packed)) ClientRequest {
+            RobotId robot;
+            /// Amount of bytes the robot answers with, `0` for commands without an answer
+            uint16_t expected;
+            uint16_t len;
+        };
+
+        /// Header of a response sent to a TCP client, followed by `len` bytes
+        ///
+        /// Responses to `FLEET` requests carry one `RobotTelemetry` per robot
+        struct __attribute__((packed)) ClientResponse {
+            RobotId robot;
+            Status status;
+            uint8_t reserved;
+            uint16_t len;
+        };
+
+        /// Called on the event loop thread once a request completed, `data` is only valid during the call
+        typedef std::function<void(Status status, const uint8_t* data, size_t len)> Callback;
+
+        /// A connection to a single robot, owns the file descriptor
+        class Link {
+        public:
+            Link(int fd, std::string name) : fd(fd), name(std::move(name)) { }
+            ~Link();
+
+            Link(const Link&) = delete;
+            Link& operator=(const Link&) = delete;
+
+            const int fd;
+            const std::string name;
+        };
+
+        /// @brief Opens a serial device (or pty) connected to a core
+        std::unique_ptr<Link> open_serial(const char* device, uint32_t baud);
+
+        /// @brief Connects to a core exposed over TCP (e.g. a WiFi remote or a serial bridge)
+        std::unique_ptr<Link> open_tcp(const char* host, uint16_t port);
+
+        /// @brief Parses a link specification (`serial:<device>[:<baud>]`, `tcp:<host>:<port>`, `pty:<path>`)
+        std::unique_ptr<Link> open_link(const std::string& spec);
+
+        /// Statistics of the event loop
+        struct Stats {
+            uint64_t completed;
+            uint64_t timeouts;
+            uint64_t wakeups;
+            /// CPU time of the event loop thread in microseconds, updated once per wake-up
+            uint64_t cpu_time;
+        };
+
+        class Gateway {
+        public:
+            Gateway();
+            ~Gateway();
+
+            Gateway(const Gateway&) = delete;
+            Gateway& operator=(const Gateway&) = delete;
+
+            /// @brief Adds a robot, has to be called before `run()`
+            RobotId add(std::unique_ptr<Link> link);
+
+            /// @brief Accepts TCP clients on the given port, has to be called before `run()`
+            bool listen(uint16_t port);
+
+            /// @brief Queues a request for a robot, can be called from any thread
+            /// @param expected Amount of bytes the robot answers with, `0` for commands without an answer
+            void submit(RobotId robot, const uint8_t* cmd, size_t len, size_t expected, Callback callback);
+
+            /// @brief Runs the event loop until `stop()` is called
+            void run();
+
+            /// @brief Stops the event loop, can be called from any thread
+            void stop();
+
+            size_t robots() const { return this->fleet.size(); }
+
+            /// @brief Copies the telemetry of all robots, can be called from any thread
+            std::vector<RobotTelemetry> telemetry() const;
+
+            /// @brief Copies the statistics of the event loop, can be called from any thread
+            Stats stats() const;
+
+        private:
+            struct Request {
+                std::vector<uint8_t> cmd;
+                size_t expected;
+                Callback callback;
+            };
+
+            struct Robot {
+                std::unique_ptr<Link> link;
+                std::deque<Request> queue;
+
+                /// The request currently waiting for its answer
+                bool busy = false;
+                Request current;
+                std::vector<uint8_t> rx;
+                /// Increased with every request sent, identifies stale timeouts
+                uint64_t serial = 0;
+
+                /// The next request must not be sent before this time (milliseconds)
+                uint64_t ready_at = 0;
+                /// Whether a `Deadline::READY` is already queued for `ready_at`
+                bool ready_pending = false;
+
+                RobotTelemetry telemetry = { };
+            };
+
+            struct Client {
+                /// Unique for every accepted client, file descriptors are reused
+                uint64_t id;
+                std::vector<uint8_t> rx;
+                std::vector<uint8_t> tx;
+                /// Whether the socket is registered for `EPOLLOUT`
+                bool waiting_out = false;
+            };
+
+            /// Work due at a certain time, the heap holds the earliest deadline on top
+            struct Deadline {
+                enum Kind : uint8_t {
+                    /// The request with `serial` times out
+                    TIMEOUT,
+                    /// The robot may send its next request
+                    READY,
+                    /// The telemetry of the robot has to be polled
+                    POLL
+                };
+
+                uint64_t at;
+                Kind kind;
+                RobotId robot;
+                uint64_t serial;
+
+                bool operator>(const Deadline& other) const { return this->at > other.at; }
+            };
+
+            void enqueue(RobotId robot, Request request);
+            void send_next(RobotId robot);
+            void complete(RobotId robot, Status status);
+            void handle_robot(RobotId robot);
+            void disconnect(RobotId robot);
+            void handle_inbox();
+            void handle_timers();
+            void poll_telemetry(RobotId robot);
+
+            void accept_clients();
+            void handle_client(int fd, uint32_t events);
+            void flush_client(int fd, Client& client);
+            void close_client(int fd);
+            void send_client(int fd, uint64_t id, RobotId robot, Status status, const uint8_t* data, size_t len);
+
+            int epoll_fd = -1;
+            int wake_fd = -1;
+            int listen_fd = -1;
+            std::atomic<bool> running { false };
+
+            std::vector<Robot> fleet;
+            std::map<int, Client> clients;
+            uint64_t next_client_id = 1;
+            std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+
+            /// Requests submitted from other threads
+            std::mutex inbox_mutex;
+            std::vector<std::pair<RobotId, Request>> inbox;
+
+            /// Guards the telemetry copies and statistics read by other threads
+            mutable std::mutex telemetry_mutex;
+            Stats loop_stats = { };
+        };
+    }
+}
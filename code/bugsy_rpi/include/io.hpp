@@ -0,0 +1,184 @@
+// ######################
+// #    BUGSY-RPI IO    #
+// ######################
+//
+// Serial connection between the RPi and the core MCU
+
+# pragma once
+
+# include <string.h>
+
+# include <bugsy/clock.hpp>
+# include <bugsy/core.hpp>
+# include <bugsy/messages.hpp>
+# include <bugsy/ota.hpp>
+# include <bugsy/trader.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "session.hpp"
+
+namespace bugsy_rpi {
+    /// Commands sent to the core MCU, every function returns `false` if the core did not answer in time
+    namespace core {
+        /// Signals the core that the RPi is ready
+        bool set_rpi_ready();
+
+        bool get_state(bugsy::CoreState* state);
+
+        bool get_battery(bugsy::BatteryState* battery);
+
+        bool get_estop_stats(bugsy::EStopStats* stats);
+
+        bool get_movement(bugsy::Movement* movement);
+
+        /// Stops all movements right away
+        bool stop();
+
+        /// Drives with the given velocity, converted into a movement by the core
+        bool drive(const bugsy::Velocity* vel);
+
+        /// Drives with the given velocity, dropped by the core if it arrives late or out of order
+        bool drive(const bugsy::Velocity* vel, const bugsy::MoveStamp* stamp);
+
+        bool get_move_stats(bugsy::MoveStats* stats);
+
+        /// Runs one clock synchronization exchange with the core and adds it to the `estimator`, the client clock is
+        /// `bugsy_rpi::micros()`. The round trip of the previous exchange is reported to the link statistics of the core
+        bool sync_clock(bugsy::clock::Estimator* estimator);
+
+        /// The link statistics of the movements the core received from the given `remote`
+        bool get_link_stats(bugsy::Remote remote, bugsy::LinkStats* stats);
+
+        bool get_failsafe_config(bugsy::FailsafeConfig* config);
+
+        /// Steps the link up to the fastest baud rate it supports (see `bugsy/baud.hpp`) and switches the serial to it
+        /// @return The baud rate the link runs at afterwards
+        uint32_t negotiate_baud();
+
+        /// The negotiated baud rate and the error counters the core keeps for the link of the given `remote`
+        bool get_baud_stats(bugsy::Remote remote, bugsy::BaudStats* stats);
+
+        /// Sets the bounds of the adaptive movement failsafe (not stored until the configuration is saved)
+        bool set_failsafe_config(const bugsy::FailsafeConfig* config);
+
+        /// Schedules a velocity at a time of the core clock (see `bugsy::clock::Estimator::to_core()`)
+        bool schedule_drive(const bugsy::ScheduledVelocity* scheduled);
+
+        bool get_schedule_stats(bugsy::ScheduleStats* stats);
+
+        /// Sends the commands of a batch (built with a `bugsy::batch::Writer`) and receives their answers
+        /// @param answers Receives the answers, has to hold `BUGSY_BATCH_ANSWER_SIZE` bytes (see `bugsy::batch::Reader`)
+        /// @param answers_len Receives the length of the answers
+        bool batch(const uint8_t* commands, size_t len, uint8_t* answers, size_t* answers_len);
+
+        bool get_drive_calibration(bugsy::DriveCalibration* cal);
+
+        /// Sets the calibration of the velocity drive mode (not stored until the configuration is saved)
+        bool set_drive_calibration(const bugsy::DriveCalibration* cal);
+
+        bool get_speed_stats(bugsy::SpeedStats* stats);
+
+        bool get_speed_gains(bugsy::SpeedGains* gains);
+
+        /// Sets the gains of the chain speed controllers (not stored until the configuration is saved)
+        bool set_speed_gains(const bugsy::SpeedGains* gains);
+
+        bool get_trader_state(bugsy::TraderState* state);
+
+        bool get_primary_sensor_data(bugsy::PrimarySensorData* data);
+
+        bool get_secondary_sensor_data(bugsy::SecondarySensorData* data);
+
+        /// Stores the current configuration of the core, the flash write runs as a job on the core
+        bool save_config(bugsy::JobTicket* ticket);
+
+        /// The state of a job started by a maintenance command (e.g. `save_config()`)
+        bool get_job_state(uint8_t id, bugsy::JobState* state);
+
+        /// Uploads a firmware image to the core (see `bugsy/ota.hpp`), calling it again with the same image resumes an
+        /// interrupted upload
+        /// @param restart Whether the core restarts into the image once it has been verified
+        /// @param status Receives the last status of the update
+        /// @return Whether the image has been verified, `false` as well if the core stopped answering
+        bool update_firmware(const uint8_t* image, uint32_t size, bool restart, bugsy::OtaStatus* status, bugsy::ota::UploadStats* stats);
+
+        bool get_ota_status(bugsy::OtaStatus* status);
+
+        /// Cancels the firmware update, the image received so far is discarded
+        bool abort_ota(bugsy::OtaStatus* status);
+    }
+
+    namespace io {
+        /// File descriptor of the serial connected to the core, `-1` if not connected
+        extern int core_fd;
+
+        /// If set, all the traffic with the core is recorded into this session (as `Remote::RPI`)
+        extern session::Writer* recorder;
+
+        /// The baud rate the serial connected to the core runs at, `0` if it has none (ptys)
+        extern uint32_t baud;
+
+        /// @brief Opens a serial `device` connected to a core and configures it as raw 8N1 with the given `baud` rate
+        /// @param baud `0` keeps the baud rate (ptys)
+        /// @param flags Additional `open()` flags (e.g. `O_NONBLOCK`)
+        /// @return The file descriptor or `-1` on failure
+        int open_serial(const char* device, uint32_t baud, int flags = 0);
+
+        // Events
+            /// @brief Opens the serial `device` connected to the core with the given `baud` rate
+            /// @return Whether the serial could be opened and configured
+            bool setup(const char* device, uint32_t baud);
+
+            /// @brief Closes the serial connection to the core
+            void close();
+        //
+
+        /// @brief Switches the serial connected to the core to a new baud rate, waits until everything written has been
+        /// sent. Ignored for serials without a baud rate (ptys)
+        /// @return Whether the serial could be reconfigured
+        bool set_baud(uint32_t baud);
+
+        /// @brief Writes all the given bytes to the core
+        /// @return Whether all bytes could be written
+        bool write_core(const void* buffer, size_t len);
+
+        /// @brief Reads exactly `len` bytes from the core
+        /// @param timeout Maximum time in milliseconds to wait for the bytes to arrive
+        /// @return Whether all bytes have been received in time
+        bool read_core(void* buffer, size_t len, uint32_t timeout = BUGSY_RPI_CORE_TIMEOUT);
+
+        /// @brief Discards all bytes that have been received but not read yet
+        void flush_core();
+
+        bool send_cmd_core(bugsy::Command cmd);
+
+        /// @brief Sends a command with a single byte argument (an ID or a `bugsy::Remote`)
+        bool send_u8_core(bugsy::Command cmd, uint8_t arg);
+
+        /// @brief Sends a command without arguments and receives its single byte answer (a state or an enum)
+        bool request_u8_core(bugsy::Command cmd, uint8_t* value);
+
+        /// @brief Sends a command with `obj` encoded by its builder `B` (see `bugsy/messages.hpp`)
+        template<typename B, typename T>
+        bool send_msg_core(bugsy::Command cmd, const T* obj) {
+            uint8_t buffer [sizeof(bugsy::Command) + B::SIZE];
+            buffer[0] = (uint8_t)cmd;
+            B(buffer + sizeof(bugsy::Command), B::SIZE).set(*obj);
+            return write_core(buffer, sizeof(buffer));
+        }
+
+        /// @brief Sends a command without arguments and decodes the answer of the core into `obj` with its view `V`
+        template<typename V, typename T>
+        bool request_msg_core(bugsy::Command cmd, T* obj) {
+            uint8_t buffer [V::SIZE];
+            flush_core();
+
+            if (!send_cmd_core(cmd) || !read_core(buffer, sizeof(buffer))) {
+                return false;
+            }
+
+            *obj = V(buffer, sizeof(buffer)).get();
+            return true;
+        }
+    }
+}
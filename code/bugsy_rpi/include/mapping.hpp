@@ -0,0 +1,197 @@
+// ###########################
+// #    BUGSY-RPI MAPPING    #
+// ###########################
+//
+// Occupancy grid mapping from the odometry and range scans, the map `bugsy::MoveMode::EXPLORE` explores
+//
+// Every cell holds the log-odds of being occupied as a saturating `int8_t` (in 1/16), a ray lowers the cells it passes
+// and raises the one it ends in. The cells are stored in square tiles of `2^BUGSY_RPI_MAP_TILE_BITS` cells, one tile after
+// another, so a ray touches a few cache lines per tile instead of one per row. Rays are traced in fixed-point along
+// their major axis, one cell per step. The vector kernel computes the cell indices of four steps at once with the vector
+// extensions of GCC (NEON on a Pi with ARMv7 or newer, SSE on a PC, plain code where neither exists) and produces exactly
+// the cells of the scalar kernel.
+//
+// Every tile remembers the revision of the grid in which its cells were last written, so a planner (see `planner.hpp`)
+// only has to look at the tiles that may have changed since it last did. A scan marks all tiles within the range of the
+// sensor, which keeps the bookkeeping out of the ray tracing.
+
+# pragma once
+
+# include <inttypes.h>
+# include <stddef.h>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+
+namespace bugsy_rpi {
+    namespace mapping {
+        /// Position in mm and heading in radians (counterclockwise, `0` along the x-axis)
+        struct Pose {
+            float x = 0.0f;
+            float y = 0.0f;
+            float theta = 0.0f;
+        };
+
+        /// A range scan, the rays are spread evenly around the heading of the sensor
+        struct Scan {
+            /// Pose of the sensor when the scan was taken
+            Pose pose;
+            /// Angle of the first ray relative to the heading in radians
+            float angle_min;
+            /// Angle between two rays in radians
+            float angle_step;
+            /// Measured distances in mm, `0` (or anything not positive) if the ray got no return
+            const float* ranges;
+            size_t count;
+            /// Range of the sensor in mm, rays reaching it only clear the cells they pass
+            float max_range;
+        };
+
+        /// Implementation of the ray tracing
+        enum class Kernel : uint8_t {
+            SCALAR,
+            VECTOR
+        };
+
+        /// Knowledge about a cell
+        enum class CellState : uint8_t {
+            UNKNOWN,
+            FREE,
+            OCCUPIED
+        };
+
+        /// Parameters of an occupancy grid, the log-odds are given in 1/16
+        struct GridParams {
+            /// Edge length of a cell in mm
+            float cell_size = BUGSY_RPI_MAP_CELL_SIZE;
+            /// Added to the cell a ray ends in (p = 0.7)
+            int8_t hit = 14;
+            /// Added to the cells a ray passes (p = 0.4)
+            int8_t miss = -6;
+            /// Limits of the log-odds, so a cell still follows a change of the world after a few scans
+            int8_t min = -96;
+            int8_t max = 96;
+            /// Log-odds from which on a cell counts as occupied, or below whose negative it counts as free
+            int8_t threshold = 16;
+
+            Kernel kernel = Kernel::VECTOR;
+        };
+
+        /// Counters of an occupancy grid
+        struct GridStats {
+            /// Rays integrated
+            uint64_t rays;
+            /// Cell updates made by the rays
+            uint64_t updates;
+        };
+
+        /// A 2D occupancy grid of a fixed area
+        class OccupancyGrid {
+        public:
+            /// @brief Creates a grid of unknown cells covering `width` x `height` mm centered around the origin
+            OccupancyGrid(float width, float height, GridParams params = GridParams());
+
+            /// @brief Integrates all rays of a scan
+            void integrate(const Scan& scan);
+
+            /// @brief Resets all cells to unknown
+            void clear();
+
+            /// @brief Sets the log-odds of a cell, e.g. to load a stored map
+            void set(uint32_t cx, uint32_t cy, int8_t value);
+
+            // Cells
+                uint32_t cells_x() const { return this->size_x; }
+                uint32_t cells_y() const { return this->size_y; }
+
+                /// @brief The log-odds of a cell in 1/16
+                int8_t get(uint32_t cx, uint32_t cy) const { return this->cells[this->index(cx, cy)]; }
+
+                /// @brief The probability of a cell being occupied
+                float probability(uint32_t cx, uint32_t cy) const;
+
+                CellState state(uint32_t cx, uint32_t cy) const;
+
+                /// @brief The cell containing the point `x`, `y` in mm
+                /// @return `false` if the point lies outside of the grid
+                bool cell_of(float x, float y, uint32_t* cx, uint32_t* cy) const;
+
+                /// @brief The center of a cell in mm
+                void center_of(uint32_t cx, uint32_t cy, float* x, float* y) const;
+            //
+
+            // Changes
+                /// @brief Raised by every `integrate()`, `set()` and `clear()`
+                uint32_t revision() const { return this->revisions; }
+
+                /// @brief Amount of tiles per row and column, a tile covers the cells `tx << BUGSY_RPI_MAP_TILE_BITS` to
+                /// `((tx + 1) << BUGSY_RPI_MAP_TILE_BITS) - 1`
+                uint32_t tiles_x() const { return (this->size_x + (1 << BUGSY_RPI_MAP_TILE_BITS) - 1) >> BUGSY_RPI_MAP_TILE_BITS; }
+                uint32_t tiles_y() const { return (this->size_y + (1 << BUGSY_RPI_MAP_TILE_BITS) - 1) >> BUGSY_RPI_MAP_TILE_BITS; }
+
+                /// @brief The revision in which the cells of the tile were last written, `0` if they never were
+                uint32_t tile_revision(uint32_t tx, uint32_t ty) const { return this->stamps[(ty << this->tiles_x_bits) | tx]; }
+            //
+
+            const GridParams& parameters() const { return this->params; }
+
+            const GridStats& stats() const { return this->counters; }
+
+        private:
+            size_t index(uint32_t cx, uint32_t cy) const {
+                const uint32_t bits = BUGSY_RPI_MAP_TILE_BITS;
+                const uint32_t mask = (1 << bits) - 1;
+
+                return ((size_t)((((cy >> bits) << this->tiles_x_bits) | (cx >> bits)) << (2 * bits)))
+                    | ((cy & mask) << bits) | (cx & mask);
+            }
+
+            /// Lowers the cells of `steps` steps starting at `x0`, `y0` (cell coordinates in 16.16 fixed-point)
+            void trace_scalar(int32_t x0, int32_t y0, int32_t step_x, int32_t step_y, uint32_t steps);
+            void trace_vector(int32_t x0, int32_t y0, int32_t step_x, int32_t step_y, uint32_t steps);
+
+            void update(size_t index, int8_t delta) {
+                int16_t value = this->cells[index] + delta;
+                this->cells[index] = (value < this->params.min) ? this->params.min : ((value > this->params.max) ? this->params.max : value);
+            }
+
+            /// Marks the tiles covering the cells `x0`, `y0` to `x1`, `y1` with the current revision
+            void mark(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+            GridParams params;
+            GridStats counters = { };
+
+            uint32_t size_x;
+            uint32_t size_y;
+            /// Amount of tiles per row as a power of 2, so a tile index is computed without a multiplication
+            uint32_t tiles_x_bits;
+
+            /// Position of the corner of the cell `0`, `0` in mm
+            float origin_x;
+            float origin_y;
+
+            /// The cells tile by tile
+            std::vector<int8_t> cells;
+
+            uint32_t revisions = 0;
+            /// Revision of the last write per tile, in the order of the tiles in `cells`
+            std::vector<uint32_t> stamps;
+        };
+
+        /// Dead reckoning from the distances travelled by both chains
+        class Odometry {
+        public:
+            /// @param track_width Distance between the centers of both chains in mm (see `bugsy::DriveCalibration`)
+            explicit Odometry(float track_width, Pose start = Pose()) : track_width(track_width), current(start) { }
+
+            /// @brief Advances the pose by the distances travelled since the last update in mm
+            void update(float left, float right);
+
+            const Pose& pose() const { return this->current; }
+
+        private:
+            float track_width;
+            Pose current;
+        };
+    }
+}
@@ -0,0 +1,270 @@
+// ###########################
+// #    BUGSY-RPI PLANNER    #
+// ###########################
+//
+// Incremental path planning over the occupancy grid (see `mapping.hpp`) and streaming of the planned trajectories to the
+// core as scheduled velocities (see `bugsy::Command::ScheduleDrive`)
+//
+// The planner runs D* Lite on the 8-connected cells of the grid. It searches from the goal towards the robot, so the
+// costs it found stay valid while the robot moves, and when cells change their state only the costs around them are
+// repaired instead of searching the whole grid again. Occupied cells are inflated by `BUGSY_RPI_PLAN_ROBOT_RADIUS`, the
+// path never cuts the corner of a blocked cell and unknown cells cost more than free ones, so known paths are preferred
+// while exploring.
+//
+// A path is shortened by line of sight and turned into segments of constant velocity: small heading changes are driven as
+// arcs, larger ones turn on the spot first. The core converts every velocity into a `bugsy::Movement` with its drive
+// calibration (see `bugsy/drive.hpp`).
+
+# pragma once
+
+# include <deque>
+# include <functional>
+# include <inttypes.h>
+# include <math.h>
+# include <queue>
+# include <vector>
+
+# include <bugsy/clock.hpp>
+# include <bugsy/drive.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "mapping.hpp"
+
+static_assert((2 * BUGSY_RPI_PLAN_STREAM_AHEAD) <= BUGSY_SCHEDULE_SIZE, "A new trajectory has to fit next to the old one on the core!");
+
+namespace bugsy_rpi {
+    namespace planning {
+        /// A point in mm
+        struct Point {
+            float x;
+            float y;
+        };
+
+        struct PlannerParams {
+            /// Distance in mm the path keeps from occupied cells
+            float robot_radius = BUGSY_RPI_PLAN_ROBOT_RADIUS;
+            /// Cost of an unknown cell relative to a free one
+            float unknown_cost = 3.0f;
+            /// Whether the path is shortened by line of sight
+            bool smooth = true;
+        };
+
+        /// Counters of a planner
+        struct PlannerStats {
+            /// Plans made
+            uint32_t plans;
+            /// Cells whose cost changed
+            uint64_t changed;
+            /// Cells taken from the queue
+            uint64_t expanded;
+            /// Cells whose cost to the goal has been recalculated
+            uint64_t updated;
+        };
+
+        /// D* Lite over an occupancy grid
+        class Planner {
+        public:
+            /// @brief Plans over `grid`, which has to outlive the planner
+            explicit Planner(const mapping::OccupancyGrid& grid, PlannerParams params = PlannerParams());
+
+            /// @brief Sets the goal in mm, discards everything searched so far
+            /// @return `false` if the goal lies outside of the grid
+            bool set_goal(float x, float y);
+
+            /// @brief Moves the robot to `x`, `y` in mm
+            /// @return `false` if the robot lies outside of the grid
+            bool set_start(float x, float y);
+
+            /// @brief Takes over the cells of the grid that changed their state since the last call
+            void update();
+
+            /// @brief Plans a path from the robot to the goal
+            /// @param path Receives the points to drive through, ending with the center of the goal cell
+            /// @return `false` if the goal can not be reached, also if the robot is closer to an obstacle than the radius
+            bool plan(std::vector<Point>& path);
+
+            /// @brief Cost of the path from the robot to the goal found by the last `plan()` in cells, infinite if there
+            /// is none
+            float cost() const { return (this->g[this->start] == COST_MAX) ? INFINITY : (this->g[this->start] / (float)STEP_STRAIGHT); }
+
+            const PlannerParams& parameters() const { return this->params; }
+
+            const PlannerStats& stats() const { return this->counters; }
+
+        private:
+            /// Cost in 1/1000 of a straight step between two free cells. On straight lines the heuristic is exact and the
+            /// first parts of many keys are equal, with floats their rounding would decide the order of the queue
+            typedef uint32_t Cost;
+
+            static constexpr Cost COST_MAX = UINT32_MAX;
+            static constexpr Cost STEP_STRAIGHT = 1000;
+            static constexpr Cost STEP_DIAGONAL = 1414;
+
+            /// Sum saturating at `COST_MAX`, which stands for unreachable
+            static Cost add(Cost a, Cost b) { return (a >= (COST_MAX - b)) ? COST_MAX : (a + b); }
+
+            /// Key of a cell in the queue, compared lexicographically
+            struct Key {
+                Cost k1;
+                Cost k2;
+
+                bool operator<(const Key& other) const {
+                    return (this->k1 < other.k1) || ((this->k1 == other.k1) && (this->k2 < other.k2));
+                }
+            };
+
+            struct Entry {
+                Key key;
+                uint32_t cell;
+
+                bool operator>(const Entry& other) const { return other.key < this->key; }
+            };
+
+            uint32_t id(uint32_t cx, uint32_t cy) const { return (cy * this->size_x) + cx; }
+
+            /// Estimated cost between two cells, the octile distance
+            Cost heuristic(uint32_t a, uint32_t b) const;
+
+            /// Cost of a straight step through a cell, `COST_MAX` for blocked cells
+            Cost factor(uint32_t cell) const;
+
+            /// Cost of the step between two neighbouring cells
+            Cost step(uint32_t a, uint32_t b) const;
+
+            Key key(uint32_t cell) const;
+
+            /// Recalculates the cost of a cell from its neighbours and queues it if it became inconsistent
+            void update_cell(uint32_t cell);
+
+            void compute();
+
+            /// Whether the straight line between two points crosses no cell costing more than `limit`
+            bool visible(const Point& from, const Point& to, Cost limit) const;
+
+            /// Applies a change of the state of a cell to the inflation and the costs
+            void apply(uint32_t cx, uint32_t cy, mapping::CellState state);
+
+            void touch(uint32_t cell);
+
+            const mapping::OccupancyGrid& grid;
+            PlannerParams params;
+            PlannerStats counters = { };
+
+            uint32_t size_x;
+            uint32_t size_y;
+
+            // Search
+                /// Cost to the goal as of the last expansion and as calculated from the neighbours
+                std::vector<Cost> g;
+                std::vector<Cost> rhs;
+
+                /// Outdated entries are dropped when they reach the top instead of being searched for
+                std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+                uint32_t start = 0;
+                uint32_t goal = 0;
+                bool has_goal = false;
+                /// Start of the last change of the costs and the heuristic travelled since the goal was set
+                uint32_t last = 0;
+                Cost km = 0;
+            //
+
+            // Costs
+                /// Cost of a straight step through an unknown cell
+                Cost unknown;
+                /// State of every cell as last taken over from the grid
+                std::vector<mapping::CellState> states;
+                /// Amount of occupied cells within the robot radius, a cell is blocked if there is any
+                std::vector<uint16_t> near;
+                /// Offsets of the cells within the robot radius
+                std::vector<std::pair<int32_t, int32_t>> disk;
+
+                /// Revision of the grid taken over
+                uint32_t revision = 0;
+
+                /// Cells whose cost changed since the last `plan()`, marked in `touched`
+                std::vector<uint32_t> changed;
+                std::vector<uint8_t> touched;
+            //
+        };
+
+        /// A piece of a trajectory, the robot drives with `vel` for `duration`
+        struct Segment {
+            bugsy::Velocity vel;
+            /// Duration in µs
+            uint32_t duration;
+        };
+
+        /// How the robot may move along a trajectory
+        struct MotionLimits {
+            /// Driving speed in mm/s
+            float speed = 200.0f;
+            /// Turning speed on the spot in rad/s
+            float turn_rate = 1.5f;
+            /// Heading changes up to this angle (radians) are driven as an arc instead of turning on the spot first
+            float arc_angle = 0.35f;
+            /// Speed limit of a single chain in mm/s, below `bugsy::DriveCalibration::max_speed`
+            float chain_speed = BUGSY_DRIVE_DEFAULT_MAX_SPEED * 0.8f;
+            /// Distance between the centers of both chains in mm
+            float track_width = BUGSY_DRIVE_DEFAULT_TRACK_WIDTH;
+        };
+
+        /// @brief Turns a path into a trajectory driven from `pose`
+        std::vector<Segment> to_segments(const mapping::Pose& pose, const std::vector<Point>& path, const MotionLimits& limits);
+
+        /// Counters of a streamer
+        struct StreamStats {
+            /// Steps accepted by the sink
+            uint32_t steps;
+            /// Steps the sink failed to send, they are sent again by the next `update()`
+            uint32_t failed;
+        };
+
+        /// Streams a trajectory to the core
+        ///
+        /// The segments are cut into steps of at most `BUGSY_RPI_PLAN_STREAM_INTERVAL` that are scheduled up to
+        /// `BUGSY_RPI_PLAN_STREAM_AHEAD` steps ahead, so the robot stops by the failsafe of the core once the RPi stops
+        /// streaming. A new trajectory overrides the steps already scheduled of the old one with steps at the same times,
+        /// the core applies the later one received. All times are microseconds of the core clock (see
+        /// `bugsy::clock::Estimator::to_core()`).
+        class Streamer {
+        public:
+            /// Sends a step to the core, e.g. with `core::schedule_drive()`
+            typedef std::function<bool(const bugsy::ScheduledVelocity& scheduled)> Sink;
+
+            explicit Streamer(Sink sink) : sink(sink) { }
+
+            /// @brief Follows `segments` from the next step on, replacing the current trajectory
+            void start(const std::vector<Segment>& segments, uint32_t now);
+
+            /// @brief Stops the robot with the next step
+            void stop(uint32_t now) { this->start({ }, now); }
+
+            /// @brief Sends the steps due, has to be called at least every `BUGSY_RPI_PLAN_STREAM_INTERVAL`
+            void update(uint32_t now);
+
+            /// @brief Whether the whole trajectory, including the final stop, has been sent
+            bool done() const { return this->finished; }
+
+            const StreamStats& stats() const { return this->counters; }
+
+        private:
+            Sink sink;
+            StreamStats counters = { };
+
+            std::vector<Segment> segments;
+            size_t segment = 0;
+            /// Time already sent of the current segment
+            uint32_t offset = 0;
+
+            /// Time of the next step
+            uint32_t next_at = 0;
+            /// Times of the steps scheduled but not yet applied
+            std::deque<uint32_t> pending;
+            /// Times of the steps of the old trajectory still to override
+            std::deque<uint32_t> overrides;
+
+            bool finished = true;
+        };
+    }
+}
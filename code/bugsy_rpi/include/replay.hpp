@@ -0,0 +1,95 @@
+// ##########################
+// #    BUGSY-RPI REPLAY    #
+// ##########################
+//
+// Feeds a recorded session (see `session.hpp`) into a core again, either the simulated core or a real one over serial,
+// and compares the answers with the recorded ones
+
+# pragma once
+
+# include <inttypes.h>
+# include <vector>
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "session.hpp"
+# include "sim_core.hpp"
+
+namespace bugsy_rpi {
+    namespace replay {
+        /// A core receiving the replayed commands
+        class Target {
+        public:
+            virtual ~Target() = default;
+
+            /// @brief Sends the command and collects the answer
+            /// @param stamp Session time of the command in microseconds
+            /// @param expected Amount of response bytes the recorded core sent
+            /// @param response Filled with the actual response
+            /// @return `false` if the expected response did not arrive in time
+            virtual bool exchange(uint64_t stamp, bugsy::Remote remote, const uint8_t* cmd, size_t len,
+                size_t expected, std::vector<uint8_t>* response) = 0;
+        };
+
+        /// Replays into an in-process `sim::SimCore`, the simulated clock follows the session time
+        class SimTarget : public Target {
+        public:
+            SimTarget();
+
+            bool exchange(uint64_t stamp, bugsy::Remote remote, const uint8_t* cmd, size_t len,
+                size_t expected, std::vector<uint8_t>* response) override;
+
+            sim::SimCore core;
+
+        private:
+            std::vector<uint8_t>* response = nullptr;
+        };
+
+        /// Replays into a real core connected over serial (see `io::setup()`), all remotes share the one connection
+        class SerialTarget : public Target {
+        public:
+            bool exchange(uint64_t stamp, bugsy::Remote remote, const uint8_t* cmd, size_t len,
+                size_t expected, std::vector<uint8_t>* response) override;
+        };
+
+        /// Results of a replay
+        struct Report {
+            /// Commands sent to the target
+            uint64_t commands;
+            /// Commands answered exactly like in the recording
+            uint64_t matched;
+            /// Commands answered differently
+            uint64_t mismatched;
+            /// Commands whose answer did not arrive in time
+            uint64_t timeouts;
+
+            /// Wall clock duration of the replay in microseconds
+            uint64_t duration;
+            /// Average and maximum time the target took per command in microseconds
+            double latency_avg;
+            uint64_t latency_max;
+            /// 99th percentile of the command latency in microseconds
+            uint64_t latency_p99;
+        };
+
+        /// A single command of a session with the answer recorded for it
+        struct Step {
+            uint64_t stamp;
+            bugsy::Remote remote;
+            const uint8_t* cmd;
+            size_t len;
+            std::vector<uint8_t> expected;
+        };
+
+        /// @brief Loads all commands from `start` (session time in microseconds) on with their recorded answers
+        std::vector<Step> load_steps(session::Reader* reader, uint64_t start = 0);
+
+        /// @brief Replays the given steps
+        /// @param realtime Keep the recorded timing if set, otherwise replay as fast as the target answers
+        Report run(const std::vector<Step>& steps, Target* target, bool realtime);
+
+        /// @brief Logs a replay report
+        void log_report(const Report& report);
+    }
+}
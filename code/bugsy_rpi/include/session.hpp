@@ -0,0 +1,183 @@
+// ###########################
+// #    BUGSY-RPI SESSION    #
+// ###########################
+//
+// Append-only, memory-mapped log of the command and telemetry streams of a robot session
+//
+// File layout:
+// - `FileHeader`
+// - Records, each a `RecordHeader` followed by `RecordHeader::len` data bytes
+// - Index (written when the session is closed): `IndexEntry[]` followed by a `Footer`
+//
+// The index holds the offset of every record starting a new `BUGSY_RPI_SESSION_INDEX_INTERVAL`, so a reader can seek to
+// any point in time without scanning the whole file. Sessions that have not been closed properly (crash, power loss) have
+// no index, the reader rebuilds it with a single scan.
+
+# pragma once
+
+# include <inttypes.h>
+# include <string>
+# include <vector>
+
+# include <bugsy/core.hpp>
+
+# include "bugsy_rpi.hpp"
+
+/* SESSION */
+/// Interval of the seek index in microseconds
+# define BUGSY_RPI_SESSION_INDEX_INTERVAL 1000000
+/// Amount of bytes the session file grows by when the mapping is full
+# define BUGSY_RPI_SESSION_CHUNK_SIZE (1 << 20)
+
+namespace bugsy_rpi {
+    namespace session {
+        /// Direction of the recorded data
+        enum class Flow : uint8_t {
+            /// Data sent to the core (commands)
+            TO_CORE = 0x00,
+            /// Data sent by the core (responses, telemetry)
+            FROM_CORE = 0x01
+        };
+
+        /// Header at the very start of the file
+        struct __attribute__((packed)) FileHeader {
+            /// Always `FILE_MAGIC`
+            uint32_t magic;
+            /// Always `FILE_VERSION`
+            uint16_t version;
+            uint16_t reserved;
+            /// Wall clock time of the session start in microseconds since the unix epoch
+            uint64_t start_time;
+        };
+
+        /// Header of a single record, 8 bytes
+        struct __attribute__((packed)) RecordHeader {
+            /// Microseconds since the previous record (or since the session start for the first record)
+            uint32_t delta;
+            /// The `bugsy::Remote` the data has been exchanged with
+            bugsy::Remote remote;
+            Flow direction;
+            /// Amount of data bytes following the header
+            uint16_t len;
+        };
+
+        /// Entry of the seek index
+        struct __attribute__((packed)) IndexEntry {
+            /// Session time of the record in microseconds
+            uint64_t stamp;
+            /// File offset of the record
+            uint64_t offset;
+        };
+
+        /// Footer at the very end of a properly closed session
+        struct __attribute__((packed)) Footer {
+            /// File offset of the first `IndexEntry`
+            uint64_t index_offset;
+            uint32_t index_count;
+            /// Always `FOOTER_MAGIC`
+            uint32_t magic;
+        };
+
+        /// Session file magic ("BGSL")
+        static constexpr uint32_t FILE_MAGIC = 0x4C534742;
+        /// Footer magic ("BGSI")
+        static constexpr uint32_t FOOTER_MAGIC = 0x49534742;
+        static constexpr uint16_t FILE_VERSION = 1;
+
+        /// A decoded record
+        struct Record {
+            /// Microseconds since the session start
+            uint64_t stamp;
+            bugsy::Remote remote;
+            Flow direction;
+            /// Points into the mapped file, valid as long as the reader is open
+            const uint8_t* data;
+            uint16_t len;
+        };
+
+        /// Records a session into a file, appending is a plain `memcpy` into the mapping
+        class Writer {
+        public:
+            Writer() = default;
+            ~Writer();
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            /// @brief Creates the session file at `path`, overwriting existing files
+            bool open(const char* path);
+
+            /// @brief Writes the index and truncates the file to its real size
+            void close();
+
+            bool is_open() const { return this->fd >= 0; }
+
+            /// @brief Appends a record with the current time
+            bool append(bugsy::Remote remote, Flow direction, const void* data, size_t len);
+
+            /// @brief Appends a record with the given session time in microseconds, must not be older than the last record
+            bool append_at(uint64_t stamp, bugsy::Remote remote, Flow direction, const void* data, size_t len);
+
+            /// @brief Microseconds since the session start
+            uint64_t session_time() const;
+
+        private:
+            /// Makes sure `len` more bytes fit into the mapping
+            bool reserve(size_t len);
+
+            int fd = -1;
+            uint8_t* map = nullptr;
+            size_t map_size = 0;
+            size_t size = 0;
+
+            uint64_t start = 0;
+            uint64_t last_stamp = 0;
+            std::vector<IndexEntry> index;
+        };
+
+        /// Reads a session file mapped into memory
+        class Reader {
+        public:
+            Reader() = default;
+            ~Reader();
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            /// @brief Maps the session at `path`, rebuilds the index if the session has not been closed properly
+            bool open(const char* path);
+
+            void close();
+
+            /// @brief Wall clock time of the session start in microseconds since the unix epoch
+            uint64_t start_time() const;
+
+            /// @brief Session time of the last record in microseconds
+            uint64_t duration() const { return this->end_stamp; }
+
+            /// @brief Reads the next record
+            /// @return `false` at the end of the session
+            bool next(Record* record);
+
+            /// @brief Moves to the first record at or after `stamp` (session time in microseconds)
+            void seek(uint64_t stamp);
+
+            /// @brief Moves back to the first record
+            void rewind();
+
+        private:
+            /// Scans the records up to `data_end` to find the session end, builds the index if none has been stored
+            void scan();
+
+            const uint8_t* map = nullptr;
+            size_t map_size = 0;
+
+            size_t data_end = 0;
+            uint64_t end_stamp = 0;
+            std::vector<IndexEntry> index;
+
+            size_t offset = 0;
+            uint64_t stamp = 0;
+        };
+    }
+}
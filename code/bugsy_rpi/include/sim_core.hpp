@@ -0,0 +1,218 @@
+// ############################
+// #    BUGSY-RPI SIM-CORE    #
+// ############################
+//
+// Host model of the core MCU, answering commands like the firmware does (see `bugsy_core::io::parse_cmd()`)
+//
+// The model runs on a simulated millisecond clock that is only advanced by the caller, so recorded sessions and load
+// tests behave the same no matter how fast they are executed. Keep it in sync with the firmware when changing the
+// command handling of the core.
+
+# pragma once
+
+# include <deque>
+# include <functional>
+# include <inttypes.h>
+
+# include <bugsy/batch.hpp>
+# include <bugsy/baud.hpp>
+# include <bugsy/battery.hpp>
+# include <bugsy/clock.hpp>
+# include <bugsy/core.hpp>
+# include <bugsy/defines.hpp>
+# include <bugsy/drive.hpp>
+# include <bugsy/link.hpp>
+# include <bugsy/mailbox.hpp>
+# include <bugsy/messages.hpp>
+# include <bugsy/ota.hpp>
+# include <bugsy/power.hpp>
+# include <bugsy/speed.hpp>
+# include <bugsy/trader.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "sim_flash.hpp"
+# include "sim_motor.hpp"
+
+/// Same failsafe duration as the firmware default (see `BUGSY_DEFAULT_MOVE_DUR` of the core)
+# define BUGSY_SIM_DEFAULT_MOVE_DUR 200
+/// Same amount of queryable jobs as the firmware (see `JOBS_HISTORY` of the core)
+# define BUGSY_SIM_JOBS_HISTORY 16
+/// Same update write queue as the firmware (see `OTA_QUEUE_SIZE` and `OTA_QUEUE_RESERVED` of the core)
+# define BUGSY_SIM_OTA_QUEUE_SIZE 8
+# define BUGSY_SIM_OTA_QUEUE_RESERVED 2
+/// Same update windows as the firmware (see `OTA_WINDOW_RPI` and `OTA_WINDOW_BT` of the core)
+# define BUGSY_SIM_OTA_WINDOW_RPI 7
+# define BUGSY_SIM_OTA_WINDOW_BT 3
+
+namespace bugsy_rpi {
+    namespace sim {
+        /// A simulated core MCU
+        class SimCore {
+        public:
+            /// Receives everything the core writes to the given remotes
+            typedef std::function<void(bugsy::Remote remotes, const uint8_t* buffer, size_t len)> Output;
+
+            explicit SimCore(Output output);
+
+            /// @brief Sets the simulated time in milliseconds, has to be monotonic
+            void set_time(uint32_t now) { this->now = now; }
+
+            uint32_t time() const { return this->now; }
+
+            /// @brief Parses a command received from `src`, like `bugsy_core::io::parse_cmd()`
+            void parse_cmd(bugsy::Remote src, const uint8_t* buffer, size_t len);
+
+            /// @brief Runs the periodic work of the core's `loop()` (movement failsafe, trader timeout, idle sleep), the
+            /// speed control ticks and the flash operations of the update that are due
+            void update();
+
+            // State
+                bugsy::CoreState state = bugsy::CoreState::STANDBY;
+                bugsy::Remote remotes = (bugsy::Remote)((uint8_t)bugsy::Remote::BLUETOOTH | (uint8_t)bugsy::Remote::TRADER | (uint8_t)bugsy::Remote::RPI);
+                bugsy::Configuration configuration = { bugsy::Remote::NONE, BUGSY_SIM_DEFAULT_MOVE_DUR, "", "", bugsy::drive::DEFAULT_CALIBRATION, bugsy::speed::DEFAULT_GAINS,
+                    bugsy::link::DEFAULT_FAILSAFE };
+
+                bugsy::Movement move = { Direction::CCW, Direction::CCW, 0, 0 };
+                uint32_t move_stamp = 0;
+                bugsy::MoveDuration move_duration = 0;
+                /// Movement mailbox like `bugsy_core::move::mailbox`
+                bugsy::mailbox::Mailbox mailbox;
+                /// Scheduled movements like `bugsy_core::move::schedule`, the core clock is the simulated time in microseconds
+                bugsy::clock::Schedule schedule;
+                /// Link statistics like `bugsy_core::move::links`, deciding the failsafe window of the movements
+                bugsy::link::Monitor links;
+
+                /// Servo trajectories like `bugsy_core::servo`, interpolated when read
+                struct ServoTrajectory {
+                    uint16_t from;
+                    uint16_t to;
+                    uint32_t start;
+                    uint16_t duration;
+                } servos [bugsy::SERVO_COUNT] = { };
+
+                /// @brief The current angle of a servo in 0.1 degrees
+                uint16_t servo_angle(uint8_t servo) const;
+
+                /// Chain motors driven by the speed control like `bugsy_core::speed` (or the open-loop duties)
+                MotorModel chains [2];
+                bugsy::speed::Controller speed;
+                /// Signed duties currently applied to the chain motors
+                int16_t duties [2] = { 0, 0 };
+                /// Simulated time of the next speed control tick in microseconds
+                uint64_t next_tick = 0;
+
+                /// Level of the emergency stop line driven by the trader, `false` stops the robot like `bugsy_core::estop`
+                /// (with zero latency) until it is released again
+                bool estop_line = true;
+                bugsy::EStopStats estop = { };
+
+                /// Simulated pack voltage under load in millivolts, the battery state is derived with the core's model
+                uint16_t battery_voltage = 8000;
+
+                bugsy::TraderState trader_state = bugsy::TraderState::DISCONNECTED;
+                uint32_t trader_stamp = 0;
+                bool rpi_ready = false;
+
+                /// Baud rates of the trader and RPi links like `bugsy_core::uart`, the model has no UARTs, so a rate is
+                /// only bookkeeping and every test frame arrives intact
+                bugsy::baud::Port trader_baud { BUGSY_UART_CORE_TO_TRADER_BAUD, BUGSY_UART_CORE_TO_TRADER_MAX_BAUD };
+                bugsy::baud::Port rpi_baud { BUGSY_UART_CORE_TO_RPI_BAUD, BUGSY_UART_CORE_TO_RPI_MAX_BAUD };
+
+                /// Idle power management like `bugsy_core::power`, sleeps are counted in simulated time and end once a
+                /// movement is received
+                bugsy::power::Governor power;
+                /// Simulated time the current sleep ends at
+                uint32_t sleep_until = 0;
+
+                bugsy::PrimarySensorData primary_sensor_data = { };
+                bugsy::SecondarySensorData secondary_sensor_data = { };
+
+                /// ID of the last maintenance job, the model finishes every job right away
+                uint8_t last_job = 0;
+
+                /// Firmware update like `bugsy_core::ota`, the writer task spends the time the simulated flash takes
+                bugsy::ota::Session ota;
+                FlashPartition flash { BUGSY_OTA_MAX_SIZE };
+                /// Restarts into a verified image, the model only forgets the update
+                uint32_t restarts = 0;
+
+                /// Amount of commands parsed
+                uint64_t commands = 0;
+            //
+
+        private:
+            /// @brief Posts a movement received by `Move` or `Drive` to the mailbox
+            void post_move(bugsy::Remote src, const bugsy::MoveStamp* stamp, const bugsy::Movement& new_move);
+
+            /// @brief Hands a movement to the mailbox and applies it right away
+            void deliver(bugsy::Remote src, const bugsy::MoveStamp* stamp, const bugsy::Movement& new_move);
+
+            /// @brief Applies a movement taken from the mailbox
+            void apply_move(const bugsy::Movement& new_move, bugsy::Remote src);
+
+            /// @brief The baud rate of the link of `src`, `nullptr` for remotes without a negotiated link
+            bugsy::baud::Port* baud_of(bugsy::Remote src);
+
+            /// A request for the update writer like `bugsy_core::ota::Request`, the step is told by the command
+            struct FlashRequest {
+                bugsy::Command step;
+                uint8_t session;
+                bool restart;
+                uint16_t index;
+                uint16_t len;
+                uint8_t data [BUGSY_OTA_CHUNK_SIZE];
+            };
+
+            /// @brief Queues a request for the update writer
+            /// @param reserve Whether the request may take the slots reserved for the requests controlling the update
+            bool ota_queue(const FlashRequest& req, bool reserve);
+
+            /// @brief Starts the flash operation of a request
+            /// @return The time it takes in microseconds
+            uint32_t ota_start(const FlashRequest& req);
+
+            /// @brief Applies the outcome of a request once its flash operation is done
+            void ota_complete(const FlashRequest& req);
+
+            void write_u8(bugsy::Remote remotes, uint8_t value) {
+                this->output(remotes, &value, sizeof(uint8_t));
+            }
+
+            void write_u16(bugsy::Remote remotes, uint16_t value) {
+                uint8_t buffer [sizeof(uint16_t)];
+                bugsy::msg::wire::put_u16(buffer, value);
+                this->output(remotes, buffer, sizeof(buffer));
+            }
+
+            /// Encoded with the builder `B` of the message like the answers of the core
+            template<typename B, typename T>
+            void write_msg(bugsy::Remote remotes, const T& obj) {
+                uint8_t buffer [B::SIZE];
+                B(buffer, sizeof(buffer)).set(obj);
+                this->output(remotes, buffer, sizeof(buffer));
+            }
+
+            Output output;
+            uint32_t now = 0;
+
+            /// Whether a batch is being parsed, its answers are sent once it is done
+            bool batching = false;
+
+            // Update writer
+                /// ID of the update, requests of replaced updates are skipped
+                uint8_t ota_id = 0;
+                std::deque<FlashRequest> ota_requests;
+                /// The request whose flash operation is running and the simulated time it ends at in microseconds
+                FlashRequest ota_current;
+                bool ota_busy = false;
+                uint64_t ota_until = 0;
+                /// Whether the partition has been erased for the update
+                bool ota_open = false;
+                /// CRC-32 read back by the running verification
+                uint32_t ota_readback = 0;
+                /// Simulated time of the requested restart, `0` if none
+                uint32_t ota_restart = 0;
+            //
+        };
+    }
+}
@@ -0,0 +1,64 @@
+// #############################
+// #    BUGSY-RPI SIM-FLASH    #
+// #############################
+//
+// Host model of an app partition in the SPI NOR flash of the core, used to check the firmware updates (see
+// `bugsy/ota.hpp`)
+//
+// Like NOR flash, an erase sets whole sectors to `0xFF` and a write can only clear bits, so a chunk written to a sector
+// that has not been erased reads back broken. Every operation returns the time it takes on the flash, the caller decides
+// how to spend it. The partition starts out holding an older image and is only allocated once it is used.
+
+# pragma once
+
+# include <inttypes.h>
+# include <stddef.h>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+
+namespace bugsy_rpi {
+    namespace sim {
+        /// Geometry and timing of the simulated flash, typical values of the flash chips of ESP32 modules
+        struct FlashParams {
+            /// Size of an erase sector in bytes
+            uint32_t sector = 4096;
+            /// Time to erase a sector in microseconds
+            uint32_t erase_us = 45000;
+            /// Size of a program page in bytes
+            uint32_t page = 256;
+            /// Time to program a page in microseconds
+            uint32_t program_us = 700;
+            /// Time to read a kilobyte in microseconds
+            uint32_t read_us = 60;
+        };
+
+        /// A simulated flash partition
+        class FlashPartition {
+        public:
+            explicit FlashPartition(uint32_t size, FlashParams params = FlashParams()) : params(params), size(size) { }
+
+            /// @brief Erases the sectors covering the first `len` bytes
+            /// @return The time the erase takes in microseconds
+            uint32_t erase(uint32_t len);
+
+            /// @brief Writes `len` bytes at `offset`, clearing bits only
+            /// @return The time the write takes in microseconds
+            uint32_t write(uint32_t offset, const uint8_t* data, size_t len);
+
+            /// @brief Reads `len` bytes at `offset`
+            /// @return The time the read takes in microseconds
+            uint32_t read(uint32_t offset, uint8_t* data, size_t len);
+
+            uint32_t capacity() const { return this->size; }
+
+        private:
+            /// @brief Allocates the partition, filled with the older image
+            void touch();
+
+            FlashParams params;
+            uint32_t size;
+            std::vector<uint8_t> bytes;
+        };
+    }
+}
@@ -0,0 +1,62 @@
+// #############################
+// #    BUGSY-RPI SIM-FLEET    #
+// #############################
+//
+// Any amount of simulated cores (see `sim_core.hpp`) served by a single background thread, used to load test the
+// gateway without any hardware
+//
+// Every core is connected through a `SOCK_SEQPACKET` socket pair, one packet is one command like a pause on a serial
+// line. The simulated clocks follow the real time since `start()`.
+
+# pragma once
+
+# include <atomic>
+# include <inttypes.h>
+# include <memory>
+# include <thread>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+# include "gateway.hpp"
+# include "sim_core.hpp"
+
+namespace bugsy_rpi {
+    namespace sim {
+        class SimFleet {
+        public:
+            SimFleet();
+            ~SimFleet();
+
+            SimFleet(const SimFleet&) = delete;
+            SimFleet& operator=(const SimFleet&) = delete;
+
+            /// @brief Creates a new simulated core, has to be called before `start()`
+            /// @return The gateway end of the connection to the core
+            std::unique_ptr<gateway::Link> add();
+
+            /// @brief Starts serving the cores in the background
+            void start();
+
+            /// @brief Stops the background thread
+            void stop();
+
+            size_t size() const { return this->cores.size(); }
+
+        private:
+            struct Entry {
+                int fd;
+                std::unique_ptr<SimCore> core;
+                std::vector<uint8_t> response;
+            };
+
+            void serve();
+
+            int epoll_fd = -1;
+            int stop_fd = -1;
+            std::vector<Entry> cores;
+
+            std::thread thread;
+            std::atomic<bool> running { false };
+        };
+    }
+}
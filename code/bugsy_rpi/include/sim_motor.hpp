@@ -0,0 +1,62 @@
+// #############################
+// #    BUGSY-RPI SIM-MOTOR    #
+// #############################
+//
+// Host model of a chain motor with its encoder, used to tune and check the speed control (see `bugsy::speed`)
+//
+// The steady-state speed follows the duty above a deadband on a slightly bent curve and scales with the supply voltage,
+// a load slows the chain down by a constant amount. The speed approaches its steady-state with a first order lag, the
+// chain position is quantized into encoder edges like the PCNT counters of the core do. The default parameters
+// deliberately differ from the default `DriveCalibration`, so open-loop movements show a tracking error.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include <bugsy/speed.hpp>
+
+# include "bugsy_rpi.hpp"
+
+namespace bugsy_rpi {
+    namespace sim {
+        /// Parameters of a simulated chain motor
+        struct MotorParams {
+            /// Speed at full duty and nominal supply in mm/s
+            double max_speed = 430.0;
+            /// Duty at which the motor starts turning
+            uint8_t deadband = 55;
+            /// Exponent bending the speed curve above the deadband (`1` is linear)
+            double curve = 0.8;
+            /// Time constant of the speed in seconds
+            double tau = 0.06;
+        };
+
+        /// A simulated chain motor
+        class MotorModel {
+        public:
+            explicit MotorModel(MotorParams params = MotorParams()) : params(params) { }
+
+            /// @brief Advances the model with the given signed duty applied
+            /// @param dt The time step in seconds
+            /// @return The encoder edges counted during the step (signed)
+            int32_t step(int16_t duty, double dt);
+
+            /// The current speed in mm/s
+            double speed = 0.0;
+            /// Speed lost to the load (terrain, slope) in mm/s, always opposes the movement
+            double load = 0.0;
+            /// Supply voltage relative to a full battery
+            double supply = 1.0;
+
+        private:
+            /// The speed the motor settles at for the given duty
+            double steady_speed(int16_t duty) const;
+
+            MotorParams params;
+            /// Travelled distance in mm
+            double position = 0.0;
+            /// Edges counted so far
+            int64_t edges = 0;
+        };
+    }
+}
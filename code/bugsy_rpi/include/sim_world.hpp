@@ -0,0 +1,76 @@
+// #############################
+// #    BUGSY-RPI SIM-WORLD    #
+// #############################
+//
+// Synthetic 2D world with a simulated range sensor, used to test and benchmark the mapping (see `mapping.hpp`) without
+// any hardware
+//
+// The world consists of walls (line segments) and round pillars. A scan casts every ray analytically against all of them,
+// adds gaussian noise to the distances and drops a share of the returns, like a cheap rotating laser scanner does.
+
+# pragma once
+
+# include <inttypes.h>
+# include <math.h>
+# include <random>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+# include "mapping.hpp"
+
+namespace bugsy_rpi {
+    namespace sim {
+        /// Parameters of a simulated range sensor
+        struct RangeParams {
+            /// Rays per scan, spread evenly over `fov`
+            uint16_t rays = 360;
+            /// Field of view in radians, centered around the heading
+            float fov = 2.0f * (float)M_PI;
+            /// Range in mm
+            float max_range = 4000.0f;
+            /// Standard deviation of the distance noise in mm
+            float noise = 10.0f;
+            /// Share of the rays that get no return
+            float dropout = 0.02f;
+        };
+
+        class World {
+        public:
+            /// @brief Adds a wall from `x0`, `y0` to `x1`, `y1` (mm)
+            void add_wall(float x0, float y0, float x1, float y1);
+
+            /// @brief Adds the four walls of an axis aligned box
+            void add_box(float x, float y, float width, float height);
+
+            /// @brief Adds a round pillar
+            void add_pillar(float x, float y, float radius);
+
+            /// @brief Two rooms of 4 x 6 m connected by a door, furnished with boxes and pillars
+            static World rooms();
+
+            /// @brief The distance from `x`, `y` along `angle` to the first surface
+            /// @return `max_range` if there is none in range
+            float cast(float x, float y, float angle, float max_range) const;
+
+            /// @brief The distance from `x`, `y` to the closest surface
+            float clearance(float x, float y) const;
+
+            /// @brief Takes a scan at `pose`
+            /// @param ranges Receives the distances of all rays, `0` for rays without a return
+            /// @return The scan, pointing to `ranges`
+            mapping::Scan scan(const mapping::Pose& pose, const RangeParams& params, std::mt19937& rng, std::vector<float>& ranges) const;
+
+        private:
+            struct Wall {
+                float x0, y0, x1, y1;
+            };
+
+            struct Pillar {
+                float x, y, radius;
+            };
+
+            std::vector<Wall> walls;
+            std::vector<Pillar> pillars;
+        };
+    }
+}
@@ -0,0 +1,152 @@
+// #############################
+// #    BUGSY-RPI TELEMETRY    #
+// #############################
+//
+// Shared memory ring publishing the robot state to any number of local processes
+//
+// The ring has exactly one writer (the `bugsy_rpi` daemon) and any number of readers. Every slot is guarded by its own
+// sequence counter (seqlock): The writer makes the counter odd while writing and even again once done, readers copy the
+// slot and retry if the counter was odd or changed while copying. Neither side ever blocks or performs a syscall after
+// mapping the ring, a reader that falls behind more than `BUGSY_RPI_TELEMETRY_SLOTS` frames skips ahead and counts the
+// frames it missed.
+//
+// A writer that died while publishing leaves its slot odd. Readers give up on a slot after
+// `BUGSY_RPI_TELEMETRY_READ_RETRIES` attempts and report no frame, and the next writer makes all counters even again
+// before it publishes, so the parity of the slot is not inverted.
+
+# pragma once
+
+# include <atomic>
+# include <inttypes.h>
+
+# include <bugsy/core.hpp>
+# include <bugsy/trader.hpp>
+
+# include "bugsy_rpi.hpp"
+
+namespace bugsy_rpi {
+    namespace telemetry {
+        /// A single telemetry record of the robot
+        struct Frame {
+            /// Timestamp of the poll in microseconds (`CLOCK_MONOTONIC`, comparable between processes)
+            uint64_t stamp;
+
+            bugsy::CoreState core_state;
+            bugsy::TraderState trader_state;
+            bugsy::Movement movement;
+            bugsy::BatteryState battery;
+            bugsy::SpeedStats speed;
+            bugsy::EStopStats estop;
+            /// Link statistics of the movements sent by the RPi
+            bugsy::LinkStats link;
+            /// Baud rate and error counters of the UART between the core and the RPi
+            bugsy::BaudStats baud;
+
+            bugsy::PrimarySensorData primary_sensor_data;
+            bugsy::SecondarySensorData secondary_sensor_data;
+        };
+
+        /// Size of a frame in 32 bit words, frames are copied word by word so the copy itself is free of data races
+        static constexpr size_t FRAME_WORDS = (sizeof(Frame) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        /// A slot of the ring, guarded by its own sequence counter
+        struct Slot {
+            /// Even if the slot is stable, odd while the writer is updating it
+            std::atomic<uint32_t> seq;
+            /// The index of the frame stored in this slot, used to detect slots that have been overwritten
+            std::atomic<uint32_t> index;
+            /// The frame data
+            std::atomic<uint32_t> words [FRAME_WORDS];
+        };
+
+        /// Layout of the whole shared memory object
+        struct Ring {
+            /// Set to `RING_MAGIC` once the ring has been initialized
+            std::atomic<uint32_t> magic;
+            /// Size of the `Frame` struct, used to detect mismatching software versions
+            uint32_t frame_size;
+            /// Number of slots, always `BUGSY_RPI_TELEMETRY_SLOTS`
+            uint32_t slots;
+            /// Index of the next frame to be written (wrapping), the latest frame has the index `head - 1`
+            std::atomic<uint32_t> head;
+
+            Slot slot [BUGSY_RPI_TELEMETRY_SLOTS];
+        };
+
+        /// Magic value marking an initialized ring ("BGTL")
+        static constexpr uint32_t RING_MAGIC = 0x4C544742;
+
+        static_assert((BUGSY_RPI_TELEMETRY_SLOTS & (BUGSY_RPI_TELEMETRY_SLOTS - 1)) == 0, "Telemetry slots have to be a power of two");
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared memory atomics have to be lock free");
+
+        /// The single writer of the telemetry ring
+        class Writer {
+        public:
+            Writer() = default;
+            ~Writer();
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            /// @brief Creates (or reuses) the shared memory object with the given `name`, the slots a previous writer left
+            /// in the middle of a publish are released
+            /// @return Whether the ring could be mapped
+            bool open(const char* name = BUGSY_RPI_TELEMETRY_SHM);
+
+            /// @brief Unmaps the ring, the shared memory object stays available for readers
+            void close();
+
+            /// @brief Publishes a new frame to all readers
+            void publish(const Frame* frame);
+
+        private:
+            Ring* ring = nullptr;
+        };
+
+        /// A reader of the telemetry ring, every reader follows the ring at its own pace
+        class Reader {
+        public:
+            Reader() = default;
+            ~Reader();
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            /// @brief Maps the shared memory object with the given `name` read-only
+            /// @return Whether the ring exists and matches the layout of this software version
+            bool open(const char* name = BUGSY_RPI_TELEMETRY_SHM);
+
+            /// @brief Unmaps the ring
+            void close();
+
+            /// @brief Copies the next frame not yet read by this reader into `frame`
+            /// @return `false` if no new frame is available, or its slot stayed locked by the writer (tried again by the
+            /// next call)
+            bool next(Frame* frame);
+
+            /// @brief Copies the latest frame into `frame`, skipping all frames in between
+            /// @return `false` if no frame has been published yet, or its slot stayed locked by the writer
+            bool latest(Frame* frame);
+
+            /// @brief Amount of frames overwritten before this reader could read them
+            uint32_t missed() const { return this->missed_frames; }
+
+        private:
+            /// Outcome of copying a slot
+            enum class Copy {
+                DONE,
+                /// The slot already holds a newer frame
+                OVERWRITTEN,
+                /// The slot stayed odd or kept changing for `BUGSY_RPI_TELEMETRY_READ_RETRIES` attempts
+                BUSY
+            };
+
+            /// Attempts to copy the frame with the given `index`
+            Copy read(uint32_t index, Frame* frame);
+
+            const Ring* ring = nullptr;
+            uint32_t tail = 0;
+            uint32_t missed_frames = 0;
+        };
+    }
+}
@@ -0,0 +1,49 @@
+// ###############################
+// #    BUGSY-RPI THREAD POOL    #
+// ###############################
+//
+// Fixed amount of worker threads processing queued tasks
+
+# pragma once
+
+# include <condition_variable>
+# include <deque>
+# include <functional>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+namespace bugsy_rpi {
+    /// A fixed set of worker threads executing tasks in submission order
+    class ThreadPool {
+    public:
+        typedef std::function<void()> Task;
+
+        /// @brief Starts `workers` threads, `0` uses one thread per CPU
+        explicit ThreadPool(size_t workers = 0);
+        /// @brief Finishes all queued tasks and joins the workers
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// @brief Queues a task to be executed by the next free worker
+        void submit(Task task);
+
+        /// @brief The amount of worker threads
+        size_t size() const { return this->workers.size(); }
+
+        /// @brief The amount of tasks that are queued or currently being executed
+        size_t pending();
+
+    private:
+        void run();
+
+        std::vector<std::thread> workers;
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::condition_variable cond;
+        size_t active = 0;
+        bool stopping = false;
+    };
+}
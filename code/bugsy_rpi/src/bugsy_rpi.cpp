@@ -0,0 +1,15 @@
+# include "bugsy_rpi.hpp"
+
+# include <time.h>
+
+namespace bugsy_rpi {
+    uint64_t micros() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+    }
+
+    uint64_t millis() {
+        return micros() / 1000;
+    }
+}
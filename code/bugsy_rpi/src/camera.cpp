@@ -0,0 +1,483 @@
+# include "camera.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <setjmp.h>
+# include <string.h>
+# include <sys/ioctl.h>
+# include <sys/socket.h>
+# include <sys/uio.h>
+# include <unistd.h>
+
+# include <linux/sockios.h>
+
+# include <jpeglib.h>
+# include <jerror.h>
+
+namespace bugsy_rpi {
+    namespace camera {
+        // Metrics
+            void Metrics::record(uint64_t latency) {
+                this->frames.fetch_add(1, std::memory_order_relaxed);
+                this->latency_sum.fetch_add(latency, std::memory_order_relaxed);
+
+                uint64_t max = this->latency_max.load(std::memory_order_relaxed);
+                while ((latency > max) && !this->latency_max.compare_exchange_weak(max, latency, std::memory_order_relaxed)) { }
+            }
+
+            void Metrics::drop() {
+                this->dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Metrics::Report Metrics::report() {
+                uint64_t now = micros();
+                uint64_t frames = this->frames.load(std::memory_order_relaxed);
+                uint64_t dropped = this->dropped.load(std::memory_order_relaxed);
+                uint64_t latency_sum = this->latency_sum.load(std::memory_order_relaxed);
+                uint64_t latency_max = this->latency_max.exchange(0, std::memory_order_relaxed);
+
+                Report report = {};
+                report.frames = frames - this->last_frames;
+                report.dropped = dropped - this->last_dropped;
+                report.latency_max_ms = latency_max / 1000.0;
+
+                if (report.frames) {
+                    report.latency_avg_ms = (latency_sum - this->last_latency_sum) / 1000.0 / report.frames;
+                }
+
+                if (now > this->last_stamp) {
+                    report.fps = report.frames * 1000000.0 / (now - this->last_stamp);
+                }
+
+                this->last_frames = frames;
+                this->last_dropped = dropped;
+                this->last_latency_sum = latency_sum;
+                this->last_stamp = now;
+
+                return report;
+            }
+
+            /// Logs a single metrics report
+            static void log_report(const char* name, Metrics& metrics) {
+                Metrics::Report report = metrics.report();
+
+                log_info("| > " << name << ": " << report.fps << " fps, ");
+                log_info("latency " << report.latency_avg_ms << " ms (max " << report.latency_max_ms << " ms)");
+                log_infoln(", dropped " << report.dropped);
+            }
+        //
+
+        // Downscale
+            Downscale::Downscale(uint32_t factor, uint32_t max_width, uint32_t max_height, size_t buffers)
+                : Stage("downscale"), factor(factor), pool(buffers, (max_width / factor) * (max_height / factor) * 2)
+            { }
+
+            FrameRef Downscale::process(const FrameRef& frame) {
+                const FrameInfo& in = frame->info;
+
+                if ((in.format != PixelFormat::YUYV) || (this->factor <= 1)) {
+                    return frame;
+                }
+
+                FrameRef out = this->pool.acquire();
+
+                if (!out) {
+                    return out;
+                }
+
+                const uint32_t f = this->factor;
+                // Output width has to stay even, one macro pixel (`Y0 U Y1 V`) covers two pixels
+                uint32_t width = (in.width / f) & ~1u;
+                uint32_t height = in.height / f;
+                uint32_t stride = width * 2;
+
+                if ((size_t)stride * height > out->capacity) {
+                    return FrameRef();
+                }
+
+                const uint32_t area = f * f;
+
+                for (uint32_t y = 0; y < height; y++) {
+                    uint8_t* dst = out->data + (y * stride);
+
+                    for (uint32_t x = 0; x < (width / 2); x++) {
+                        // The output macro pixel covers `2f` input pixels (`f` macro pixels) of `f` rows
+                        uint32_t y0 = 0, y1 = 0, u = 0, v = 0;
+
+                        for (uint32_t row = 0; row < f; row++) {
+                            const uint8_t* src = frame->data + ((y * f + row) * in.stride) + (x * f * 4);
+
+                            for (uint32_t p = 0; p < (2 * f); p++) {
+                                uint8_t luma = src[((p / 2) * 4) + ((p % 2) * 2)];
+
+                                if (p < f) {
+                                    y0 += luma;
+                                } else {
+                                    y1 += luma;
+                                }
+                            }
+
+                            for (uint32_t m = 0; m < f; m++) {
+                                u += src[(m * 4) + 1];
+                                v += src[(m * 4) + 3];
+                            }
+                        }
+
+                        dst[0] = (uint8_t)(y0 / area);
+                        dst[1] = (uint8_t)(u / area);
+                        dst[2] = (uint8_t)(y1 / area);
+                        dst[3] = (uint8_t)(v / area);
+                        dst += 4;
+                    }
+                }
+
+                out->info = in;
+                out->info.width = width;
+                out->info.height = height;
+                out->info.stride = stride;
+                out->info.size = (size_t)stride * height;
+
+                return out;
+            }
+        //
+
+        // JpegEncoder
+            /// libjpeg destination writing straight into a frame buffer
+            struct JpegDestination {
+                struct jpeg_destination_mgr mgr;
+                FrameBuffer* buffer;
+            };
+
+            /// libjpeg error handler returning to the encoder instead of exiting the process
+            struct JpegError {
+                struct jpeg_error_mgr mgr;
+                jmp_buf jump;
+            };
+
+            static void jpeg_dest_init(j_compress_ptr cinfo) {
+                JpegDestination* dest = (JpegDestination*)cinfo->dest;
+                dest->mgr.next_output_byte = dest->buffer->data;
+                dest->mgr.free_in_buffer = dest->buffer->capacity;
+            }
+
+            static boolean jpeg_dest_overflow(j_compress_ptr cinfo) {
+                // The buffer is sized for the uncompressed image, running out means the data is garbage
+                ERREXIT(cinfo, JERR_BUFFER_SIZE);
+                return FALSE;
+            }
+
+            static void jpeg_dest_term(j_compress_ptr) { }
+
+            static void jpeg_error_exit(j_common_ptr cinfo) {
+                longjmp(((JpegError*)cinfo->err)->jump, 1);
+            }
+
+            JpegEncoder::JpegEncoder(int quality, uint32_t max_width, uint32_t max_height, size_t buffers)
+                : Stage("jpeg"), quality(quality), pool(buffers, max_width * max_height * 2)
+            { }
+
+            FrameRef JpegEncoder::process(const FrameRef& frame) {
+                const FrameInfo& in = frame->info;
+
+                if (in.format != PixelFormat::YUYV) {
+                    return frame;
+                }
+
+                FrameRef out = this->pool.acquire();
+
+                if (!out) {
+                    return out;
+                }
+
+                // One converted scanline per worker thread
+                thread_local std::vector<uint8_t> row;
+                row.resize(in.width * 3);
+
+                struct jpeg_compress_struct cinfo;
+                JpegError error;
+                JpegDestination dest;
+
+                cinfo.err = jpeg_std_error(&error.mgr);
+                error.mgr.error_exit = jpeg_error_exit;
+
+                if (setjmp(error.jump)) {
+                    jpeg_destroy_compress(&cinfo);
+                    return FrameRef();
+                }
+
+                jpeg_create_compress(&cinfo);
+
+                dest.mgr.init_destination = jpeg_dest_init;
+                dest.mgr.empty_output_buffer = jpeg_dest_overflow;
+                dest.mgr.term_destination = jpeg_dest_term;
+                dest.buffer = out.get();
+                cinfo.dest = &dest.mgr;
+
+                cinfo.image_width = in.width;
+                cinfo.image_height = in.height;
+                cinfo.input_components = 3;
+                cinfo.in_color_space = JCS_YCbCr;     // Skips the RGB conversion, YUYV is already YCbCr
+
+                jpeg_set_defaults(&cinfo);
+                jpeg_set_quality(&cinfo, this->quality, TRUE);
+                cinfo.dct_method = JDCT_IFAST;
+
+                jpeg_start_compress(&cinfo, TRUE);
+
+                while (cinfo.next_scanline < cinfo.image_height) {
+                    const uint8_t* src = frame->data + (cinfo.next_scanline * in.stride);
+                    uint8_t* dst = row.data();
+
+                    for (uint32_t x = 0; x < (in.width / 2); x++) {
+                        dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[3];
+                        dst[3] = src[2]; dst[4] = src[1]; dst[5] = src[3];
+                        src += 4;
+                        dst += 6;
+                    }
+
+                    JSAMPROW rows [1] = { row.data() };
+                    jpeg_write_scanlines(&cinfo, rows, 1);
+                }
+
+                jpeg_finish_compress(&cinfo);
+
+                out->info = in;
+                out->info.format = PixelFormat::JPEG;
+                out->info.stride = 0;
+                out->info.size = out->capacity - dest.mgr.free_in_buffer;
+
+                jpeg_destroy_compress(&cinfo);
+
+                return out;
+            }
+        //
+
+        // TcpSink
+            TcpSink::TcpSink(uint16_t port) : port(port) { }
+
+            TcpSink::~TcpSink() {
+                this->stop();
+            }
+
+            bool TcpSink::start() {
+                this->server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+                if (this->server_fd < 0) {
+                    log_errorln("> [ERROR] Failed to create camera socket: " << strerror(errno));
+                    return false;
+                }
+
+                int enable = 1;
+                setsockopt(this->server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+                struct sockaddr_in addr = {};
+                addr.sin_family = AF_INET;
+                addr.sin_addr.s_addr = htonl(INADDR_ANY);
+                addr.sin_port = htons(this->port);
+
+                if ((bind(this->server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) || (listen(this->server_fd, 1) < 0)) {
+                    log_errorln("> [ERROR] Failed to listen on camera port " << this->port << ": " << strerror(errno));
+                    this->stop();
+                    return false;
+                }
+
+                return true;
+            }
+
+            void TcpSink::stop() {
+                if (this->client_fd >= 0) {
+                    close(this->client_fd);
+                    this->client_fd = -1;
+                }
+
+                if (this->server_fd >= 0) {
+                    close(this->server_fd);
+                    this->server_fd = -1;
+                }
+            }
+
+            void TcpSink::accept_client() {
+                int fd = accept4(this->server_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+                if (fd < 0) {
+                    return;
+                }
+
+                // Newest client wins
+                if (this->client_fd >= 0) {
+                    close(this->client_fd);
+                }
+
+                int enable = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+                this->client_fd = fd;
+                log_infoln("> Camera client connected!");
+            }
+
+            void TcpSink::send(const FrameRef& frame) {
+                uint64_t start = micros();
+
+                if (this->server_fd >= 0) {
+                    this->accept_client();
+                }
+
+                if (this->client_fd < 0) {
+                    return;
+                }
+
+                // Only start a frame if it fits into the socket buffer completely, a frame cut in half breaks the stream
+                int queued = 0;
+                int sndbuf = 0;
+                socklen_t optlen = sizeof(sndbuf);
+                getsockopt(this->client_fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &optlen);
+                if (ioctl(this->client_fd, SIOCOUTQ, &queued) < 0) {
+                    queued = 0;
+                }
+
+                if ((size_t)(sndbuf - queued) < (sizeof(StreamHeader) + frame->info.size)) {
+                    this->metrics.drop();
+                    return;
+                }
+
+                StreamHeader header;
+                header.magic = STREAM_MAGIC;
+                header.size = (uint32_t)frame->info.size;
+                header.sequence = frame->info.sequence;
+                header.width = (uint16_t)frame->info.width;
+                header.height = (uint16_t)frame->info.height;
+                header.format = (uint8_t)frame->info.format;
+                header.stamp = frame->info.stamp;
+
+                struct iovec iov [2] = {
+                    { &header, sizeof(header) },
+                    { frame->data, frame->info.size }
+                };
+
+                ssize_t written = writev(this->client_fd, iov, 2);
+
+                if (written < (ssize_t)(sizeof(header) + frame->info.size)) {
+                    log_errorln("> Camera client disconnected!");
+                    close(this->client_fd);
+                    this->client_fd = -1;
+                    return;
+                }
+
+                this->metrics.record(micros() - start);
+            }
+        //
+
+        // Pipeline
+            Pipeline::Pipeline(Source* source, ThreadPool* workers) : source(source), workers(workers) { }
+
+            Pipeline::~Pipeline() {
+                this->stop();
+            }
+
+            void Pipeline::add_stage(Stage* stage) {
+                this->stages.push_back(stage);
+            }
+
+            void Pipeline::add_sink(Sink* sink) {
+                this->sinks.push_back(sink);
+            }
+
+            bool Pipeline::start() {
+                if (!this->source->start()) {
+                    return false;
+                }
+
+                this->running = true;
+                this->capture_thread = std::thread(&Pipeline::capture_loop, this);
+
+                return true;
+            }
+
+            void Pipeline::stop() {
+                if (!this->running.exchange(false)) {
+                    return;
+                }
+
+                this->capture_thread.join();
+
+                while (this->in_flight.load()) {
+                    std::this_thread::yield();
+                }
+
+                this->source->stop();
+            }
+
+            void Pipeline::log_metrics() {
+                log_infoln("> Camera pipeline (" << this->source->name() << ")");
+                log_report("capture", this->capture_metrics);
+
+                for (Stage* stage : this->stages) {
+                    log_report(stage->name(), stage->metrics);
+                }
+
+                log_report("delivery", this->delivery_metrics);
+            }
+
+            void Pipeline::capture_loop() {
+                while (this->running) {
+                    uint64_t start = micros();
+                    FrameRef frame = this->source->capture();
+
+                    if (!frame) {
+                        this->capture_metrics.drop();
+                        continue;
+                    }
+
+                    this->capture_metrics.record(micros() - start);
+
+                    // Never queue more frames than there are workers, a backlog would only add latency and keep
+                    // source buffers (possibly the driver's) occupied
+                    if (this->in_flight.load() >= this->workers->size()) {
+                        this->capture_metrics.drop();
+                        continue;
+                    }
+
+                    this->in_flight++;
+                    this->workers->submit([this, frame] () mutable {
+                        this->process(std::move(frame));
+                        this->in_flight--;
+                    });
+                }
+            }
+
+            void Pipeline::process(FrameRef frame) {
+                for (Stage* stage : this->stages) {
+                    uint64_t start = micros();
+                    FrameRef out = stage->process(frame);
+
+                    if (!out) {
+                        stage->metrics.drop();
+                        return;
+                    }
+
+                    stage->metrics.record(micros() - start);
+                    frame = std::move(out);     // Releases the input buffer early
+                }
+
+                std::lock_guard<std::mutex> lock (this->delivery_mutex);
+
+                // Frames finishing out of order would make the stream jump back in time
+                if (this->delivered_any && ((int32_t)(frame->info.sequence - this->delivered_sequence) <= 0)) {
+                    this->delivery_metrics.drop();
+                    return;
+                }
+
+                this->delivered_any = true;
+                this->delivered_sequence = frame->info.sequence;
+
+                for (Sink* sink : this->sinks) {
+                    sink->send(frame);
+                }
+
+                this->delivery_metrics.record(micros() - frame->info.stamp);
+            }
+        //
+    }
+}
@@ -0,0 +1,299 @@
+# include "camera.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <poll.h>
+# include <string.h>
+# include <sys/ioctl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+
+# include <linux/videodev2.h>
+
+namespace bugsy_rpi {
+    namespace camera {
+        /// `ioctl()` retrying on interrupts
+        static int xioctl(int fd, unsigned long request, void* arg) {
+            int res;
+
+            do {
+                res = ioctl(fd, request, arg);
+            } while ((res < 0) && (errno == EINTR));
+
+            return res;
+        }
+
+        // V4L2Source
+            V4L2Source::V4L2Source(const char* device, uint32_t width, uint32_t height, uint32_t buffers)
+                : device(device), width(width), height(height), buffer_count(buffers)
+            { }
+
+            V4L2Source::~V4L2Source() {
+                this->stop();
+            }
+
+            bool V4L2Source::start() {
+                this->fd = open(this->device.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+                if (this->fd < 0) {
+                    log_errorln("> [ERROR] Failed to open camera '" << this->device << "': " << strerror(errno));
+                    return false;
+                }
+
+                struct v4l2_format fmt = {};
+                fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                fmt.fmt.pix.width = this->width;
+                fmt.fmt.pix.height = this->height;
+                fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+                fmt.fmt.pix.field = V4L2_FIELD_NONE;
+
+                if ((xioctl(this->fd, VIDIOC_S_FMT, &fmt) < 0) || (fmt.fmt.pix.pixelformat != V4L2_PIX_FMT_YUYV)) {
+                    log_errorln("> [ERROR] Camera does not support YUYV capture!");
+                    this->stop();
+                    return false;
+                }
+
+                // The driver may adjust the resolution
+                this->width = fmt.fmt.pix.width;
+                this->height = fmt.fmt.pix.height;
+                this->stride = fmt.fmt.pix.bytesperline;
+
+                struct v4l2_requestbuffers req = {};
+                req.count = this->buffer_count;
+                req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                req.memory = V4L2_MEMORY_MMAP;
+
+                if ((xioctl(this->fd, VIDIOC_REQBUFS, &req) < 0) || (req.count < 2)) {
+                    log_errorln("> [ERROR] Camera does not support mmap buffers!");
+                    this->stop();
+                    return false;
+                }
+
+                size_t capacity = 0;
+
+                for (uint32_t i = 0; i < req.count; i++) {
+                    struct v4l2_buffer buf = {};
+                    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                    buf.memory = V4L2_MEMORY_MMAP;
+                    buf.index = i;
+
+                    if (xioctl(this->fd, VIDIOC_QUERYBUF, &buf) < 0) {
+                        this->stop();
+                        return false;
+                    }
+
+                    void* addr = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, buf.m.offset);
+
+                    if (addr == MAP_FAILED) {
+                        log_errorln("> [ERROR] Failed to map camera buffer: " << strerror(errno));
+                        this->stop();
+                        return false;
+                    }
+
+                    this->mappings.push_back((uint8_t*)addr);
+                    this->mapping_sizes.push_back(buf.length);
+                    capacity = (capacity && (capacity < buf.length)) ? capacity : buf.length;
+                }
+
+                // The pool hands out the driver's buffers directly, releasing one gives it back to the driver
+                this->pool.reset(new FramePool(this->mappings, capacity, [this] (uint32_t id) { this->requeue(id); }));
+
+                for (uint32_t i = 0; i < this->mappings.size(); i++) {
+                    this->requeue(i);
+                }
+
+                enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                if (xioctl(this->fd, VIDIOC_STREAMON, &type) < 0) {
+                    log_errorln("> [ERROR] Failed to start camera stream: " << strerror(errno));
+                    this->stop();
+                    return false;
+                }
+
+                return true;
+            }
+
+            void V4L2Source::stop() {
+                if (this->fd < 0) {
+                    return;
+                }
+
+                enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                xioctl(this->fd, VIDIOC_STREAMOFF, &type);
+
+                // All frames have to be released before, see `Pipeline::stop()`
+                for (size_t i = 0; i < this->mappings.size(); i++) {
+                    munmap(this->mappings[i], this->mapping_sizes[i]);
+                }
+
+                this->mappings.clear();
+                this->mapping_sizes.clear();
+
+                close(this->fd);
+                this->fd = -1;
+            }
+
+            void V4L2Source::requeue(uint32_t id) {
+                if (this->fd < 0) {
+                    return;
+                }
+
+                struct v4l2_buffer buf = {};
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.memory = V4L2_MEMORY_MMAP;
+                buf.index = id;
+
+                xioctl(this->fd, VIDIOC_QBUF, &buf);
+            }
+
+            FrameRef V4L2Source::capture() {
+                struct pollfd pfd = { this->fd, POLLIN, 0 };
+
+                if (poll(&pfd, 1, 1000) <= 0) {
+                    return FrameRef();
+                }
+
+                struct v4l2_buffer buf = {};
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.memory = V4L2_MEMORY_MMAP;
+
+                if (xioctl(this->fd, VIDIOC_DQBUF, &buf) < 0) {
+                    return FrameRef();
+                }
+
+                FrameRef frame = this->pool->adopt(buf.index);
+
+                frame->info.width = this->width;
+                frame->info.height = this->height;
+                frame->info.stride = this->stride;
+                frame->info.format = PixelFormat::YUYV;
+                frame->info.sequence = this->sequence++;
+                frame->info.stamp = micros();
+                frame->info.size = buf.bytesused;
+
+                return frame;
+            }
+        //
+
+        // SyntheticSource
+            SyntheticSource::SyntheticSource(uint32_t width, uint32_t height, uint32_t fps)
+                : width(width & ~1u), height(height), interval(1000000 / fps), pool(BUGSY_RPI_CAMERA_BUFFERS, (size_t)width * height * 2)
+            { }
+
+            bool SyntheticSource::start() {
+                this->next_stamp = micros();
+                return true;
+            }
+
+            void SyntheticSource::pace() {
+                uint64_t now = micros();
+
+                if (this->next_stamp > now) {
+                    usleep(this->next_stamp - now);
+                }
+
+                this->next_stamp += this->interval;
+
+                // Do not try to catch up after a stall
+                if (this->next_stamp < now) {
+                    this->next_stamp = now + this->interval;
+                }
+            }
+
+            FrameRef SyntheticSource::capture() {
+                this->pace();
+
+                FrameRef frame = this->pool.acquire();
+
+                if (!frame) {
+                    return frame;
+                }
+
+                uint32_t stride = this->width * 2;
+                uint32_t offset = this->sequence * 4;
+
+                // Diagonal luma gradient moving with every frame, color bars in the chroma channels
+                for (uint32_t y = 0; y < this->height; y++) {
+                    uint8_t* row = frame->data + (y * stride);
+
+                    for (uint32_t x = 0; x < this->width; x += 2) {
+                        row[0] = (uint8_t)(x + y + offset);
+                        row[1] = (uint8_t)((x * 8 / this->width) * 32);
+                        row[2] = (uint8_t)(x + 1 + y + offset);
+                        row[3] = (uint8_t)(255 - (y * 8 / this->height) * 32);
+                        row += 4;
+                    }
+                }
+
+                frame->info.width = this->width;
+                frame->info.height = this->height;
+                frame->info.stride = stride;
+                frame->info.format = PixelFormat::YUYV;
+                frame->info.sequence = this->sequence++;
+                frame->info.stamp = micros();
+                frame->info.size = (size_t)stride * this->height;
+
+                return frame;
+            }
+        //
+
+        // FileSource
+            FileSource::FileSource(const char* path, uint32_t width, uint32_t height, uint32_t fps)
+                : SyntheticSource(width, height, fps), path(path)
+            { }
+
+            FileSource::~FileSource() {
+                this->stop();
+            }
+
+            bool FileSource::start() {
+                this->file = fopen(this->path.c_str(), "rb");
+
+                if (!this->file) {
+                    log_errorln("> [ERROR] Failed to open frame file '" << this->path << "': " << strerror(errno));
+                    return false;
+                }
+
+                return SyntheticSource::start();
+            }
+
+            void FileSource::stop() {
+                if (this->file) {
+                    fclose(this->file);
+                    this->file = nullptr;
+                }
+            }
+
+            FrameRef FileSource::capture() {
+                this->pace();
+
+                FrameRef frame = this->pool.acquire();
+
+                if (!frame) {
+                    return frame;
+                }
+
+                uint32_t stride = this->width * 2;
+                size_t size = (size_t)stride * this->height;
+
+                if (fread(frame->data, 1, size, this->file) != size) {
+                    // Loop back to the first frame
+                    rewind(this->file);
+
+                    if (fread(frame->data, 1, size, this->file) != size) {
+                        return FrameRef();
+                    }
+                }
+
+                frame->info.width = this->width;
+                frame->info.height = this->height;
+                frame->info.stride = stride;
+                frame->info.format = PixelFormat::YUYV;
+                frame->info.sequence = this->sequence++;
+                frame->info.stamp = micros();
+                frame->info.size = size;
+
+                return frame;
+            }
+        //
+    }
+}
@@ -0,0 +1,119 @@
+# include "frame.hpp"
+
+namespace bugsy_rpi {
+    namespace camera {
+        // FrameRef
+            FrameRef::FrameRef(const FrameRef& other) : buffer(other.buffer) {
+                if (this->buffer) {
+                    this->buffer->refs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            FrameRef::FrameRef(FrameRef&& other) noexcept : buffer(other.buffer) {
+                other.buffer = nullptr;
+            }
+
+            FrameRef& FrameRef::operator=(const FrameRef& other) {
+                if (this != &other) {
+                    FrameRef copy (other);
+                    *this = std::move(copy);
+                }
+
+                return *this;
+            }
+
+            FrameRef& FrameRef::operator=(FrameRef&& other) noexcept {
+                if (this != &other) {
+                    this->reset();
+                    this->buffer = other.buffer;
+                    other.buffer = nullptr;
+                }
+
+                return *this;
+            }
+
+            FrameRef::~FrameRef() {
+                this->reset();
+            }
+
+            void FrameRef::reset() {
+                if (this->buffer) {
+                    // Last reference, all writes to the buffer have to be visible to the next user
+                    if (this->buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        this->buffer->pool->release(this->buffer);
+                    }
+
+                    this->buffer = nullptr;
+                }
+            }
+        //
+
+        // FramePool
+            FramePool::FramePool(size_t count, size_t capacity) {
+                this->memory.reset(new uint8_t [count * capacity]);
+                this->init(count, capacity);
+
+                for (size_t i = 0; i < count; i++) {
+                    this->buffers[i].data = this->memory.get() + (i * capacity);
+                }
+            }
+
+            FramePool::FramePool(const std::vector<uint8_t*>& storage, size_t capacity, ReleaseHandler on_release)
+                : on_release(std::move(on_release))
+            {
+                this->init(storage.size(), capacity);
+
+                for (size_t i = 0; i < storage.size(); i++) {
+                    this->buffers[i].data = storage[i];
+                }
+            }
+
+            void FramePool::init(size_t count, size_t capacity) {
+                this->buffers.reset(new FrameBuffer [count]);
+                this->buffer_count = count;
+                this->buffer_capacity = capacity;
+
+                for (size_t i = 0; i < count; i++) {
+                    this->buffers[i].info = {};
+                    this->buffers[i].capacity = capacity;
+                    this->buffers[i].refs.store(0, std::memory_order_relaxed);
+                    this->buffers[i].pool = this;
+                    this->buffers[i].id = (uint32_t)i;
+                }
+            }
+
+            FrameRef FramePool::acquire() {
+                uint32_t start = this->next.fetch_add(1, std::memory_order_relaxed);
+
+                for (size_t i = 0; i < this->buffer_count; i++) {
+                    FrameBuffer& buffer = this->buffers[(start + i) % this->buffer_count];
+                    uint32_t free = 0;
+
+                    if (buffer.refs.compare_exchange_strong(free, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        buffer.info = {};
+                        return FrameRef(&buffer);
+                    }
+                }
+
+                this->exhausted_count.fetch_add(1, std::memory_order_relaxed);
+                return FrameRef();
+            }
+
+            FrameRef FramePool::adopt(uint32_t id) {
+                if (id >= this->buffer_count) {
+                    return FrameRef();
+                }
+
+                FrameBuffer& buffer = this->buffers[id];
+                buffer.refs.store(1, std::memory_order_release);
+                return FrameRef(&buffer);
+            }
+
+            void FramePool::release(FrameBuffer* buffer) {
+                if (this->on_release) {
+                    this->on_release(buffer->id);
+                }
+            }
+        //
+    }
+}
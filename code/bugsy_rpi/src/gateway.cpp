@@ -0,0 +1,679 @@
+# include "gateway.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <netdb.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <string.h>
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+# include <sys/socket.h>
+# include <time.h>
+# include <unistd.h>
+
+# include "io.hpp"
+
+using bugsy::Command;
+
+/// Kinds of file descriptors registered in the epoll instance, stored in the upper half of the event data
+enum FdKind : uint64_t {
+    FD_WAKE = 1,
+    FD_LISTEN = 2,
+    FD_ROBOT = 3,
+    FD_CLIENT = 4
+};
+
+static uint64_t fd_data(FdKind kind, uint32_t value) {
+    return ((uint64_t)kind << 32) | value;
+}
+
+/// CPU time of the calling thread in microseconds
+static uint64_t thread_cpu_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+namespace bugsy_rpi {
+    namespace gateway {
+        // Links
+            Link::~Link() {
+                if (this->fd >= 0) {
+                    ::close(this->fd);
+                }
+            }
+
+            std::unique_ptr<Link> open_serial(const char* device, uint32_t baud) {
+                int fd = io::open_serial(device, baud, O_NONBLOCK);
+
+                if (fd < 0) {
+                    return nullptr;
+                }
+
+                return std::unique_ptr<Link>(new Link(fd, device));
+            }
+
+            std::unique_ptr<Link> open_tcp(const char* host, uint16_t port) {
+                struct addrinfo hints = { };
+                struct addrinfo* result = nullptr;
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+
+                std::string service = std::to_string(port);
+                if (getaddrinfo(host, service.c_str(), &hints, &result) != 0) {
+                    log_errorln("> [ERROR] Failed to resolve '" << host << "'!");
+                    return nullptr;
+                }
+
+                int fd = -1;
+                for (struct addrinfo* addr = result; addr; addr = addr->ai_next) {
+                    fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+
+                    if ((fd >= 0) && (connect(fd, addr->ai_addr, addr->ai_addrlen) == 0)) {
+                        break;
+                    }
+
+                    if (fd >= 0) {
+                        ::close(fd);
+                        fd = -1;
+                    }
+                }
+
+                freeaddrinfo(result);
+
+                if (fd < 0) {
+                    log_errorln("> [ERROR] Failed to connect to '" << host << ":" << port << "'!");
+                    return nullptr;
+                }
+
+                // Commands are tiny, they must not wait for more data
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+                return std::unique_ptr<Link>(new Link(fd, std::string(host) + ":" + service));
+            }
+
+            std::unique_ptr<Link> open_link(const std::string& spec) {
+                size_t colon = spec.find(':');
+                std::string kind = spec.substr(0, colon);
+                std::string rest = (colon == std::string::npos) ? "" : spec.substr(colon + 1);
+
+                if (kind == "serial") {
+                    size_t baud_colon = rest.rfind(':');
+                    uint32_t baud = BUGSY_UART_CORE_TO_RPI_BAUD;
+
+                    if (baud_colon != std::string::npos) {
+                        baud = (uint32_t)std::stoul(rest.substr(baud_colon + 1));
+                        rest = rest.substr(0, baud_colon);
+                    }
+
+                    return open_serial(rest.c_str(), baud);
+                }
+
+                if (kind == "pty") {
+                    return open_serial(rest.c_str(), 0);
+                }
+
+                if (kind == "tcp") {
+                    size_t port_colon = rest.rfind(':');
+
+                    if (port_colon != std::string::npos) {
+                        return open_tcp(rest.substr(0, port_colon).c_str(), (uint16_t)std::stoul(rest.substr(port_colon + 1)));
+                    }
+                }
+
+                log_errorln("> [ERROR] Invalid link '" << spec << "'!");
+                return nullptr;
+            }
+        //
+
+        // Gateway
+            Gateway::Gateway() {
+                this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+                this->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+                struct epoll_event event = { };
+                event.events = EPOLLIN;
+                event.data.u64 = fd_data(FD_WAKE, 0);
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->wake_fd, &event);
+            }
+
+            Gateway::~Gateway() {
+                for (auto& client : this->clients) {
+                    ::close(client.first);
+                }
+
+                if (this->listen_fd >= 0) {
+                    ::close(this->listen_fd);
+                }
+
+                ::close(this->wake_fd);
+                ::close(this->epoll_fd);
+            }
+
+            RobotId Gateway::add(std::unique_ptr<Link> link) {
+                RobotId id = (RobotId)this->fleet.size();
+
+                struct epoll_event event = { };
+                event.events = EPOLLIN;
+                event.data.u64 = fd_data(FD_ROBOT, id);
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, link->fd, &event);
+
+                this->fleet.emplace_back();
+                Robot& robot = this->fleet.back();
+                robot.link = std::move(link);
+                robot.telemetry.connected = 1;
+
+                // Spread the polls of the fleet over the interval
+                this->deadlines.push({ millis() + (id % BUGSY_GATEWAY_POLL_INTERVAL), Deadline::POLL, id, 0 });
+
+                return id;
+            }
+
+            bool Gateway::listen(uint16_t port) {
+                this->listen_fd = socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+
+                int one = 1;
+                setsockopt(this->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+                struct sockaddr_in6 addr = { };
+                addr.sin6_family = AF_INET6;
+                addr.sin6_addr = in6addr_any;
+                addr.sin6_port = htons(port);
+
+                if ((bind(this->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) || (::listen(this->listen_fd, 16) < 0)) {
+                    log_errorln("> [ERROR] Failed to listen on port " << port << ": " << strerror(errno));
+                    ::close(this->listen_fd);
+                    this->listen_fd = -1;
+                    return false;
+                }
+
+                struct epoll_event event = { };
+                event.events = EPOLLIN;
+                event.data.u64 = fd_data(FD_LISTEN, 0);
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->listen_fd, &event);
+
+                return true;
+            }
+
+            void Gateway::submit(RobotId robot, const uint8_t* cmd, size_t len, size_t expected, Callback callback) {
+                Request request;
+                request.cmd.assign(cmd, cmd + len);
+                request.expected = expected;
+                request.callback = std::move(callback);
+
+                {
+                    std::lock_guard<std::mutex> lock (this->inbox_mutex);
+                    this->inbox.emplace_back(robot, std::move(request));
+                }
+
+                uint64_t one = 1;
+                if (write(this->wake_fd, &one, sizeof(one)) < 0) {
+                    // Counter is already set, the loop wakes up anyway
+                }
+            }
+
+            void Gateway::stop() {
+                this->running = false;
+
+                uint64_t one = 1;
+                if (write(this->wake_fd, &one, sizeof(one)) < 0) {
+                    // See `submit()`
+                }
+            }
+
+            std::vector<RobotTelemetry> Gateway::telemetry() const {
+                std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                std::vector<RobotTelemetry> result;
+                result.reserve(this->fleet.size());
+
+                for (const Robot& robot : this->fleet) {
+                    result.push_back(robot.telemetry);
+                }
+
+                return result;
+            }
+
+            Stats Gateway::stats() const {
+                std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                return this->loop_stats;
+            }
+
+            void Gateway::run() {
+                std::vector<struct epoll_event> events (64);
+                uint64_t cpu_start = thread_cpu_time();
+
+                this->running = true;
+
+                while (this->running) {
+                    int timeout = -1;
+
+                    if (!this->deadlines.empty()) {
+                        uint64_t now = millis();
+                        uint64_t at = this->deadlines.top().at;
+                        timeout = (at > now) ? (int)(at - now) : 0;
+                    }
+
+                    int count = epoll_wait(this->epoll_fd, events.data(), (int)events.size(), timeout);
+
+                    for (int i = 0; i < count; i++) {
+                        uint64_t data = events[i].data.u64;
+                        uint32_t value = (uint32_t)data;
+
+                        switch ((FdKind)(data >> 32)) {
+                            case FD_WAKE: {
+                                uint64_t counter;
+                                if (read(this->wake_fd, &counter, sizeof(counter)) < 0) {
+                                    // Already reset
+                                }
+
+                                this->handle_inbox();
+                                break;
+                            }
+
+                            case FD_LISTEN:
+                                this->accept_clients();
+                                break;
+
+                            case FD_ROBOT:
+                                this->handle_robot((RobotId)value);
+                                break;
+
+                            case FD_CLIENT:
+                                this->handle_client((int)value, events[i].events);
+                                break;
+                        }
+                    }
+
+                    this->handle_timers();
+
+                    std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                    this->loop_stats.wakeups++;
+                    this->loop_stats.cpu_time = thread_cpu_time() - cpu_start;
+                }
+            }
+
+            void Gateway::handle_inbox() {
+                std::vector<std::pair<RobotId, Request>> pending;
+
+                {
+                    std::lock_guard<std::mutex> lock (this->inbox_mutex);
+                    pending.swap(this->inbox);
+                }
+
+                for (auto& entry : pending) {
+                    this->enqueue(entry.first, std::move(entry.second));
+                }
+            }
+
+            void Gateway::enqueue(RobotId id, Request request) {
+                if (id >= this->fleet.size()) {
+                    request.callback(Status::UNKNOWN_ROBOT, nullptr, 0);
+                    return;
+                }
+
+                Robot& robot = this->fleet[id];
+
+                if (!robot.telemetry.connected) {
+                    request.callback(Status::DISCONNECTED, nullptr, 0);
+                    return;
+                }
+
+                if (robot.queue.size() >= BUGSY_GATEWAY_QUEUE_SIZE) {
+                    request.callback(Status::QUEUE_FULL, nullptr, 0);
+                    return;
+                }
+
+                robot.queue.push_back(std::move(request));
+                this->send_next(id);
+            }
+
+            void Gateway::send_next(RobotId id) {
+                Robot& robot = this->fleet[id];
+
+                if (robot.busy || robot.queue.empty() || !robot.telemetry.connected) {
+                    return;
+                }
+
+                uint64_t now = millis();
+
+                if (now < robot.ready_at) {
+                    if (!robot.ready_pending) {
+                        robot.ready_pending = true;
+                        this->deadlines.push({ robot.ready_at, Deadline::READY, id, 0 });
+                    }
+
+                    return;
+                }
+
+                robot.current = std::move(robot.queue.front());
+                robot.queue.pop_front();
+                robot.rx.clear();
+
+                const uint8_t* bytes = robot.current.cmd.data();
+                size_t len = robot.current.cmd.size();
+
+                while (len) {
+                    ssize_t written = write(robot.link->fd, bytes, len);
+
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+
+                        // Commands are far smaller than any kernel buffer, a full buffer means the robot is gone
+                        robot.busy = true;
+                        this->disconnect(id);
+                        return;
+                    }
+
+                    bytes += written;
+                    len -= written;
+                }
+
+                if (robot.current.expected == 0) {
+                    robot.ready_at = now + BUGSY_GATEWAY_FRAME_GAP;
+                    robot.busy = true;
+                    this->complete(id, Status::OK);
+                    return;
+                }
+
+                robot.busy = true;
+                robot.serial++;
+                this->deadlines.push({ now + BUGSY_GATEWAY_TIMEOUT, Deadline::TIMEOUT, id, robot.serial });
+            }
+
+            void Gateway::complete(RobotId id, Status status) {
+                Robot& robot = this->fleet[id];
+                Request request = std::move(robot.current);
+                robot.busy = false;
+
+                {
+                    std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+
+                    if (status == Status::OK) {
+                        robot.telemetry.requests++;
+                        this->loop_stats.completed++;
+                    } else if (status == Status::TIMEOUT) {
+                        robot.telemetry.timeouts++;
+                        this->loop_stats.timeouts++;
+                    }
+                }
+
+                size_t len = (status == Status::OK) ? request.expected : 0;
+                request.callback(status, robot.rx.data(), len);
+
+                this->send_next(id);
+            }
+
+            void Gateway::handle_robot(RobotId id) {
+                Robot& robot = this->fleet[id];
+                uint8_t buffer [256];
+
+                while (true) {
+                    ssize_t received = read(robot.link->fd, buffer, sizeof(buffer));
+
+                    if (received == 0) {
+                        this->disconnect(id);
+                        return;
+                    }
+
+                    if (received < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+
+                        if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                            this->disconnect(id);
+                        }
+
+                        return;
+                    }
+
+                    // Bytes without a request waiting are late answers of timed out requests
+                    if (robot.busy) {
+                        robot.rx.insert(robot.rx.end(), buffer, buffer + received);
+
+                        if (robot.rx.size() >= robot.current.expected) {
+                            this->complete(id, Status::OK);
+                        }
+                    }
+                }
+            }
+
+            void Gateway::disconnect(RobotId id) {
+                Robot& robot = this->fleet[id];
+
+                log_errorln("> [ERROR] Lost robot " << id << " ('" << robot.link->name << "')");
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, robot.link->fd, nullptr);
+
+                {
+                    std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                    robot.telemetry.connected = 0;
+                }
+
+                if (robot.busy) {
+                    robot.busy = false;
+                    robot.current.callback(Status::DISCONNECTED, nullptr, 0);
+                }
+
+                while (!robot.queue.empty()) {
+                    Request request = std::move(robot.queue.front());
+                    robot.queue.pop_front();
+                    request.callback(Status::DISCONNECTED, nullptr, 0);
+                }
+            }
+
+            void Gateway::handle_timers() {
+                uint64_t now = millis();
+
+                while (!this->deadlines.empty() && (this->deadlines.top().at <= now)) {
+                    Deadline deadline = this->deadlines.top();
+                    this->deadlines.pop();
+
+                    Robot& robot = this->fleet[deadline.robot];
+
+                    switch (deadline.kind) {
+                        case Deadline::TIMEOUT:
+                            if (robot.busy && (robot.serial == deadline.serial)) {
+                                // Give late answers the time to arrive before the next request is sent
+                                robot.ready_at = now + BUGSY_GATEWAY_FRAME_GAP;
+                                this->complete(deadline.robot, Status::TIMEOUT);
+                            }
+                            break;
+
+                        case Deadline::READY:
+                            robot.ready_pending = false;
+                            this->send_next(deadline.robot);
+                            break;
+
+                        case Deadline::POLL:
+                            if (robot.telemetry.connected) {
+                                this->poll_telemetry(deadline.robot);
+                                this->deadlines.push({ now + BUGSY_GATEWAY_POLL_INTERVAL, Deadline::POLL, deadline.robot, 0 });
+                            }
+                            break;
+                    }
+                }
+            }
+
+            void Gateway::poll_telemetry(RobotId id) {
+                // Polls are skipped while the robot is busy with client requests, so they never pile up
+                if (this->fleet[id].queue.size() > 1) {
+                    return;
+                }
+
+                static const uint8_t GET_STATE = (uint8_t)Command::GetState;
+                static const uint8_t GET_BATTERY = (uint8_t)Command::GetBattery;
+
+                this->enqueue(id, { { GET_STATE }, sizeof(bugsy::CoreState), [this, id] (Status status, const uint8_t* data, size_t) {
+                    if (status == Status::OK) {
+                        std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                        this->fleet[id].telemetry.state = (bugsy::CoreState)data[0];
+                    }
+                } });
+
+                this->enqueue(id, { { GET_BATTERY }, sizeof(bugsy::BatteryState), [this, id] (Status status, const uint8_t* data, size_t) {
+                    if (status == Status::OK) {
+                        std::lock_guard<std::mutex> lock (this->telemetry_mutex);
+                        memcpy(&this->fleet[id].telemetry.battery, data, sizeof(bugsy::BatteryState));
+                        this->fleet[id].telemetry.stamp = micros();
+                    }
+                } });
+            }
+        //
+
+        // Clients
+            void Gateway::accept_clients() {
+                while (true) {
+                    int fd = accept4(this->listen_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+
+                    if (fd < 0) {
+                        return;
+                    }
+
+                    int one = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                    struct epoll_event event = { };
+                    event.events = EPOLLIN;
+                    event.data.u64 = fd_data(FD_CLIENT, (uint32_t)fd);
+                    epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+
+                    this->clients[fd].id = this->next_client_id++;
+                }
+            }
+
+            void Gateway::handle_client(int fd, uint32_t events) {
+                auto it = this->clients.find(fd);
+
+                if (it == this->clients.end()) {
+                    return;
+                }
+
+                Client& client = it->second;
+
+                if (events & EPOLLOUT) {
+                    this->flush_client(fd, client);
+                }
+
+                if (!(events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                    return;
+                }
+
+                uint8_t buffer [4096];
+                ssize_t received = read(fd, buffer, sizeof(buffer));
+
+                if ((received == 0) || ((received < 0) && (errno != EAGAIN) && (errno != EINTR))) {
+                    this->close_client(fd);
+                    return;
+                }
+
+                if (received < 0) {
+                    return;
+                }
+
+                // Callbacks may drop the client while parsing, so the buffer is taken out of it
+                std::vector<uint8_t> rx = std::move(client.rx);
+                rx.insert(rx.end(), buffer, buffer + received);
+
+                // Parse all complete requests
+                size_t offset = 0;
+                uint64_t id = client.id;
+
+                while ((rx.size() - offset) >= sizeof(ClientRequest)) {
+                    ClientRequest header;
+                    memcpy(&header, rx.data() + offset, sizeof(header));
+
+                    if ((rx.size() - offset - sizeof(header)) < header.len) {
+                        break;
+                    }
+
+                    const uint8_t* cmd = rx.data() + offset + sizeof(header);
+                    offset += sizeof(header) + header.len;
+
+                    if (header.robot == FLEET) {
+                        std::vector<RobotTelemetry> fleet = this->telemetry();
+                        this->send_client(fd, id, FLEET, Status::OK, (const uint8_t*)fleet.data(), fleet.size() * sizeof(RobotTelemetry));
+                        continue;
+                    }
+
+                    RobotId robot = header.robot;
+                    Request request;
+                    request.cmd.assign(cmd, cmd + header.len);
+                    request.expected = header.expected;
+                    request.callback = [this, fd, id, robot] (Status status, const uint8_t* data, size_t len) {
+                        this->send_client(fd, id, robot, status, data, len);
+                    };
+
+                    this->enqueue(robot, std::move(request));
+                }
+
+                it = this->clients.find(fd);
+                if ((it != this->clients.end()) && (it->second.id == id)) {
+                    rx.erase(rx.begin(), rx.begin() + offset);
+                    it->second.rx = std::move(rx);
+                }
+            }
+
+            void Gateway::send_client(int fd, uint64_t id, RobotId robot, Status status, const uint8_t* data, size_t len) {
+                auto it = this->clients.find(fd);
+
+                // The client disconnected while the request was pending
+                if ((it == this->clients.end()) || (it->second.id != id)) {
+                    return;
+                }
+
+                Client& client = it->second;
+
+                if ((client.tx.size() + sizeof(ClientResponse) + len) > BUGSY_GATEWAY_CLIENT_BUFFER) {
+                    log_errorln("> [ERROR] Client is not reading its responses, dropping it");
+                    this->close_client(fd);
+                    return;
+                }
+
+                ClientResponse header = { robot, status, 0, (uint16_t)len };
+                const uint8_t* header_bytes = (const uint8_t*)&header;
+
+                client.tx.insert(client.tx.end(), header_bytes, header_bytes + sizeof(header));
+                client.tx.insert(client.tx.end(), data, data + len);
+
+                this->flush_client(fd, client);
+            }
+
+            void Gateway::flush_client(int fd, Client& client) {
+                while (!client.tx.empty()) {
+                    ssize_t written = send(fd, client.tx.data(), client.tx.size(), MSG_NOSIGNAL);
+
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+
+                        break;
+                    }
+
+                    client.tx.erase(client.tx.begin(), client.tx.begin() + written);
+                }
+
+                // Only wait for the socket to become writable while data is left
+                if (client.waiting_out != !client.tx.empty()) {
+                    client.waiting_out = !client.tx.empty();
+
+                    struct epoll_event event = { };
+                    event.events = EPOLLIN | (client.waiting_out ? (uint32_t)EPOLLOUT : 0);
+                    event.data.u64 = fd_data(FD_CLIENT, (uint32_t)fd);
+                    epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event);
+                }
+            }
+
+            void Gateway::close_client(int fd) {
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                ::close(fd);
+                this->clients.erase(fd);
+            }
+        //
+    }
+}
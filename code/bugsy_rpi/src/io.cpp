@@ -0,0 +1,432 @@
+# include "io.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <poll.h>
+# include <string.h>
+# include <sys/ioctl.h>
+# include <unistd.h>
+
+// `termios2` allows arbitrary baud rates like the 250 kbaud used by the core
+# include <asm/termbits.h>
+
+# include <bugsy/batch.hpp>
+# include <bugsy/baud.hpp>
+# include <bugsy/ota.hpp>
+
+using bugsy::Command;
+
+namespace bugsy_rpi {
+    namespace core {
+        bool set_rpi_ready() {
+            return io::send_cmd_core(Command::SetRPiReady);
+        }
+
+        bool get_state(bugsy::CoreState* state) {
+            uint8_t value;
+
+            if (!io::request_u8_core(Command::GetState, &value)) {
+                return false;
+            }
+
+            *state = (bugsy::CoreState)value;
+            return true;
+        }
+
+        bool get_battery(bugsy::BatteryState* battery) {
+            return io::request_msg_core<bugsy::msg::BatteryStateView>(Command::GetBattery, battery);
+        }
+
+        bool get_estop_stats(bugsy::EStopStats* stats) {
+            return io::request_msg_core<bugsy::msg::EStopStatsView>(Command::GetEStopStats, stats);
+        }
+
+        bool get_movement(bugsy::Movement* movement) {
+            return io::request_msg_core<bugsy::msg::MovementView>(Command::GetMovement, movement);
+        }
+
+        bool stop() {
+            return io::send_cmd_core(Command::Stop);
+        }
+
+        bool drive(const bugsy::Velocity* vel) {
+            return io::send_msg_core<bugsy::msg::VelocityBuilder>(Command::Drive, vel);
+        }
+
+        bool drive(const bugsy::Velocity* vel, const bugsy::MoveStamp* stamp) {
+            uint8_t buffer [sizeof(Command) + bugsy::msg::MoveStampBuilder::SIZE + bugsy::msg::VelocityBuilder::SIZE];
+            uint8_t* args = buffer + sizeof(Command);
+
+            buffer[0] = (uint8_t)Command::Drive;
+            bugsy::msg::MoveStampBuilder(args, bugsy::msg::MoveStampBuilder::SIZE).set(*stamp);
+            bugsy::msg::VelocityBuilder(args + bugsy::msg::MoveStampBuilder::SIZE, bugsy::msg::VelocityBuilder::SIZE).set(*vel);
+            return io::write_core(buffer, sizeof(buffer));
+        }
+
+        bool get_move_stats(bugsy::MoveStats* stats) {
+            return io::request_msg_core<bugsy::msg::MoveStatsView>(Command::GetMoveStats, stats);
+        }
+
+        bool sync_clock(bugsy::clock::Estimator* estimator) {
+            uint8_t request [sizeof(Command) + (2 * sizeof(uint32_t))];
+            uint8_t answer [bugsy::msg::ClockSampleView::SIZE];
+            uint32_t sent = (uint32_t)bugsy_rpi::micros();
+
+            request[0] = (uint8_t)Command::SyncClock;
+            bugsy::msg::wire::put_u32(request + sizeof(Command), sent);
+            bugsy::msg::wire::put_u32(request + sizeof(Command) + sizeof(uint32_t), estimator->latest_rtt());
+
+            // The round trip is only reported once there is one
+            size_t len = estimator->synced() ? sizeof(request) : (sizeof(Command) + sizeof(uint32_t));
+
+            io::flush_core();
+
+            if (!io::write_core(request, len) || !io::read_core(answer, sizeof(answer))) {
+                return false;
+            }
+
+            bugsy::ClockSample sample = bugsy::msg::ClockSampleView(answer, sizeof(answer)).get();
+
+            // A late answer to an earlier request would spoil the estimate
+            if (sample.client_send != sent) {
+                return false;
+            }
+
+            estimator->add(sample, (uint32_t)bugsy_rpi::micros());
+            return true;
+        }
+
+        bool get_link_stats(bugsy::Remote remote, bugsy::LinkStats* stats) {
+            uint8_t answer [bugsy::msg::LinkStatsView::SIZE];
+
+            io::flush_core();
+
+            if (!io::send_u8_core(Command::GetLinkStats, (uint8_t)remote) || !io::read_core(answer, sizeof(answer))) {
+                return false;
+            }
+
+            *stats = bugsy::msg::LinkStatsView(answer, sizeof(answer)).get();
+            return true;
+        }
+
+        bool get_failsafe_config(bugsy::FailsafeConfig* config) {
+            return io::request_msg_core<bugsy::msg::FailsafeConfigView>(Command::GetFailsafeConfig, config);
+        }
+
+        bool set_failsafe_config(const bugsy::FailsafeConfig* config) {
+            return io::send_msg_core<bugsy::msg::FailsafeConfigBuilder>(Command::SetFailsafeConfig, config);
+        }
+
+        /// Transport of the baud negotiation (see `bugsy::baud::negotiate()`)
+        struct BaudLink {
+            bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len) {
+                io::flush_core();
+                return io::write_core(cmd, len) && io::read_core(answer, answer_len);
+            }
+
+            void set_baud(uint32_t baud) { io::set_baud(baud); }
+
+            void wait(uint32_t ms) { usleep(ms * 1000); }
+        };
+
+        uint32_t negotiate_baud() {
+            // Ptys forward at any speed, there is nothing to negotiate
+            if (!io::baud) {
+                return 0;
+            }
+
+            BaudLink link;
+            return bugsy::baud::negotiate(link, io::baud, BUGSY_UART_CORE_TO_RPI_MAX_BAUD);
+        }
+
+        bool get_baud_stats(bugsy::Remote remote, bugsy::BaudStats* stats) {
+            uint8_t answer [bugsy::msg::BaudStatsView::SIZE];
+
+            io::flush_core();
+
+            if (!io::send_u8_core(Command::GetBaudStats, (uint8_t)remote) || !io::read_core(answer, sizeof(answer))) {
+                return false;
+            }
+
+            *stats = bugsy::msg::BaudStatsView(answer, sizeof(answer)).get();
+            return true;
+        }
+
+        bool schedule_drive(const bugsy::ScheduledVelocity* scheduled) {
+            return io::send_msg_core<bugsy::msg::ScheduledVelocityBuilder>(Command::ScheduleDrive, scheduled);
+        }
+
+        bool get_schedule_stats(bugsy::ScheduleStats* stats) {
+            return io::request_msg_core<bugsy::msg::ScheduleStatsView>(Command::GetScheduleStats, stats);
+        }
+
+        bool batch(const uint8_t* commands, size_t len, uint8_t* answers, size_t* answers_len) {
+            uint8_t buffer [BUGSY_BATCH_FRAME_SIZE];
+            uint8_t total;
+
+            if ((len + sizeof(Command)) > sizeof(buffer)) {
+                return false;
+            }
+
+            buffer[0] = (uint8_t)Command::Batch;
+            memcpy(buffer + sizeof(Command), commands, len);
+
+            io::flush_core();
+
+            if (!io::write_core(buffer, len + sizeof(Command)) || !io::read_core(&total, sizeof(total))
+                || (total > BUGSY_BATCH_ANSWER_SIZE) || !io::read_core(answers, total)) {
+                return false;
+            }
+
+            *answers_len = total;
+            return true;
+        }
+
+        bool get_drive_calibration(bugsy::DriveCalibration* cal) {
+            return io::request_msg_core<bugsy::msg::DriveCalibrationView>(Command::GetDriveCalibration, cal);
+        }
+
+        bool set_drive_calibration(const bugsy::DriveCalibration* cal) {
+            return io::send_msg_core<bugsy::msg::DriveCalibrationBuilder>(Command::SetDriveCalibration, cal);
+        }
+
+        bool get_speed_stats(bugsy::SpeedStats* stats) {
+            return io::request_msg_core<bugsy::msg::SpeedStatsView>(Command::GetSpeedStats, stats);
+        }
+
+        bool get_speed_gains(bugsy::SpeedGains* gains) {
+            return io::request_msg_core<bugsy::msg::SpeedGainsView>(Command::GetSpeedGains, gains);
+        }
+
+        bool set_speed_gains(const bugsy::SpeedGains* gains) {
+            return io::send_msg_core<bugsy::msg::SpeedGainsBuilder>(Command::SetSpeedGains, gains);
+        }
+
+        bool get_trader_state(bugsy::TraderState* state) {
+            uint8_t value;
+
+            if (!io::request_u8_core(Command::GetTraderState, &value)) {
+                return false;
+            }
+
+            *state = (bugsy::TraderState)value;
+            return true;
+        }
+
+        bool get_primary_sensor_data(bugsy::PrimarySensorData* data) {
+            return io::request_msg_core<bugsy::msg::PrimarySensorDataView>(Command::GetPrimarySensorData, data);
+        }
+
+        bool get_secondary_sensor_data(bugsy::SecondarySensorData* data) {
+            return io::request_msg_core<bugsy::msg::SecondarySensorDataView>(Command::GetSecondarySensorData, data);
+        }
+
+        bool save_config(bugsy::JobTicket* ticket) {
+            return io::request_msg_core<bugsy::msg::JobTicketView>(Command::SaveConfig, ticket);
+        }
+
+        bool get_job_state(uint8_t id, bugsy::JobState* state) {
+            uint8_t value;
+            io::flush_core();
+
+            if (!io::send_u8_core(Command::GetJobState, id) || !io::read_core(&value, sizeof(value))) {
+                return false;
+            }
+
+            *state = (bugsy::JobState)value;
+            return true;
+        }
+
+        /// Transport of the firmware upload (see `bugsy::ota::upload()`)
+        struct OtaLink {
+            bool send(const uint8_t* data, size_t len) { return io::write_core(data, len); }
+
+            bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len) {
+                io::flush_core();
+                return io::write_core(cmd, len) && io::read_core(answer, answer_len);
+            }
+
+            void wait(uint32_t ms) { usleep(ms * 1000); }
+        };
+
+        bool update_firmware(const uint8_t* image, uint32_t size, bool restart, bugsy::OtaStatus* status, bugsy::ota::UploadStats* stats) {
+            OtaLink link;
+            return bugsy::ota::upload(link, image, size, restart, status, stats);
+        }
+
+        bool get_ota_status(bugsy::OtaStatus* status) {
+            return io::request_msg_core<bugsy::msg::OtaStatusView>(Command::GetOtaStatus, status);
+        }
+
+        bool abort_ota(bugsy::OtaStatus* status) {
+            return io::request_msg_core<bugsy::msg::OtaStatusView>(Command::OtaAbort, status);
+        }
+    }
+
+    namespace io {
+        int core_fd = -1;
+        session::Writer* recorder = nullptr;
+        uint32_t baud = 0;
+
+        int open_serial(const char* device, uint32_t baud, int flags) {
+            int fd = open(device, O_RDWR | O_NOCTTY | O_CLOEXEC | flags);
+
+            if (fd < 0) {
+                log_error("> [ERROR] Failed to open core serial '");
+                log_error(device);
+                log_errorln("': " << strerror(errno));
+                return -1;
+            }
+
+            struct termios2 tio;
+            if (ioctl(fd, TCGETS2, &tio) < 0) {
+                log_errorln("> [ERROR] Device is not a serial: " << strerror(errno));
+                ::close(fd);
+                return -1;
+            }
+
+            // Raw 8N1 without any flow control
+            tio.c_iflag = 0;
+            tio.c_oflag = 0;
+            tio.c_lflag = 0;
+            tio.c_cc[VMIN] = 0;
+            tio.c_cc[VTIME] = 0;
+
+            // Ptys have no baud rate
+            if (baud) {
+                tio.c_cflag = CS8 | CREAD | CLOCAL | BOTHER;
+                tio.c_ispeed = baud;
+                tio.c_ospeed = baud;
+            }
+
+            if (ioctl(fd, TCSETS2, &tio) < 0) {
+                log_errorln("> [ERROR] Failed to configure core serial: " << strerror(errno));
+                ::close(fd);
+                return -1;
+            }
+
+            ioctl(fd, TCFLSH, TCIFLUSH);
+            return fd;
+        }
+
+        // Events
+            bool setup(const char* device, uint32_t baud) {
+                core_fd = open_serial(device, baud);
+                io::baud = (core_fd >= 0) ? baud : 0;
+                return core_fd >= 0;
+            }
+
+            void close() {
+                if (core_fd >= 0) {
+                    ::close(core_fd);
+                    core_fd = -1;
+                }
+            }
+        //
+
+        bool set_baud(uint32_t new_baud) {
+            if (!baud || (new_baud == baud)) {
+                return true;
+            }
+
+            struct termios2 tio;
+
+            // Bytes still queued would go out at the new rate
+            if ((ioctl(core_fd, TCSBRK, 1) < 0) || (ioctl(core_fd, TCGETS2, &tio) < 0)) {
+                return false;
+            }
+
+            tio.c_cflag = CS8 | CREAD | CLOCAL | BOTHER;
+            tio.c_ispeed = new_baud;
+            tio.c_ospeed = new_baud;
+
+            if (ioctl(core_fd, TCSETS2, &tio) < 0) {
+                log_errorln("> [ERROR] Failed to switch core serial to " << new_baud << " baud: " << strerror(errno));
+                return false;
+            }
+
+            baud = new_baud;
+            return true;
+        }
+
+        bool write_core(const void* buffer, size_t len) {
+            const uint8_t* bytes = (const uint8_t*)buffer;
+
+            if (recorder) {
+                recorder->append(bugsy::Remote::RPI, session::Flow::TO_CORE, buffer, len);
+            }
+
+            while (len) {
+                ssize_t written = write(core_fd, bytes, len);
+
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    return false;
+                }
+
+                bytes += written;
+                len -= written;
+            }
+
+            return true;
+        }
+
+        bool read_core(void* buffer, size_t len, uint32_t timeout) {
+            uint8_t* bytes = (uint8_t*)buffer;
+            uint64_t deadline = millis() + timeout;
+
+            while (len) {
+                uint64_t now = millis();
+
+                if (now >= deadline) {
+                    return false;
+                }
+
+                struct pollfd pfd = { core_fd, POLLIN, 0 };
+                if (poll(&pfd, 1, (int)(deadline - now)) <= 0) {
+                    continue;
+                }
+
+                ssize_t received = read(core_fd, bytes, len);
+
+                if (received < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    return false;
+                }
+
+                if (recorder && received) {
+                    recorder->append(bugsy::Remote::RPI, session::Flow::FROM_CORE, bytes, received);
+                }
+
+                bytes += received;
+                len -= received;
+            }
+
+            return true;
+        }
+
+        void flush_core() {
+            ioctl(core_fd, TCFLSH, TCIFLUSH);
+        }
+
+        bool send_cmd_core(Command cmd) {
+            return write_core(&cmd, sizeof(Command));
+        }
+
+        bool send_u8_core(Command cmd, uint8_t arg) {
+            uint8_t buffer [sizeof(Command) + sizeof(uint8_t)] = { (uint8_t)cmd, arg };
+            return write_core(buffer, sizeof(buffer));
+        }
+
+        bool request_u8_core(Command cmd, uint8_t* value) {
+            flush_core();
+            return send_cmd_core(cmd) && read_core(value, sizeof(uint8_t));
+        }
+    }
+}
@@ -0,0 +1,242 @@
+// ###################
+// ##   BUGSY-RPI   ##
+// ###################
+//
+// Daemon running on the RPi of the Bugsy robot, connects to the core MCU and publishes its telemetry to local processes
+
+# include <signal.h>
+# include <string.h>
+# include <type_traits>
+# include <unistd.h>
+
+# include <bugsy/batch.hpp>
+# include <bugsy/baud.hpp>
+# include <bugsy/core.hpp>
+# include <bugsy/defines.hpp>
+# include <bugsy/messages.hpp>
+
+// Local headers
+# include "bugsy_rpi.hpp"
+
+# include "io.hpp"
+# include "session.hpp"
+# include "telemetry.hpp"
+
+using bugsy::Command;
+using bugsy::CoreState;
+using bugsy::Remote;
+using bugsy::TraderState;
+
+namespace bugsy_rpi {
+    /// The telemetry ring all the polled data is published to
+    static telemetry::Writer telemetry_writer;
+    /// Optional recording of the traffic with the core
+    static session::Writer session_writer;
+
+    /// Failed polls, a burst of them returns the serial to the base rate (see `bugsy/baud.hpp`)
+    static bugsy::baud::Bursts poll_errors;
+
+    /// Cleared by `SIGINT` / `SIGTERM` to shut the daemon down cleanly
+    static volatile sig_atomic_t running = 1;
+
+    static void handle_signal(int) {
+        running = 0;
+    }
+
+    /// Decodes an answer with the view `V` of its message into `field` of a frame
+    template<typename V, auto field>
+    static void decode(const uint8_t* answer, telemetry::Frame* frame) {
+        frame->*field = V(answer, V::SIZE).get();
+    }
+
+    /// Decodes a single byte answer (a state) into `field` of a frame
+    template<auto field>
+    static void decode_u8(const uint8_t* answer, telemetry::Frame* frame) {
+        frame->*field = (std::remove_reference_t<decltype(frame->*field)>)answer[0];
+    }
+
+    /// A request of the telemetry poll
+    struct Poll {
+        Command cmd;
+        /// Whether the command takes the remote of the link (`Remote::RPI`) as its argument
+        bool link;
+        /// Size of the answer
+        size_t size;
+        void (*decode)(const uint8_t* answer, telemetry::Frame* frame);
+    };
+
+    static constexpr Poll POLLS [] = {
+        { Command::GetState, false, sizeof(uint8_t), &decode_u8<&telemetry::Frame::core_state> },
+        { Command::GetTraderState, false, sizeof(uint8_t), &decode_u8<&telemetry::Frame::trader_state> },
+        { Command::GetMovement, false, bugsy::msg::MovementView::SIZE,
+            &decode<bugsy::msg::MovementView, &telemetry::Frame::movement> },
+        { Command::GetBattery, false, bugsy::msg::BatteryStateView::SIZE,
+            &decode<bugsy::msg::BatteryStateView, &telemetry::Frame::battery> },
+        { Command::GetSpeedStats, false, bugsy::msg::SpeedStatsView::SIZE,
+            &decode<bugsy::msg::SpeedStatsView, &telemetry::Frame::speed> },
+        { Command::GetEStopStats, false, bugsy::msg::EStopStatsView::SIZE,
+            &decode<bugsy::msg::EStopStatsView, &telemetry::Frame::estop> },
+        { Command::GetLinkStats, true, bugsy::msg::LinkStatsView::SIZE,
+            &decode<bugsy::msg::LinkStatsView, &telemetry::Frame::link> },
+        { Command::GetBaudStats, true, bugsy::msg::BaudStatsView::SIZE,
+            &decode<bugsy::msg::BaudStatsView, &telemetry::Frame::baud> },
+        { Command::GetPrimarySensorData, false, bugsy::msg::PrimarySensorDataView::SIZE,
+            &decode<bugsy::msg::PrimarySensorDataView, &telemetry::Frame::primary_sensor_data> },
+        { Command::GetSecondarySensorData, false, bugsy::msg::SecondarySensorDataView::SIZE,
+            &decode<bugsy::msg::SecondarySensorDataView, &telemetry::Frame::secondary_sensor_data> }
+    };
+
+    /// Size of the batch of the poll or of its answer, each entry is prefixed by its length
+    static constexpr size_t polls_size(bool answers) {
+        size_t size = 0;
+
+        for (const Poll& poll : POLLS) {
+            size += 1 + (answers ? poll.size : (sizeof(Command) + (poll.link ? sizeof(Remote) : 0)));
+        }
+
+        return size;
+    }
+
+    static_assert(polls_size(false) <= (BUGSY_BATCH_FRAME_SIZE - sizeof(Command)), "The telemetry poll does not fit into a batch!");
+    static_assert(polls_size(true) <= BUGSY_BATCH_ANSWER_SIZE, "The answers of the telemetry poll do not fit into a batch!");
+
+    /// Polls all the telemetry from the core in a single batch and publishes it as a new frame
+    /// @return Whether the core answered all requests
+    static bool poll_telemetry() {
+        telemetry::Frame frame = {};
+        frame.stamp = micros();
+
+        const Remote link_remote = Remote::RPI;
+
+        uint8_t commands [BUGSY_BATCH_FRAME_SIZE - sizeof(Command)];
+        bugsy::batch::Writer writer(commands, sizeof(commands));
+
+        for (const Poll& poll : POLLS) {
+            writer.begin();
+            writer.append(&poll.cmd, sizeof(Command));
+
+            if (poll.link) {
+                writer.append(&link_remote, sizeof(Remote));
+            }
+
+            writer.end();
+        }
+
+        uint8_t answers [BUGSY_BATCH_ANSWER_SIZE];
+        size_t answers_len;
+
+        if (!core::batch(commands, writer.size(), answers, &answers_len)) {
+            return false;
+        }
+
+        bugsy::batch::Reader reader(answers, answers_len);
+
+        for (const Poll& poll : POLLS) {
+            const uint8_t* answer;
+            size_t answer_len;
+
+            if (!reader.next(&answer, &answer_len) || (answer_len != poll.size)) {
+                return false;
+            }
+
+            poll.decode(answer, &frame);
+        }
+
+        telemetry_writer.publish(&frame);
+        return true;
+    }
+
+    /// Steps the serial up to the fastest baud rate the wiring supports
+    static void negotiate_baud() {
+        uint32_t baud = core::negotiate_baud();
+
+        if (baud) {
+            log_infoln("> Core link at " << baud << " baud");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* device = (argc > 1) ? argv[1] : BUGSY_RPI_CORE_DEVICE;
+    const char* session_path = (argc > 2) ? argv[2] : nullptr;
+
+    log_infoln("");
+    log_debugln("###################");
+    log_debugln("##   BUGSY-RPI   ##");
+    log_debugln("###################");
+    log_debugln("|");
+    log_info("> Bugsy Software Version: '");
+    log_info(BUGSY_SOFTWARE_VERSION);
+    log_debugln("'");
+    log_debugln("|");
+
+    log_debug("| > Connecting to core at '" << device << "' ... ");
+    if (!bugsy_rpi::io::setup(device, BUGSY_UART_CORE_TO_RPI_BAUD)) {
+        return 1;
+    }
+    log_debugln("done!");
+
+    log_debug("| > Opening telemetry ring ... ");
+    if (!bugsy_rpi::telemetry_writer.open()) {
+        return 1;
+    }
+    log_debugln("done!");
+
+    if (session_path) {
+        log_debug("| > Recording session to '" << session_path << "' ... ");
+        if (!bugsy_rpi::session_writer.open(session_path)) {
+            return 1;
+        }
+        bugsy_rpi::io::recorder = &bugsy_rpi::session_writer;
+        log_debugln("done!");
+    }
+
+    bugsy_rpi::core::set_rpi_ready();
+    bugsy_rpi::negotiate_baud();
+    log_infoln("> SETUP complete!");
+
+    signal(SIGINT, bugsy_rpi::handle_signal);
+    signal(SIGTERM, bugsy_rpi::handle_signal);
+
+    uint64_t next_poll = bugsy_rpi::millis();
+    bool core_connected = true;
+
+    while (bugsy_rpi::running) {
+        bool success = bugsy_rpi::poll_telemetry();
+
+        if (success != core_connected) {
+            if (success) {
+                log_infoln("> Core reconnected!");
+                bugsy_rpi::core::set_rpi_ready();
+                bugsy_rpi::negotiate_baud();
+            } else {
+                log_errorln("> [ERROR] Core stopped answering telemetry requests!");
+            }
+
+            core_connected = success;
+        }
+
+        // The core falls back on its own once it receives garbage, so both ends meet at the base rate again
+        if (!success && bugsy_rpi::poll_errors.error((uint32_t)bugsy_rpi::millis())
+            && (bugsy_rpi::io::baud > BUGSY_UART_CORE_TO_RPI_BAUD)) {
+            log_errorln("> [ERROR] Error burst, core link falls back to " << BUGSY_UART_CORE_TO_RPI_BAUD << " baud!");
+            bugsy_rpi::io::set_baud(BUGSY_UART_CORE_TO_RPI_BAUD);
+        }
+
+        // Keep a fixed rate, polls that took too long are not made up for
+        next_poll += BUGSY_RPI_TELEMETRY_INTERVAL;
+        uint64_t now = bugsy_rpi::millis();
+
+        if (next_poll > now) {
+            usleep((next_poll - now) * 1000);
+        } else {
+            next_poll = now;
+        }
+    }
+
+    log_infoln("> Shutting down ...");
+    bugsy_rpi::session_writer.close();
+    bugsy_rpi::io::close();
+
+    return 0;
+}
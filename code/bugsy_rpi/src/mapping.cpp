@@ -0,0 +1,283 @@
+# include "mapping.hpp"
+
+# include <algorithm>
+# include <math.h>
+# include <stdlib.h>
+# include <string.h>
+
+namespace bugsy_rpi {
+    namespace mapping {
+        /// Lanes of the vector kernel, 128 bits fill a NEON or SSE register
+        typedef int32_t Lanes __attribute__((vector_size(16)));
+        static const uint32_t LANES = sizeof(Lanes) / sizeof(int32_t);
+
+        /// One cell in 16.16 fixed-point
+        static const int32_t FIXED_ONE = 1 << 16;
+        /// Distance in cells the rays are clipped to inside the border of the grid, more than the fixed-point steps can
+        /// drift along the longest ray
+        static const float CLIP_MARGIN = 1.0f / 32.0f;
+
+        static Lanes splat(int32_t value) {
+            Lanes lanes = { value, value, value, value };
+            return lanes;
+        }
+
+        /// Clips a line to the rectangle `0, 0` - `max_x, max_y` (Liang-Barsky)
+        /// @param end Receives the fraction of the line kept at its end
+        /// @return `false` if the line lies completely outside
+        static bool clip(float* x0, float* y0, float* x1, float* y1, float max_x, float max_y, float* end) {
+            const float dx = *x1 - *x0;
+            const float dy = *y1 - *y0;
+            const float p [4] = { -dx, dx, -dy, dy };
+            const float q [4] = { *x0, max_x - *x0, *y0, max_y - *y0 };
+
+            float t0 = 0.0f, t1 = 1.0f;
+
+            for (uint8_t i = 0; i < 4; i++) {
+                if (p[i] == 0.0f) {
+                    if (q[i] < 0.0f) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                float t = q[i] / p[i];
+
+                if (p[i] < 0.0f) {
+                    t0 = (t > t0) ? t : t0;
+                } else {
+                    t1 = (t < t1) ? t : t1;
+                }
+
+                if (t0 > t1) {
+                    return false;
+                }
+            }
+
+            *x1 = *x0 + (t1 * dx);
+            *y1 = *y0 + (t1 * dy);
+            *x0 = *x0 + (t0 * dx);
+            *y0 = *y0 + (t0 * dy);
+            *end = t1;
+            return true;
+        }
+
+        OccupancyGrid::OccupancyGrid(float width, float height, GridParams params) : params(params) {
+            const uint32_t tile = 1 << BUGSY_RPI_MAP_TILE_BITS;
+
+            this->size_x = (uint32_t)ceilf(width / params.cell_size);
+            this->size_y = (uint32_t)ceilf(height / params.cell_size);
+            this->origin_x = -(this->size_x * params.cell_size) / 2.0f;
+            this->origin_y = -(this->size_y * params.cell_size) / 2.0f;
+
+            uint32_t tiles_x = (this->size_x + tile - 1) / tile;
+            uint32_t tiles_y = (this->size_y + tile - 1) / tile;
+
+            this->tiles_x_bits = 0;
+
+            while ((1u << this->tiles_x_bits) < tiles_x) {
+                this->tiles_x_bits++;
+            }
+
+            this->cells.assign(((size_t)tiles_y << this->tiles_x_bits) * tile * tile, 0);
+            this->stamps.assign((size_t)tiles_y << this->tiles_x_bits, 0);
+        }
+
+        void OccupancyGrid::integrate(const Scan& scan) {
+            const float scale = 1.0f / this->params.cell_size;
+            const float max_x = this->size_x - CLIP_MARGIN;
+            const float max_y = this->size_y - CLIP_MARGIN;
+
+            // Position of the sensor in cells
+            const float sensor_x = (scan.pose.x - this->origin_x) * scale;
+            const float sensor_y = (scan.pose.y - this->origin_y) * scale;
+
+            for (size_t i = 0; i < scan.count; i++) {
+                float range = scan.ranges[i];
+
+                // Also skips NaNs
+                if (!(range > 0.0f)) {
+                    continue;
+                }
+
+                bool hit = range < scan.max_range;
+                range = hit ? (range * scale) : (scan.max_range * scale);
+
+                float angle = scan.pose.theta + scan.angle_min + (i * scan.angle_step);
+                float x0 = sensor_x, y0 = sensor_y;
+                float x1 = sensor_x + (cosf(angle) * range);
+                float y1 = sensor_y + (sinf(angle) * range);
+                float end;
+
+                if (!clip(&x0, &y0, &x1, &y1, max_x, max_y, &end)) {
+                    continue;
+                }
+
+                // The obstacle lies outside of the grid
+                hit = hit && (end >= 1.0f);
+
+                // Stepping one cell along the major axis, starting at the center of the first cell. Every cell but the
+                // last is passed, the last one is updated on its own
+                int32_t cx0 = (int32_t)x0, cy0 = (int32_t)y0;
+                int32_t cx1 = (int32_t)x1, cy1 = (int32_t)y1;
+                float dx = x1 - x0, dy = y1 - y0;
+
+                int32_t fx, fy, step_x, step_y;
+                uint32_t steps;
+
+                if (fabsf(dx) >= fabsf(dy)) {
+                    float dir = (dx < 0.0f) ? -1.0f : 1.0f;
+                    float slope = (dx != 0.0f) ? (dy / fabsf(dx)) : 0.0f;
+                    float start = y0 + ((cx0 + 0.5f - x0) * dir * slope);
+
+                    steps = (uint32_t)abs(cx1 - cx0);
+                    fx = (cx0 << 16) | (FIXED_ONE / 2);
+                    fy = (int32_t)(fminf(fmaxf(start, 0.0f), max_y) * FIXED_ONE);
+                    step_x = (dx < 0.0f) ? -FIXED_ONE : FIXED_ONE;
+                    step_y = (int32_t)(slope * FIXED_ONE);
+                } else {
+                    float dir = (dy < 0.0f) ? -1.0f : 1.0f;
+                    float slope = dx / fabsf(dy);
+                    float start = x0 + ((cy0 + 0.5f - y0) * dir * slope);
+
+                    steps = (uint32_t)abs(cy1 - cy0);
+                    fx = (int32_t)(fminf(fmaxf(start, 0.0f), max_x) * FIXED_ONE);
+                    fy = (cy0 << 16) | (FIXED_ONE / 2);
+                    step_x = (int32_t)(slope * FIXED_ONE);
+                    step_y = (dy < 0.0f) ? -FIXED_ONE : FIXED_ONE;
+                }
+
+                if (this->params.kernel == Kernel::VECTOR) {
+                    this->trace_vector(fx, fy, step_x, step_y, steps);
+                } else {
+                    this->trace_scalar(fx, fy, step_x, step_y, steps);
+                }
+
+                this->update(this->index(cx1, cy1), hit ? this->params.hit : this->params.miss);
+
+                this->counters.rays++;
+                this->counters.updates += steps + 1;
+            }
+
+            // No ray reaches further than the range of the sensor
+            const float range = scan.max_range * scale;
+
+            if (((sensor_x + range) >= 0.0f) && ((sensor_y + range) >= 0.0f) && ((sensor_x - range) < max_x) && ((sensor_y - range) < max_y)) {
+                this->revisions++;
+                this->mark((uint32_t)fmaxf(sensor_x - range, 0.0f), (uint32_t)fmaxf(sensor_y - range, 0.0f),
+                    (uint32_t)fminf(sensor_x + range, max_x), (uint32_t)fminf(sensor_y + range, max_y));
+            }
+        }
+
+        void OccupancyGrid::mark(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+            const uint32_t bits = BUGSY_RPI_MAP_TILE_BITS;
+
+            for (uint32_t ty = y0 >> bits; ty <= (y1 >> bits); ty++) {
+                for (uint32_t tx = x0 >> bits; tx <= (x1 >> bits); tx++) {
+                    this->stamps[(ty << this->tiles_x_bits) | tx] = this->revisions;
+                }
+            }
+        }
+
+        void OccupancyGrid::trace_scalar(int32_t x0, int32_t y0, int32_t step_x, int32_t step_y, uint32_t steps) {
+            for (uint32_t k = 0; k < steps; k++) {
+                this->update(this->index((x0 + (int32_t)k * step_x) >> 16, (y0 + (int32_t)k * step_y) >> 16), this->params.miss);
+            }
+        }
+
+        void OccupancyGrid::trace_vector(int32_t x0, int32_t y0, int32_t step_x, int32_t step_y, uint32_t steps) {
+            const int32_t bits = BUGSY_RPI_MAP_TILE_BITS;
+            const Lanes mask = splat((1 << bits) - 1);
+            const Lanes advance_x = splat((int32_t)LANES * step_x);
+            const Lanes advance_y = splat((int32_t)LANES * step_y);
+
+            Lanes x = { x0, x0 + step_x, x0 + (2 * step_x), x0 + (3 * step_x) };
+            Lanes y = { y0, y0 + step_y, y0 + (2 * step_y), y0 + (3 * step_y) };
+
+            int32_t indices [LANES];
+
+            for (uint32_t k = 0; k < steps; k += LANES) {
+                Lanes cx = x >> 16;
+                Lanes cy = y >> 16;
+                Lanes index = ((((cy >> bits) << (int32_t)this->tiles_x_bits) | (cx >> bits)) << (2 * bits))
+                    | ((cy & mask) << bits) | (cx & mask);
+
+                memcpy(indices, &index, sizeof(indices));
+
+                // Neither NEON nor SSE can scatter, the updates stay scalar
+                uint32_t count = ((steps - k) < LANES) ? (steps - k) : LANES;
+
+                for (uint32_t i = 0; i < count; i++) {
+                    this->update((size_t)indices[i], this->params.miss);
+                }
+
+                x += advance_x;
+                y += advance_y;
+            }
+        }
+
+        void OccupancyGrid::clear() {
+            memset(this->cells.data(), 0, this->cells.size());
+            this->counters = { };
+
+            // Every known cell became unknown
+            this->revisions++;
+            std::fill(this->stamps.begin(), this->stamps.end(), this->revisions);
+        }
+
+        void OccupancyGrid::set(uint32_t cx, uint32_t cy, int8_t value) {
+            this->cells[this->index(cx, cy)] = value;
+
+            this->revisions++;
+            this->mark(cx, cy, cx, cy);
+        }
+
+        float OccupancyGrid::probability(uint32_t cx, uint32_t cy) const {
+            return 1.0f - (1.0f / (1.0f + expf(this->get(cx, cy) / 16.0f)));
+        }
+
+        CellState OccupancyGrid::state(uint32_t cx, uint32_t cy) const {
+            int8_t value = this->get(cx, cy);
+
+            if (value >= this->params.threshold) {
+                return CellState::OCCUPIED;
+            }
+
+            if (value <= -this->params.threshold) {
+                return CellState::FREE;
+            }
+
+            return CellState::UNKNOWN;
+        }
+
+        bool OccupancyGrid::cell_of(float x, float y, uint32_t* cx, uint32_t* cy) const {
+            float gx = (x - this->origin_x) / this->params.cell_size;
+            float gy = (y - this->origin_y) / this->params.cell_size;
+
+            if ((gx < 0.0f) || (gy < 0.0f) || (gx >= this->size_x) || (gy >= this->size_y)) {
+                return false;
+            }
+
+            *cx = (uint32_t)gx;
+            *cy = (uint32_t)gy;
+            return true;
+        }
+
+        void OccupancyGrid::center_of(uint32_t cx, uint32_t cy, float* x, float* y) const {
+            *x = this->origin_x + ((cx + 0.5f) * this->params.cell_size);
+            *y = this->origin_y + ((cy + 0.5f) * this->params.cell_size);
+        }
+
+        void Odometry::update(float left, float right) {
+            float distance = (left + right) / 2.0f;
+            float turn = (right - left) / this->track_width;
+
+            // Moving along the mean heading of the step
+            float heading = this->current.theta + (turn / 2.0f);
+            this->current.x += distance * cosf(heading);
+            this->current.y += distance * sinf(heading);
+            this->current.theta = remainderf(this->current.theta + turn, 2.0f * (float)M_PI);
+        }
+    }
+}
@@ -0,0 +1,541 @@
+# include "planner.hpp"
+
+# include <algorithm>
+# include <math.h>
+# include <stdlib.h>
+
+namespace bugsy_rpi {
+    namespace planning {
+        /// Neighbours of a cell, the orthogonal ones first
+        static const int8_t NEIGHBOURS [8][2] = {
+            { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+        };
+
+        /// Distance in cells between two samples of a line of sight
+        static const float SIGHT_STEP = 0.25f;
+        /// Longest line of sight tried in cells, keeps the smoothing linear in the length of the path
+        static const float SIGHT_MAX = 64.0f;
+
+        // Planner
+            Planner::Planner(const mapping::OccupancyGrid& grid, PlannerParams params) : grid(grid), params(params) {
+                this->size_x = grid.cells_x();
+                this->size_y = grid.cells_y();
+
+                const size_t cells = (size_t)this->size_x * this->size_y;
+
+                this->unknown = (Cost)lroundf(STEP_STRAIGHT * params.unknown_cost);
+
+                this->g.assign(cells, COST_MAX);
+                this->rhs.assign(cells, COST_MAX);
+                this->states.assign(cells, mapping::CellState::UNKNOWN);
+                this->near.assign(cells, 0);
+                this->touched.assign(cells, 0);
+
+                // A cell is blocked if an occupied cell lies closer to its center than the radius (measured between the
+                // centers), rounded up to whole cells
+                const int32_t radius = (int32_t)ceilf(params.robot_radius / grid.parameters().cell_size);
+
+                for (int32_t dy = -radius; dy <= radius; dy++) {
+                    for (int32_t dx = -radius; dx <= radius; dx++) {
+                        if (((dx * dx) + (dy * dy)) <= (radius * radius)) {
+                            this->disk.push_back({ dx, dy });
+                        }
+                    }
+                }
+            }
+
+            bool Planner::set_goal(float x, float y) {
+                uint32_t cx, cy;
+
+                if (!this->grid.cell_of(x, y, &cx, &cy)) {
+                    return false;
+                }
+
+                std::fill(this->g.begin(), this->g.end(), COST_MAX);
+                std::fill(this->rhs.begin(), this->rhs.end(), COST_MAX);
+                this->queue = decltype(this->queue)();
+
+                this->goal = this->id(cx, cy);
+                this->has_goal = true;
+                this->km = 0;
+                this->last = this->start;
+
+                this->rhs[this->goal] = 0;
+                this->queue.push({ this->key(this->goal), this->goal });
+                return true;
+            }
+
+            bool Planner::set_start(float x, float y) {
+                uint32_t cx, cy;
+
+                if (!this->grid.cell_of(x, y, &cx, &cy)) {
+                    return false;
+                }
+
+                // Instead of requeueing every cell for the new heuristic, the keys are raised by the distance travelled
+                this->start = this->id(cx, cy);
+                this->km += this->heuristic(this->last, this->start);
+                this->last = this->start;
+                return true;
+            }
+
+            void Planner::update() {
+                const uint32_t bits = BUGSY_RPI_MAP_TILE_BITS;
+                const uint32_t revision = this->grid.revision();
+
+                for (uint32_t ty = 0; ty < this->grid.tiles_y(); ty++) {
+                    for (uint32_t tx = 0; tx < this->grid.tiles_x(); tx++) {
+                        // Wraps like the revision does
+                        if ((int32_t)(this->grid.tile_revision(tx, ty) - this->revision) <= 0) {
+                            continue;
+                        }
+
+                        const uint32_t end_y = std::min((ty + 1) << bits, this->size_y);
+                        const uint32_t end_x = std::min((tx + 1) << bits, this->size_x);
+
+                        for (uint32_t cy = ty << bits; cy < end_y; cy++) {
+                            for (uint32_t cx = tx << bits; cx < end_x; cx++) {
+                                mapping::CellState state = this->grid.state(cx, cy);
+
+                                if (state != this->states[this->id(cx, cy)]) {
+                                    this->apply(cx, cy, state);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                this->revision = revision;
+
+                if (!this->has_goal) {
+                    for (uint32_t cell : this->changed) {
+                        this->touched[cell] = 0;
+                    }
+
+                    this->changed.clear();
+                    return;
+                }
+
+                // The cost of the steps from and to a changed cell changed, and so did the diagonal steps past its corners,
+                // all of them start and end in the cell or its neighbours
+                std::vector<uint32_t> cells;
+
+                for (uint32_t cell : this->changed) {
+                    uint32_t cx = cell % this->size_x, cy = cell / this->size_x;
+
+                    for (int8_t dy = -1; dy <= 1; dy++) {
+                        for (int8_t dx = -1; dx <= 1; dx++) {
+                            int64_t nx = (int64_t)cx + dx, ny = (int64_t)cy + dy;
+
+                            if ((nx < 0) || (ny < 0) || (nx >= this->size_x) || (ny >= this->size_y)) {
+                                continue;
+                            }
+
+                            uint32_t neighbour = this->id((uint32_t)nx, (uint32_t)ny);
+
+                            // `1` marks a changed cell, `2` a cell already recalculated
+                            if (this->touched[neighbour] != 2) {
+                                cells.push_back(neighbour);
+                                this->touched[neighbour] = 2;
+                            }
+                        }
+                    }
+                }
+
+                for (uint32_t cell : cells) {
+                    this->update_cell(cell);
+                    this->touched[cell] = 0;
+                }
+
+                for (uint32_t cell : this->changed) {
+                    this->touched[cell] = 0;
+                }
+
+                this->changed.clear();
+            }
+
+            void Planner::apply(uint32_t cx, uint32_t cy, mapping::CellState state) {
+                const uint32_t cell = this->id(cx, cy);
+                const mapping::CellState old = this->states[cell];
+
+                this->states[cell] = state;
+
+                // Only the cost of the cell itself changes between free and unknown
+                if ((old != mapping::CellState::OCCUPIED) && (state != mapping::CellState::OCCUPIED)) {
+                    this->touch(cell);
+                    return;
+                }
+
+                const bool occupied = state == mapping::CellState::OCCUPIED;
+
+                for (const std::pair<int32_t, int32_t>& offset : this->disk) {
+                    int64_t nx = (int64_t)cx + offset.first, ny = (int64_t)cy + offset.second;
+
+                    if ((nx < 0) || (ny < 0) || (nx >= this->size_x) || (ny >= this->size_y)) {
+                        continue;
+                    }
+
+                    uint32_t neighbour = this->id((uint32_t)nx, (uint32_t)ny);
+
+                    if (occupied) {
+                        if (!(this->near[neighbour]++)) {
+                            this->touch(neighbour);
+                        }
+                    } else if (!(--this->near[neighbour])) {
+                        this->touch(neighbour);
+                    }
+                }
+            }
+
+            void Planner::touch(uint32_t cell) {
+                if (!this->touched[cell]) {
+                    this->touched[cell] = 1;
+                    this->changed.push_back(cell);
+                    this->counters.changed++;
+                }
+            }
+
+            Planner::Cost Planner::heuristic(uint32_t a, uint32_t b) const {
+                Cost dx = abs((int32_t)(a % this->size_x) - (int32_t)(b % this->size_x));
+                Cost dy = abs((int32_t)(a / this->size_x) - (int32_t)(b / this->size_x));
+
+                return (dx > dy) ? ((STEP_STRAIGHT * dx) + ((STEP_DIAGONAL - STEP_STRAIGHT) * dy))
+                    : ((STEP_STRAIGHT * dy) + ((STEP_DIAGONAL - STEP_STRAIGHT) * dx));
+            }
+
+            Planner::Cost Planner::factor(uint32_t cell) const {
+                if (this->near[cell]) {
+                    return COST_MAX;
+                }
+
+                return (this->states[cell] == mapping::CellState::UNKNOWN) ? this->unknown : STEP_STRAIGHT;
+            }
+
+            Planner::Cost Planner::step(uint32_t a, uint32_t b) const {
+                Cost fa = this->factor(a), fb = this->factor(b);
+
+                if ((fa == COST_MAX) || (fb == COST_MAX)) {
+                    return COST_MAX;
+                }
+
+                uint32_t ax = a % this->size_x, ay = a / this->size_x;
+                uint32_t bx = b % this->size_x, by = b / this->size_x;
+
+                if ((ax == bx) || (ay == by)) {
+                    return std::max(fa, fb);
+                }
+
+                // No cutting corners, the robot would touch the obstacle
+                if (this->near[this->id(bx, ay)] || this->near[this->id(ax, by)]) {
+                    return COST_MAX;
+                }
+
+                return (std::max(fa, fb) * STEP_DIAGONAL) / STEP_STRAIGHT;
+            }
+
+            Planner::Key Planner::key(uint32_t cell) const {
+                Cost best = std::min(this->g[cell], this->rhs[cell]);
+                return { add(add(best, this->heuristic(this->start, cell)), this->km), best };
+            }
+
+            void Planner::update_cell(uint32_t cell) {
+                if (cell != this->goal) {
+                    uint32_t cx = cell % this->size_x, cy = cell / this->size_x;
+                    Cost best = COST_MAX;
+
+                    for (const int8_t* offset : NEIGHBOURS) {
+                        int64_t nx = (int64_t)cx + offset[0], ny = (int64_t)cy + offset[1];
+
+                        if ((nx < 0) || (ny < 0) || (nx >= this->size_x) || (ny >= this->size_y)) {
+                            continue;
+                        }
+
+                        uint32_t neighbour = this->id((uint32_t)nx, (uint32_t)ny);
+                        best = std::min(best, add(this->step(cell, neighbour), this->g[neighbour]));
+                    }
+
+                    this->rhs[cell] = best;
+                    this->counters.updated++;
+                }
+
+                if (this->g[cell] != this->rhs[cell]) {
+                    this->queue.push({ this->key(cell), cell });
+                }
+            }
+
+            void Planner::compute() {
+                while (true) {
+                    // Entries of consistent cells are outdated, the ones of a cell queued again are requeued or expanded
+                    // once more when they reach the top
+                    while (!this->queue.empty() && (this->g[this->queue.top().cell] == this->rhs[this->queue.top().cell])) {
+                        this->queue.pop();
+                    }
+
+                    if (this->queue.empty()) {
+                        return;
+                    }
+
+                    const Entry top = this->queue.top();
+
+                    if (!(top.key < this->key(this->start)) && (this->g[this->start] == this->rhs[this->start])) {
+                        return;
+                    }
+
+                    this->queue.pop();
+
+                    const uint32_t cell = top.cell;
+                    const Key current = this->key(cell);
+
+                    // Queued before the robot moved or before the cost of the cell changed
+                    if (top.key < current) {
+                        this->queue.push({ current, cell });
+                        continue;
+                    }
+
+                    this->counters.expanded++;
+
+                    if (this->g[cell] > this->rhs[cell]) {
+                        this->g[cell] = this->rhs[cell];
+                    } else {
+                        this->g[cell] = COST_MAX;
+                        this->update_cell(cell);
+                    }
+
+                    uint32_t cx = cell % this->size_x, cy = cell / this->size_x;
+
+                    for (const int8_t* offset : NEIGHBOURS) {
+                        int64_t nx = (int64_t)cx + offset[0], ny = (int64_t)cy + offset[1];
+
+                        if ((nx < 0) || (ny < 0) || (nx >= this->size_x) || (ny >= this->size_y)) {
+                            continue;
+                        }
+
+                        this->update_cell(this->id((uint32_t)nx, (uint32_t)ny));
+                    }
+                }
+            }
+
+            bool Planner::plan(std::vector<Point>& path) {
+                path.clear();
+
+                if (!this->has_goal) {
+                    return false;
+                }
+
+                this->counters.plans++;
+                this->compute();
+
+                if (this->g[this->start] == COST_MAX) {
+                    return false;
+                }
+
+                // Following the cheapest steps, every cell is passed at most once on a consistent search
+                std::vector<uint32_t> cells = { this->start };
+                uint32_t cell = this->start;
+
+                while (cell != this->goal) {
+                    uint32_t cx = cell % this->size_x, cy = cell / this->size_x;
+                    uint32_t next = cell;
+                    Cost best = COST_MAX;
+
+                    for (const int8_t* offset : NEIGHBOURS) {
+                        int64_t nx = (int64_t)cx + offset[0], ny = (int64_t)cy + offset[1];
+
+                        if ((nx < 0) || (ny < 0) || (nx >= this->size_x) || (ny >= this->size_y)) {
+                            continue;
+                        }
+
+                        uint32_t neighbour = this->id((uint32_t)nx, (uint32_t)ny);
+                        Cost total = add(this->step(cell, neighbour), this->g[neighbour]);
+
+                        if (total < best) {
+                            best = total;
+                            next = neighbour;
+                        }
+                    }
+
+                    if ((best == COST_MAX) || (cells.size() > this->g.size())) {
+                        return false;
+                    }
+
+                    cells.push_back(next);
+                    cell = next;
+                }
+
+                std::vector<Point> points;
+                Cost factors_max = 0;
+
+                for (uint32_t c : cells) {
+                    Point point;
+                    this->grid.center_of(c % this->size_x, c / this->size_x, &point.x, &point.y);
+                    points.push_back(point);
+                }
+
+                if (!this->params.smooth) {
+                    path.assign(points.begin() + 1, points.end());
+                    return true;
+                }
+
+                // Skipping every point the last one kept sees the next one from, without crossing cells more expensive
+                // than the ones of the skipped part of the path
+                size_t anchor = 0;
+
+                for (size_t i = 1; i < points.size(); i++) {
+                    factors_max = std::max(factors_max, this->factor(cells[i]));
+
+                    if (((i + 1) < points.size()) && this->visible(points[anchor], points[i + 1],
+                            std::max(factors_max, this->factor(cells[i + 1])))) {
+                        continue;
+                    }
+
+                    path.push_back(points[i]);
+                    anchor = i;
+                    factors_max = this->factor(cells[i]);
+                }
+
+                return true;
+            }
+
+            bool Planner::visible(const Point& from, const Point& to, Cost limit) const {
+                const float cell_size = this->grid.parameters().cell_size;
+                const float length = hypotf(to.x - from.x, to.y - from.y) / cell_size;
+                const uint32_t steps = (uint32_t)ceilf(length / SIGHT_STEP);
+
+                if (length > SIGHT_MAX) {
+                    return false;
+                }
+
+                for (uint32_t k = 1; k < steps; k++) {
+                    float t = (float)k / steps;
+                    uint32_t cx, cy;
+
+                    if (!this->grid.cell_of(from.x + (t * (to.x - from.x)), from.y + (t * (to.y - from.y)), &cx, &cy)
+                            || (this->factor(this->id(cx, cy)) > limit)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        //
+
+        std::vector<Segment> to_segments(const mapping::Pose& pose, const std::vector<Point>& path, const MotionLimits& limits) {
+            std::vector<Segment> segments;
+            mapping::Pose current = pose;
+
+            // On the spot both chains run at the turning speed times half the track width
+            const float turn_rate = std::min(limits.turn_rate, limits.chain_speed / (limits.track_width / 2.0f));
+
+            for (const Point& point : path) {
+                float dx = point.x - current.x;
+                float dy = point.y - current.y;
+                float chord = hypotf(dx, dy);
+
+                if (chord < 1.0f) {
+                    continue;
+                }
+
+                // Angle between the heading and the straight line to the point
+                float alpha = remainderf(atan2f(dy, dx) - current.theta, 2.0f * (float)M_PI);
+
+                if (fabsf(alpha) > limits.arc_angle) {
+                    Segment turn;
+                    turn.vel = { 0, (int16_t)lroundf(copysignf(turn_rate, alpha) * 1000.0f) };
+                    turn.duration = (uint32_t)lroundf(fabsf(alpha) / turn_rate * 1000000.0f);
+                    segments.push_back(turn);
+
+                    current.theta = remainderf(current.theta + alpha, 2.0f * (float)M_PI);
+                    alpha = 0.0f;
+                }
+
+                // The circular arc tangent to the heading through the point turns twice the angle to the chord
+                float turn = 2.0f * alpha;
+                float length = (fabsf(alpha) > 1e-4f) ? (chord * alpha / sinf(alpha)) : chord;
+
+                // The outer chain runs faster than the center of the robot
+                float duration = std::max(length / limits.speed,
+                    (length + (fabsf(turn) * limits.track_width / 2.0f)) / limits.chain_speed);
+
+                Segment arc;
+                arc.vel = { (int16_t)lroundf(length / duration), (int16_t)lroundf(turn * 1000.0f / duration) };
+                arc.duration = (uint32_t)lroundf(duration * 1000000.0f);
+                segments.push_back(arc);
+
+                current.x = point.x;
+                current.y = point.y;
+                current.theta = remainderf(current.theta + turn, 2.0f * (float)M_PI);
+            }
+
+            return segments;
+        }
+
+        // Streamer
+            void Streamer::start(const std::vector<Segment>& segments, uint32_t now) {
+                // Steps at least the lead time away can still be overridden, the ones before will be applied anyway
+                while (!this->pending.empty() && ((int32_t)(this->pending.front() - now) < BUGSY_RPI_PLAN_STREAM_LEAD)) {
+                    this->pending.pop_front();
+                }
+
+                this->overrides = this->pending;
+                this->pending.clear();
+
+                this->next_at = this->overrides.empty() ? (now + BUGSY_RPI_PLAN_STREAM_LEAD) : this->overrides.front();
+                this->segments = segments;
+                this->segment = 0;
+                this->offset = 0;
+                this->finished = false;
+
+                this->update(now);
+            }
+
+            void Streamer::update(uint32_t now) {
+                while (!this->pending.empty() && ((int32_t)(this->pending.front() - now) <= 0)) {
+                    this->pending.pop_front();
+                }
+
+                while (!this->finished && (this->pending.size() < BUGSY_RPI_PLAN_STREAM_AHEAD)
+                        && ((int32_t)(this->next_at - now) < (BUGSY_RPI_PLAN_STREAM_AHEAD * BUGSY_RPI_PLAN_STREAM_INTERVAL))) {
+                    // After the last segment the robot stops, also at the times of the old steps still to come
+                    bool stopping = this->segment >= this->segments.size();
+                    bugsy::ScheduledVelocity step = { this->next_at, { 0, 0 } };
+                    uint32_t length = BUGSY_RPI_PLAN_STREAM_INTERVAL;
+
+                    if (!stopping) {
+                        step.vel = this->segments[this->segment].vel;
+                        length = std::min(length, this->segments[this->segment].duration - this->offset);
+                    }
+
+                    // An old step must not fall between two new ones, it would apply the old trajectory until the next
+                    while (!this->overrides.empty() && ((int32_t)(this->overrides.front() - this->next_at) <= 0)) {
+                        this->overrides.pop_front();
+                    }
+
+                    if (!this->overrides.empty()) {
+                        length = std::min(length, this->overrides.front() - this->next_at);
+                    }
+
+                    if (!this->sink(step)) {
+                        this->counters.failed++;
+                        return;
+                    }
+
+                    this->counters.steps++;
+                    this->pending.push_back(this->next_at);
+                    this->next_at += length;
+
+                    if (stopping) {
+                        this->finished = this->overrides.empty();
+                        continue;
+                    }
+
+                    this->offset += length;
+
+                    if (this->offset >= this->segments[this->segment].duration) {
+                        this->segment++;
+                        this->offset = 0;
+                    }
+                }
+            }
+        //
+    }
+}
@@ -0,0 +1,139 @@
+# include "replay.hpp"
+
+# include <algorithm>
+# include <map>
+# include <unistd.h>
+
+# include "io.hpp"
+
+using bugsy::Remote;
+using bugsy_rpi::session::Flow;
+
+namespace bugsy_rpi {
+    namespace replay {
+        // SimTarget
+            SimTarget::SimTarget() : core([this] (Remote, const uint8_t* buffer, size_t len) {
+                if (this->response) {
+                    this->response->insert(this->response->end(), buffer, buffer + len);
+                }
+            }) { }
+
+            bool SimTarget::exchange(uint64_t stamp, Remote remote, const uint8_t* cmd, size_t len, size_t, std::vector<uint8_t>* response) {
+                this->core.set_time((uint32_t)(stamp / 1000));
+                this->core.update();
+
+                this->response = response;
+                this->core.parse_cmd(remote, cmd, len);
+                this->response = nullptr;
+
+                return true;
+            }
+        //
+
+        // SerialTarget
+            bool SerialTarget::exchange(uint64_t, Remote, const uint8_t* cmd, size_t len, size_t expected, std::vector<uint8_t>* response) {
+                io::flush_core();
+
+                if (!io::write_core(cmd, len)) {
+                    return false;
+                }
+
+                response->resize(expected);
+                return (expected == 0) || io::read_core(response->data(), expected);
+            }
+        //
+
+        std::vector<Step> load_steps(session::Reader* reader, uint64_t start) {
+            std::vector<Step> steps;
+            // Index of the last command of every remote, answers are assigned to it
+            std::map<Remote, size_t> pending;
+            session::Record record;
+
+            reader->seek(start);
+
+            while (reader->next(&record)) {
+                if (record.direction == Flow::TO_CORE) {
+                    pending[record.remote] = steps.size();
+                    steps.push_back({ record.stamp, record.remote, record.data, record.len, { } });
+                } else {
+                    auto it = pending.find(record.remote);
+
+                    // Answers to commands before `start` are skipped
+                    if (it != pending.end()) {
+                        std::vector<uint8_t>& expected = steps[it->second].expected;
+                        expected.insert(expected.end(), record.data, record.data + record.len);
+                    }
+                }
+            }
+
+            return steps;
+        }
+
+        Report run(const std::vector<Step>& steps, Target* target, bool realtime) {
+            Report report = {};
+            std::vector<uint64_t> latencies;
+            std::vector<uint8_t> response;
+            uint64_t latency_sum = 0;
+
+            latencies.reserve(steps.size());
+
+            uint64_t start = micros();
+            uint64_t first_stamp = steps.empty() ? 0 : steps.front().stamp;
+
+            for (const Step& step : steps) {
+                if (realtime) {
+                    uint64_t due = start + (step.stamp - first_stamp);
+                    uint64_t now = micros();
+
+                    if (due > now) {
+                        usleep(due - now);
+                    }
+                }
+
+                response.clear();
+
+                uint64_t sent = micros();
+                bool answered = target->exchange(step.stamp, step.remote, step.cmd, step.len, step.expected.size(), &response);
+                uint64_t latency = micros() - sent;
+
+                report.commands++;
+                latency_sum += latency;
+                latencies.push_back(latency);
+
+                if (!answered) {
+                    report.timeouts++;
+                } else if (response == step.expected) {
+                    report.matched++;
+                } else {
+                    report.mismatched++;
+                }
+            }
+
+            report.duration = micros() - start;
+
+            if (!latencies.empty()) {
+                std::sort(latencies.begin(), latencies.end());
+
+                report.latency_avg = (double)latency_sum / latencies.size();
+                report.latency_max = latencies.back();
+                report.latency_p99 = latencies[(latencies.size() * 99) / 100];
+            }
+
+            return report;
+        }
+
+        void log_report(const Report& report) {
+            log_infoln("> Replay finished in " << (report.duration / 1000.0) << " ms");
+            log_infoln("| > Commands: " << report.commands);
+            log_infoln("| > Matched: " << report.matched);
+            log_infoln("| > Mismatched: " << report.mismatched);
+            log_infoln("| > Timeouts: " << report.timeouts);
+            log_info("| > Latency: avg " << report.latency_avg << " us, p99 " << report.latency_p99 << " us");
+            log_infoln(", max " << report.latency_max << " us");
+
+            if (report.duration) {
+                log_infoln("| > Throughput: " << (report.commands * 1000000.0 / report.duration) << " commands/s");
+            }
+        }
+    }
+}
@@ -0,0 +1,341 @@
+# include "session.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <string.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+# include <unistd.h>
+
+using bugsy::Remote;
+
+namespace bugsy_rpi {
+    namespace session {
+        // Writer
+            Writer::~Writer() {
+                this->close();
+            }
+
+            bool Writer::open(const char* path) {
+                this->fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+                if (this->fd < 0) {
+                    log_errorln("> [ERROR] Failed to create session '" << path << "': " << strerror(errno));
+                    return false;
+                }
+
+                this->size = 0;
+                this->index.clear();
+
+                if (!this->reserve(sizeof(FileHeader))) {
+                    this->close();
+                    return false;
+                }
+
+                struct timeval tv;
+                gettimeofday(&tv, nullptr);
+
+                FileHeader header = {};
+                header.magic = FILE_MAGIC;
+                header.version = FILE_VERSION;
+                header.start_time = ((uint64_t)tv.tv_sec * 1000000) + tv.tv_usec;
+
+                memcpy(this->map, &header, sizeof(header));
+                this->size = sizeof(header);
+
+                this->start = micros();
+                this->last_stamp = 0;
+
+                return true;
+            }
+
+            void Writer::close() {
+                if (this->fd < 0) {
+                    return;
+                }
+
+                // Append the index, the file is only marked as complete by the footer
+                if (this->map && this->reserve((this->index.size() * sizeof(IndexEntry)) + sizeof(Footer))) {
+                    Footer footer;
+                    footer.index_offset = this->size;
+                    footer.index_count = (uint32_t)this->index.size();
+                    footer.magic = FOOTER_MAGIC;
+
+                    memcpy(this->map + this->size, this->index.data(), this->index.size() * sizeof(IndexEntry));
+                    this->size += this->index.size() * sizeof(IndexEntry);
+
+                    memcpy(this->map + this->size, &footer, sizeof(footer));
+                    this->size += sizeof(footer);
+                }
+
+                if (this->map) {
+                    munmap(this->map, this->map_size);
+                    this->map = nullptr;
+                    this->map_size = 0;
+                }
+
+                if (ftruncate(this->fd, this->size) < 0) {
+                    log_errorln("> [ERROR] Failed to truncate session: " << strerror(errno));
+                }
+
+                ::close(this->fd);
+                this->fd = -1;
+            }
+
+            bool Writer::reserve(size_t len) {
+                if ((this->size + len) <= this->map_size) {
+                    return true;
+                }
+
+                size_t new_size = this->map_size;
+                while (new_size < (this->size + len)) {
+                    new_size += BUGSY_RPI_SESSION_CHUNK_SIZE;
+                }
+
+                if (ftruncate(this->fd, new_size) < 0) {
+                    log_errorln("> [ERROR] Failed to grow session: " << strerror(errno));
+                    return false;
+                }
+
+                void* addr = this->map
+                    ? mremap(this->map, this->map_size, new_size, MREMAP_MAYMOVE)
+                    : mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+
+                if (addr == MAP_FAILED) {
+                    log_errorln("> [ERROR] Failed to map session: " << strerror(errno));
+                    return false;
+                }
+
+                this->map = (uint8_t*)addr;
+                this->map_size = new_size;
+
+                return true;
+            }
+
+            uint64_t Writer::session_time() const {
+                return micros() - this->start;
+            }
+
+            bool Writer::append(Remote remote, Flow direction, const void* data, size_t len) {
+                return this->append_at(this->session_time(), remote, direction, data, len);
+            }
+
+            bool Writer::append_at(uint64_t stamp, Remote remote, Flow direction, const void* data, size_t len) {
+                if ((this->fd < 0) || (len > UINT16_MAX)) {
+                    return false;
+                }
+
+                if (stamp < this->last_stamp) {
+                    stamp = this->last_stamp;
+                }
+
+                // Bridge gaps longer than a delta can hold with empty records
+                while ((stamp - this->last_stamp) > UINT32_MAX) {
+                    if (!this->append_at(this->last_stamp + UINT32_MAX, Remote::NONE, Flow::TO_CORE, nullptr, 0)) {
+                        return false;
+                    }
+                }
+
+                if (!this->reserve(sizeof(RecordHeader) + len)) {
+                    return false;
+                }
+
+                // First record of a new index interval
+                if (this->index.empty() || ((stamp / BUGSY_RPI_SESSION_INDEX_INTERVAL) != (this->index.back().stamp / BUGSY_RPI_SESSION_INDEX_INTERVAL))) {
+                    this->index.push_back({ stamp, this->size });
+                }
+
+                RecordHeader header;
+                header.delta = (uint32_t)(stamp - this->last_stamp);
+                header.remote = remote;
+                header.direction = direction;
+                header.len = (uint16_t)len;
+
+                memcpy(this->map + this->size, &header, sizeof(header));
+
+                if (len) {
+                    memcpy(this->map + this->size + sizeof(header), data, len);
+                }
+
+                this->size += sizeof(header) + len;
+                this->last_stamp = stamp;
+
+                return true;
+            }
+        //
+
+        // Reader
+            Reader::~Reader() {
+                this->close();
+            }
+
+            bool Reader::open(const char* path) {
+                int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+
+                if (fd < 0) {
+                    log_errorln("> [ERROR] Failed to open session '" << path << "': " << strerror(errno));
+                    return false;
+                }
+
+                struct stat st;
+                if ((fstat(fd, &st) < 0) || ((size_t)st.st_size < sizeof(FileHeader))) {
+                    log_errorln("> [ERROR] Session '" << path << "' is too short!");
+                    ::close(fd);
+                    return false;
+                }
+
+                void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                ::close(fd);
+
+                if (addr == MAP_FAILED) {
+                    log_errorln("> [ERROR] Failed to map session: " << strerror(errno));
+                    return false;
+                }
+
+                this->map = (const uint8_t*)addr;
+                this->map_size = st.st_size;
+
+                const FileHeader* header = (const FileHeader*)this->map;
+                if ((header->magic != FILE_MAGIC) || (header->version != FILE_VERSION)) {
+                    log_errorln("> [ERROR] '" << path << "' is not a supported session file!");
+                    this->close();
+                    return false;
+                }
+
+                this->index.clear();
+                this->data_end = this->map_size;
+
+                // Use the stored index if the session has been closed properly
+                Footer footer;
+                memcpy(&footer, this->map + this->map_size - sizeof(Footer), sizeof(Footer));
+
+                if ((footer.magic == FOOTER_MAGIC)
+                    && (footer.index_offset <= (this->map_size - sizeof(Footer)))
+                    && ((footer.index_count * sizeof(IndexEntry)) == (this->map_size - sizeof(Footer) - footer.index_offset))
+                ) {
+                    this->data_end = footer.index_offset;
+                    this->index.resize(footer.index_count);
+                    memcpy(this->index.data(), this->map + footer.index_offset, footer.index_count * sizeof(IndexEntry));
+                }
+
+                this->scan();
+                this->rewind();
+
+                return true;
+            }
+
+            void Reader::close() {
+                if (this->map) {
+                    munmap((void*)this->map, this->map_size);
+                    this->map = nullptr;
+                    this->map_size = 0;
+                }
+            }
+
+            uint64_t Reader::start_time() const {
+                return ((const FileHeader*)this->map)->start_time;
+            }
+
+            void Reader::scan() {
+                bool build_index = this->index.empty();
+                size_t offset = sizeof(FileHeader);
+                uint64_t stamp = 0;
+
+                // With an index only the last interval has to be scanned to find the duration
+                if (!build_index) {
+                    offset = this->index.back().offset;
+                    stamp = this->index.back().stamp - ((const RecordHeader*)(this->map + offset))->delta;
+                }
+
+                while ((offset + sizeof(RecordHeader)) <= this->data_end) {
+                    RecordHeader header;
+                    memcpy(&header, this->map + offset, sizeof(header));
+
+                    // Unclosed sessions end with the zeroed, preallocated part of the file
+                    if ((offset + sizeof(header) + header.len) > this->data_end) {
+                        break;
+                    }
+
+                    if ((header.delta == 0) && (header.len == 0) && (header.remote == Remote::NONE)) {
+                        break;
+                    }
+
+                    stamp += header.delta;
+
+                    if (build_index && (this->index.empty() || ((stamp / BUGSY_RPI_SESSION_INDEX_INTERVAL) != (this->index.back().stamp / BUGSY_RPI_SESSION_INDEX_INTERVAL)))) {
+                        this->index.push_back({ stamp, offset });
+                    }
+
+                    offset += sizeof(header) + header.len;
+                }
+
+                this->data_end = offset;
+                this->end_stamp = stamp;
+            }
+
+            bool Reader::next(Record* record) {
+                while ((this->offset + sizeof(RecordHeader)) <= this->data_end) {
+                    RecordHeader header;
+                    memcpy(&header, this->map + this->offset, sizeof(header));
+
+                    this->stamp += header.delta;
+
+                    record->stamp = this->stamp;
+                    record->remote = header.remote;
+                    record->direction = header.direction;
+                    record->data = this->map + this->offset + sizeof(header);
+                    record->len = header.len;
+
+                    this->offset += sizeof(header) + header.len;
+
+                    // Skip gap-bridging records
+                    if ((header.remote != Remote::NONE) || header.len) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void Reader::seek(uint64_t stamp) {
+                this->rewind();
+
+                // Last index entry not after `stamp`
+                size_t low = 0, high = this->index.size();
+                while (low < high) {
+                    size_t mid = (low + high) / 2;
+
+                    if (this->index[mid].stamp <= stamp) {
+                        low = mid + 1;
+                    } else {
+                        high = mid;
+                    }
+                }
+
+                if (low) {
+                    const IndexEntry& entry = this->index[low - 1];
+                    this->offset = entry.offset;
+                    this->stamp = entry.stamp - ((const RecordHeader*)(this->map + entry.offset))->delta;
+                }
+
+                // Linear scan within the interval
+                while ((this->offset + sizeof(RecordHeader)) <= this->data_end) {
+                    const RecordHeader* header = (const RecordHeader*)(this->map + this->offset);
+
+                    if ((this->stamp + header->delta) >= stamp) {
+                        break;
+                    }
+
+                    this->stamp += header->delta;
+                    this->offset += sizeof(RecordHeader) + header->len;
+                }
+            }
+
+            void Reader::rewind() {
+                this->offset = sizeof(FileHeader);
+                this->stamp = 0;
+            }
+        //
+    }
+}
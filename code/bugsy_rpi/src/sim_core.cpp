@@ -0,0 +1,765 @@
+# include "sim_core.hpp"
+
+# include <string.h>
+
+using bugsy::Command;
+using bugsy::CoreState;
+using bugsy::Movement;
+using bugsy::Remote;
+using bugsy::TraderState;
+
+namespace bugsy_rpi {
+    namespace sim {
+        /// Same as `bugsy_core::MOVEMENT_NONE`
+        static const Movement MOVEMENT_NONE = { Direction::CCW, Direction::CCW, 0, 0 };
+
+        SimCore::SimCore(Output output) : output(std::move(output)) {
+            for (ServoTrajectory& servo : this->servos) {
+                servo = { bugsy::SERVO_ANGLE_MAX / 2, bugsy::SERVO_ANGLE_MAX / 2, 0, 0 };
+            }
+        }
+
+        uint16_t SimCore::servo_angle(uint8_t servo) const {
+            const ServoTrajectory& traj = this->servos[servo];
+            uint32_t elapsed = this->now - traj.start;
+
+            if (elapsed >= traj.duration) {
+                return traj.to;
+            }
+
+            return traj.from + (int16_t)(((int32_t)(traj.to - traj.from) * (int32_t)elapsed) / traj.duration);
+        }
+
+        void SimCore::parse_cmd(Remote src, const uint8_t* buffer, size_t len) {
+            if (len == 0) {
+                return;
+            }
+
+            this->commands++;
+
+            Command cmd = (Command)buffer[0];
+            const uint8_t* arg_bytes = buffer + sizeof(Command);
+            size_t arg_len = len - sizeof(Command);
+
+            // The remote streaming firmware chunks may only send update commands
+            if (!bugsy::ota::is_update(cmd) && this->ota.owns(src, this->now)) {
+                return;
+            }
+
+            switch (cmd) {
+                case Command::Test:
+                    if (arg_len) {
+                        this->output(src, arg_bytes, arg_len);
+                    }
+                    break;
+
+                case Command::Batch: {
+                    uint8_t answer [1 + BUGSY_BATCH_ANSWER_SIZE];
+                    bugsy::batch::Writer writer(answer + 1, BUGSY_BATCH_ANSWER_SIZE);
+                    bugsy::batch::Reader reader(arg_bytes, arg_len);
+
+                    const uint8_t* entry;
+                    size_t entry_len;
+
+                    // Collect the answers like the firmware
+                    Output output = this->output;
+                    this->output = [&writer](Remote, const uint8_t* data, size_t data_len) {
+                        writer.append(data, data_len);
+                    };
+                    this->batching = true;
+
+                    while (reader.next(&entry, &entry_len)) {
+                        writer.begin();
+
+                        if ((entry_len == 0) || (entry_len == bugsy::batch::NO_ANSWER) || ((Command)entry[0] == Command::Batch)) {
+                            writer.drop();
+                        } else {
+                            this->parse_cmd(src, entry, entry_len);
+                        }
+
+                        writer.end();
+                    }
+
+                    this->output = output;
+                    this->batching = false;
+
+                    answer[0] = (uint8_t)writer.size();
+                    this->output(src, answer, writer.size() + 1);
+                    break;
+                }
+
+                case Command::GetState:
+                    this->write_u8(src, (uint8_t)this->state);
+                    break;
+
+                case Command::GetPowerStats:
+                    this->write_msg<bugsy::msg::PowerStatsBuilder>(src, this->power.stats);
+                    break;
+
+                case Command::GetEStopStats:
+                    this->write_msg<bugsy::msg::EStopStatsBuilder>(src, this->estop);
+                    break;
+
+                case Command::GetBattery: {
+                    // Same derivation as `bugsy_core::battery::update()`, the duty limit itself is not simulated
+                    bugsy::BatteryState battery = bugsy::battery::state(this->battery_voltage,
+                        (uint16_t)this->move.chain_left_duty + this->move.chain_right_duty);
+                    this->write_msg<bugsy::msg::BatteryStateBuilder>(src, battery);
+                    break;
+                }
+
+                case Command::SyncClock: {
+                    if ((arg_len != sizeof(uint32_t)) && (arg_len != (2 * sizeof(uint32_t)))) {
+                        break;
+                    }
+
+                    // No processing time in the model
+                    bugsy::ClockSample sample;
+                    memcpy(&sample.client_send, arg_bytes, sizeof(uint32_t));
+                    sample.core_receive = this->now * 1000;
+                    sample.core_send = this->now * 1000;
+                    this->write_msg<bugsy::msg::ClockSampleBuilder>(src, sample);
+
+                    if (arg_len == (2 * sizeof(uint32_t))) {
+                        uint32_t rtt;
+                        memcpy(&rtt, arg_bytes + sizeof(uint32_t), sizeof(rtt));
+                        this->links.report_rtt(src, rtt);
+                    }
+
+                    break;
+                }
+
+                case Command::GetLinkStats: {
+                    if (arg_len != sizeof(Remote)) {
+                        return;
+                    }
+
+                    bugsy::LinkStats stats = this->links.stats((Remote)arg_bytes[0], this->configuration.failsafe, this->configuration.move_dur);
+                    this->write_msg<bugsy::msg::LinkStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::GetFailsafeConfig:
+                    this->write_msg<bugsy::msg::FailsafeConfigBuilder>(src, this->configuration.failsafe);
+                    break;
+
+                case Command::SetFailsafeConfig: {
+                    bugsy::FailsafeConfig failsafe;
+
+                    if (arg_len != sizeof(failsafe)) {
+                        return;
+                    }
+
+                    memcpy(&failsafe, arg_bytes, sizeof(failsafe));
+
+                    if (bugsy::link::valid(failsafe)) {
+                        this->configuration.failsafe = failsafe;
+                    }
+
+                    break;
+                }
+
+                case Command::ProposeBaud: {
+                    if (arg_len != sizeof(uint32_t)) {
+                        return;
+                    }
+
+                    bugsy::baud::Port* port = this->baud_of(src);
+                    uint8_t accepted = port && !this->batching && port->propose(bugsy::msg::wire::get_u32(arg_bytes), this->now);
+                    this->write_u8(src, accepted);
+                    break;
+                }
+
+                case Command::BaudTest: {
+                    bugsy::baud::Port* port = this->baud_of(src);
+                    uint8_t answer [BUGSY_BAUD_TEST_SIZE];
+
+                    if (port && port->test(arg_bytes, arg_len, answer)) {
+                        this->output(src, answer, sizeof(answer));
+                    }
+
+                    break;
+                }
+
+                case Command::ConfirmBaud: {
+                    bugsy::baud::Port* port = this->baud_of(src);
+                    uint8_t confirmed = port && port->confirm();
+                    this->write_u8(src, confirmed);
+                    break;
+                }
+
+                case Command::GetBaudStats: {
+                    if (arg_len != sizeof(Remote)) {
+                        return;
+                    }
+
+                    bugsy::baud::Port* port = this->baud_of((Remote)arg_bytes[0]);
+                    bugsy::BaudStats stats = port ? port->stats : bugsy::BaudStats { };
+                    this->write_msg<bugsy::msg::BaudStatsBuilder>(src, stats);
+                    break;
+                }
+
+                case Command::ScheduleMove: {
+                    bugsy::ScheduledMove scheduled;
+
+                    if (arg_len == sizeof(scheduled)) {
+                        memcpy(&scheduled, arg_bytes, sizeof(scheduled));
+                        this->schedule.add(src, scheduled.at, scheduled.move, this->now * 1000);
+                    }
+                    break;
+                }
+
+                case Command::ScheduleDrive: {
+                    bugsy::ScheduledVelocity scheduled;
+
+                    if (arg_len == sizeof(scheduled)) {
+                        memcpy(&scheduled, arg_bytes, sizeof(scheduled));
+                        this->schedule.add(src, scheduled.at, bugsy::drive::to_movement(scheduled.vel, this->configuration.drive), this->now * 1000);
+                    }
+                    break;
+                }
+
+                case Command::GetScheduleStats:
+                    this->write_msg<bugsy::msg::ScheduleStatsBuilder>(src, this->schedule.stats);
+                    break;
+
+                case Command::Move: {
+                    Movement new_move;
+
+                    if (arg_len == sizeof(Movement)) {
+                        memcpy(&new_move, arg_bytes, sizeof(Movement));
+                        this->post_move(src, nullptr, new_move);
+                    } else if (arg_len == (sizeof(bugsy::MoveStamp) + sizeof(Movement))) {
+                        bugsy::MoveStamp stamp;
+                        memcpy(&stamp, arg_bytes, sizeof(stamp));
+                        memcpy(&new_move, arg_bytes + sizeof(stamp), sizeof(Movement));
+                        this->post_move(src, &stamp, new_move);
+                    }
+                    break;
+                }
+
+                case Command::Stop:
+                    this->mailbox.clear();
+                    this->schedule.clear();
+                    this->move = MOVEMENT_NONE;
+                    this->move_duration = 0;
+                    this->state = CoreState::STANDBY;
+                    break;
+
+                case Command::GetMovement:
+                    this->write_msg<bugsy::msg::MovementBuilder>(src, this->move);
+                    break;
+
+                case Command::MoveServo: {
+                    bugsy::ServoMove servo_move;
+
+                    if (arg_len != sizeof(servo_move)) {
+                        return;
+                    }
+
+                    memcpy(&servo_move, arg_bytes, sizeof(servo_move));
+
+                    if (((uint8_t)servo_move.servo < bugsy::SERVO_COUNT) && (servo_move.angle <= bugsy::SERVO_ANGLE_MAX)) {
+                        uint8_t index = (uint8_t)servo_move.servo;
+                        this->servos[index] = { this->servo_angle(index), servo_move.angle, this->now, servo_move.duration };
+                    }
+
+                    break;
+                }
+
+                case Command::GetServo: {
+                    if (arg_len != sizeof(bugsy::Servo)) {
+                        return;
+                    }
+
+                    uint16_t angle = (arg_bytes[0] < bugsy::SERVO_COUNT) ? this->servo_angle(arg_bytes[0]) : 0;
+                    this->write_u16(src, angle);
+                    break;
+                }
+
+                case Command::Drive: {
+                    bugsy::Velocity vel;
+
+                    if (arg_len == sizeof(bugsy::Velocity)) {
+                        memcpy(&vel, arg_bytes, sizeof(vel));
+                        this->post_move(src, nullptr, bugsy::drive::to_movement(vel, this->configuration.drive));
+                    } else if (arg_len == (sizeof(bugsy::MoveStamp) + sizeof(bugsy::Velocity))) {
+                        bugsy::MoveStamp stamp;
+                        memcpy(&stamp, arg_bytes, sizeof(stamp));
+                        memcpy(&vel, arg_bytes + sizeof(stamp), sizeof(vel));
+                        this->post_move(src, &stamp, bugsy::drive::to_movement(vel, this->configuration.drive));
+                    }
+                    break;
+                }
+
+                case Command::GetMoveStats:
+                    this->write_msg<bugsy::msg::MoveStatsBuilder>(src, this->mailbox.stats);
+                    break;
+
+                case Command::GetDriveCalibration:
+                    this->write_msg<bugsy::msg::DriveCalibrationBuilder>(src, this->configuration.drive);
+                    break;
+
+                case Command::SetDriveCalibration: {
+                    bugsy::DriveCalibration cal;
+
+                    if (arg_len != sizeof(cal)) {
+                        return;
+                    }
+
+                    memcpy(&cal, arg_bytes, sizeof(cal));
+
+                    if (bugsy::drive::valid(cal)) {
+                        this->configuration.drive = cal;
+                    }
+
+                    break;
+                }
+
+                case Command::GetSpeedStats:
+                    this->write_msg<bugsy::msg::SpeedStatsBuilder>(src, this->speed.stats);
+                    break;
+
+                case Command::GetSpeedGains:
+                    this->write_msg<bugsy::msg::SpeedGainsBuilder>(src, this->configuration.speed_gains);
+                    break;
+
+                case Command::SetSpeedGains: {
+                    bugsy::SpeedGains gains;
+
+                    if (arg_len != sizeof(gains)) {
+                        return;
+                    }
+
+                    memcpy(&gains, arg_bytes, sizeof(gains));
+
+                    if (bugsy::speed::valid(gains)) {
+                        this->configuration.speed_gains = gains;
+                    }
+
+                    break;
+                }
+
+                case Command::SetTraderState:
+                    if (arg_len != sizeof(TraderState)) {
+                        return;
+                    }
+
+                    this->trader_state = (TraderState)arg_bytes[0];
+                    this->write_u8(src, (uint8_t)this->state);
+                    this->trader_stamp = this->now;
+                    break;
+
+                case Command::GetTraderState:
+                    this->write_u8(src, (uint8_t)this->trader_state);
+                    break;
+
+                case Command::PublishPrimarySensorData:
+                    if (arg_len != sizeof(bugsy::PrimarySensorData)) {
+                        return;
+                    }
+
+                    memcpy(&this->primary_sensor_data, arg_bytes, sizeof(bugsy::PrimarySensorData));
+                    this->trader_stamp = this->now;
+                    break;
+
+                case Command::GetPrimarySensorData:
+                    this->write_msg<bugsy::msg::PrimarySensorDataBuilder>(src, this->primary_sensor_data);
+                    break;
+
+                case Command::PublishSecondarySensorData:
+                    if (arg_len != sizeof(bugsy::SecondarySensorData)) {
+                        return;
+                    }
+
+                    memcpy(&this->secondary_sensor_data, arg_bytes, sizeof(bugsy::SecondarySensorData));
+                    this->trader_stamp = this->now;
+                    break;
+
+                case Command::GetSecondarySensorData:
+                    this->write_msg<bugsy::msg::SecondarySensorDataBuilder>(src, this->secondary_sensor_data);
+                    break;
+
+                case Command::SetRPiReady:
+                    this->rpi_ready = true;
+                    break;
+
+                case Command::IsRPiReady:
+                    this->write_u8(src, this->rpi_ready);
+                    break;
+
+                case Command::Remotes:
+                    this->write_u8(src, (uint8_t)this->remotes);
+                    break;
+
+                case Command::GetWiFiSSID:
+                    this->output(src, (const uint8_t*)this->configuration.wifi_ssid, strlen(this->configuration.wifi_ssid) + 1);
+                    break;
+
+                // Maintenance, remote reconfiguration and config persistence have no effect on the model
+                case Command::RemoteConfigure:
+                case Command::SaveConfig:
+                case Command::SetWiFiSSID:
+                case Command::SetWiFiPwd: {
+                    bugsy::JobTicket ticket = { 0, bugsy::JobState::DONE };
+
+                    if ((cmd == Command::RemoteConfigure) && (arg_len < sizeof(Remote))) {
+                        ticket.state = bugsy::JobState::REJECTED;
+                    } else if (cmd == Command::SetWiFiSSID) {
+                        memset(this->configuration.wifi_ssid, 0, BUGSY_WIFI_CRED_BUFFER_SIZE);
+                        memcpy(this->configuration.wifi_ssid, arg_bytes, (arg_len < (BUGSY_WIFI_CRED_BUFFER_SIZE - 1)) ? arg_len : (BUGSY_WIFI_CRED_BUFFER_SIZE - 1));
+                    } else if (cmd == Command::SetWiFiPwd) {
+                        memset(this->configuration.wifi_password, 0, BUGSY_WIFI_CRED_BUFFER_SIZE);
+                        memcpy(this->configuration.wifi_password, arg_bytes, (arg_len < (BUGSY_WIFI_CRED_BUFFER_SIZE - 1)) ? arg_len : (BUGSY_WIFI_CRED_BUFFER_SIZE - 1));
+                    }
+
+                    this->last_job = (this->last_job == UINT8_MAX) ? 1 : (this->last_job + 1);
+                    ticket.id = this->last_job;
+                    this->write_msg<bugsy::msg::JobTicketBuilder>(src, ticket);
+                    break;
+                }
+
+                case Command::GetJobState: {
+                    if (arg_len != sizeof(uint8_t)) {
+                        break;
+                    }
+
+                    // Every job is finished right away, only the recent ones can be queried
+                    uint8_t age = (uint8_t)(this->last_job - arg_bytes[0]);
+                    bugsy::JobState job_state = ((arg_bytes[0] != 0) && (this->last_job != 0) && (age < BUGSY_SIM_JOBS_HISTORY))
+                        ? bugsy::JobState::DONE : bugsy::JobState::UNKNOWN;
+                    this->write_u8(src, (uint8_t)job_state);
+                    break;
+                }
+
+                case Command::OtaBegin: {
+                    if (arg_len != bugsy::msg::OtaImageView::SIZE) {
+                        break;
+                    }
+
+                    uint8_t window = (src == Remote::RPI) ? BUGSY_SIM_OTA_WINDOW_RPI : ((src == Remote::BLUETOOTH) ? BUGSY_SIM_OTA_WINDOW_BT : 1);
+
+                    if (!this->ota.begin(bugsy::msg::OtaImageView(arg_bytes, arg_len).get(), src, this->now, window)) {
+                        this->ota_id++;
+
+                        if ((this->ota.state() == bugsy::OtaState::ERASING)
+                            && !this->ota_queue(FlashRequest { Command::OtaBegin, this->ota_id, false, 0, 0, { } }, true)) {
+                            this->ota.set_state(bugsy::OtaState::FAILED);
+                        }
+                    }
+
+                    bugsy::OtaStatus status = this->ota.get();
+                    this->write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
+                    break;
+                }
+
+                case Command::OtaChunk: {
+                    FlashRequest req = { Command::OtaChunk, this->ota_id, false, 0, 0, { } };
+                    req.len = this->ota.accept(src, arg_bytes, arg_len, this->now, &req.index);
+
+                    if (!req.len) {
+                        break;
+                    }
+
+                    memcpy(req.data, arg_bytes + (2 * sizeof(uint16_t)), req.len);
+
+                    if (this->ota_queue(req, false)) {
+                        this->ota.receive(req.index);
+                    } else {
+                        this->ota.drop();
+                    }
+
+                    break;
+                }
+
+                case Command::GetOtaStatus: {
+                    bugsy::OtaStatus status = this->ota.get();
+                    this->write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
+                    break;
+                }
+
+                case Command::OtaFinish: {
+                    if (arg_len != sizeof(uint8_t)) {
+                        break;
+                    }
+
+                    bool ready = (this->ota.state() == bugsy::OtaState::READY);
+                    bool complete = (this->ota.state() == bugsy::OtaState::RECEIVING) && this->ota.complete();
+
+                    if (complete) {
+                        this->ota.set_state(bugsy::OtaState::VERIFYING);
+                    }
+
+                    if ((ready || complete) && !this->ota_queue(FlashRequest { Command::OtaFinish, this->ota_id, arg_bytes[0] != 0, 0, 0, { } }, true)
+                        && complete) {
+                        this->ota.set_state(bugsy::OtaState::FAILED);
+                    }
+
+                    bugsy::OtaStatus status = this->ota.get();
+                    this->write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
+                    break;
+                }
+
+                case Command::OtaAbort: {
+                    this->ota.set_state(bugsy::OtaState::IDLE);
+                    this->ota_id++;
+                    this->ota_queue(FlashRequest { Command::OtaAbort, this->ota_id, false, 0, 0, { } }, true);
+
+                    bugsy::OtaStatus status = this->ota.get();
+                    this->write_msg<bugsy::msg::OtaStatusBuilder>(src, status);
+                    break;
+                }
+
+                default: {
+                    bugsy::baud::Port* port = this->baud_of(src);
+
+                    if (port) {
+                        port->error(this->now);
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        bugsy::baud::Port* SimCore::baud_of(Remote src) {
+            switch (src) {
+                case Remote::TRADER:
+                    return &this->trader_baud;
+
+                case Remote::RPI:
+                    return &this->rpi_baud;
+
+                default:
+                    return nullptr;
+            }
+        }
+
+        bool SimCore::ota_queue(const FlashRequest& req, bool reserve) {
+            size_t limit = BUGSY_SIM_OTA_QUEUE_SIZE + (reserve ? BUGSY_SIM_OTA_QUEUE_RESERVED : 0);
+
+            if (this->ota_requests.size() >= limit) {
+                return false;
+            }
+
+            this->ota_requests.push_back(req);
+            return true;
+        }
+
+        uint32_t SimCore::ota_start(const FlashRequest& req) {
+            if (req.session != this->ota_id) {
+                return 0;
+            }
+
+            switch (req.step) {
+                case Command::OtaBegin:
+                    return this->flash.erase(this->ota.image().size);
+
+                case Command::OtaChunk:
+                    return this->ota_open ? this->flash.write((uint32_t)req.index * BUGSY_OTA_CHUNK_SIZE, req.data, req.len) : 0;
+
+                case Command::OtaFinish: {
+                    if (this->ota.state() != bugsy::OtaState::VERIFYING) {
+                        return 0;
+                    }
+
+                    // Read back in blocks like the firmware
+                    uint8_t block [512];
+                    uint32_t size = this->ota.image().size;
+                    uint32_t time = 0;
+                    this->ota_readback = 0;
+
+                    for (uint32_t offset = 0; offset < size; offset += sizeof(block)) {
+                        size_t len = ((size - offset) < sizeof(block)) ? (size - offset) : sizeof(block);
+                        time += this->flash.read(offset, block, len);
+                        this->ota_readback = bugsy::crc::crc32(block, len, this->ota_readback);
+                    }
+
+                    return time;
+                }
+
+                default:
+                    return 0;
+            }
+        }
+
+        void SimCore::ota_complete(const FlashRequest& req) {
+            // Aborting closes the partition no matter which update it belongs to
+            if (req.step == Command::OtaAbort) {
+                this->ota_open = false;
+                return;
+            }
+
+            if (req.session != this->ota_id) {
+                return;
+            }
+
+            switch (req.step) {
+                case Command::OtaBegin:
+                    this->ota_open = true;
+                    this->ota.set_state(bugsy::OtaState::RECEIVING);
+                    break;
+
+                case Command::OtaChunk:
+                    if (this->ota_open) {
+                        this->ota.written(req.len);
+                    }
+
+                    break;
+
+                case Command::OtaFinish:
+                    if (this->ota.state() == bugsy::OtaState::VERIFYING) {
+                        this->ota_open = false;
+                        this->ota.set_state((this->ota_readback == this->ota.image().crc) ? bugsy::OtaState::READY : bugsy::OtaState::FAILED);
+                    }
+
+                    if ((this->ota.state() == bugsy::OtaState::READY) && req.restart) {
+                        this->ota_restart = this->now + BUGSY_OTA_RESTART_DELAY;
+                    }
+
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        void SimCore::post_move(Remote src, const bugsy::MoveStamp* stamp, const Movement& new_move) {
+            this->links.arrival(src, stamp, this->now);
+            this->deliver(src, stamp, new_move);
+        }
+
+        void SimCore::deliver(Remote src, const bugsy::MoveStamp* stamp, const Movement& new_move) {
+            Movement next;
+
+            // Every frame is a loop iteration of its own in the model, so the mailbox is emptied right away
+            if (this->mailbox.post(src, stamp, new_move, this->now) && this->mailbox.take(&next, &src)) {
+                this->apply_move(next, src);
+            }
+        }
+
+        void SimCore::apply_move(const Movement& new_move, Remote src) {
+            if (this->estop.active || !this->estop_line) {
+                return;
+            }
+
+            // Received bytes end the sleep of the firmware right away
+            this->power.activity(this->now);
+            this->sleep_until = this->now;
+
+            this->move = new_move;
+            this->move_stamp = this->now;
+            this->move_duration = this->links.window(src, this->configuration.failsafe, this->configuration.move_dur);
+            this->state = CoreState::DRIVING;
+        }
+
+        void SimCore::update() {
+            // Emergency stop, the core stops right on the edge of the line
+            if (!this->estop_line && !this->estop.active) {
+                this->estop.active = 1;
+                this->estop.triggers++;
+            } else if (this->estop_line && this->estop.active) {
+                this->estop.active = 0;
+            }
+
+            if (this->estop.active) {
+                this->schedule.clear();
+                this->move = MOVEMENT_NONE;
+                this->move_duration = 0;
+            }
+
+            // Scheduled movements, the model applies them exactly on the millisecond they are due in
+            Remote src;
+            Movement scheduled;
+
+            while (this->schedule.due(this->now * 1000, &src, &scheduled)) {
+                this->deliver(src, nullptr, scheduled);
+            }
+
+            // Movement failsafe
+            if (this->move_duration && ((this->move_stamp + this->move_duration) < this->now)) {
+                this->move = MOVEMENT_NONE;
+                this->move_duration = 0;
+            }
+
+            this->state = this->move_duration ? CoreState::DRIVING : CoreState::STANDBY;
+
+            if (((this->trader_stamp + BUGSY_TRADER_MIN_UPDATES) < this->now) && (this->trader_state != TraderState::DISCONNECTED)) {
+                this->trader_state = TraderState::DISCONNECTED;
+                this->trader_baud.fallback();
+            }
+
+            // Unconfirmed baud rates
+            this->trader_baud.update(this->now);
+            this->rpi_baud.update(this->now);
+
+            // Update writer, every request takes the time of its flash operation, one after another
+            uint64_t now_us = (uint64_t)this->now * 1000;
+
+            while (true) {
+                if (this->ota_busy) {
+                    if (this->ota_until > now_us) {
+                        break;
+                    }
+
+                    this->ota_busy = false;
+                    this->ota_complete(this->ota_current);
+                }
+
+                if (this->ota_requests.empty()) {
+                    this->ota_until = now_us;
+                    break;
+                }
+
+                this->ota_current = this->ota_requests.front();
+                this->ota_requests.pop_front();
+                this->ota_until += this->ota_start(this->ota_current);
+                this->ota_busy = true;
+            }
+
+            if (this->ota_restart && ((int32_t)(this->now - this->ota_restart) >= 0)) {
+                this->ota_restart = 0;
+                this->ota = bugsy::ota::Session();
+                this->ota_id++;
+                this->restarts++;
+            }
+
+            // Speed control, runs on its own timer on the core and therefore does not depend on the loop
+            const double dt = bugsy::speed::TICK_PERIOD / 1000000.0;
+
+            while (this->next_tick <= ((uint64_t)this->now * 1000)) {
+                const bugsy::DriveCalibration& cal = this->configuration.drive;
+
+                int16_t target_left, target_right;
+                bugsy::speed::targets_of(this->move, cal, &target_left, &target_right);
+                this->speed.set_targets(target_left, target_right);
+
+                int16_t left, right;
+                this->speed.step((uint32_t)this->next_tick, this->chains[0].step(this->duties[0], dt),
+                    this->chains[1].step(this->duties[1], dt), cal, this->configuration.speed_gains, 0xFF, &left, &right);
+
+                if (this->configuration.speed_gains.enabled) {
+                    this->duties[0] = left;
+                    this->duties[1] = right;
+                } else {
+                    this->duties[0] = (bool)this->move.chain_left_dir ? this->move.chain_left_duty : -this->move.chain_left_duty;
+                    this->duties[1] = (bool)this->move.chain_right_dir ? this->move.chain_right_duty : -this->move.chain_right_duty;
+                }
+
+                this->next_tick += bugsy::speed::TICK_PERIOD;
+            }
+
+            // Idle sleep, a new one can only be planned once the last has ended
+            if (this->now >= this->sleep_until) {
+                bool level_changed = false;
+                uint32_t deadline = this->move_duration ? (this->move_stamp + this->move_duration) : (this->now + BUGSY_POWER_MAX_SLEEP);
+                uint32_t sleep = this->power.plan(this->now, this->move_duration != 0, deadline, &level_changed);
+
+                if (sleep) {
+                    this->power.record_sleep(sleep);
+                    this->sleep_until = this->now + sleep;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+# include "sim_flash.hpp"
+
+# include <string.h>
+
+namespace bugsy_rpi {
+    namespace sim {
+        void FlashPartition::touch() {
+            if (this->bytes.empty()) {
+                this->bytes.resize(this->size);
+
+                // Any content that is not erased, so missing erases show up
+                for (uint32_t i = 0; i < this->size; i++) {
+                    this->bytes[i] = (uint8_t)(i * 31);
+                }
+            }
+        }
+
+        uint32_t FlashPartition::erase(uint32_t len) {
+            uint32_t sectors = (len + this->params.sector - 1) / this->params.sector;
+            uint32_t end = sectors * this->params.sector;
+
+            this->touch();
+            memset(this->bytes.data(), 0xFF, (end < this->size) ? end : this->size);
+
+            return sectors * this->params.erase_us;
+        }
+
+        uint32_t FlashPartition::write(uint32_t offset, const uint8_t* data, size_t len) {
+            this->touch();
+
+            for (size_t i = 0; (i < len) && ((offset + i) < this->size); i++) {
+                this->bytes[offset + i] &= data[i];
+            }
+
+            // Pages are programmed one after another, a write spanning two pages programs both
+            uint32_t first = offset / this->params.page;
+            uint32_t last = (offset + (uint32_t)len - 1) / this->params.page;
+            return len ? ((last - first + 1) * this->params.program_us) : 0;
+        }
+
+        uint32_t FlashPartition::read(uint32_t offset, uint8_t* data, size_t len) {
+            this->touch();
+
+            size_t avail = (offset < this->size) ? (this->size - offset) : 0;
+            memcpy(data, this->bytes.data() + offset, (len < avail) ? len : avail);
+
+            return (uint32_t)((len * this->params.read_us) / 1024);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+# include "sim_fleet.hpp"
+
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+# include <sys/socket.h>
+# include <unistd.h>
+
+namespace bugsy_rpi {
+    namespace sim {
+        SimFleet::SimFleet() {
+            this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            this->stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+            struct epoll_event event = { };
+            event.events = EPOLLIN;
+            event.data.u64 = UINT64_MAX;
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->stop_fd, &event);
+        }
+
+        SimFleet::~SimFleet() {
+            this->stop();
+
+            for (Entry& entry : this->cores) {
+                ::close(entry.fd);
+            }
+
+            ::close(this->stop_fd);
+            ::close(this->epoll_fd);
+        }
+
+        std::unique_ptr<gateway::Link> SimFleet::add() {
+            int fds [2];
+
+            if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0, fds) < 0) {
+                return nullptr;
+            }
+
+            size_t index = this->cores.size();
+
+            Entry entry;
+            entry.fd = fds[0];
+            entry.core.reset(new SimCore([this, index] (bugsy::Remote, const uint8_t* buffer, size_t len) {
+                std::vector<uint8_t>& response = this->cores[index].response;
+                response.insert(response.end(), buffer, buffer + len);
+            }));
+            this->cores.push_back(std::move(entry));
+
+            struct epoll_event event = { };
+            event.events = EPOLLIN;
+            event.data.u64 = index;
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fds[0], &event);
+
+            return std::unique_ptr<gateway::Link>(new gateway::Link(fds[1], "sim:" + std::to_string(index)));
+        }
+
+        void SimFleet::start() {
+            this->running = true;
+            this->thread = std::thread(&SimFleet::serve, this);
+        }
+
+        void SimFleet::stop() {
+            if (!this->running) {
+                return;
+            }
+
+            this->running = false;
+
+            uint64_t one = 1;
+            if (write(this->stop_fd, &one, sizeof(one)) < 0) {
+                // Counter already set
+            }
+
+            this->thread.join();
+        }
+
+        void SimFleet::serve() {
+            std::vector<struct epoll_event> events (64);
+            uint64_t start = millis();
+            uint8_t packet [256];
+
+            while (this->running) {
+                int count = epoll_wait(this->epoll_fd, events.data(), (int)events.size(), -1);
+                uint32_t now = (uint32_t)(millis() - start);
+
+                for (int i = 0; i < count; i++) {
+                    if (events[i].data.u64 == UINT64_MAX) {
+                        continue;
+                    }
+
+                    Entry& entry = this->cores[events[i].data.u64];
+
+                    while (true) {
+                        ssize_t len = recv(entry.fd, packet, sizeof(packet), 0);
+
+                        if (len <= 0) {
+                            break;
+                        }
+
+                        entry.core->set_time(now);
+                        entry.core->update();
+
+                        entry.response.clear();
+                        entry.core->parse_cmd(bugsy::Remote::USB, packet, (size_t)len);
+
+                        if (!entry.response.empty()) {
+                            send(entry.fd, entry.response.data(), entry.response.size(), MSG_NOSIGNAL);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
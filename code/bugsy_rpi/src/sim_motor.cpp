@@ -0,0 +1,35 @@
+# include "sim_motor.hpp"
+
+# include <math.h>
+
+namespace bugsy_rpi {
+    namespace sim {
+        double MotorModel::steady_speed(int16_t duty) const {
+            int16_t duty_abs = (duty < 0) ? -duty : duty;
+
+            if (duty_abs <= this->params.deadband) {
+                return 0.0;
+            }
+
+            double x = (double)(duty_abs - this->params.deadband) / (255 - this->params.deadband);
+            double speed = this->params.max_speed * this->supply * pow(x, this->params.curve) - this->load;
+
+            if (speed < 0.0) {
+                speed = 0.0;
+            }
+
+            return (duty < 0) ? -speed : speed;
+        }
+
+        int32_t MotorModel::step(int16_t duty, double dt) {
+            this->speed += (this->steady_speed(duty) - this->speed) * (dt / (this->params.tau + dt));
+            this->position += this->speed * dt;
+
+            int64_t edges = (int64_t)floor((this->position * BUGSY_SPEED_ENCODER_EDGES_PER_M) / 1000.0);
+            int32_t delta = (int32_t)(edges - this->edges);
+            this->edges = edges;
+
+            return delta;
+        }
+    }
+}
@@ -0,0 +1,138 @@
+# include "sim_world.hpp"
+
+namespace bugsy_rpi {
+    namespace sim {
+        void World::add_wall(float x0, float y0, float x1, float y1) {
+            this->walls.push_back({ x0, y0, x1, y1 });
+        }
+
+        void World::add_box(float x, float y, float width, float height) {
+            this->add_wall(x, y, x + width, y);
+            this->add_wall(x + width, y, x + width, y + height);
+            this->add_wall(x + width, y + height, x, y + height);
+            this->add_wall(x, y + height, x, y);
+        }
+
+        void World::add_pillar(float x, float y, float radius) {
+            this->pillars.push_back({ x, y, radius });
+        }
+
+        World World::rooms() {
+            World world;
+
+            // Outer walls, 8 x 6 m around the origin
+            world.add_box(-4000.0f, -3000.0f, 8000.0f, 6000.0f);
+
+            // Dividing wall with a door of 1 m
+            world.add_wall(0.0f, -3000.0f, 0.0f, -500.0f);
+            world.add_wall(0.0f, 500.0f, 0.0f, 3000.0f);
+
+            // Furniture
+            world.add_box(-3000.0f, 1500.0f, 800.0f, 600.0f);
+            world.add_box(-2200.0f, -2400.0f, 1200.0f, 500.0f);
+            world.add_box(1500.0f, 1800.0f, 600.0f, 600.0f);
+            world.add_box(2600.0f, -1500.0f, 700.0f, 1200.0f);
+
+            world.add_pillar(-1500.0f, 0.0f, 200.0f);
+            world.add_pillar(1200.0f, -200.0f, 150.0f);
+            world.add_pillar(2800.0f, 1000.0f, 180.0f);
+
+            return world;
+        }
+
+        float World::cast(float x, float y, float angle, float max_range) const {
+            const float dx = cosf(angle);
+            const float dy = sinf(angle);
+            float best = max_range;
+
+            for (const Wall& wall : this->walls) {
+                float ex = wall.x1 - wall.x0;
+                float ey = wall.y1 - wall.y0;
+                float det = (ex * dy) - (ey * dx);
+
+                // Parallel to the wall
+                if (fabsf(det) < 1e-6f) {
+                    continue;
+                }
+
+                float wx = wall.x0 - x;
+                float wy = wall.y0 - y;
+                // Distance along the ray and position along the wall
+                float t = ((ex * wy) - (ey * wx)) / det;
+                float u = ((dx * wy) - (dy * wx)) / det;
+
+                if ((t > 0.0f) && (t < best) && (u >= 0.0f) && (u <= 1.0f)) {
+                    best = t;
+                }
+            }
+
+            for (const Pillar& pillar : this->pillars) {
+                float px = pillar.x - x;
+                float py = pillar.y - y;
+                float along = (px * dx) + (py * dy);
+                float off = (px * px) + (py * py) - (along * along);
+                float r2 = pillar.radius * pillar.radius;
+
+                if (off > r2) {
+                    continue;
+                }
+
+                float t = along - sqrtf(r2 - off);
+
+                if ((t > 0.0f) && (t < best)) {
+                    best = t;
+                }
+            }
+
+            return best;
+        }
+
+        float World::clearance(float x, float y) const {
+            float best = INFINITY;
+
+            for (const Wall& wall : this->walls) {
+                float ex = wall.x1 - wall.x0;
+                float ey = wall.y1 - wall.y0;
+                float u = (((x - wall.x0) * ex) + ((y - wall.y0) * ey)) / ((ex * ex) + (ey * ey));
+                u = fminf(fmaxf(u, 0.0f), 1.0f);
+
+                best = fminf(best, hypotf(x - (wall.x0 + (u * ex)), y - (wall.y0 + (u * ey))));
+            }
+
+            for (const Pillar& pillar : this->pillars) {
+                best = fminf(best, fabsf(hypotf(x - pillar.x, y - pillar.y) - pillar.radius));
+            }
+
+            return best;
+        }
+
+        mapping::Scan World::scan(const mapping::Pose& pose, const RangeParams& params, std::mt19937& rng, std::vector<float>& ranges) const {
+            std::normal_distribution<float> noise(0.0f, params.noise);
+            std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+            mapping::Scan scan;
+            scan.pose = pose;
+            scan.angle_step = params.fov / params.rays;
+            scan.angle_min = -(params.fov / 2.0f) + (scan.angle_step / 2.0f);
+            scan.max_range = params.max_range;
+
+            ranges.resize(params.rays);
+
+            for (uint16_t i = 0; i < params.rays; i++) {
+                float range = this->cast(pose.x, pose.y, pose.theta + scan.angle_min + (i * scan.angle_step), params.max_range);
+
+                if (chance(rng) < params.dropout) {
+                    ranges[i] = 0.0f;
+                } else if (range >= params.max_range) {
+                    ranges[i] = params.max_range;
+                } else {
+                    ranges[i] = fmaxf(range + noise(rng), 1.0f);
+                }
+            }
+
+            scan.ranges = ranges.data();
+            scan.count = ranges.size();
+            return scan;
+        }
+    }
+}
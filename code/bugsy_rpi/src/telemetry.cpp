@@ -0,0 +1,243 @@
+# include "telemetry.hpp"
+
+# include <errno.h>
+# include <fcntl.h>
+# include <string.h>
+# include <sys/mman.h>
+# include <unistd.h>
+
+namespace bugsy_rpi {
+    namespace telemetry {
+        /// Maps the shared memory object `name`, creating it if `writable` is set
+        static void* map_ring(const char* name, bool writable) {
+            int fd = shm_open(name, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+
+            if (fd < 0) {
+                log_errorln("> [ERROR] Failed to open telemetry ring '" << name << "': " << strerror(errno));
+                return nullptr;
+            }
+
+            if (writable && (ftruncate(fd, sizeof(Ring)) < 0)) {
+                log_errorln("> [ERROR] Failed to resize telemetry ring: " << strerror(errno));
+                ::close(fd);
+                return nullptr;
+            }
+
+            void* addr = mmap(nullptr, sizeof(Ring), writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);     // The mapping stays valid without the descriptor
+
+            if (addr == MAP_FAILED) {
+                log_errorln("> [ERROR] Failed to map telemetry ring: " << strerror(errno));
+                return nullptr;
+            }
+
+            return addr;
+        }
+
+        // Writer
+            Writer::~Writer() {
+                this->close();
+            }
+
+            bool Writer::open(const char* name) {
+                this->ring = (Ring*)map_ring(name, true);
+
+                if (!this->ring) {
+                    return false;
+                }
+
+                // Reuse a ring of a previous daemon run, so readers can just continue
+                if ((this->ring->magic.load(std::memory_order_acquire) == RING_MAGIC)
+                    && (this->ring->frame_size == sizeof(Frame))
+                    && (this->ring->slots == BUGSY_RPI_TELEMETRY_SLOTS)
+                ) {
+                    // A daemon that died while publishing left its slot odd, the next publish would invert its parity.
+                    // The frame in it has never been published (`head` was not advanced), its index does not match
+                    for (size_t i = 0; i < BUGSY_RPI_TELEMETRY_SLOTS; i++) {
+                        uint32_t seq = this->ring->slot[i].seq.load(std::memory_order_relaxed);
+
+                        if (seq & 1) {
+                            this->ring->slot[i].seq.store(seq + 1, std::memory_order_release);
+                        }
+                    }
+
+                    return true;
+                }
+
+                // A new ring or one of another software version. `ftruncate` only zeroes the bytes it adds, so the slots of
+                // an older layout keep their counters. Readers opening meanwhile reject the ring until `magic` is back
+                this->ring->magic.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                for (size_t i = 0; i < BUGSY_RPI_TELEMETRY_SLOTS; i++) {
+                    Slot& slot = this->ring->slot[i];
+                    slot.seq.store(0, std::memory_order_relaxed);
+                    slot.index.store(0, std::memory_order_relaxed);
+
+                    for (size_t w = 0; w < FRAME_WORDS; w++) {
+                        slot.words[w].store(0, std::memory_order_relaxed);
+                    }
+                }
+
+                this->ring->frame_size = sizeof(Frame);
+                this->ring->slots = BUGSY_RPI_TELEMETRY_SLOTS;
+                this->ring->head.store(0, std::memory_order_relaxed);
+                this->ring->magic.store(RING_MAGIC, std::memory_order_release);
+
+                return true;
+            }
+
+            void Writer::close() {
+                if (this->ring) {
+                    munmap(this->ring, sizeof(Ring));
+                    this->ring = nullptr;
+                }
+            }
+
+            void Writer::publish(const Frame* frame) {
+                uint32_t words [FRAME_WORDS] = { 0 };
+                memcpy(words, frame, sizeof(Frame));
+
+                uint32_t index = this->ring->head.load(std::memory_order_relaxed);
+                Slot& slot = this->ring->slot[index & (BUGSY_RPI_TELEMETRY_SLOTS - 1)];
+                uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+
+                // Mark the slot as being written
+                slot.seq.store(seq + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                slot.index.store(index, std::memory_order_relaxed);
+                for (size_t i = 0; i < FRAME_WORDS; i++) {
+                    slot.words[i].store(words[i], std::memory_order_relaxed);
+                }
+
+                // Mark as stable again and make the frame visible
+                slot.seq.store(seq + 2, std::memory_order_release);
+                this->ring->head.store(index + 1, std::memory_order_release);
+            }
+        //
+
+        // Reader
+            Reader::~Reader() {
+                this->close();
+            }
+
+            bool Reader::open(const char* name) {
+                this->ring = (const Ring*)map_ring(name, false);
+
+                if (!this->ring) {
+                    return false;
+                }
+
+                if ((this->ring->magic.load(std::memory_order_acquire) != RING_MAGIC)
+                    || (this->ring->frame_size != sizeof(Frame))
+                    || (this->ring->slots != BUGSY_RPI_TELEMETRY_SLOTS)
+                ) {
+                    log_errorln("> [ERROR] Telemetry ring has not been initialized or uses a different layout!");
+                    this->close();
+                    return false;
+                }
+
+                // Start with the latest frame
+                uint32_t head = this->ring->head.load(std::memory_order_acquire);
+                this->tail = head ? (head - 1) : 0;
+                this->missed_frames = 0;
+
+                return true;
+            }
+
+            void Reader::close() {
+                if (this->ring) {
+                    munmap((void*)this->ring, sizeof(Ring));
+                    this->ring = nullptr;
+                }
+            }
+
+            Reader::Copy Reader::read(uint32_t index, Frame* frame) {
+                const Slot& slot = this->ring->slot[index & (BUGSY_RPI_TELEMETRY_SLOTS - 1)];
+                uint32_t words [FRAME_WORDS];
+
+                // Bounded, a writer that died while publishing leaves the slot odd until the next one opens the ring
+                for (uint32_t attempt = 0; attempt < BUGSY_RPI_TELEMETRY_READ_RETRIES; attempt++) {
+                    uint32_t seq_start = slot.seq.load(std::memory_order_acquire);
+
+                    if (seq_start & 1) {
+                        continue;       // Writer is currently updating the slot, only takes a few hundred nanoseconds
+                    }
+
+                    uint32_t slot_index = slot.index.load(std::memory_order_relaxed);
+                    for (size_t i = 0; i < FRAME_WORDS; i++) {
+                        words[i] = slot.words[i].load(std::memory_order_relaxed);
+                    }
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+
+                    if (slot.seq.load(std::memory_order_relaxed) != seq_start) {
+                        continue;       // Slot changed while copying
+                    }
+
+                    if (slot_index != index) {
+                        return Copy::OVERWRITTEN;
+                    }
+
+                    memcpy(frame, words, sizeof(Frame));
+                    return Copy::DONE;
+                }
+
+                return Copy::BUSY;
+            }
+
+            bool Reader::next(Frame* frame) {
+                while (true) {
+                    uint32_t head = this->ring->head.load(std::memory_order_acquire);
+
+                    if (head == this->tail) {
+                        return false;
+                    }
+
+                    // Skip frames that have already been overwritten
+                    if ((head - this->tail) > BUGSY_RPI_TELEMETRY_SLOTS) {
+                        this->missed_frames += (head - this->tail) - BUGSY_RPI_TELEMETRY_SLOTS;
+                        this->tail = head - BUGSY_RPI_TELEMETRY_SLOTS;
+                    }
+
+                    Copy copy = this->read(this->tail, frame);
+
+                    if (copy == Copy::DONE) {
+                        this->tail++;
+                        return true;
+                    }
+
+                    if (copy == Copy::BUSY) {
+                        return false;
+                    }
+
+                    // The writer lapped the reader while copying, try again with the updated head
+                    this->tail++;
+                    this->missed_frames++;
+                }
+            }
+
+            bool Reader::latest(Frame* frame) {
+                while (true) {
+                    uint32_t head = this->ring->head.load(std::memory_order_acquire);
+
+                    if (head == 0) {
+                        return false;
+                    }
+
+                    Copy copy = this->read(head - 1, frame);
+
+                    if (copy == Copy::DONE) {
+                        this->tail = head;
+                        return true;
+                    }
+
+                    if (copy == Copy::BUSY) {
+                        return false;
+                    }
+                }
+            }
+        //
+    }
+}
@@ -0,0 +1,68 @@
+# include "thread_pool.hpp"
+
+namespace bugsy_rpi {
+    ThreadPool::ThreadPool(size_t workers) {
+        if (workers == 0) {
+            workers = std::thread::hardware_concurrency();
+        }
+
+        if (workers == 0) {
+            workers = 1;
+        }
+
+        for (size_t i = 0; i < workers; i++) {
+            this->workers.emplace_back(&ThreadPool::run, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock (this->mutex);
+            this->stopping = true;
+        }
+
+        this->cond.notify_all();
+
+        for (std::thread& worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock (this->mutex);
+            this->tasks.push_back(std::move(task));
+        }
+
+        this->cond.notify_one();
+    }
+
+    size_t ThreadPool::pending() {
+        std::lock_guard<std::mutex> lock (this->mutex);
+        return this->tasks.size() + this->active;
+    }
+
+    void ThreadPool::run() {
+        while (true) {
+            Task task;
+
+            {
+                std::unique_lock<std::mutex> lock (this->mutex);
+                this->cond.wait(lock, [this] { return this->stopping || !this->tasks.empty(); });
+
+                if (this->tasks.empty()) {
+                    return;     // Stopping and all tasks are done
+                }
+
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+                this->active++;
+            }
+
+            task();
+
+            std::lock_guard<std::mutex> lock (this->mutex);
+            this->active--;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+// ######################
+// ##   BUGSY-CAMERA   ##
+// ######################
+//
+// Captures camera frames, downscales and JPEG encodes them and streams them over TCP (see `camera::StreamHeader`)
+//
+// Usage: `camera [source] [port]` with `source` being a V4L2 device (`/dev/video0`, default), a file of raw YUYV frames
+// or `synthetic` for a generated test pattern
+
+# include <memory>
+# include <string.h>
+# include <unistd.h>
+
+# include "bugsy_rpi.hpp"
+# include "camera.hpp"
+# include "thread_pool.hpp"
+
+using namespace bugsy_rpi::camera;
+
+int main(int argc, char** argv) {
+    const char* source_name = (argc > 1) ? argv[1] : "/dev/video0";
+    uint16_t port = (argc > 2) ? (uint16_t)atoi(argv[2]) : BUGSY_RPI_CAMERA_PORT;
+
+    std::unique_ptr<Source> source;
+
+    if (strcmp(source_name, "synthetic") == 0) {
+        source.reset(new SyntheticSource(BUGSY_RPI_CAMERA_WIDTH, BUGSY_RPI_CAMERA_HEIGHT));
+    } else if (strncmp(source_name, "/dev/video", 10) == 0) {
+        source.reset(new V4L2Source(source_name, BUGSY_RPI_CAMERA_WIDTH, BUGSY_RPI_CAMERA_HEIGHT));
+    } else {
+        source.reset(new FileSource(source_name, BUGSY_RPI_CAMERA_WIDTH, BUGSY_RPI_CAMERA_HEIGHT));
+    }
+
+    bugsy_rpi::ThreadPool workers;
+
+    Downscale downscale (2, BUGSY_RPI_CAMERA_WIDTH, BUGSY_RPI_CAMERA_HEIGHT);
+    JpegEncoder jpeg (BUGSY_RPI_CAMERA_JPEG_QUALITY, BUGSY_RPI_CAMERA_WIDTH, BUGSY_RPI_CAMERA_HEIGHT);
+    TcpSink sink (port);
+
+    if (!sink.start()) {
+        return 1;
+    }
+
+    Pipeline pipeline (source.get(), &workers);
+    pipeline.add_stage(&downscale);
+    pipeline.add_stage(&jpeg);
+    pipeline.add_sink(&sink);
+
+    log_info("> Starting camera pipeline (" << source->name() << ", " << workers.size() << " workers)");
+    log_infoln(" on port " << port << " ...");
+
+    if (!pipeline.start()) {
+        return 1;
+    }
+
+    while (true) {
+        sleep(5);
+        pipeline.log_metrics();
+    }
+}
@@ -0,0 +1,149 @@
+// Load generator for the gateway, measures how the request latency and the CPU time of the event loop scale with the
+// size of the fleet
+//
+// Usage: `fleet_load [--rate <requests/s per robot>] [--duration <seconds>] [<robots>...]`
+//
+// For every fleet size a gateway with that many simulated cores is created, every robot receives `GetState` requests at
+// the given rate (like a teleop client) on top of the telemetry polls of the gateway.
+
+# include <algorithm>
+# include <stdlib.h>
+# include <string.h>
+# include <thread>
+# include <unistd.h>
+
+# include "bugsy_rpi.hpp"
+# include "gateway.hpp"
+# include "sim_fleet.hpp"
+
+using namespace bugsy_rpi;
+
+/// Results of a single fleet size
+struct Result {
+    size_t robots;
+    uint64_t requests;
+    uint64_t failed;
+    double latency_avg;
+    uint64_t latency_p50;
+    uint64_t latency_p99;
+    uint64_t latency_max;
+    /// CPU load of the gateway's event loop in percent of one core
+    double cpu;
+    double duration;
+};
+
+static Result run(size_t robots, double rate, double duration) {
+    gateway::Gateway gw;
+    sim::SimFleet fleet;
+
+    for (size_t i = 0; i < robots; i++) {
+        gw.add(fleet.add());
+    }
+
+    fleet.start();
+    std::thread loop ([&gw] { gw.run(); });
+
+    // Only touched by the callbacks on the event loop thread
+    std::vector<uint64_t> latencies;
+    uint64_t failed = 0;
+
+    const uint8_t cmd = (uint8_t)bugsy::Command::GetState;
+    uint64_t interval = (uint64_t)(1000000.0 / (rate * robots));
+    uint64_t start = micros();
+    uint64_t end = start + (uint64_t)(duration * 1000000);
+    uint64_t next = start;
+    size_t robot = 0;
+
+    // Requests are spread evenly over time and the fleet
+    while (next < end) {
+        uint64_t now = micros();
+
+        if (now < next) {
+            usleep((useconds_t)std::min<uint64_t>(next - now, 1000));
+            continue;
+        }
+
+        uint64_t sent = now;
+        gw.submit((gateway::RobotId)robot, &cmd, 1, sizeof(bugsy::CoreState), [&latencies, &failed, sent] (gateway::Status status, const uint8_t*, size_t) {
+            if (status == gateway::Status::OK) {
+                latencies.push_back(micros() - sent);
+            } else {
+                failed++;
+            }
+        });
+
+        robot = (robot + 1) % robots;
+        next += interval;
+    }
+
+    // Let the last requests finish
+    usleep((BUGSY_GATEWAY_TIMEOUT + 10) * 1000);
+
+    gateway::Stats stats = gw.stats();
+    gw.stop();
+    loop.join();
+    fleet.stop();
+
+    Result result = { };
+    result.robots = robots;
+    result.requests = latencies.size();
+    result.failed = failed;
+    result.duration = (micros() - start) / 1000000.0;
+    result.cpu = (stats.cpu_time / 10000.0) / result.duration;
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+
+        uint64_t sum = 0;
+        for (uint64_t latency : latencies) {
+            sum += latency;
+        }
+
+        result.latency_avg = (double)sum / latencies.size();
+        result.latency_p50 = latencies[latencies.size() / 2];
+        result.latency_p99 = latencies[(latencies.size() * 99) / 100];
+        result.latency_max = latencies.back();
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    double rate = 20;
+    double duration = 3;
+    std::vector<size_t> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--rate") == 0) && ((i + 1) < argc)) {
+            rate = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--duration") == 0) && ((i + 1) < argc)) {
+            duration = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--help") == 0) || (strcmp(argv[i], "-h") == 0)) {
+            log_infoln("Usage: fleet_load [--rate <requests/s per robot>] [--duration <seconds>] [<robots>...]");
+            return 0;
+        } else if ((argv[i][0] == '-') || (atoi(argv[i]) <= 0)) {
+            // Anything else would be taken for a fleet size of 0 and the benchmark would run with the defaults
+            log_errorln("Usage: fleet_load [--rate <requests/s per robot>] [--duration <seconds>] [<robots>...]");
+            return 1;
+        } else {
+            sizes.push_back((size_t)atoi(argv[i]));
+        }
+    }
+
+    if (sizes.empty()) {
+        sizes = { 1, 10, 100, 250, 500 };
+    }
+
+    log_infoln("> " << rate << " requests/s per robot for " << duration << " s");
+    log_infoln("| robots | requests | failed | avg [us] | p50 [us] | p99 [us] | max [us] | gateway CPU [%] |");
+    log_infoln("| ------ | -------- | ------ | -------- | -------- | -------- | -------- | --------------- |");
+
+    for (size_t size : sizes) {
+        Result r = run(size, rate, duration);
+
+        log_infoln("| " << r.robots << " | " << r.requests << " | " << r.failed << " | " << (uint64_t)r.latency_avg
+            << " | " << r.latency_p50 << " | " << r.latency_p99 << " | " << r.latency_max << " | " << r.cpu << " |");
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Fleet gateway, connects to any amount of robots and serves TCP clients
+//
+// Usage: `gateway [--port <port>] [--sim <count>] <link>...`
+//
+// Links are given as `serial:<device>[:<baud>]`, `pty:<path>` or `tcp:<host>:<port>`, robots get their IDs in the
+// given order. `--sim` adds simulated cores after the given links. The fleet telemetry is logged every 5 seconds.
+
+# include <signal.h>
+# include <stdlib.h>
+# include <string.h>
+# include <thread>
+# include <unistd.h>
+
+# include "bugsy_rpi.hpp"
+# include "gateway.hpp"
+# include "sim_fleet.hpp"
+
+using namespace bugsy_rpi;
+
+/// Cleared by `SIGINT` / `SIGTERM` to shut the gateway down cleanly
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int) {
+    running = 0;
+}
+
+int main(int argc, char** argv) {
+    uint16_t port = BUGSY_GATEWAY_PORT;
+    size_t sim_count = 0;
+
+    gateway::Gateway gw;
+    sim::SimFleet sim_fleet;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--port") == 0) && ((i + 1) < argc)) {
+            port = (uint16_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--sim") == 0) && ((i + 1) < argc)) {
+            sim_count = (size_t)atoi(argv[++i]);
+        } else {
+            std::unique_ptr<gateway::Link> link = gateway::open_link(argv[i]);
+
+            if (!link) {
+                return 1;
+            }
+
+            log_infoln("> Robot " << gw.add(std::move(link)) << ": '" << argv[i] << "'");
+        }
+    }
+
+    for (size_t i = 0; i < sim_count; i++) {
+        gw.add(sim_fleet.add());
+    }
+
+    if (gw.robots() == 0) {
+        log_errorln("Usage: gateway [--port <port>] [--sim <count>] <link>...");
+        return 1;
+    }
+
+    if (!gw.listen(port)) {
+        return 1;
+    }
+
+    sim_fleet.start();
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    log_infoln("> Serving " << gw.robots() << " robots on port " << port << " ...");
+
+    std::thread loop ([&gw] { gw.run(); });
+
+    while (running) {
+        for (int i = 0; (i < 50) && running; i++) {
+            usleep(100000);
+        }
+
+        std::vector<gateway::RobotTelemetry> fleet = gw.telemetry();
+        size_t connected = 0;
+
+        for (gateway::RobotId id = 0; id < fleet.size(); id++) {
+            const gateway::RobotTelemetry& robot = fleet[id];
+            connected += robot.connected;
+
+            log_info("| > Robot " << id << ": state 0x" << std::hex << (int)robot.state << std::dec);
+            log_info(", battery " << robot.battery.voltage << " mV/" << (int)robot.battery.charge << "%");
+            log_infoln(", " << robot.requests << " requests, " << robot.timeouts << " timeouts" << (robot.connected ? "" : " (lost)"));
+        }
+
+        gateway::Stats stats = gw.stats();
+        log_infoln("> " << connected << "/" << fleet.size() << " robots connected, " << stats.completed << " requests, CPU " << (stats.cpu_time / 1000) << " ms");
+    }
+
+    log_infoln("> Shutting down ...");
+    gw.stop();
+    loop.join();
+    sim_fleet.stop();
+
+    return 0;
+}
@@ -0,0 +1,315 @@
+// Benchmark and regression check of the occupancy grid mapping against a synthetic world (see `sim_world.hpp`)
+//
+// Usage: `map_bench [--rays <per scan>] [--seed <seed>] [--pgm <file>]`
+//
+// Drives a simulated robot through two furnished rooms, scanning at 10 Hz, once with exact poses and once with poses
+// from noisy chain odometry. The scans of every scenario are integrated with the scalar and the vector kernel, the
+// program prints a markdown table of their throughput and the accuracy of the maps and exits with `1` if the kernels
+// disagree or the map of the exact poses misses the accuracy requirements. `--pgm` writes that map as an image.
+
+# include <chrono>
+# include <fstream>
+# include <math.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include <bugsy/drive.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "mapping.hpp"
+# include "sim_world.hpp"
+
+using namespace bugsy_rpi;
+
+/// Time between two scans in seconds
+# define SCAN_PERIOD 0.1f
+/// Driving speed of the robot in mm/s
+# define DRIVE_SPEED 300.0f
+/// Turning speed of the robot in rad/s
+# define TURN_SPEED 1.6f
+/// Runs of every kernel, the fastest one counts
+# define RUNS 5
+
+/// Minimum share of the occupied cells that contain a surface
+# define REQUIRED_OCCUPIED_PRECISION 95.0
+/// Minimum share of the free cells that contain no surface
+# define REQUIRED_FREE_PRECISION 99.0
+
+struct Point {
+    float x;
+    float y;
+};
+
+/// Round trip through both rooms, clear of the furniture
+static const Point PATH [] = {
+    { -3300.0f, -1300.0f }, { -1000.0f, -1300.0f }, { -600.0f, 0.0f }, { 600.0f, 0.0f }, { 1800.0f, 800.0f },
+    { 1800.0f, -2300.0f }, { 3600.0f, -2300.0f }, { 3600.0f, 2600.0f }, { 800.0f, 2600.0f }, { 600.0f, 0.0f },
+    { -600.0f, 0.0f }, { -1000.0f, 900.0f }, { -3300.0f, 900.0f }, { -3300.0f, -1300.0f }
+};
+
+struct Scenario {
+    const char* name;
+    /// Standard deviation of the distance measured by the chains, relative to the distance
+    float odometry_noise;
+    /// Constant scale error of the left and right chain
+    float left_scale;
+    float right_scale;
+};
+
+static const Scenario SCENARIOS [] = {
+    { "exact poses", 0.0f, 1.0f, 1.0f },
+    { "odometry 2% noise", 0.02f, 1.0f, 1.0f },
+    { "odometry 1% slip", 0.02f, 0.99f, 1.0f }
+};
+
+struct Accuracy {
+    /// Share of the occupied cells that contain a surface in percent
+    double occupied;
+    /// Share of the free cells that contain no surface in percent
+    double free;
+    /// Area of the cells known as free or occupied in m²
+    double known;
+};
+
+/// The poses of the robot driving along `PATH`, one per scan
+static std::vector<mapping::Pose> drive() {
+    std::vector<mapping::Pose> poses;
+    mapping::Pose pose;
+    pose.x = PATH[0].x;
+    pose.y = PATH[0].y;
+
+    for (size_t i = 1; i < (sizeof(PATH) / sizeof(Point)); i++) {
+        float dx = PATH[i].x - pose.x;
+        float dy = PATH[i].y - pose.y;
+        float heading = atan2f(dy, dx);
+        float turn = remainderf(heading - pose.theta, 2.0f * (float)M_PI);
+
+        // Turning on the spot towards the next point
+        for (uint32_t k = 0, n = (uint32_t)ceilf(fabsf(turn) / (TURN_SPEED * SCAN_PERIOD)); k < n; k++) {
+            pose.theta = remainderf(pose.theta + (turn / n), 2.0f * (float)M_PI);
+            poses.push_back(pose);
+        }
+
+        float length = hypotf(dx, dy);
+
+        for (uint32_t k = 0, n = (uint32_t)ceilf(length / (DRIVE_SPEED * SCAN_PERIOD)); k < n; k++) {
+            pose.x += dx / n;
+            pose.y += dy / n;
+            poses.push_back(pose);
+        }
+    }
+
+    return poses;
+}
+
+/// The poses the odometry estimates along the true ones
+static std::vector<mapping::Pose> estimate(const std::vector<mapping::Pose>& truth, const Scenario& scenario, std::mt19937& rng) {
+    const float track_width = bugsy::drive::DEFAULT_CALIBRATION.track_width;
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    mapping::Odometry odometry(track_width, truth[0]);
+    std::vector<mapping::Pose> poses = { truth[0] };
+
+    for (size_t i = 1; i < truth.size(); i++) {
+        float distance = hypotf(truth[i].x - truth[i - 1].x, truth[i].y - truth[i - 1].y);
+        float turn = remainderf(truth[i].theta - truth[i - 1].theta, 2.0f * (float)M_PI);
+
+        float left = distance - (turn * track_width / 2.0f);
+        float right = distance + (turn * track_width / 2.0f);
+
+        left *= scenario.left_scale * (1.0f + (scenario.odometry_noise * noise(rng)));
+        right *= scenario.right_scale * (1.0f + (scenario.odometry_noise * noise(rng)));
+
+        odometry.update(left, right);
+        poses.push_back(odometry.pose());
+    }
+
+    return poses;
+}
+
+static Accuracy accuracy(const mapping::OccupancyGrid& grid, const sim::World& world) {
+    const float cell = grid.parameters().cell_size;
+    uint64_t occupied = 0, occupied_right = 0, free = 0, free_right = 0;
+
+    for (uint32_t cy = 0; cy < grid.cells_y(); cy++) {
+        for (uint32_t cx = 0; cx < grid.cells_x(); cx++) {
+            mapping::CellState state = grid.state(cx, cy);
+
+            if (state == mapping::CellState::UNKNOWN) {
+                continue;
+            }
+
+            float x, y;
+            grid.center_of(cx, cy, &x, &y);
+            float clearance = world.clearance(x, y);
+
+            if (state == mapping::CellState::OCCUPIED) {
+                occupied++;
+                // One cell of tolerance, a surface on the border between two cells may raise either of them
+                occupied_right += (clearance < (cell * 1.5f));
+            } else {
+                free++;
+                // A surface closer to the center than half a cell definitely crosses the cell
+                free_right += (clearance >= (cell / 2.0f));
+            }
+        }
+    }
+
+    Accuracy result;
+    result.occupied = occupied ? (occupied_right * 100.0 / occupied) : 0.0;
+    result.free = free ? (free_right * 100.0 / free) : 0.0;
+    result.known = (occupied + free) * (cell / 1000.0) * (cell / 1000.0);
+    return result;
+}
+
+/// Integrates all scans with the given kernel
+/// @return The fastest run in seconds
+static double integrate(mapping::OccupancyGrid& grid, const std::vector<mapping::Scan>& scans) {
+    double best = INFINITY;
+
+    for (uint8_t run = 0; run < RUNS; run++) {
+        grid.clear();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (const mapping::Scan& scan : scans) {
+            grid.integrate(scan);
+        }
+
+        best = fmin(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+}
+
+static bool same(const mapping::OccupancyGrid& a, const mapping::OccupancyGrid& b) {
+    for (uint32_t cy = 0; cy < a.cells_y(); cy++) {
+        for (uint32_t cx = 0; cx < a.cells_x(); cx++) {
+            if (a.get(cx, cy) != b.get(cx, cy)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool write_pgm(const char* path, const mapping::OccupancyGrid& grid) {
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file) {
+        return false;
+    }
+
+    file << "P5\n" << grid.cells_x() << " " << grid.cells_y() << "\n255\n";
+
+    // Top row first, occupied cells dark
+    for (uint32_t row = 0; row < grid.cells_y(); row++) {
+        uint32_t cy = grid.cells_y() - 1 - row;
+
+        for (uint32_t cx = 0; cx < grid.cells_x(); cx++) {
+            file.put((char)(uint8_t)lroundf(255.0f * (1.0f - grid.probability(cx, cy))));
+        }
+    }
+
+    return (bool)file;
+}
+
+int main(int argc, char** argv) {
+    sim::RangeParams range;
+    uint32_t seed = 1;
+    const char* pgm = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if ((i + 1) >= argc) {
+            log_errorln("> [ERROR] Missing value for '" << argv[i] << "'!");
+            return 1;
+        }
+
+        if (!strcmp(argv[i], "--rays")) {
+            range.rays = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed")) {
+            seed = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--pgm")) {
+            pgm = argv[++i];
+        } else {
+            log_errorln("> [ERROR] Unknown argument '" << argv[i] << "'!");
+            return 1;
+        }
+    }
+
+    if (range.rays == 0) {
+        log_errorln("> [ERROR] A scan needs at least one ray!");
+        return 1;
+    }
+
+    const sim::World world = sim::World::rooms();
+    const std::vector<mapping::Pose> truth = drive();
+
+    log_infoln("> " << truth.size() << " scans of " << range.rays << " rays, cells of " << BUGSY_RPI_MAP_CELL_SIZE << " mm");
+    log_infoln("");
+    log_infoln("| Scenario | Kernel | Rays/s | Cell updates/s | Occupied correct | Free correct | Known area |");
+    log_infoln("|---|---|---|---|---|---|---|");
+
+    bool passed = true;
+
+    for (const Scenario& scenario : SCENARIOS) {
+        std::mt19937 rng(seed);
+        std::vector<mapping::Pose> poses = estimate(truth, scenario, rng);
+
+        // The scans are taken at the true poses, but integrated at the estimated ones
+        std::vector<std::vector<float>> ranges(truth.size());
+        std::vector<mapping::Scan> scans;
+
+        for (size_t i = 0; i < truth.size(); i++) {
+            scans.push_back(world.scan(truth[i], range, rng, ranges[i]));
+            scans.back().pose = poses[i];
+        }
+
+        mapping::GridParams scalar_params;
+        scalar_params.kernel = mapping::Kernel::SCALAR;
+
+        mapping::GridParams vector_params;
+        vector_params.kernel = mapping::Kernel::VECTOR;
+
+        // Some margin around the 8 x 6 m of the world for drifted poses
+        mapping::OccupancyGrid scalar(10000.0f, 8000.0f, scalar_params);
+        mapping::OccupancyGrid vector(10000.0f, 8000.0f, vector_params);
+
+        double times [2] = { integrate(scalar, scans), integrate(vector, scans) };
+        const mapping::OccupancyGrid* grids [2] = { &scalar, &vector };
+        Accuracy acc = accuracy(vector, world);
+
+        for (uint8_t k = 0; k < 2; k++) {
+            const mapping::GridStats& stats = grids[k]->stats();
+
+            log_infoln("| " << scenario.name << " | " << ((k == 0) ? "scalar" : "vector")
+                << " | " << (uint64_t)(stats.rays / times[k])
+                << " | " << (uint64_t)(stats.updates / times[k])
+                << " | " << acc.occupied << " %"
+                << " | " << acc.free << " %"
+                << " | " << acc.known << " m² |");
+        }
+
+        if (!same(scalar, vector)) {
+            log_errorln("> [ERROR] The kernels disagree in scenario '" << scenario.name << "'!");
+            passed = false;
+        }
+
+        // Only the map of the exact poses has to be accurate, the others show the effect of the odometry
+        if ((&scenario == &SCENARIOS[0]) && ((acc.occupied < REQUIRED_OCCUPIED_PRECISION) || (acc.free < REQUIRED_FREE_PRECISION))) {
+            log_errorln("> [ERROR] Map of scenario '" << scenario.name << "' is not accurate enough!");
+            passed = false;
+        }
+
+        if ((&scenario == &SCENARIOS[0]) && pgm && !write_pgm(pgm, vector)) {
+            log_errorln("> [ERROR] Failed to write '" << pgm << "'!");
+            passed = false;
+        }
+    }
+
+    log_infoln("");
+    log_infoln((passed ? "> All checks passed" : "> Checks FAILED"));
+
+    return passed ? 0 : 1;
+}
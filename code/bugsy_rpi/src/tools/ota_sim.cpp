@@ -0,0 +1,262 @@
+// Throughput and robustness check of the firmware update (see `bugsy/ota.hpp`) against the simulated core
+//
+// Usage: `ota_sim [--size <bytes>] [--seed <seed>]`
+//
+// Uploads a random image through a model of the RPi UART and of a Bluetooth link in a set of scenarios (clean, lost and
+// broken chunks, an outage in the middle of the transfer), resuming the upload whenever the core stops answering. Prints
+// a markdown table of the results and exits with `1` if the partition of the core does not hold the image afterwards
+// in any scenario. All times are simulated.
+
+# include <stdlib.h>
+# include <string.h>
+# include <vector>
+
+# include <bugsy/ota.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "sim_core.hpp"
+
+using namespace bugsy_rpi;
+
+using bugsy::OtaState;
+using bugsy::Remote;
+
+/// Time in milliseconds the uploader waits after the core stopped answering until it resumes
+# define RESUME_DELAY 500
+/// Length of the outage of the outage scenario in milliseconds
+# define OUTAGE_DURATION 3000
+
+/// A link between the uploader and the core
+struct LinkParams {
+    const char* name;
+    Remote remote;
+    /// Bytes per second in both directions
+    uint32_t rate;
+    /// Latency of the link in one direction in microseconds
+    uint32_t latency;
+};
+
+struct Scenario {
+    const char* name;
+    /// Chunks lost on the way in percent
+    double loss;
+    /// Chunks arriving broken in percent
+    double corrupt;
+    /// Whether the link is gone for `OUTAGE_DURATION` once half of the image has been sent
+    bool outage;
+};
+
+/// Transport of the upload (see `bugsy::ota::upload()`), delivering every transfer to the simulated core after its
+/// transfer time
+class SimLink {
+public:
+    SimLink(sim::SimCore& core, const LinkParams& params, const Scenario& scenario, uint16_t outage_at)
+        : core(core), params(params), scenario(scenario), outage_at(outage_at) { }
+
+    bool send(const uint8_t* data, size_t len) {
+        this->transfer(len);
+
+        if (this->down()) {
+            return true;
+        }
+
+        // Only chunks are lost, a lost request shows up as a timeout like an outage
+        if ((data[0] == (uint8_t)bugsy::Command::OtaChunk) && this->chance(this->scenario.loss)) {
+            return true;
+        }
+
+        std::vector<uint8_t> frame (data, data + len);
+
+        if ((data[0] == (uint8_t)bugsy::Command::OtaChunk) && this->chance(this->scenario.corrupt)) {
+            frame[1 + (rand() % (len - 1))] ^= 0x10;
+        }
+
+        if (data[0] == (uint8_t)bugsy::Command::OtaChunk) {
+            this->chunks++;
+        }
+
+        this->core.parse_cmd(this->params.remote, frame.data(), frame.size());
+        this->step();
+        return true;
+    }
+
+    bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len) {
+        this->answer.clear();
+        this->send(cmd, len);
+
+        // The chunks sent before are on their way at the same time, only the request waits for the round trip
+        this->clock += 2 * (uint64_t)this->params.latency;
+        this->step();
+
+        if (this->down() || (this->answer.size() < answer_len)) {
+            this->wait(BUGSY_RPI_CORE_TIMEOUT);
+            return false;
+        }
+
+        this->transfer(answer_len);
+        memcpy(answer, this->answer.data(), answer_len);
+        return true;
+    }
+
+    void wait(uint32_t ms) {
+        this->clock += (uint64_t)ms * 1000;
+        this->step();
+    }
+
+    /// @brief Receives the output of the core
+    void output(const uint8_t* data, size_t len) {
+        this->answer.insert(this->answer.end(), data, data + len);
+    }
+
+    /// Simulated time in microseconds
+    uint64_t clock = 0;
+
+private:
+    void transfer(size_t len) {
+        this->clock += (uint64_t)len * 1000000 / this->params.rate;
+        this->step();
+    }
+
+    void step() {
+        this->core.set_time((uint32_t)(this->clock / 1000));
+        this->core.update();
+    }
+
+    bool chance(double percent) {
+        return (rand() % 10000) < (int)(percent * 100);
+    }
+
+    /// @brief Whether the link is in its outage
+    bool down() {
+        if (this->scenario.outage && !this->outage_end && (this->chunks >= this->outage_at)) {
+            this->outage_end = this->clock + ((uint64_t)OUTAGE_DURATION * 1000);
+        }
+
+        return this->outage_end && (this->clock < this->outage_end);
+    }
+
+    sim::SimCore& core;
+    LinkParams params;
+    Scenario scenario;
+
+    uint16_t outage_at;
+    uint64_t outage_end = 0;
+    uint32_t chunks = 0;
+
+    std::vector<uint8_t> answer;
+};
+
+struct Result {
+    bool verified;
+    double seconds;
+    uint32_t attempts;
+    bugsy::ota::UploadStats stats;
+    uint16_t dropped;
+};
+
+static Result run(const std::vector<uint8_t>& image, const LinkParams& params, const Scenario& scenario) {
+    SimLink* link_ptr = nullptr;
+    sim::SimCore core ([&link_ptr](Remote, const uint8_t* buffer, size_t len) {
+        link_ptr->output(buffer, len);
+    });
+
+    SimLink link (core, params, scenario, bugsy::ota::chunks_of((uint32_t)image.size()) / 2);
+    link_ptr = &link;
+
+    Result result = { };
+    bugsy::OtaStatus status = { };
+    bool done = false;
+
+    // Resumes until the image is verified, an outage only delays it
+    while (!done && (result.attempts < 10)) {
+        result.attempts++;
+        done = bugsy::ota::upload(link, image.data(), (uint32_t)image.size(), true, &status, &result.stats);
+
+        if (!done) {
+            link.wait(RESUME_DELAY);
+        }
+    }
+
+    result.seconds = link.clock / 1000000.0;
+    result.dropped = status.dropped;
+
+    // The core restarts into the image, so the partition has to hold it
+    link.wait(BUGSY_OTA_RESTART_DELAY);
+
+    std::vector<uint8_t> written (image.size());
+    core.flash.read(0, written.data(), written.size());
+
+    result.verified = done && (core.restarts == 1) && (memcmp(written.data(), image.data(), image.size()) == 0);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint32_t size = 512 * 1024;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--size") == 0) && ((i + 1) < argc)) {
+            size = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc)) {
+            seed = (unsigned int)atoi(argv[++i]);
+        }
+    }
+
+    if ((size == 0) || (size > BUGSY_OTA_MAX_SIZE)) {
+        log_errorln("> [ERROR] The size has to be between 1 and " << BUGSY_OTA_MAX_SIZE << " bytes!");
+        return 1;
+    }
+
+    srand(seed);
+
+    std::vector<uint8_t> image (size);
+
+    for (uint8_t& byte : image) {
+        byte = (uint8_t)rand();
+    }
+
+    const LinkParams links [] = {
+        // Negotiated UART rate, 10 bits per byte
+        { "RPi UART", Remote::RPI, BUGSY_UART_CORE_TO_RPI_MAX_BAUD / 10, 50 },
+        // Serial port profile, throughput and latency of a typical phone connection
+        { "Bluetooth", Remote::BLUETOOTH, 40000, 15000 }
+    };
+
+    const Scenario scenarios [] = {
+        { "clean", 0.0, 0.0, false },
+        { "1 % lost", 1.0, 0.0, false },
+        { "5 % lost, 2 % broken", 5.0, 2.0, false },
+        { "outage", 0.0, 0.0, true }
+    };
+
+    bool passed = true;
+
+    log_infoln("> Image: " << size << " bytes, " << bugsy::ota::chunks_of(size) << " chunks");
+    log_infoln("");
+    log_infoln("| Link | Scenario | Time | Throughput | Sent | Retransmitted | Rounds | Dropped | Attempts | Verified |");
+    log_infoln("|---|---|---|---|---|---|---|---|---|---|");
+
+    for (const LinkParams& params : links) {
+        for (const Scenario& scenario : scenarios) {
+            Result result = run(image, params, scenario);
+            passed &= result.verified;
+
+            log_info("| " << params.name << " | " << scenario.name);
+            log_info(" | " << result.seconds << " s");
+            log_info(" | " << (size / result.seconds / 1024.0) << " KiB/s");
+            log_info(" | " << result.stats.sent << " | " << result.stats.retransmitted << " | " << result.stats.rounds);
+            log_info(" | " << result.dropped << " | " << result.attempts);
+            log_infoln(" | " << (result.verified ? "yes" : "NO") << " |");
+        }
+    }
+
+    log_infoln("");
+
+    if (!passed) {
+        log_errorln("> [ERROR] The image did not arrive in all scenarios!");
+        return 1;
+    }
+
+    log_infoln("> All scenarios passed!");
+    return 0;
+}
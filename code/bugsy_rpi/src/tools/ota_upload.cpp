@@ -0,0 +1,126 @@
+// Uploads a firmware image to the core over its serial (see `bugsy/ota.hpp`)
+//
+// Usage: `ota_upload <device> <firmware.bin> [--restart] [--abort]`
+//
+// The `bugsy_rpi` daemon has to be stopped, as it owns the serial otherwise. The link is negotiated up to its fastest
+// baud rate first. An upload interrupted by the core not answering is resumed right away up to `UPLOAD_ATTEMPTS` times,
+// running the tool again with the same image resumes it as well. `--restart` restarts the core into the image once it
+// has been verified, `--abort` cancels the update on the core instead.
+
+# include <stdio.h>
+# include <string.h>
+# include <unistd.h>
+# include <vector>
+
+# include "bugsy_rpi.hpp"
+# include "io.hpp"
+
+using bugsy::OtaState;
+using bugsy::OtaStatus;
+
+/// Attempts to upload the image, every attempt resumes the previous one
+# define UPLOAD_ATTEMPTS 3
+
+static const char* state_name(OtaState state) {
+    switch (state) {
+        case OtaState::IDLE: return "idle";
+        case OtaState::ERASING: return "erasing";
+        case OtaState::RECEIVING: return "receiving";
+        case OtaState::VERIFYING: return "verifying";
+        case OtaState::READY: return "ready";
+        default: return "failed";
+    }
+}
+
+static bool read_image(const char* path, std::vector<uint8_t>* image) {
+    FILE* file = fopen(path, "rb");
+
+    if (!file) {
+        return false;
+    }
+
+    uint8_t buffer [4096];
+    size_t len;
+
+    while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        image->insert(image->end(), buffer, buffer + len);
+    }
+
+    fclose(file);
+    return !image->empty();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        log_errorln("Usage: ota_upload <device> <firmware.bin> [--restart] [--abort]");
+        return 1;
+    }
+
+    bool restart = false;
+    bool abort = false;
+
+    for (int i = 3; i < argc; i++) {
+        restart |= (strcmp(argv[i], "--restart") == 0);
+        abort |= (strcmp(argv[i], "--abort") == 0);
+    }
+
+    if (!bugsy_rpi::io::setup(argv[1], BUGSY_UART_CORE_TO_RPI_BAUD)) {
+        return 1;
+    }
+
+    OtaStatus status = { };
+
+    if (abort) {
+        bool aborted = bugsy_rpi::core::abort_ota(&status);
+        log_infoln((aborted ? "> Update aborted" : "> [ERROR] The core did not answer!"));
+        return aborted ? 0 : 1;
+    }
+
+    std::vector<uint8_t> image;
+
+    if (!read_image(argv[2], &image)) {
+        log_errorln("> [ERROR] Failed to read '" << argv[2] << "'!");
+        return 1;
+    }
+
+    if (image.size() > BUGSY_OTA_MAX_SIZE) {
+        log_errorln("> [ERROR] The image exceeds the update partition (" << BUGSY_OTA_MAX_SIZE << " bytes)!");
+        return 1;
+    }
+
+    log_infoln("> Link at " << bugsy_rpi::core::negotiate_baud() << " baud");
+
+    bugsy::ota::UploadStats stats = { };
+    bool done = false;
+    uint64_t start = bugsy_rpi::micros();
+
+    for (uint8_t attempt = 0; !done && (attempt < UPLOAD_ATTEMPTS); attempt++) {
+        done = bugsy_rpi::core::update_firmware(image.data(), (uint32_t)image.size(), restart, &status, &stats);
+
+        log_infoln("> Attempt " << (attempt + 1) << ": " << state_name(status.state) << ", " << status.next << "/"
+            << status.chunks << " chunks");
+
+        if (status.state == OtaState::FAILED) {
+            break;
+        }
+
+        // The core might be busy with something else, it forgets the owner of the update after a while
+        if (!done) {
+            usleep(BUGSY_OTA_OWNER_TIMEOUT * 1000);
+        }
+    }
+
+    double seconds = (bugsy_rpi::micros() - start) / 1000000.0;
+
+    log_infoln("> " << image.size() << " bytes in " << seconds << " s (" << (image.size() / seconds / 1024.0) << " KiB/s)");
+    log_infoln("> Chunks sent: " << stats.sent << ", retransmitted: " << stats.retransmitted << ", rounds: " << stats.rounds
+        << ", dropped by the core: " << status.dropped);
+
+    if (!done) {
+        log_errorln("> [ERROR] Update not finished, run again to resume");
+        return 1;
+    }
+
+    log_infoln((restart ? "> Image verified, the core restarts into it" : "> Image verified, boots with the next restart"));
+    return 0;
+}
@@ -0,0 +1,378 @@
+// Benchmark and regression check of the incremental path planning (see `planner.hpp`)
+//
+// Usage: `plan_bench [--replans <per grid>] [--seed <seed>]`
+//
+// Plans across random grids of growing size while the robot drives along the path and discovers new obstacles in front
+// of it. Every replan is repaired incrementally and compared against planning from scratch, the program prints a markdown
+// table of the planning times and fails if both ever disagree on the cost of the path. Obstacles closing the last way to
+// the goal are counted as closed and removed again. Afterwards a simulated robot (see
+// `sim_core.hpp`) drives through the rooms of `sim_world.hpp` on the trajectories streamed to the scheduled drive of the
+// core, and the program fails if it does not arrive or comes too close to a wall.
+
+# include <chrono>
+# include <math.h>
+# include <random>
+# include <stdlib.h>
+# include <string.h>
+
+# include <bugsy/drive.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "mapping.hpp"
+# include "planner.hpp"
+# include "sim_core.hpp"
+# include "sim_world.hpp"
+
+using namespace bugsy_rpi;
+
+/// Log-odds set for the cells of the synthetic grids
+# define CELL_FREE -96
+# define CELL_OCCUPIED 96
+
+/// Distance ahead on the path at which an obstacle is discovered in mm
+# define DISCOVER_DISTANCE 1500.0f
+
+/// Period of replanning while driving in ms
+# define DRIVE_REPLAN_PERIOD 1000
+/// Period of streaming while driving in ms
+# define DRIVE_STREAM_PERIOD 20
+/// Time the drive may take at most in ms
+# define DRIVE_TIMEOUT 120000
+/// Distance to the goal in mm the drive has to end within
+# define REQUIRED_ARRIVAL 100.0f
+/// Distance in mm the center of the robot has to keep from the walls, half the width of the robot
+# define REQUIRED_CLEARANCE 80.0f
+
+struct GridSize {
+    uint32_t cells_x;
+    uint32_t cells_y;
+};
+
+static const GridSize SIZES [] = {
+    { 200, 160 }, { 400, 320 }, { 800, 640 }
+};
+
+struct Timing {
+    uint32_t count = 0;
+    double total = 0.0;
+    double max = 0.0;
+    uint64_t expanded = 0;
+
+    void add(double time, uint64_t expanded) {
+        this->count++;
+        this->total += time;
+        this->max = fmax(this->max, time);
+        this->expanded += expanded;
+    }
+};
+
+static double elapsed(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+/// Sets the cells of an axis aligned box, clipped to the grid
+static void fill(mapping::OccupancyGrid& grid, int64_t x0, int64_t y0, int64_t x1, int64_t y1, int8_t value) {
+    for (int64_t cy = std::max<int64_t>(y0, 0); cy <= std::min<int64_t>(y1, grid.cells_y() - 1); cy++) {
+        for (int64_t cx = std::max<int64_t>(x0, 0); cx <= std::min<int64_t>(x1, grid.cells_x() - 1); cx++) {
+            grid.set((uint32_t)cx, (uint32_t)cy, value);
+        }
+    }
+}
+
+/// The point `distance` mm along the path from `from`, the end of the path if it is shorter
+static planning::Point along(planning::Point from, const std::vector<planning::Point>& path, float distance) {
+    for (const planning::Point& point : path) {
+        float length = hypotf(point.x - from.x, point.y - from.y);
+
+        if (length >= distance) {
+            float t = distance / length;
+            return { from.x + (t * (point.x - from.x)), from.y + (t * (point.y - from.y)) };
+        }
+
+        distance -= length;
+        from = point;
+    }
+
+    return from;
+}
+
+/// The length of the path from `from` in mm
+static float length_of(planning::Point from, const std::vector<planning::Point>& path) {
+    float length = 0.0f;
+
+    for (const planning::Point& point : path) {
+        length += hypotf(point.x - from.x, point.y - from.y);
+        from = point;
+    }
+
+    return length;
+}
+
+/// Plans across a random grid while the robot drives and discovers obstacles
+/// @return `false` if the incremental planner disagreed with planning from scratch
+static bool benchmark(const GridSize& size, uint32_t replans, std::mt19937& rng) {
+    const float cell = BUGSY_RPI_MAP_CELL_SIZE;
+
+    mapping::OccupancyGrid grid(size.cells_x * cell, size.cells_y * cell);
+    fill(grid, 0, 0, size.cells_x - 1, size.cells_y - 1, CELL_FREE);
+
+    // Corner to corner, random boxes everywhere but around both ends
+    planning::Point start = { -0.45f * size.cells_x * cell, -0.45f * size.cells_y * cell };
+    planning::Point goal = { 0.45f * size.cells_x * cell, 0.45f * size.cells_y * cell };
+
+    std::uniform_int_distribution<uint32_t> pos_x(0, size.cells_x - 1), pos_y(0, size.cells_y - 1), extent(2, 10);
+
+    for (uint32_t i = 0, n = (size.cells_x * size.cells_y) / 500; i < n; i++) {
+        uint32_t cx = pos_x(rng), cy = pos_y(rng);
+        float x, y;
+        grid.center_of(cx, cy, &x, &y);
+
+        if ((hypotf(x - start.x, y - start.y) < 1000.0f) || (hypotf(x - goal.x, y - goal.y) < 1000.0f)) {
+            continue;
+        }
+
+        fill(grid, cx, cy, cx + extent(rng), cy + extent(rng), CELL_OCCUPIED);
+    }
+
+    planning::Planner planner(grid);
+    std::vector<planning::Point> path;
+
+    auto begin = std::chrono::steady_clock::now();
+    planner.update();
+    planner.set_start(start.x, start.y);
+    planner.set_goal(goal.x, goal.y);
+    bool found = planner.plan(path);
+    double initial = elapsed(begin);
+    uint64_t initial_expanded = planner.stats().expanded;
+
+    // The robot arrives at the goal with the last replan
+    const float advance = length_of(start, path) / (replans + 1);
+
+    Timing incremental, scratch;
+    uint32_t done = 0, closed = 0;
+    bool passed = true;
+
+    while (found && (done < replans)) {
+        start = along(start, path, advance);
+
+        // A box across the path ahead, leaving the robot and the goal free
+        planning::Point obstacle = along(start, path, DISCOVER_DISTANCE);
+        uint32_t cx, cy, half = extent(rng) / 2;
+        bool placed = (hypotf(obstacle.x - goal.x, obstacle.y - goal.y) > 1000.0f) && grid.cell_of(obstacle.x, obstacle.y, &cx, &cy);
+
+        if (placed) {
+            fill(grid, (int64_t)cx - half, (int64_t)cy - half, (int64_t)cx + half, (int64_t)cy + half, CELL_OCCUPIED);
+        }
+
+        uint64_t expanded = planner.stats().expanded;
+        std::vector<planning::Point> next;
+
+        begin = std::chrono::steady_clock::now();
+        planner.update();
+        planner.set_start(start.x, start.y);
+        found = planner.plan(next);
+        double time = elapsed(begin);
+        expanded = planner.stats().expanded - expanded;
+
+        // The costs are taken over untimed, only the search is compared
+        planning::Planner fresh(grid);
+        std::vector<planning::Point> fresh_path;
+        fresh.update();
+
+        begin = std::chrono::steady_clock::now();
+        fresh.set_start(start.x, start.y);
+        fresh.set_goal(goal.x, goal.y);
+        bool fresh_found = fresh.plan(fresh_path);
+
+        // Without a way to the goal both search everything reachable, which says nothing about the repair
+        if (found) {
+            incremental.add(time, expanded);
+            scratch.add(elapsed(begin), fresh.stats().expanded);
+        }
+
+        // The costs are integers internally, both have to be exactly the same
+        if ((found != fresh_found) || (planner.cost() != fresh.cost())) {
+            log_errorln("> [ERROR] Replan " << done << " on " << size.cells_x << " x " << size.cells_y << " disagrees: "
+                << planner.cost() << " incremental, " << fresh.cost() << " from scratch!");
+            passed = false;
+        }
+
+        done++;
+
+        // The box closed the last way to the goal, it turns out to be a misreading and is removed again
+        if (!found && placed) {
+            fill(grid, (int64_t)cx - half, (int64_t)cy - half, (int64_t)cx + half, (int64_t)cy + half, CELL_FREE);
+            planner.update();
+            found = planner.plan(next);
+            closed++;
+        }
+
+        path = next;
+    }
+
+    if (!found || !incremental.count) {
+        log_errorln("> [ERROR] No path across the " << size.cells_x << " x " << size.cells_y << " grid!");
+        return false;
+    }
+
+    log_infoln("| " << size.cells_x << " x " << size.cells_y
+        << " | " << (initial * 1000.0) << " ms (" << initial_expanded << ")"
+        << " | " << (incremental.total * 1000.0 / incremental.count) << " ms (" << (incremental.expanded / incremental.count) << ")"
+        << " | " << (incremental.max * 1000.0) << " ms"
+        << " | " << (scratch.total * 1000.0 / scratch.count) << " ms (" << (scratch.expanded / scratch.count) << ")"
+        << " | " << (scratch.total / incremental.total) << " x"
+        << " | " << closed << " |");
+
+    return passed;
+}
+
+/// Drives the simulated robot through the rooms on streamed trajectories
+/// @return `false` if it did not arrive or came too close to a wall
+static bool drive() {
+    const sim::World world = sim::World::rooms();
+    const float cell = BUGSY_RPI_MAP_CELL_SIZE;
+
+    // The map of the rooms as a perfect sensor would build it
+    mapping::OccupancyGrid grid(8400.0f, 6400.0f);
+
+    for (uint32_t cy = 0; cy < grid.cells_y(); cy++) {
+        for (uint32_t cx = 0; cx < grid.cells_x(); cx++) {
+            float x, y;
+            grid.center_of(cx, cy, &x, &y);
+            grid.set(cx, cy, (world.clearance(x, y) < (cell * 0.75f)) ? CELL_OCCUPIED : CELL_FREE);
+        }
+    }
+
+    const planning::Point goal = { 3600.0f, 2600.0f };
+    const bugsy::DriveCalibration& cal = bugsy::drive::DEFAULT_CALIBRATION;
+
+    mapping::Pose start;
+    start.x = -3300.0f;
+    start.y = -1300.0f;
+
+    mapping::Odometry odometry(cal.track_width, start);
+
+    sim::SimCore core ([](bugsy::Remote, const uint8_t*, size_t) { });
+
+    planning::Streamer streamer ([&core](const bugsy::ScheduledVelocity& scheduled) {
+        uint8_t frame [1 + sizeof(bugsy::ScheduledVelocity)] = { (uint8_t)bugsy::Command::ScheduleDrive };
+        memcpy(frame + 1, &scheduled, sizeof(scheduled));
+        core.parse_cmd(bugsy::Remote::RPI, frame, sizeof(frame));
+        return true;
+    });
+
+    planning::Planner planner(grid);
+    planning::MotionLimits limits;
+    limits.track_width = cal.track_width;
+    limits.chain_speed = cal.max_speed * 0.8f;
+
+    planner.update();
+    planner.set_start(start.x, start.y);
+    planner.set_goal(goal.x, goal.y);
+
+    float clearance = INFINITY;
+    double planning = 0.0;
+    uint32_t plans = 0;
+    uint32_t now = 1;
+
+    for (; now < DRIVE_TIMEOUT; now++) {
+        core.set_time(now);
+        const mapping::Pose& pose = odometry.pose();
+
+        if ((now == 1) || (((now % DRIVE_REPLAN_PERIOD) == 1) && !streamer.done())) {
+            std::vector<planning::Point> path;
+
+            auto begin = std::chrono::steady_clock::now();
+            planner.set_start(pose.x, pose.y);
+
+            if (!planner.plan(path)) {
+                log_errorln("> [ERROR] No path from " << pose.x << ", " << pose.y << " mm!");
+                return false;
+            }
+
+            planning += elapsed(begin);
+            plans++;
+
+            streamer.start(planning::to_segments(pose, path, limits), now * 1000);
+        } else if ((now % DRIVE_STREAM_PERIOD) == 0) {
+            streamer.update(now * 1000);
+        }
+
+        core.update();
+
+        odometry.update((float)core.chains[0].speed / 1000.0f, (float)core.chains[1].speed / 1000.0f);
+        clearance = fminf(clearance, world.clearance(odometry.pose().x, odometry.pose().y));
+
+        if (streamer.done() && (core.state == bugsy::CoreState::STANDBY) && (fabs(core.chains[0].speed) < 1.0)
+                && (fabs(core.chains[1].speed) < 1.0)) {
+            break;
+        }
+    }
+
+    const mapping::Pose& pose = odometry.pose();
+    float arrival = hypotf(pose.x - goal.x, pose.y - goal.y);
+
+    log_infoln("> Drove through the rooms in " << (now / 1000.0) << " s with " << plans << " plans ("
+        << (planning * 1000.0 / plans) << " ms on average) and " << streamer.stats().steps << " scheduled steps, "
+        << "stopped " << arrival << " mm from the goal, closest to a wall " << clearance << " mm");
+
+    bool passed = true;
+
+    if (arrival > REQUIRED_ARRIVAL) {
+        log_errorln("> [ERROR] The robot did not arrive!");
+        passed = false;
+    }
+
+    if (clearance < REQUIRED_CLEARANCE) {
+        log_errorln("> [ERROR] The robot came too close to a wall!");
+        passed = false;
+    }
+
+    if (core.schedule.stats.rejected) {
+        log_errorln("> [ERROR] The core rejected " << core.schedule.stats.rejected << " scheduled steps!");
+        passed = false;
+    }
+
+    return passed;
+}
+
+int main(int argc, char** argv) {
+    uint32_t replans = 20;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if ((i + 1) >= argc) {
+            log_errorln("> [ERROR] Missing value for '" << argv[i] << "'!");
+            return 1;
+        }
+
+        if (!strcmp(argv[i], "--replans")) {
+            replans = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed")) {
+            seed = (uint32_t)atoi(argv[++i]);
+        } else {
+            log_errorln("> [ERROR] Unknown argument '" << argv[i] << "'!");
+            return 1;
+        }
+    }
+
+    log_infoln("> " << replans << " replans per grid along the way to the goal, cells of " << BUGSY_RPI_MAP_CELL_SIZE << " mm");
+    log_infoln("");
+    log_infoln("| Grid | Initial plan (expanded) | Replan (expanded) | Slowest replan | From scratch (expanded) | Speedup | Closed |");
+    log_infoln("|---|---|---|---|---|---|---|");
+
+    std::mt19937 rng(seed);
+    bool passed = true;
+
+    for (const GridSize& size : SIZES) {
+        passed &= benchmark(size, replans, rng);
+    }
+
+    log_infoln("");
+    passed &= drive();
+
+    log_infoln("");
+    log_infoln((passed ? "> All checks passed" : "> Checks FAILED"));
+
+    return passed ? 0 : 1;
+}
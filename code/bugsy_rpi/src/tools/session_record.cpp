@@ -0,0 +1,117 @@
+// Records a session between a client and the core
+//
+// Usage: `session_record <device> <session> [usb|bluetooth|rpi]`
+//
+// Opens the core at `device` and creates a pseudo terminal for the client (e.g. `rustbug <pty>`), all traffic is
+// forwarded in both directions and recorded as the given remote (default `usb`)
+
+# include <errno.h>
+# include <fcntl.h>
+# include <poll.h>
+# include <signal.h>
+# include <stdlib.h>
+# include <string.h>
+# include <termios.h>
+# include <unistd.h>
+
+# include "bugsy_rpi.hpp"
+# include "io.hpp"
+# include "session.hpp"
+
+using bugsy::Remote;
+using bugsy_rpi::session::Flow;
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int) {
+    running = 0;
+}
+
+static Remote parse_remote(const char* name) {
+    if (strcmp(name, "bluetooth") == 0) {
+        return Remote::BLUETOOTH;
+    } else if (strcmp(name, "rpi") == 0) {
+        return Remote::RPI;
+    }
+
+    return Remote::USB;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        log_errorln("Usage: session_record <device> <session> [usb|bluetooth|rpi]");
+        return 1;
+    }
+
+    Remote remote = (argc > 3) ? parse_remote(argv[3]) : Remote::USB;
+
+    if (!bugsy_rpi::io::setup(argv[1], BUGSY_UART_CORE_TO_RPI_BAUD)) {
+        return 1;
+    }
+
+    // Pseudo terminal the client connects to
+    int pty = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((pty < 0) || (grantpt(pty) < 0) || (unlockpt(pty) < 0)) {
+        log_errorln("> [ERROR] Failed to create pseudo terminal: " << strerror(errno));
+        return 1;
+    }
+
+    struct termios tio;
+    tcgetattr(pty, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(pty, TCSANOW, &tio);
+
+    bugsy_rpi::session::Writer writer;
+    if (!writer.open(argv[2])) {
+        return 1;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    log_infoln("> Recording to '" << argv[2] << "', connect the client to " << ptsname(pty));
+
+    uint8_t buffer [256];
+    uint64_t records = 0;
+
+    while (running) {
+        struct pollfd fds [2] = {
+            { pty, POLLIN, 0 },
+            { bugsy_rpi::io::core_fd, POLLIN, 0 }
+        };
+
+        if (poll(fds, 2, 100) <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            ssize_t len = read(pty, buffer, sizeof(buffer));
+
+            if (len > 0) {
+                writer.append(remote, Flow::TO_CORE, buffer, len);
+                bugsy_rpi::io::write_core(buffer, len);
+                records++;
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            ssize_t len = read(bugsy_rpi::io::core_fd, buffer, sizeof(buffer));
+
+            if (len > 0) {
+                writer.append(remote, Flow::FROM_CORE, buffer, len);
+
+                if (write(pty, buffer, len) < 0) {
+                    log_errorln("> [ERROR] Failed to forward to client: " << strerror(errno));
+                }
+
+                records++;
+            }
+        }
+    }
+
+    writer.close();
+    log_infoln("> Recorded " << records << " records");
+
+    return 0;
+}
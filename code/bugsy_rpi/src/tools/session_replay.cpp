@@ -0,0 +1,66 @@
+// Replays a recorded session and compares the answers of the core with the recorded ones
+//
+// Usage: `session_replay <session> [sim|<device>] [--fast] [--from <seconds>]`
+//
+// `sim` (default) replays into the simulated core, a device path into a real core. With `--fast` the commands are sent
+// as fast as the target answers them instead of keeping the recorded timing. The exit code is `2` if any answer differed
+// from the recording, so sessions can be used as regression tests.
+
+# include <stdlib.h>
+# include <string.h>
+
+# include "bugsy_rpi.hpp"
+# include "io.hpp"
+# include "replay.hpp"
+# include "session.hpp"
+
+using namespace bugsy_rpi;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        log_errorln("Usage: session_replay <session> [sim|<device>] [--fast] [--from <seconds>]");
+        return 1;
+    }
+
+    const char* target_name = "sim";
+    bool realtime = true;
+    uint64_t start = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--fast") == 0) {
+            realtime = false;
+        } else if ((strcmp(argv[i], "--from") == 0) && ((i + 1) < argc)) {
+            start = (uint64_t)(atof(argv[++i]) * 1000000);
+        } else {
+            target_name = argv[i];
+        }
+    }
+
+    session::Reader reader;
+    if (!reader.open(argv[1])) {
+        return 1;
+    }
+
+    std::vector<replay::Step> steps = replay::load_steps(&reader, start);
+
+    log_info("> Replaying " << steps.size() << " commands (" << (reader.duration() / 1000000.0) << " s session)");
+    log_infoln(" into '" << target_name << "'" << (realtime ? "" : " as fast as possible") << " ...");
+
+    replay::Report report;
+
+    if (strcmp(target_name, "sim") == 0) {
+        replay::SimTarget target;
+        report = replay::run(steps, &target, realtime);
+    } else {
+        if (!io::setup(target_name, BUGSY_UART_CORE_TO_RPI_BAUD)) {
+            return 1;
+        }
+
+        replay::SerialTarget target;
+        report = replay::run(steps, &target, realtime);
+    }
+
+    replay::log_report(report);
+
+    return (report.mismatched || report.timeouts) ? 2 : 0;
+}
@@ -0,0 +1,176 @@
+// Tuning and regression check of the chain speed control against the simulated motor (see `sim_motor.hpp`)
+//
+// Usage: `speed_tune [--kp <gain>] [--ki <gain>] [--kd <gain>]`
+//
+// Runs a set of scenarios (steps, load, battery sag, reversal) once open-loop with the feed-forward duty only and once
+// with the given gains (defaults of `bugsy::speed`), prints a markdown table of the results and exits with `1` if the
+// closed loop misses the tracking requirements in any scenario.
+
+# include <math.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include <bugsy/drive.hpp>
+# include <bugsy/speed.hpp>
+
+# include "bugsy_rpi.hpp"
+# include "sim_motor.hpp"
+
+using namespace bugsy_rpi;
+
+/// Duration of every scenario in seconds
+# define SCENARIO_DURATION 2.0
+/// Time at which the disturbance of a scenario happens in seconds
+# define SCENARIO_CHANGE 1.0
+/// Maximum steady-state error of the closed loop in percent of the target
+# define REQUIRED_STEADY_ERROR 3.0
+/// Maximum settling time of the closed loop in milliseconds
+# define REQUIRED_SETTLING 400.0
+/// Band around the target counting as settled in percent
+# define SETTLING_BAND 5.0
+
+struct Scenario {
+    const char* name;
+    int16_t target;
+    /// Target after `SCENARIO_CHANGE`
+    int16_t target_after;
+    /// Load after `SCENARIO_CHANGE` in mm/s
+    double load_after;
+    double supply;
+};
+
+static const Scenario SCENARIOS [] = {
+    { "step 200 mm/s", 200, 200, 0.0, 1.0 },
+    { "step 50 mm/s", 50, 50, 0.0, 1.0 },
+    { "load +60 mm/s", 200, 200, 60.0, 1.0 },
+    { "battery 85%", 300, 300, 0.0, 0.85 },
+    { "reverse", 200, -200, 0.0, 1.0 }
+};
+
+struct Result {
+    /// Mean absolute error over the last 500 ms in percent of the target
+    double steady_error;
+    /// Maximum overshoot after the last change in percent of the target
+    double overshoot;
+    /// Time after the last change until the speed stays within the band in milliseconds
+    double settling;
+};
+
+static Result run(const Scenario& scenario, const bugsy::SpeedGains& gains) {
+    const bugsy::DriveCalibration& cal = bugsy::drive::DEFAULT_CALIBRATION;
+    const double dt = bugsy::speed::TICK_PERIOD / 1000000.0;
+    const uint32_t ticks = (uint32_t)(SCENARIO_DURATION / dt);
+    const uint32_t change = (uint32_t)(SCENARIO_CHANGE / dt);
+
+    sim::MotorModel motor;
+    motor.supply = scenario.supply;
+
+    bugsy::speed::Controller controller;
+    int16_t duty = 0, unused = 0;
+
+    Result result = { 0.0, 0.0, 0.0 };
+    double error_sum = 0.0;
+    uint32_t error_count = 0;
+    uint32_t last_outside = 0;
+
+    // The last change is the disturbance if there is one, the start otherwise
+    bool disturbed = (scenario.target_after != scenario.target) || (scenario.load_after != 0.0);
+    uint32_t reference = disturbed ? change : 0;
+
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        int16_t target = scenario.target;
+
+        if (tick >= change) {
+            target = scenario.target_after;
+            motor.load = scenario.load_after;
+        }
+
+        controller.set_targets(target, 0);
+        controller.step(tick * bugsy::speed::TICK_PERIOD, motor.step(duty, dt), 0, cal, gains, 0xFF, &duty, &unused);
+
+        if (!gains.enabled) {
+            duty = bugsy::speed::feed_forward(cal.left, target, cal.max_speed);
+        }
+
+        if (tick < reference) {
+            continue;
+        }
+
+        double error = (motor.speed - target) * 100.0 / abs(target);
+
+        if (fabs(error) > SETTLING_BAND) {
+            last_outside = tick;
+        }
+
+        if (((target > 0) && (motor.speed > target)) || ((target < 0) && (motor.speed < target))) {
+            result.overshoot = fmax(result.overshoot, fabs(error));
+        }
+
+        if (tick >= (ticks - (uint32_t)(0.5 / dt))) {
+            error_sum += fabs(error);
+            error_count++;
+        }
+    }
+
+    result.steady_error = error_sum / error_count;
+    result.settling = (last_outside >= (ticks - 1)) ? INFINITY : ((last_outside + 1 - reference) * dt * 1000.0);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    bugsy::SpeedGains gains = bugsy::speed::DEFAULT_GAINS;
+
+    for (int i = 1; i < argc; i++) {
+        if ((i + 1) >= argc) {
+            log_errorln("> [ERROR] Missing value for '" << argv[i] << "'!");
+            return 1;
+        }
+
+        if (!strcmp(argv[i], "--kp")) {
+            gains.kp = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--ki")) {
+            gains.ki = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--kd")) {
+            gains.kd = (uint16_t)atoi(argv[++i]);
+        } else {
+            log_errorln("> [ERROR] Unknown argument '" << argv[i] << "'!");
+            return 1;
+        }
+    }
+
+    bugsy::SpeedGains open_loop = gains;
+    open_loop.enabled = 0;
+
+    log_infoln("> Gains: kp " << gains.kp << ", ki " << gains.ki << ", kd " << gains.kd << " (8 fractional bits)");
+    log_infoln("");
+    log_infoln("| Scenario | Open-loop error | Closed-loop error | Overshoot | Settling |");
+    log_infoln("|---|---|---|---|---|");
+
+    bool passed = true;
+
+    for (const Scenario& scenario : SCENARIOS) {
+        Result open = run(scenario, open_loop);
+        Result closed = run(scenario, gains);
+
+        log_info("| " << scenario.name);
+        log_info(" | " << open.steady_error << " %");
+        log_info(" | " << closed.steady_error << " %");
+        log_info(" | " << closed.overshoot << " %");
+        log_infoln(" | " << closed.settling << " ms |");
+
+        if ((closed.steady_error > REQUIRED_STEADY_ERROR) || (closed.settling > REQUIRED_SETTLING)) {
+            passed = false;
+        }
+    }
+
+    log_infoln("");
+
+    if (!passed) {
+        log_errorln("> [ERROR] The closed loop misses the requirements (error <= " << REQUIRED_STEADY_ERROR
+            << " %, settling <= " << REQUIRED_SETTLING << " ms)!");
+        return 1;
+    }
+
+    log_infoln("> All scenarios passed!");
+    return 0;
+}
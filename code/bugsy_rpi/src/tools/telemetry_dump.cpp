@@ -0,0 +1,48 @@
+// Example consumer of the telemetry ring, prints every frame published by the `bugsy_rpi` daemon
+
+# include <unistd.h>
+
+# include "bugsy_rpi.hpp"
+# include "telemetry.hpp"
+
+using bugsy_rpi::telemetry::Frame;
+using bugsy_rpi::telemetry::Reader;
+
+int main() {
+    Reader reader;
+
+    if (!reader.open()) {
+        log_errorln("> [ERROR] Is the bugsy_rpi daemon running?");
+        return 1;
+    }
+
+    Frame frame;
+    uint32_t missed = 0;
+
+    while (true) {
+        // Polling the ring does not require any syscalls, sleeping is only done to save CPU
+        while (reader.next(&frame)) {
+            log_info("[" << frame.stamp << "] Core: 0x" << std::hex << (int)frame.core_state);
+            log_info(", Trader: 0x" << (int)frame.trader_state << std::dec);
+            log_info(", Left: " << (bool)frame.movement.chain_left_dir << "/" << (int)frame.movement.chain_left_duty);
+            log_info(", Right: " << (bool)frame.movement.chain_right_dir << "/" << (int)frame.movement.chain_right_duty);
+            log_info(", Battery: " << frame.battery.voltage << " mV/" << (int)frame.battery.charge << "%");
+            log_info(" (limit " << (int)frame.battery.duty_limit << ")");
+            log_info(", Speed: " << frame.speed.speed_left << "/" << frame.speed.target_left);
+            log_info(" " << frame.speed.speed_right << "/" << frame.speed.target_right << " mm/s");
+            log_info(" (error " << frame.speed.error_left << "/" << frame.speed.error_right << ", jitter " << frame.speed.jitter_avg << " us)");
+            log_info(", E-Stop: " << (frame.estop.active ? "ENGAGED" : "clear") << " (" << frame.estop.triggers << "x, max ");
+            log_info(frame.estop.latency_max << " us, " << frame.estop.violations << " late)");
+            log_info(", Link: " << frame.link.interval << " +- " << frame.link.jitter << " ms, " << frame.link.lost << " lost");
+            log_info(", RTT " << frame.link.rtt << " us (failsafe " << frame.link.window << " ms)");
+            log_infoln(", UART: " << frame.baud.baud << " baud (" << frame.baud.rx_errors << " errors, " << frame.baud.fallbacks << " fallbacks)");
+        }
+
+        if (reader.missed() != missed) {
+            missed = reader.missed();
+            log_errorln("> [WARN] Missed frames: " << missed);
+        }
+
+        usleep(1000);
+    }
+}
@@ -5,7 +5,6 @@
 # include <bugsy/core.hpp>
 # include <bugsy/trader.hpp>
 
-# include <sylo/components/rotary_encoder.hpp>
 
 /// @brief Maximum size of incomming messages
 # define PARSE_BUFFER_SIZE 64
@@ -14,18 +13,70 @@
 /// @brief Debug baud rate of the trader MCU
 # define BUGSY_TRADER_DEBUG_BAUD 115200
 
+// Core link
+    /// Size of the receive ring of the core link, holds the largest answer (a baud test frame). Power of 2, at most 128
+    # define USART_RX_BUFFER_SIZE 64
+    /// Size of the transmit ring of the core link, holds the largest request (a baud test frame). Power of 2, at most 128
+    # define USART_TX_BUFFER_SIZE 64
+    /// Time in milliseconds the core has to answer a request within
+    # define CORE_ANSWER_TIMEOUT 15
+    /// Time in microseconds the line stays idle after a frame until the next one is queued, the core splits the commands
+    /// by a pause of `RX_GAP_US` (200 µs) and would take two frames sent back to back for a single one
+    # define CORE_FRAME_GAP 400
+    /// State requests of the connected core that may go unanswered in a row until the link counts as lost
+    # define CORE_ANSWER_RETRIES 2
+    /// Time in milliseconds the trader stays silent after it lost the link at a negotiated rate until it returns to the
+    /// base rate, longer than `BUGSY_TRADER_MIN_UPDATES`, after which the core falls back as well
+    # define CORE_FALLBACK_DELAY (BUGSY_TRADER_MIN_UPDATES + 250)
+
+    /// Delay in milliseconds between the first attempts to reconnect to the core, doubled with every failed attempt
+    # define RECONNECT_MIN_DELAY 100
+    /// Maximum delay in milliseconds between two attempts to reconnect to the core
+    # define RECONNECT_MAX_DELAY 3200
+    /// Random delay added to every attempt in percent of the current delay
+    # define RECONNECT_JITTER 25
+//
+
 // Pins
-    /// Data pin of the rotary encoder, no pull down required as it is included in the module
-    # define PIN_ENCODER_DT 0
-    /// Clock pin of the rotary encoder, no pull down required as it is included in the module
-    # define PIN_ENCODER_CL 0
+    /// Clock pin of the rotary encoder, no pull down required as it is included in the module. Has to be interrupt capable!
+    # define PIN_ENCODER_CL 2
+    /// Data pin of the rotary encoder, no pull down required as it is included in the module. Has to be interrupt capable!
+    # define PIN_ENCODER_DT 3
     /// Switch signal of the rotary encoder, no pull down required as it is included in the module
-    # define PIN_ENCODER_SW 0
+    # define PIN_ENCODER_SW 4
+
+    /// Data pin for the DHT humidity & temperature sensor. Has to be interrupt capable!
+    # define PIN_DHT_SENSOR 19
 
-    /// Data pin for the DHT humidity & temperature sensor
-    # define PIN_DHT_SENSOR 0
+    /// Output of the obstacle sensor, active low. Has to be interrupt capable!
+    # define PIN_OBSTACLE 18
+    /// Emergency stop line to the core (`PIN_ESTOP` of the core), high while driving is allowed
+    # define PIN_ESTOP 22
 // 
 
+// Sensors
+    /// Encoder edges per step (detent) of the rotary encoder
+    # define ENCODER_EDGES_PER_STEP 4
+    /// Time in milliseconds the encoder switch has to be stable to register
+    # define ENCODER_SW_DEBOUNCE 20
+
+    /// Time in microseconds the DHT data line is pulled low to request a measurement (DHT22: >= 1 ms)
+    # define DHT_START_PULSE 1100
+    /// Time in microseconds a DHT transmission may take at most until it counts as timed out
+    # define DHT_TIMEOUT 8000
+    /// Time in microseconds between two falling edges above which a transmitted bit is a `1` (`0`: ~78us, `1`: ~120us)
+    # define DHT_BIT_THRESHOLD 100
+//
+
+// Publishing
+    /// Change of the encoder position in steps that is published immediately
+    # define DEADBAND_ENCODER_POSITION 1
+    /// Change of the temperature in 0.1 degrees celsius that is published immediately
+    # define DEADBAND_TEMPERATURE 5
+    /// Change of the humidity in 0.1 percent that is published immediately
+    # define DEADBAND_HUMIDITY 20
+//
+
 namespace bugsy_trader {
     /// @brief The curret state of the trader MCU
     extern bugsy::TraderState state;
@@ -34,9 +85,27 @@ namespace bugsy_trader {
         /// @brief Stores the last fetched state of the core MCU
         extern bugsy::CoreState state;
 
-        /// @brief Attempts to reconnect to the core MCU, blocks the process until connected
+        /// @brief Starts reconnecting to the core MCU at the base baud rate, the attempts are made by `update()`
         void reconnect();
 
+        /// @brief Whether the core is connected, sensor data is only published while it is
+        bool connected();
+
+        /// @brief Whether a frame may be sent to the core: it is connected, no answer is outstanding and the last frame
+        /// has been followed by `CORE_FRAME_GAP`
+        bool ready();
+
+        /// @brief Advances the connection to the core, call in every `loop()`
+        ///
+        /// While connected the trader state is sent every `BUGSY_STATE_INTERVAL`, a core that is not operational anymore
+        /// starts a reconnection at the current rate. A request that is not answered is sent again, after
+        /// `CORE_ANSWER_RETRIES` the link counts as lost and the trader returns to the base rate once the core did
+        /// (`CORE_FALLBACK_DELAY`). Attempts to reconnect are made with an exponential backoff (`RECONNECT_*`), once one
+        /// succeeds the baud rate is negotiated and the sensor data sampled meanwhile is published in one batch. The
+        /// answers of the core are picked up by later calls, so the loop never waits for them. No frame is queued before
+        /// the last one has been answered or followed by `CORE_FRAME_GAP` (see `ready()`)
+        void update();
+
         // Commands
         void test();
 
@@ -47,24 +116,159 @@ namespace bugsy_trader {
         char* get_wifi_ssid();
     }
 
+    /// Sensors and other peripheral devices, all of them are sampled without blocking the main loop
     namespace device {
-        
+        /// The sensor data most recently sampled
+        extern bugsy::PrimarySensorData primary_sensor_data;
+        /// The sensor data most recently sampled
+        extern bugsy::SecondarySensorData secondary_sensor_data;
+
+        /// Rotary encoder, edges are counted by ISRs
+        namespace encoder {
+            /// @brief Configures the pins and attaches the ISRs
+            void setup();
+
+            /// @brief Applies the edges counted by the ISRs to the position, has to be called at least every 127 edges
+            void update();
+        }
+
+        /// DHT22 humidity & temperature sensor
+        ///
+        /// The single-wire protocol is run as a state machine advanced by `update()`, the bits are decoded from the
+        /// timestamps of falling edges captured by an ISR, so a measurement never busy-waits for the sensor
+        namespace dht {
+            /// @brief Configures the data pin
+            void setup();
+
+            /// @brief Requests a new measurement (at most every 2 seconds)
+            /// @return `false` if a measurement is still running
+            bool start();
+
+            /// @brief Advances the measurement, call in every `loop()`
+            /// @return `true` once a measurement has finished, the results have been written to `secondary_sensor_data`
+            bool update();
+        }
+
+        /// Obstacle sensor, asserts the emergency stop line of the core
+        ///
+        /// The line is pulled low directly in the ISR of the sensor, so neither the loop nor the UART are involved in
+        /// stopping the robot. `update()` releases it once the sensor has been clear for `BUGSY_ESTOP_HOLD`
+        namespace obstacle {
+            /// @brief Configures the pins and attaches the ISR, the line stays asserted until the first `update()`s
+            /// found the sensor clear
+            void setup();
+
+            /// @brief Releases the line if possible and updates `primary_sensor_data.obstacle`
+            void update();
+        }
+
+        // Events
+            /// @brief Setup all the devices, should be called in `setup()`
+            void setup();
+
+            /// @brief Update all the devices, should be called in `loop()`
+            /// @return `true` if a new `secondary_sensor_data` is available
+            bool update();
+        // 
+    }
+
+    /// Publishes sensor data to the core once it changed significantly (see the `DEADBAND_*` defines) or once the last
+    /// publish is older than the maximum staleness, so unchanged data does not load the core link
+    namespace publish {
+        /// @brief Publishes the sensor data that changed or became stale, call in every `loop()`. Data due at the same time
+        /// is sent in one batch, as the core takes only one frame per `CORE_FRAME_GAP`
+        void update();
+
+        /// @brief Publishes the latest sensor data in one batch (see `bugsy/batch.hpp`), once the core is back
+        void flush();
+    }
+
+    /// Interrupt driven driver of the USART of the core link (USART3, replacing `Serial3`)
+    ///
+    /// The ISRs fill the receive ring and drain the transmit ring, so neither sending nor receiving waits for the line
+    namespace usart {
+        /// Error counters of the link since the start
+        struct Stats {
+            /// Bytes dropped as the receive ring was full
+            uint16_t rx_overruns;
+            /// Bytes lost as the ISR was late (data overrun of the USART)
+            uint16_t hw_overruns;
+            /// Bytes dropped because of a framing error
+            uint16_t frame_errors;
+            /// Frames dropped as the transmit ring was full
+            uint16_t tx_dropped;
+        };
+
+        /// @brief Starts the USART at the given baud rate (8N1), drops everything not received or sent yet
+        void begin(uint32_t baud);
+
+        /// @brief Waits until everything has been sent and stops the USART
+        void end();
+
+        /// @brief Queues a frame to be sent, does not block
+        /// @return `false` if the transmit ring can not hold the whole frame, nothing is sent then
+        bool send(const uint8_t* data, size_t len);
+
+        /// @brief The amount of bytes received and not read yet
+        uint8_t available();
+
+        /// @brief Reads up to `len` received bytes, does not block
+        /// @return The amount of bytes read
+        uint8_t read(uint8_t* buffer, uint8_t len);
+
+        /// @brief Drops all bytes received and not read yet
+        void clear();
+
+        /// @brief Whether the last byte queued has left the USART
+        bool idle();
+
+        /// @brief Waits until the last byte queued has left the USART
+        void flush();
+
+        /// @brief A consistent copy of the error counters
+        Stats stats();
     }
 
     namespace io {
-        extern HardwareSerial* core_serial;
         extern char parse_buffer [PARSE_BUFFER_SIZE];
+        /// The baud rate the link to the core currently runs at
+        extern uint32_t baud;
 
         // Events
             void setup();
         // 
 
+        /// @brief Switches the UART of the core link to a new baud rate, waits until everything written has been sent
+        void set_baud(uint32_t baud);
+
+        /// @brief Steps the core link up to the fastest baud rate it supports (see `bugsy/baud.hpp`)
+        void negotiate_baud();
+
+        /// @brief Queues a frame to the core, all the frames are sent through here (see `ready()`)
+        /// @return `false` if the transmit ring can not hold the frame
+        bool send(const uint8_t* frame, size_t len);
+
+        /// @brief Whether the last frame queued has left the line at least `CORE_FRAME_GAP` ago
+        bool ready();
+
         void send_cmd_core(bugsy::Command cmd);
 
-        template<typename T>
-        void send_obj_core(bugsy::Command cmd, T* obj);
+        /// @brief Sends a command with a single byte argument (a state or an enum)
+        void send_u8_core(bugsy::Command cmd, uint8_t arg);
+
+        /// @brief Sends a message encoded with its builder `B` (see `bugsy/messages.hpp`), independent of the layout of `T`
+        template<typename B, typename T>
+        void send_msg_core(bugsy::Command cmd, const T& obj);
+
+        /// @brief Takes an answer of `len` bytes of the core into `parse_buffer` once it is complete, does not block
+        /// @return `len` once the answer is complete, `0` otherwise
+        size_t poll_core(size_t len);
+
+        /// @brief Waits up to `CORE_ANSWER_TIMEOUT` for an answer of the core of up to `len` bytes
+        /// @return The amount of bytes received into `parse_buffer`, `0` if the core did not answer in time
+        size_t recv_core(size_t len = PARSE_BUFFER_SIZE);
 
-        template<typename T>
-        T* recv_obj_core();
+        /// @brief Logs the error counters of the core link if they changed since the last call
+        void log_stats();
     }
 }
\ No newline at end of file
@@ -0,0 +1,254 @@
+# include "bugsy_trader.hpp"
+
+using bugsy::SensorStatus;
+
+/// Amount of falling edges of a complete DHT transmission: response, start of data and the end of all 40 bits
+# define DHT_EDGE_COUNT 42
+
+namespace bugsy_trader {
+    namespace device {
+        bugsy::PrimarySensorData primary_sensor_data;
+        bugsy::SecondarySensorData secondary_sensor_data;
+
+        namespace encoder {
+            /// Quadrature transitions indexed by `(previous AB << 2) | current AB`, invalid transitions (bounce) count zero
+            static const int8_t TRANSITIONS [16] = {
+                0, -1,  1,  0,
+                1,  0,  0, -1,
+               -1,  0,  0,  1,
+                0,  1, -1,  0
+            };
+
+            /// Edges counted by the ISR, a single byte can be read and written atomically on the AVR, so no locking is
+            /// required. The counter wraps, `update()` only uses the difference to the last value
+            static volatile uint8_t edges = 0;
+            /// Last AB state of the encoder pins, only touched by the ISR
+            static volatile uint8_t pin_state = 0;
+
+            /// Value of `edges` at the last `update()`
+            static uint8_t last_edges = 0;
+            /// Total amount of edges since the start
+            static int32_t edge_position = 0;
+
+            // Switch debouncing
+            static uint8_t sw_raw = 0;
+            static uint32_t sw_changed = 0;
+
+            static void isr() {
+                pin_state = ((pin_state << 2) | (digitalRead(PIN_ENCODER_CL) << 1) | digitalRead(PIN_ENCODER_DT)) & 0x0F;
+                edges += TRANSITIONS[pin_state];
+            }
+
+            void setup() {
+                pinMode(PIN_ENCODER_CL, INPUT);
+                pinMode(PIN_ENCODER_DT, INPUT);
+                pinMode(PIN_ENCODER_SW, INPUT);
+
+                pin_state = (digitalRead(PIN_ENCODER_CL) << 1) | digitalRead(PIN_ENCODER_DT);
+
+                attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_CL), isr, CHANGE);
+                attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_DT), isr, CHANGE);
+            }
+
+            void update() {
+                uint8_t current = edges;
+
+                edge_position += (int8_t)(current - last_edges);
+                last_edges = current;
+
+                primary_sensor_data.encoder_position = edge_position / ENCODER_EDGES_PER_STEP;
+
+                // The switch of the module is active low
+                uint8_t sw = (digitalRead(PIN_ENCODER_SW) == LOW);
+
+                if (sw != sw_raw) {
+                    sw_raw = sw;
+                    sw_changed = millis();
+                } else if ((millis() - sw_changed) >= ENCODER_SW_DEBOUNCE) {
+                    primary_sensor_data.encoder_pressed = sw;
+                }
+            }
+        }
+
+        namespace dht {
+            enum class Phase : uint8_t {
+                IDLE,
+                /// Data line is held low by the trader to request a measurement
+                START,
+                /// Data line is released, the ISR captures the falling edges
+                RECEIVING
+            };
+
+            static Phase phase = Phase::IDLE;
+            /// Time the current phase has been entered in microseconds
+            static uint32_t phase_start = 0;
+
+            /// Lower 16 bits of `micros()` at every falling edge, enough as a transmission is way shorter than 65 ms
+            static volatile uint16_t edge_stamps [DHT_EDGE_COUNT];
+            /// Amount of edges captured, kept at `DHT_EDGE_COUNT` while not receiving, so the ISR ignores the falling
+            /// edge of the start pulse
+            static volatile uint8_t edge_count = DHT_EDGE_COUNT;
+
+            static void isr() {
+                if (edge_count < DHT_EDGE_COUNT) {
+                    edge_stamps[edge_count++] = (uint16_t)micros();
+                }
+            }
+
+            /// Decodes the captured edges into `secondary_sensor_data`
+            static SensorStatus decode() {
+                uint8_t data [5] = { 0, 0, 0, 0, 0 };
+
+                for (uint8_t i = 0; i < 40; i++) {
+                    // Each bit is a 50us low pulse followed by a 26us (`0`) or 70us (`1`) high pulse
+                    uint16_t duration = edge_stamps[i + 2] - edge_stamps[i + 1];
+
+                    data[i / 8] <<= 1;
+                    if (duration > DHT_BIT_THRESHOLD) {
+                        data[i / 8] |= 1;
+                    }
+                }
+
+                if ((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4]) {
+                    return SensorStatus::CHECKSUM_ERROR;
+                }
+
+                secondary_sensor_data.humidity = ((uint16_t)data[0] << 8) | data[1];
+                secondary_sensor_data.temperature = (int16_t)((((uint16_t)data[2] & 0x7F) << 8) | data[3]);
+
+                if (data[2] & 0x80) {
+                    secondary_sensor_data.temperature = -secondary_sensor_data.temperature;
+                }
+
+                return SensorStatus::OK;
+            }
+
+            /// Ends the current transmission
+            static void finish(SensorStatus status) {
+                edge_count = DHT_EDGE_COUNT;
+                secondary_sensor_data.dht_status = status;
+                phase = Phase::IDLE;
+            }
+
+            void setup() {
+                pinMode(PIN_DHT_SENSOR, INPUT_PULLUP);
+                secondary_sensor_data.dht_status = SensorStatus::NONE;
+
+                attachInterrupt(digitalPinToInterrupt(PIN_DHT_SENSOR), isr, FALLING);
+            }
+
+            bool start() {
+                if (phase != Phase::IDLE) {
+                    return false;
+                }
+
+                pinMode(PIN_DHT_SENSOR, OUTPUT);
+                digitalWrite(PIN_DHT_SENSOR, LOW);
+
+                phase = Phase::START;
+                phase_start = micros();
+
+                return true;
+            }
+
+            bool update() {
+                switch (phase) {
+                    case Phase::IDLE:
+                        return false;
+
+                    case Phase::START:
+                        if ((micros() - phase_start) < DHT_START_PULSE) {
+                            return false;
+                        }
+
+                        // Release the line, the sensor answers within ~40us
+                        edge_count = 0;
+                        pinMode(PIN_DHT_SENSOR, INPUT_PULLUP);
+
+                        phase = Phase::RECEIVING;
+                        phase_start = micros();
+
+                        return false;
+
+                    case Phase::RECEIVING:
+                        if (edge_count >= DHT_EDGE_COUNT) {
+                            // The ISR does not touch the stamps anymore
+                            finish(decode());
+                            return true;
+                        }
+
+                        if ((micros() - phase_start) > DHT_TIMEOUT) {
+                            finish(SensorStatus::TIMEOUT);
+                            return true;
+                        }
+
+                        return false;
+                }
+
+                return false;
+            }
+        }
+
+        namespace obstacle {
+            /// Whether the line is asserted, set by the ISR and cleared by `update()` with interrupts disabled
+            static volatile uint8_t asserted = 0;
+            /// Last time the sensor detected an obstacle
+            static uint32_t last_seen = 0;
+
+            static void isr() {
+                if (digitalRead(PIN_OBSTACLE) == LOW) {
+                    digitalWrite(PIN_ESTOP, LOW);
+                    asserted = 1;
+                }
+            }
+
+            void setup() {
+                pinMode(PIN_OBSTACLE, INPUT_PULLUP);
+
+                // Stopped until the sensor has been found clear
+                digitalWrite(PIN_ESTOP, LOW);
+                pinMode(PIN_ESTOP, OUTPUT);
+                asserted = 1;
+                last_seen = millis();
+
+                attachInterrupt(digitalPinToInterrupt(PIN_OBSTACLE), isr, CHANGE);
+            }
+
+            void update() {
+                uint8_t detected = (digitalRead(PIN_OBSTACLE) == LOW);
+                primary_sensor_data.obstacle = detected;
+
+                if (detected) {
+                    last_seen = millis();
+                    return;
+                }
+
+                if (asserted && ((millis() - last_seen) >= BUGSY_ESTOP_HOLD)) {
+                    // Checking again with the ISR locked out, so an obstacle appearing right now is not released
+                    noInterrupts();
+
+                    if (digitalRead(PIN_OBSTACLE) == HIGH) {
+                        digitalWrite(PIN_ESTOP, HIGH);
+                        asserted = 0;
+                    }
+
+                    interrupts();
+                }
+            }
+        }
+
+        // Events
+            void setup() {
+                encoder::setup();
+                dht::setup();
+                obstacle::setup();
+            }
+
+            bool update() {
+                encoder::update();
+                obstacle::update();
+                return dht::update();
+            }
+        //
+    }
+}
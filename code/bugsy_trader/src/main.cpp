@@ -1,5 +1,8 @@
 // Libraries
+# include <bugsy/batch.hpp>
+# include <bugsy/baud.hpp>
 # include <bugsy/defines.hpp>
+# include <bugsy/messages.hpp>
 # include <sylo/logging.hpp>
 # include <sylo/timing/timer.hpp>
 
@@ -9,25 +12,212 @@
 # include "bugsy_trader.hpp"
 
 // Static fields
-static Timer state_interval, primary_interval, secondary_interval;
+static Timer state_interval, secondary_interval;
 
 namespace bugsy_trader {
     bugsy::TraderState state;
 
     namespace core {
-        void reconnect() {
+        /// State of the link to the core
+        enum class Link : uint8_t {
+            /// Waiting for the next attempt to reach the core
+            BACKOFF,
+            /// The state request of an attempt waits for its answer
+            CONNECTING,
+            /// The state is exchanged every `BUGSY_STATE_INTERVAL` to check up on the core, the publishes are the heartbeat
+            CONNECTED,
+            /// The link got lost at a negotiated rate, silent until the core timed out and fell back to the base rate
+            FALLBACK
+        };
+
+        /// Outcome of a state request
+        enum class Answer : uint8_t {
+            PENDING,
+            RECEIVED,
+            /// Not answered within `CORE_ANSWER_TIMEOUT`
+            MISSED
+        };
+
+        static Link link = Link::BACKOFF;
+
+        /// Whether a state request waits for its answer and the time it has been sent at
+        static bool awaiting = false;
+        static unsigned long request_stamp = 0;
+
+        /// State requests of the connected core not answered in a row, the next one is sent right away
+        static uint8_t misses = 0;
+
+        /// Current delay between two attempts to reach the core and the time the next attempt is due at
+        static unsigned long backoff = RECONNECT_MIN_DELAY;
+        static unsigned long attempt_stamp = 0;
+
+        /// Time the link got lost at
+        static unsigned long lost_stamp = 0;
+
+        /// Whether the sensor data sampled while the core was gone still has to be published
+        static bool flush_due = false;
+
+        /// Sends the trader state, the answer is picked up by `answer()`
+        static void request() {
+            // Leftovers of an earlier answer would be taken for this one
+            usart::clear();
+            io::send_u8_core(bugsy::Command::SetTraderState, (uint8_t)bugsy_trader::state);
+
+            awaiting = true;
+            request_stamp = millis();
+        }
+
+        /// Picks up the answer of the last state request into `state`
+        static Answer answer() {
+            if (io::poll_core(sizeof(bugsy::CoreState))) {
+                state = (bugsy::CoreState)io::parse_buffer[0];
+            } else if ((millis() - request_stamp) >= CORE_ANSWER_TIMEOUT) {
+                awaiting = false;
+                return Answer::MISSED;
+            } else {
+                return Answer::PENDING;
+            }
+
+            awaiting = false;
+            return Answer::RECEIVED;
+        }
+
+        /// Starts the attempts to reach the core at the current rate
+        static void connect() {
             log_info("> Connecting to core ...");
 
-            while (bugsy::is_operational(bugsy_trader::core::state)) {
-                delay(100);
-                log_info(".");
-                bugsy_trader::core::state = bugsy_trader::core::set_trader_state(bugsy_trader::state);
+            link = Link::BACKOFF;
+            awaiting = false;
+            misses = 0;
+            flush_due = false;
+            backoff = RECONNECT_MIN_DELAY;
+            // First attempt right away
+            attempt_stamp = millis();
+        }
+
+        /// Gives up a link that does not answer anymore
+        static void lost() {
+            state = bugsy::CoreState::ERROR;
+
+            if (io::baud == BUGSY_UART_CORE_TO_TRADER_BAUD) {
+                reconnect();
+                return;
             }
 
-            // Send ready connection success to core
-            bugsy_trader::core::set_trader_state(bugsy_trader::state);
+            // Frames at the base rate would reach the core as garbage until it timed out the trader on its side as well
+            log_errorln("> Core link lost, falling back to the base rate");
+
+            link = Link::FALLBACK;
+            awaiting = false;
+            lost_stamp = millis();
+        }
+
+        void reconnect() {
+            // A lost connection starts over at the base rate, as does the core once the trader timed out
+            io::set_baud(BUGSY_UART_CORE_TO_TRADER_BAUD);
+            connect();
+        }
+
+        bool connected() {
+            return link == Link::CONNECTED;
+        }
+
+        bool ready() {
+            return (link == Link::CONNECTED) && !awaiting && io::ready();
+        }
+
+        void update() {
+            Answer result;
+
+            switch (link) {
+                case Link::BACKOFF:
+                    if (((long)(millis() - attempt_stamp) >= 0) && io::ready()) {
+                        request();
+                        link = Link::CONNECTING;
+                    }
+
+                    break;
+
+                case Link::CONNECTING:
+                    result = answer();
+
+                    if (result == Answer::PENDING) {
+                        break;
+                    }
 
-            log_infoln(" done!");
+                    // A core still at a negotiated rate answers the attempts, one that fell back does not
+                    if ((result == Answer::MISSED) && (io::baud != BUGSY_UART_CORE_TO_TRADER_BAUD)) {
+                        lost();
+                        break;
+                    }
+
+                    if ((result == Answer::RECEIVED) && bugsy::is_operational(state)) {
+                        log_infoln(" done!");
+
+                        io::negotiate_baud();
+                        link = Link::CONNECTED;
+                        state_interval.set();
+
+                        // Everything sampled while the core was gone, once the last test frame has been framed
+                        flush_due = true;
+                        break;
+                    }
+
+                    log_info(".");
+
+                    // Exponential backoff, the jitter keeps the attempts from locking onto a periodic fault of the core
+                    attempt_stamp = millis() + backoff + random((long)(backoff * RECONNECT_JITTER / 100) + 1);
+                    backoff = ((backoff * 2) < RECONNECT_MAX_DELAY) ? (backoff * 2) : RECONNECT_MAX_DELAY;
+                    link = Link::BACKOFF;
+                    break;
+
+                case Link::CONNECTED:
+                    if (awaiting) {
+                        result = answer();
+
+                        if (result == Answer::RECEIVED) {
+                            misses = 0;
+
+                            // The link itself works, so the rate is kept
+                            if (!bugsy::is_operational(state)) {
+                                connect();
+                            }
+                        } else if (result == Answer::MISSED) {
+                            // A single lost frame, e.g. a broken byte, is no reason to give up the link
+                            if (++misses > CORE_ANSWER_RETRIES) {
+                                lost();
+                            } else {
+                                log_errorln("> Core did not answer, retrying");
+                            }
+                        }
+
+                        break;
+                    }
+
+                    // The core would merge the next frame with the last one, e.g. a publish of the last iteration
+                    if (!io::ready()) {
+                        break;
+                    }
+
+                    if (flush_due) {
+                        publish::flush();
+                        flush_due = false;
+                    } else if ((misses > 0) || state_interval.has_elapsed()) {
+                        request();
+                        state_interval.set();
+
+                        io::log_stats();
+                    }
+
+                    break;
+
+                case Link::FALLBACK:
+                    if ((millis() - lost_stamp) >= CORE_FALLBACK_DELAY) {
+                        reconnect();
+                    }
+
+                    break;
+            }
         }
 
         // Commands
@@ -37,48 +227,269 @@ namespace bugsy_trader {
 
         bugsy::CoreState get_state() {
             io::send_cmd_core(bugsy::Command::GetState);
-            // Write to parse buffers, so `CoreState::ERROR` gets parsed when no message has been received
-            io::parse_buffer[0] = (uint8_t)bugsy::CoreState::ERROR;
-            return *io::recv_obj_core<bugsy::CoreState>();
+            // `CoreState::ERROR` if no message has been received
+            return io::recv_core(sizeof(bugsy::CoreState)) ? (bugsy::CoreState)io::parse_buffer[0] : bugsy::CoreState::ERROR;
         }
 
         bugsy::CoreState set_trader_state(bugsy::TraderState state) {
-            io::send_obj_core(bugsy::Command::SetTraderState, &state);
-            // Write to parse buffers, so `CoreState::ERROR` gets parsed when no message has been received
-            io::parse_buffer[0] = (uint8_t)bugsy::CoreState::ERROR;
-            return *io::recv_obj_core<bugsy::CoreState>();
-
+            io::send_u8_core(bugsy::Command::SetTraderState, (uint8_t)state);
+            // `CoreState::ERROR` if no message has been received
+            return io::recv_core(sizeof(bugsy::CoreState)) ? (bugsy::CoreState)io::parse_buffer[0] : bugsy::CoreState::ERROR;
         }
 
         char* get_wifi_ssid() {
             io::send_cmd_core(bugsy::Command::GetWiFiSSID);
-            return io::recv_obj_core<char>();
+            size_t len = io::recv_core();
+
+            // Terminated in any case, the answer might have been cut off
+            io::parse_buffer[(len < PARSE_BUFFER_SIZE) ? len : (PARSE_BUFFER_SIZE - 1)] = 0;
+            return io::parse_buffer;
+        }
+    }
+
+    namespace publish {
+        /// The sensor data last sent to the core
+        static bugsy::PrimarySensorData primary_last;
+        static bugsy::SecondarySensorData secondary_last;
+
+        /// Time of the last publishes
+        static unsigned long primary_stamp = 0;
+        static unsigned long secondary_stamp = 0;
+
+        /// Whether `a` and `b` differ by at least `deadband`
+        static bool exceeds(int32_t a, int32_t b, int32_t deadband) {
+            return (a > b) ? ((a - b) >= deadband) : ((b - a) >= deadband);
+        }
+
+        /// Appends a publish of `data` encoded with its builder `B` to a batch
+        template<typename B, typename T>
+        static void add(bugsy::batch::Writer& writer, bugsy::Command cmd, const T& data) {
+            uint8_t buffer [B::SIZE];
+            B(buffer, sizeof(buffer)).set(data);
+
+            writer.begin();
+            writer.append(&cmd, sizeof(bugsy::Command));
+            writer.append(buffer, sizeof(buffer));
+            writer.end();
+        }
+
+        /// Whether the primary sensor data changed or became stale since the last publish
+        static bool primary_due() {
+            const bugsy::PrimarySensorData& data = device::primary_sensor_data;
+            unsigned long elapsed = millis() - primary_stamp;
+
+            bool changed = exceeds(data.encoder_position, primary_last.encoder_position, DEADBAND_ENCODER_POSITION)
+                || (data.encoder_pressed != primary_last.encoder_pressed)
+                || (data.obstacle != primary_last.obstacle);
+
+            return (changed && (elapsed >= BUGSY_SENSOR_MIN_PUBLISH_INTERVAL)) || (elapsed >= BUGSY_PRIMARY_SENSOR_INTERVAL);
+        }
+
+        /// Whether the secondary sensor data changed or became stale since the last publish
+        static bool secondary_due() {
+            const bugsy::SecondarySensorData& data = device::secondary_sensor_data;
+            unsigned long elapsed = millis() - secondary_stamp;
+
+            // A failing sensor should be reported right away, changed values of a failed measurement are meaningless
+            bool changed = (data.dht_status != secondary_last.dht_status) || ((data.dht_status == bugsy::SensorStatus::OK) && (
+                exceeds(data.temperature, secondary_last.temperature, DEADBAND_TEMPERATURE)
+                || exceeds(data.humidity, secondary_last.humidity, DEADBAND_HUMIDITY)
+            ));
+
+            return (changed && (elapsed >= BUGSY_SENSOR_MIN_PUBLISH_INTERVAL)) || (elapsed >= BUGSY_SECONDARY_SENSOR_MAX_STALENESS);
+        }
+
+        /// Publishes the selected sensor data as one frame, a batch if both are selected
+        static void send(bool primary, bool secondary) {
+            uint8_t frame [BUGSY_BATCH_FRAME_SIZE];
+            size_t len;
+
+            if (primary && secondary) {
+                frame[0] = (uint8_t)bugsy::Command::Batch;
+
+                bugsy::batch::Writer writer(frame + sizeof(bugsy::Command), sizeof(frame) - sizeof(bugsy::Command));
+                add<bugsy::msg::PrimarySensorDataBuilder>(writer, bugsy::Command::PublishPrimarySensorData, device::primary_sensor_data);
+                add<bugsy::msg::SecondarySensorDataBuilder>(writer, bugsy::Command::PublishSecondarySensorData, device::secondary_sensor_data);
+
+                len = sizeof(bugsy::Command) + writer.size();
+            } else if (primary) {
+                frame[0] = (uint8_t)bugsy::Command::PublishPrimarySensorData;
+                bugsy::msg::PrimarySensorDataBuilder(frame + sizeof(bugsy::Command), bugsy::msg::PrimarySensorDataBuilder::SIZE)
+                    .set(device::primary_sensor_data);
+
+                len = sizeof(bugsy::Command) + bugsy::msg::PrimarySensorDataBuilder::SIZE;
+            } else if (secondary) {
+                frame[0] = (uint8_t)bugsy::Command::PublishSecondarySensorData;
+                bugsy::msg::SecondarySensorDataBuilder(frame + sizeof(bugsy::Command), bugsy::msg::SecondarySensorDataBuilder::SIZE)
+                    .set(device::secondary_sensor_data);
+
+                len = sizeof(bugsy::Command) + bugsy::msg::SecondarySensorDataBuilder::SIZE;
+            } else {
+                return;
+            }
+
+            // The answer of a batch (no answers) is dropped with the next request
+            if (!io::send(frame, len)) {
+                return;
+            }
+
+            if (primary) {
+                primary_last = device::primary_sensor_data;
+                primary_stamp = millis();
+            }
+
+            if (secondary) {
+                secondary_last = device::secondary_sensor_data;
+                secondary_stamp = millis();
+            }
+        }
+
+        void update() {
+            // Kept in `device::*_sensor_data` until `flush()` or the next call the core is ready at
+            if (!core::ready()) {
+                return;
+            }
+
+            // Both due at once, e.g. after a measurement, would be two frames, of which only one could be sent now
+            send(primary_due(), secondary_due());
+        }
+
+        void flush() {
+            send(true, true);
         }
     }
 
     namespace io {
-        HardwareSerial* core_serial = &Serial3;
         char parse_buffer [PARSE_BUFFER_SIZE];
+        uint32_t baud = BUGSY_UART_CORE_TO_TRADER_BAUD;
+
+        /// Transport of the baud negotiation (see `bugsy::baud::negotiate()`)
+        struct BaudLink {
+            bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len) {
+                // Leftovers of an earlier answer would shift this one
+                usart::clear();
+
+                if (!send(cmd, len) || (recv_core(answer_len) != answer_len)) {
+                    return false;
+                }
+
+                memcpy(answer, parse_buffer, answer_len);
+                return true;
+            }
+
+            void set_baud(uint32_t baud) { io::set_baud(baud); }
+
+            void wait(uint32_t ms) { delay(ms); }
+        };
+
+        /// Error counters at the last `log_stats()`
+        static usart::Stats stats_last = { };
+
+        /// Whether a frame has been queued since the line was last found idle, and the time it was found idle at
+        static bool queued = false;
+        static unsigned long idle_stamp = 0;
 
         void setup() {
-            core_serial->begin(BUGSY_UART_CORE_TO_TRADER_BAUD);
-            core_serial->setTimeout(15);
+            usart::begin(BUGSY_UART_CORE_TO_TRADER_BAUD);
+        }
+
+        void set_baud(uint32_t new_baud) {
+            if (new_baud == baud) {
+                return;
+            }
+
+            usart::end();
+            usart::begin(new_baud);
+            baud = new_baud;
+        }
+
+        void negotiate_baud() {
+            BaudLink link;
+
+            log_info("> Negotiating baud rate ... ");
+            bugsy::baud::negotiate(link, baud, BUGSY_UART_CORE_TO_TRADER_MAX_BAUD);
+            log_info(baud);
+            log_infoln(" baud");
+        }
+
+        // Every command is queued as one frame, so it is either sent completely or not at all
+
+        bool send(const uint8_t* frame, size_t len) {
+            if (!usart::send(frame, len)) {
+                return false;
+            }
+
+            queued = true;
+            return true;
+        }
+
+        bool ready() {
+            if (queued) {
+                if (!usart::idle()) {
+                    return false;
+                }
+
+                // Found later than the last byte left, which only lengthens the gap
+                queued = false;
+                idle_stamp = micros();
+            }
+
+            return (micros() - idle_stamp) >= CORE_FRAME_GAP;
         }
 
         void send_cmd_core(bugsy::Command cmd) {
-            core_serial->write((const uint8_t*)&cmd, sizeof(bugsy::Command));
+            send((const uint8_t*)&cmd, sizeof(bugsy::Command));
         }
 
-        template<typename T>
-        void send_obj_core(bugsy::Command cmd, T* obj) {
-            core_serial->write((const uint8_t*)&cmd, sizeof(bugsy::Command));
-            core_serial->write((const uint8_t*)obj, sizeof(T));
+        void send_u8_core(bugsy::Command cmd, uint8_t arg) {
+            uint8_t frame [sizeof(bugsy::Command) + sizeof(uint8_t)] = { (uint8_t)cmd, arg };
+            send(frame, sizeof(frame));
         }
 
-        template<typename T>
-        T* recv_obj_core() {
-            core_serial->readBytes((uint8_t*)parse_buffer, PARSE_BUFFER_SIZE);
-            return (T*)parse_buffer;
+        template<typename B, typename T>
+        void send_msg_core(bugsy::Command cmd, const T& obj) {
+            uint8_t frame [sizeof(bugsy::Command) + B::SIZE];
+            memcpy(frame, &cmd, sizeof(bugsy::Command));
+            B(frame + sizeof(bugsy::Command), B::SIZE).set(obj);
+
+            send(frame, sizeof(frame));
+        }
+
+        size_t poll_core(size_t len) {
+            if (usart::available() < len) {
+                return 0;
+            }
+
+            return usart::read((uint8_t*)parse_buffer, len);
+        }
+
+        size_t recv_core(size_t len) {
+            unsigned long start = millis();
+
+            // Answers arrive in one piece, the wait ends with their last byte
+            while ((usart::available() < len) && ((millis() - start) < CORE_ANSWER_TIMEOUT));
+
+            return usart::read((uint8_t*)parse_buffer, (len < PARSE_BUFFER_SIZE) ? len : PARSE_BUFFER_SIZE);
+        }
+
+        void log_stats() {
+            usart::Stats stats = usart::stats();
+
+            if (memcmp(&stats, &stats_last, sizeof(usart::Stats)) == 0) {
+                return;
+            }
+
+            log_error("> Core link errors: ");
+            log_error(stats.rx_overruns);
+            log_error(" RX overruns, ");
+            log_error(stats.hw_overruns);
+            log_error(" USART overruns, ");
+            log_error(stats.frame_errors);
+            log_error(" framing errors, ");
+            log_error(stats.tx_dropped);
+            log_errorln(" frames dropped");
+
+            stats_last = stats;
         }
     }
 }
@@ -98,33 +509,26 @@ void setup() {
     log_debugln("|");
 
     bugsy_trader::io::setup();
+    bugsy_trader::device::setup();
 
     log_infoln("> SETUP done!");
 
+    // Connects in the background, the sensors are sampled meanwhile
     bugsy_trader::core::reconnect();
     state_interval.set(BUGSY_STATE_INTERVAL);
-    primary_interval.set(BUGSY_PRIMARY_SENSOR_INTERVAL);
     secondary_interval.set(BUGSY_SECONDARY_SENSOR_INTERVAL);
 }
 
 void loop() {
-    // Check up state
-    if (state_interval.has_elapsed()) {
-        bugsy_trader::core::state = bugsy_trader::core::set_trader_state(bugsy_trader::state);
-
-        //
-        if (!bugsy::is_operational(bugsy_trader::core::state)) {
-            bugsy_trader::core::reconnect();
-        }
-
-        state_interval.set();
-    }
+    // Check up state or reconnect, the answers of the core are picked up by the next iterations
+    bugsy_trader::core::update();
 
-    if (primary_interval.has_elapsed()) {
-        primary_interval.set();
-    }
+    // Sensors are sampled without blocking and only published when they changed or became stale
+    bugsy_trader::device::update();
+    bugsy_trader::publish::update();
 
     if (secondary_interval.has_elapsed()) {
+        bugsy_trader::device::dht::start();
         secondary_interval.set();
     }
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+# include "bugsy_trader.hpp"
+
+# include <avr/interrupt.h>
+# include <avr/io.h>
+
+# if (USART_RX_BUFFER_SIZE & (USART_RX_BUFFER_SIZE - 1)) || (USART_RX_BUFFER_SIZE > 128)
+    # error "The receive ring has to be a power of 2 of at most 128 bytes!"
+# endif
+
+# if (USART_TX_BUFFER_SIZE & (USART_TX_BUFFER_SIZE - 1)) || (USART_TX_BUFFER_SIZE > 128)
+    # error "The transmit ring has to be a power of 2 of at most 128 bytes!"
+# endif
+
+namespace bugsy_trader {
+    namespace usart {
+        // Rings
+            // The positions only ever grow and wrap with their byte, each one is only written by either the ISR or the
+            // loop. A single byte is read and written atomically on the AVR, so no locking is required
+
+            static uint8_t rx_data [USART_RX_BUFFER_SIZE];
+            /// Written by the receive ISR
+            static volatile uint8_t rx_head = 0;
+            /// Written by the loop
+            static volatile uint8_t rx_tail = 0;
+
+            static uint8_t tx_data [USART_TX_BUFFER_SIZE];
+            /// Written by the loop
+            static volatile uint8_t tx_head = 0;
+            /// Written by the transmit ISR
+            static volatile uint8_t tx_tail = 0;
+        //
+
+        /// Counters, the ones of the receive side are written by the ISR
+        static volatile Stats counters = { };
+
+        /// Whether anything has been sent since `begin()`, the transmit complete flag is never set otherwise
+        static bool written = false;
+
+        void begin(uint32_t baud) {
+            UCSR3B = 0;
+
+            // Double speed halves the divider error, 250k, 500k and 1M are exact at 16 MHz
+            UBRR3 = (uint16_t)(((F_CPU / 4 / baud) - 1) / 2);
+            UCSR3A = _BV(U2X3);
+            // 8N1
+            UCSR3C = _BV(UCSZ31) | _BV(UCSZ30);
+
+            rx_tail = rx_head;
+            tx_head = tx_tail;
+            written = false;
+
+            UCSR3B = _BV(RXEN3) | _BV(TXEN3) | _BV(RXCIE3);
+        }
+
+        void end() {
+            flush();
+            UCSR3B = 0;
+            rx_tail = rx_head;
+        }
+
+        bool send(const uint8_t* data, size_t len) {
+            uint8_t head = tx_head;
+
+            // A frame is never cut off, the core could not tell where the next one starts
+            if (len > (size_t)(USART_TX_BUFFER_SIZE - (uint8_t)(head - tx_tail))) {
+                counters.tx_dropped++;
+                return false;
+            }
+
+            for (size_t i = 0; i < len; i++) {
+                tx_data[(uint8_t)(head + i) & (USART_TX_BUFFER_SIZE - 1)] = data[i];
+            }
+
+            // Cleared by writing a one, set again once the last byte left the shift register (see `flush()`)
+            UCSR3A = (UCSR3A & _BV(U2X3)) | _BV(TXC3);
+            written = true;
+
+            tx_head = head + len;
+            UCSR3B |= _BV(UDRIE3);
+
+            return true;
+        }
+
+        uint8_t available() {
+            return rx_head - rx_tail;
+        }
+
+        uint8_t read(uint8_t* buffer, uint8_t len) {
+            uint8_t tail = rx_tail;
+            uint8_t avail = rx_head - tail;
+
+            if (len > avail) {
+                len = avail;
+            }
+
+            for (uint8_t i = 0; i < len; i++) {
+                buffer[i] = rx_data[(uint8_t)(tail + i) & (USART_RX_BUFFER_SIZE - 1)];
+            }
+
+            rx_tail = tail + len;
+            return len;
+        }
+
+        void clear() {
+            rx_tail = rx_head;
+        }
+
+        bool idle() {
+            return (tx_head == tx_tail) && (!written || (UCSR3A & _BV(TXC3)));
+        }
+
+        void flush() {
+            while (!idle());
+        }
+
+        Stats stats() {
+            noInterrupts();
+            Stats copy = { counters.rx_overruns, counters.hw_overruns, counters.frame_errors, counters.tx_dropped };
+            interrupts();
+
+            return copy;
+        }
+    }
+}
+
+ISR(USART3_RX_vect) {
+    using namespace bugsy_trader::usart;
+
+    // The flags belong to the byte in the data register, so they have to be read first
+    uint8_t status = UCSR3A;
+    uint8_t byte = UDR3;
+
+    if (status & _BV(DOR3)) {
+        counters.hw_overruns++;
+    }
+
+    // A broken byte is dropped, the frame fails its length check and is requested again
+    if (status & _BV(FE3)) {
+        counters.frame_errors++;
+        return;
+    }
+
+    uint8_t head = rx_head;
+
+    if ((uint8_t)(head - rx_tail) >= USART_RX_BUFFER_SIZE) {
+        counters.rx_overruns++;
+        return;
+    }
+
+    rx_data[head & (USART_RX_BUFFER_SIZE - 1)] = byte;
+    rx_head = head + 1;
+}
+
+ISR(USART3_UDRE_vect) {
+    using namespace bugsy_trader::usart;
+
+    uint8_t tail = tx_tail;
+    UDR3 = tx_data[tail & (USART_TX_BUFFER_SIZE - 1)];
+    tx_tail = ++tail;
+
+    if (tail == tx_head) {
+        UCSR3B &= ~_BV(UDRIE3);
+    }
+}
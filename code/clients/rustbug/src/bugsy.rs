@@ -3,116 +3,74 @@ use core::time::Duration;
 use colored::Colorize;
 use serialport::SerialPort;
 
-/// A standard command used by the bugsy robot, see the `bugsy.hpp` header file for more infos
-#[repr(u8)]
-#[derive(Clone, Copy, Debug)]
-pub enum Command {
-    Test = 0x00,
-    GetState = 0x01,
-
-    Move = 0x10,
-    
-    IsTraderReady = 0x21,
-    IsRPiReady = 0x23,
-
-    RemoteMode = 0x40
-}
-
-/// The current state of the Bugsy
-#[derive(Clone, Copy, Debug)]
-#[repr(u8)]
-pub enum State {
-    /// No state has been set yet
-    NONE = 0x00,
-    /// The controller is currently setting up
-    SETUP = 0x10,
-    /// The robot is in standby mode
-    STANDBY = 0x20,
-    /// The controller is at full activity and running
-    DRIVING = 0x21,
-    /// The controller has stopped due to a critical error
-    ERROR = 0xF0
-}
+pub use crate::messages::{Command, CoreState, Direction, MovementBuilder, Remote, TraderState};
 
-impl core::fmt::Display for State {
+impl core::fmt::Display for CoreState {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         // Prints out a colored version of the state
         match self {
             Self::NONE => f.write_fmt(format_args!("{}", "NONE".white())),
             Self::SETUP => f.write_fmt(format_args!("{}", "SETUP".yellow())),
             Self::STANDBY => f.write_fmt(format_args!("{}", "STANDBY".bright_blue())),
+            Self::ACTIVE => f.write_fmt(format_args!("{}", "ACTIVE".bright_green())),
             Self::DRIVING => f.write_fmt(format_args!("{}", "RUNNING".green())),
             Self::ERROR => f.write_fmt(format_args!("{}", "ERROR".red()))
         }
     }
 }
 
-/// Current remote configuration mode of the Bugsy
-#[derive(Clone, Copy, Debug)]
-#[repr(u8)]
-#[allow(non_camel_case_types)]
-pub enum Remote {
-    NONE = 0x00,
-
-    BLUETOOTH = 0x01,
-
-    USB = 0x02,
-    TRADER = 0x04,
-    RPI = 0x08,
-
-    WIFI_UDP = 0x10,
-    WIFI_TCP = 0x20,
-    WIFI_MQTT = 0x40,
-    WIFI_CAM = 0x80,
-
-    ANY_WIFI = 0xF0,
-
-    ALL = 0xFF
-}
-
 #[derive(Copy, Clone, Debug)]
 pub struct Movement {
-    pub chain_left_dir : bool,
-    pub chain_right_dir : bool,
+    pub chain_left_dir : Direction,
+    pub chain_right_dir : Direction,
     pub chain_left_duty : u8,
     pub chain_right_duty : u8
 }
 
 impl Movement {
     pub const NONE : Self = Self {
-        chain_left_dir: true,
-        chain_right_dir: true,
+        chain_left_dir: Direction::CW,
+        chain_right_dir: Direction::CW,
         chain_left_duty: 0,
         chain_right_duty: 0
     }; 
 
     pub const FORWARD : Self = Self {
-        chain_left_dir: true,
-        chain_right_dir: true,
+        chain_left_dir: Direction::CW,
+        chain_right_dir: Direction::CW,
         chain_left_duty: u8::MAX,
         chain_right_duty: u8::MAX
     };  
 
     pub const BACKWARD : Self = Self {
-        chain_left_dir: false,
-        chain_right_dir: false,
+        chain_left_dir: Direction::CCW,
+        chain_right_dir: Direction::CCW,
         chain_left_duty: u8::MAX,
         chain_right_duty: u8::MAX
     };
 
     pub const SPIN_CW : Self = Self {
-        chain_left_dir: true,
-        chain_right_dir: false,
+        chain_left_dir: Direction::CW,
+        chain_right_dir: Direction::CCW,
         chain_left_duty: u8::MAX,
         chain_right_duty: u8::MAX
     };
 
     pub const SPIN_CCW : Self = Self {
-        chain_left_dir: false,
-        chain_right_dir: true,
+        chain_left_dir: Direction::CCW,
+        chain_right_dir: Direction::CW,
         chain_left_duty: u8::MAX,
         chain_right_duty: u8::MAX
-    };    
+    };
+
+    /// Encodes the movement in the wire format of the core
+    pub fn encode(&self, builder : &mut MovementBuilder) {
+        builder
+            .chain_left_dir(self.chain_left_dir)
+            .chain_right_dir(self.chain_right_dir)
+            .chain_left_duty(self.chain_left_duty)
+            .chain_right_duty(self.chain_right_duty);
+    }
 }
 
 
@@ -139,9 +97,17 @@ impl Movement {
         }
 
         // USB I/O
-            pub unsafe fn read_obj<T>(&mut self, size : usize) -> Result<T, std::io::Error> {
+            pub fn read_bytes(&mut self, size : usize) -> Result<&[u8], std::io::Error> {
                 self.port.read_exact(&mut self.rx_buffer[0 .. size])?;
-                Ok(core::mem::transmute_copy(&mut self.rx_buffer))
+                Ok(&self.rx_buffer[0 .. size])
+            }
+
+            pub fn read_state(&mut self) -> Result<CoreState, std::io::Error> {
+                let value = self.read_bytes(1)?[0];
+
+                CoreState::try_from(value).map_err(|value| std::io::Error::new(
+                    std::io::ErrorKind::InvalidData, format!("Unknown core state 0x{:02X}", value)
+                ))
             }
 
             pub fn write_cmd(&mut self, cmd : Command) -> Result<usize, std::io::Error> {
@@ -149,18 +115,10 @@ impl Movement {
                 self.port.write(&self.tx_buffer[0 .. 1])
             }
 
-            pub unsafe fn write_cmd_obj<T>(&mut self, cmd : Command, obj : &T) -> Result<usize, std::io::Error> {
+            pub fn write_cmd_args(&mut self, cmd : Command, args : &[u8]) -> Result<usize, std::io::Error> {
                 self.tx_buffer[0] = cmd as u8;
-
-                let size = core::mem::size_of::<T>();
-
-                core::ptr::copy_nonoverlapping(
-                    obj as *const T as *const u8, 
-                    &mut self.tx_buffer[1] as *mut u8, 
-                    size
-                );
-
-                self.port.write(&self.tx_buffer[0 .. (size + 1)])
+                self.tx_buffer[1 .. (args.len() + 1)].copy_from_slice(args);
+                self.port.write(&self.tx_buffer[0 .. (args.len() + 1)])
             }
         //
 
@@ -185,39 +143,35 @@ impl Movement {
         // 
 
         // Commands
-            pub fn get_state(&mut self) -> Result<State, std::io::Error> {
+            pub fn get_state(&mut self) -> Result<CoreState, std::io::Error> {
                 self.write_cmd(Command::GetState)?;
-                unsafe {
-                    self.read_obj(1)
-                }
+                self.read_state()
             } 
 
             pub fn is_trader_ready(&mut self) -> Result<bool, std::io::Error> {
-                self.write_cmd(Command::IsTraderReady)?;
-                unsafe {
-                    self.read_obj(1)
-                }
+                self.write_cmd(Command::GetTraderState)?;
+                Ok(TraderState::try_from(self.read_bytes(1)?[0]) == Ok(TraderState::ACTIVE))
             } 
 
             pub fn is_rpi_ready(&mut self) -> Result<bool, std::io::Error> {
                 self.write_cmd(Command::IsRPiReady)?;
-                unsafe {
-                    self.read_obj(1)
-                }
+                Ok(self.read_bytes(1)?[0] != 0)
             }
 
             pub fn send_move(&mut self, movement : &Movement) -> Result<(), std::io::Error> {
-                unsafe {
-                    self.write_cmd_obj(Command::Move, movement)?;
-                };
+                let mut args = [0; MovementBuilder::SIZE];
+
+                if let Some(mut builder) = MovementBuilder::new(&mut args) {
+                    movement.encode(&mut builder);
+                }
+
+                self.write_cmd_args(Command::Move, &args)?;
                 Ok(())
             }
 
-            pub fn remote_mode(&mut self) -> Result<Remote, std::io::Error> {
-                self.write_cmd(Command::RemoteMode)?;
-                unsafe {
-                    self.read_obj(1)
-                }
+            pub fn remotes(&mut self) -> Result<Remote, std::io::Error> {
+                self.write_cmd(Command::Remotes)?;
+                Ok(Remote(self.read_bytes(1)?[0]))
             }
         //
     }
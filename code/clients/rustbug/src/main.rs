@@ -16,7 +16,8 @@ use crossterm::terminal::{disable_raw_mode, enable_raw_mode, Clear, ClearType};
 use std::io::stdout;
 
 mod bugsy;
-pub use bugsy::{BugsySerial, Movement, State};
+mod messages;
+pub use bugsy::{BugsySerial, CoreState, Movement};
 
 fn bool_to_colored_text(b : bool) -> ColoredString {
     if b {
@@ -218,18 +219,16 @@ fn main() {
             bugsy.write_cmd(bugsy::Command::GetState).expect("[ERROR] Error while sending the command!");
             let inst = Instant::now();
 
-            let state : State = unsafe {
-                match bugsy.read_obj(1) {
-                    Ok(state) => state,
-                    Err(err) => {
-                        if err.kind() == ErrorKind::TimedOut {
-                            println!("| > [{}] Request timed out!", counter);
-                            std::thread::sleep(dur);
-                            counter += 1;
-                            continue;
-                        } else {
-                            panic!("[ERROR] Error while reading input");
-                        }
+            let state : CoreState = match bugsy.read_state() {
+                Ok(state) => state,
+                Err(err) => {
+                    if err.kind() == ErrorKind::TimedOut {
+                        println!("| > [{}] Request timed out!", counter);
+                        std::thread::sleep(dur);
+                        counter += 1;
+                        continue;
+                    } else {
+                        panic!("[ERROR] Error while reading input");
                     }
                 }
             };
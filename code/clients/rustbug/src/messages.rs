@@ -0,0 +1,2111 @@
+// #########################
+// #    BUGSY - MESSAGES    #
+// #########################
+//
+// GENERATED by `schema/generate.py` from `schema/messages.json`, do not edit!
+//
+// Wire format of all messages exchanged with the core, little endian and without any implicit padding.
+//
+// Views decode a message in place from a received buffer, builders encode it in place into a send buffer, both check
+// the length once when created.
+
+#![allow(dead_code)]
+
+/// Command-codes that can be sent to the bugsy to cause actions / acquire data
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum Command {
+    Test = 0x00,
+    GetState = 0x01,
+    GetBattery = 0x02,
+    GetPowerStats = 0x03,
+    GetEStopStats = 0x04,
+    SyncClock = 0x05,
+    Batch = 0x06,
+    GetLinkStats = 0x07,
+    GetFailsafeConfig = 0x08,
+    SetFailsafeConfig = 0x09,
+    ProposeBaud = 0x0A,
+    BaudTest = 0x0B,
+    ConfirmBaud = 0x0C,
+    GetBaudStats = 0x0D,
+    Move = 0x10,
+    SetMoveMode = 0x11,
+    GetMoveMode = 0x12,
+    GetMoveConfig = 0x13,
+    SetMoveConfig = 0x14,
+    GetMovement = 0x15,
+    MoveServo = 0x16,
+    GetServo = 0x17,
+    Drive = 0x18,
+    GetDriveCalibration = 0x19,
+    SetDriveCalibration = 0x1A,
+    GetSpeedStats = 0x1B,
+    GetSpeedGains = 0x1C,
+    SetSpeedGains = 0x1D,
+    Stop = 0x1E,
+    GetMoveStats = 0x1F,
+    SetTraderState = 0x20,
+    GetTraderState = 0x21,
+    PublishPrimarySensorData = 0x22,
+    GetPrimarySensorData = 0x23,
+    PublishSecondarySensorData = 0x24,
+    GetSecondarySensorData = 0x25,
+    SetRPiReady = 0x28,
+    IsRPiReady = 0x29,
+    ScheduleMove = 0x30,
+    ScheduleDrive = 0x31,
+    GetScheduleStats = 0x32,
+    Remotes = 0x40,
+    RemoteConfigure = 0x41,
+    OtaBegin = 0x50,
+    OtaChunk = 0x51,
+    GetOtaStatus = 0x52,
+    OtaFinish = 0x53,
+    OtaAbort = 0x54,
+    SaveConfig = 0x80,
+    GetJobState = 0x81,
+    GetWiFiSSID = 0xA0,
+    SetWiFiSSID = 0xA1,
+    GetWiFiPwd = 0xA2,
+    SetWiFiPwd = 0xA3,
+}
+
+impl TryFrom<u8> for Command {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::Test),
+            0x01 => Ok(Self::GetState),
+            0x02 => Ok(Self::GetBattery),
+            0x03 => Ok(Self::GetPowerStats),
+            0x04 => Ok(Self::GetEStopStats),
+            0x05 => Ok(Self::SyncClock),
+            0x06 => Ok(Self::Batch),
+            0x07 => Ok(Self::GetLinkStats),
+            0x08 => Ok(Self::GetFailsafeConfig),
+            0x09 => Ok(Self::SetFailsafeConfig),
+            0x0A => Ok(Self::ProposeBaud),
+            0x0B => Ok(Self::BaudTest),
+            0x0C => Ok(Self::ConfirmBaud),
+            0x0D => Ok(Self::GetBaudStats),
+            0x10 => Ok(Self::Move),
+            0x11 => Ok(Self::SetMoveMode),
+            0x12 => Ok(Self::GetMoveMode),
+            0x13 => Ok(Self::GetMoveConfig),
+            0x14 => Ok(Self::SetMoveConfig),
+            0x15 => Ok(Self::GetMovement),
+            0x16 => Ok(Self::MoveServo),
+            0x17 => Ok(Self::GetServo),
+            0x18 => Ok(Self::Drive),
+            0x19 => Ok(Self::GetDriveCalibration),
+            0x1A => Ok(Self::SetDriveCalibration),
+            0x1B => Ok(Self::GetSpeedStats),
+            0x1C => Ok(Self::GetSpeedGains),
+            0x1D => Ok(Self::SetSpeedGains),
+            0x1E => Ok(Self::Stop),
+            0x1F => Ok(Self::GetMoveStats),
+            0x20 => Ok(Self::SetTraderState),
+            0x21 => Ok(Self::GetTraderState),
+            0x22 => Ok(Self::PublishPrimarySensorData),
+            0x23 => Ok(Self::GetPrimarySensorData),
+            0x24 => Ok(Self::PublishSecondarySensorData),
+            0x25 => Ok(Self::GetSecondarySensorData),
+            0x28 => Ok(Self::SetRPiReady),
+            0x29 => Ok(Self::IsRPiReady),
+            0x30 => Ok(Self::ScheduleMove),
+            0x31 => Ok(Self::ScheduleDrive),
+            0x32 => Ok(Self::GetScheduleStats),
+            0x40 => Ok(Self::Remotes),
+            0x41 => Ok(Self::RemoteConfigure),
+            0x50 => Ok(Self::OtaBegin),
+            0x51 => Ok(Self::OtaChunk),
+            0x52 => Ok(Self::GetOtaStatus),
+            0x53 => Ok(Self::OtaFinish),
+            0x54 => Ok(Self::OtaAbort),
+            0x80 => Ok(Self::SaveConfig),
+            0x81 => Ok(Self::GetJobState),
+            0xA0 => Ok(Self::GetWiFiSSID),
+            0xA1 => Ok(Self::SetWiFiSSID),
+            0xA2 => Ok(Self::GetWiFiPwd),
+            0xA3 => Ok(Self::SetWiFiPwd),
+            _ => Err(value)
+        }
+    }
+}
+
+/// The status of the core MCU
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum CoreState {
+    NONE = 0x00,
+    SETUP = 0x10,
+    STANDBY = 0x11,
+    ACTIVE = 0x20,
+    DRIVING = 0x21,
+    ERROR = 0xF0,
+}
+
+impl TryFrom<u8> for CoreState {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::NONE),
+            0x10 => Ok(Self::SETUP),
+            0x11 => Ok(Self::STANDBY),
+            0x20 => Ok(Self::ACTIVE),
+            0x21 => Ok(Self::DRIVING),
+            0xF0 => Ok(Self::ERROR),
+            _ => Err(value)
+        }
+    }
+}
+
+/// The remotes of the robot, a set of flags
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Default)]
+pub struct Remote(pub u8);
+
+impl Remote {
+    pub const NONE : Self = Self(0x00);
+    pub const BLUETOOTH : Self = Self(0x01);
+    pub const LORA : Self = Self(0x02);
+    pub const USB : Self = Self(0x04);
+    pub const TRADER : Self = Self(0x08);
+    pub const RPI : Self = Self(0x10);
+    pub const WIFI_TCP : Self = Self(0x20);
+    pub const WIFI_MQTT : Self = Self(0x40);
+    pub const ANY_WIFI : Self = Self(0x60);
+    pub const MOD : Self = Self(0x80);
+
+    /// Whether all flags of `other` are set
+    pub fn contains(self, other : Self) -> bool {
+        (self.0 & other.0) == other.0
+    }
+}
+
+/// Rotation direction of a chain, `CW` means forward
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum Direction {
+    CCW = 0x00,
+    CW = 0x01,
+}
+
+impl TryFrom<u8> for Direction {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::CCW),
+            0x01 => Ok(Self::CW),
+            _ => Err(value)
+        }
+    }
+}
+
+/// The servos of the robot
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum Servo {
+    HEAD = 0x00,
+}
+
+impl TryFrom<u8> for Servo {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::HEAD),
+            _ => Err(value)
+        }
+    }
+}
+
+/// State of a background job of the core
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum JobState {
+    UNKNOWN = 0x00,
+    QUEUED = 0x01,
+    RUNNING = 0x02,
+    DONE = 0x03,
+    FAILED = 0x04,
+    REJECTED = 0x05,
+}
+
+impl TryFrom<u8> for JobState {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::UNKNOWN),
+            0x01 => Ok(Self::QUEUED),
+            0x02 => Ok(Self::RUNNING),
+            0x03 => Ok(Self::DONE),
+            0x04 => Ok(Self::FAILED),
+            0x05 => Ok(Self::REJECTED),
+            _ => Err(value)
+        }
+    }
+}
+
+/// State of a firmware update of the core
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum OtaState {
+    IDLE = 0x00,
+    ERASING = 0x01,
+    RECEIVING = 0x02,
+    VERIFYING = 0x03,
+    READY = 0x04,
+    FAILED = 0x80,
+}
+
+impl TryFrom<u8> for OtaState {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::IDLE),
+            0x01 => Ok(Self::ERASING),
+            0x02 => Ok(Self::RECEIVING),
+            0x03 => Ok(Self::VERIFYING),
+            0x04 => Ok(Self::READY),
+            0x80 => Ok(Self::FAILED),
+            _ => Err(value)
+        }
+    }
+}
+
+/// The status of the trader MCU
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum TraderState {
+    DISCONNECTED = 0x00,
+    SETUP = 0x10,
+    CONNECTING = 0x11,
+    ACTIVE = 0x20,
+    ERROR = 0x80,
+}
+
+impl TryFrom<u8> for TraderState {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::DISCONNECTED),
+            0x10 => Ok(Self::SETUP),
+            0x11 => Ok(Self::CONNECTING),
+            0x20 => Ok(Self::ACTIVE),
+            0x80 => Ok(Self::ERROR),
+            _ => Err(value)
+        }
+    }
+}
+
+/// Result of the last measurement of a sensor
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types, clippy::upper_case_acronyms)]
+pub enum SensorStatus {
+    NONE = 0x00,
+    OK = 0x01,
+    TIMEOUT = 0x10,
+    CHECKSUM_ERROR = 0x11,
+}
+
+impl TryFrom<u8> for SensorStatus {
+    type Error = u8;
+
+    fn try_from(value : u8) -> Result<Self, u8> {
+        match value {
+            0x00 => Ok(Self::NONE),
+            0x01 => Ok(Self::OK),
+            0x10 => Ok(Self::TIMEOUT),
+            0x11 => Ok(Self::CHECKSUM_ERROR),
+            _ => Err(value)
+        }
+    }
+}
+
+/// Answer to a command that has been deferred to a background job (read only view)
+#[derive(Clone, Copy)]
+pub struct JobTicketView<'a>(&'a [u8]);
+
+impl<'a> JobTicketView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 2;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// ID to query the state with, never `0`
+    pub fn id(&self) -> u8 {
+        self.0[0] as u8
+    }
+
+    /// Unknown values are returned as the error
+    pub fn state(&self) -> Result<JobState, u8> {
+        JobState::try_from(self.0[1])
+    }
+}
+
+/// Answer to a command that has been deferred to a background job (in place encoder)
+pub struct JobTicketBuilder<'a>(&'a mut [u8]);
+
+impl<'a> JobTicketBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 2;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// ID to query the state with, never `0`
+    pub fn id(&mut self, value : u8) -> &mut Self {
+        self.0[0 .. 1].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn state(&mut self, value : JobState) -> &mut Self {
+        self.0[1] = value as u8;
+        self
+    }
+}
+
+/// A movement with all the information how to adjust the PWM signals (read only view)
+#[derive(Clone, Copy)]
+pub struct MovementView<'a>(&'a [u8]);
+
+impl<'a> MovementView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn chain_left_dir(&self) -> Direction {
+        if self.0[0] != 0 { Direction::CW } else { Direction::CCW }
+    }
+
+    pub fn chain_right_dir(&self) -> Direction {
+        if self.0[1] != 0 { Direction::CW } else { Direction::CCW }
+    }
+
+    /// `0` means fully off while `0xFF` means fully on
+    pub fn chain_left_duty(&self) -> u8 {
+        self.0[2] as u8
+    }
+
+    /// `0` means fully off while `0xFF` means fully on
+    pub fn chain_right_duty(&self) -> u8 {
+        self.0[3] as u8
+    }
+}
+
+/// A movement with all the information how to adjust the PWM signals (in place encoder)
+pub struct MovementBuilder<'a>(&'a mut [u8]);
+
+impl<'a> MovementBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn chain_left_dir(&mut self, value : Direction) -> &mut Self {
+        self.0[0] = value as u8;
+        self
+    }
+
+    pub fn chain_right_dir(&mut self, value : Direction) -> &mut Self {
+        self.0[1] = value as u8;
+        self
+    }
+
+    /// `0` means fully off while `0xFF` means fully on
+    pub fn chain_left_duty(&mut self, value : u8) -> &mut Self {
+        self.0[2 .. 3].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// `0` means fully off while `0xFF` means fully on
+    pub fn chain_right_duty(&mut self, value : u8) -> &mut Self {
+        self.0[3 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Optional header in front of the arguments of `Move` and `Drive` (read only view)
+#[derive(Clone, Copy)]
+pub struct MoveStampView<'a>(&'a [u8]);
+
+impl<'a> MoveStampView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Send time in milliseconds of the client clock
+    pub fn stamp(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    /// Sequence number, incremented for every movement
+    pub fn seq(&self) -> u16 {
+        u16::from_le_bytes([ self.0[4], self.0[5] ])
+    }
+}
+
+/// Optional header in front of the arguments of `Move` and `Drive` (in place encoder)
+pub struct MoveStampBuilder<'a>(&'a mut [u8]);
+
+impl<'a> MoveStampBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Send time in milliseconds of the client clock
+    pub fn stamp(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Sequence number, incremented for every movement
+    pub fn seq(&mut self, value : u16) -> &mut Self {
+        self.0[4 .. 6].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[6 .. 8].fill(0);
+        self
+    }
+}
+
+/// Statistics of the movement mailbox of the core (read only view)
+#[derive(Clone, Copy)]
+pub struct MoveStatsView<'a>(&'a [u8]);
+
+impl<'a> MoveStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn accepted(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn superseded(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    pub fn out_of_order(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+
+    pub fn expired(&self) -> u32 {
+        u32::from_le_bytes([ self.0[12], self.0[13], self.0[14], self.0[15] ])
+    }
+
+    pub fn last_seq(&self) -> u16 {
+        u16::from_le_bytes([ self.0[16], self.0[17] ])
+    }
+
+    /// Age of the last stamped movement in milliseconds
+    pub fn last_age(&self) -> u16 {
+        u16::from_le_bytes([ self.0[18], self.0[19] ])
+    }
+}
+
+/// Statistics of the movement mailbox of the core (in place encoder)
+pub struct MoveStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> MoveStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn accepted(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn superseded(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn out_of_order(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn expired(&mut self, value : u32) -> &mut Self {
+        self.0[12 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn last_seq(&mut self, value : u16) -> &mut Self {
+        self.0[16 .. 18].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Age of the last stamped movement in milliseconds
+    pub fn last_age(&mut self, value : u16) -> &mut Self {
+        self.0[18 .. 20].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Link statistics of a remote, gathered from the movements it sends (read only view)
+#[derive(Clone, Copy)]
+pub struct LinkStatsView<'a>(&'a [u8]);
+
+impl<'a> LinkStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn received(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    /// Movements missing in the sequence of the stamped ones
+    pub fn lost(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    /// Last round trip reported by the client in microseconds
+    pub fn rtt(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+
+    /// Average time between two movements in milliseconds
+    pub fn interval(&self) -> u16 {
+        u16::from_le_bytes([ self.0[12], self.0[13] ])
+    }
+
+    /// Average deviation from the interval in milliseconds
+    pub fn jitter(&self) -> u16 {
+        u16::from_le_bytes([ self.0[14], self.0[15] ])
+    }
+
+    /// Current failsafe window in milliseconds
+    pub fn window(&self) -> u16 {
+        u16::from_le_bytes([ self.0[16], self.0[17] ])
+    }
+}
+
+/// Link statistics of a remote, gathered from the movements it sends (in place encoder)
+pub struct LinkStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> LinkStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn received(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Movements missing in the sequence of the stamped ones
+    pub fn lost(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Last round trip reported by the client in microseconds
+    pub fn rtt(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Average time between two movements in milliseconds
+    pub fn interval(&mut self, value : u16) -> &mut Self {
+        self.0[12 .. 14].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Average deviation from the interval in milliseconds
+    pub fn jitter(&mut self, value : u16) -> &mut Self {
+        self.0[14 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Current failsafe window in milliseconds
+    pub fn window(&mut self, value : u16) -> &mut Self {
+        self.0[16 .. 18].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[18 .. 20].fill(0);
+        self
+    }
+}
+
+/// Bounds of the adaptive movement failsafe (read only view)
+#[derive(Clone, Copy)]
+pub struct FailsafeConfigView<'a>(&'a [u8]);
+
+impl<'a> FailsafeConfigView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// In milliseconds
+    pub fn min_window(&self) -> u16 {
+        u16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// In milliseconds
+    pub fn max_window(&self) -> u16 {
+        u16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+
+    pub fn jitter_factor(&self) -> u8 {
+        self.0[4] as u8
+    }
+
+    pub fn adaptive(&self) -> u8 {
+        self.0[5] as u8
+    }
+}
+
+/// Bounds of the adaptive movement failsafe (in place encoder)
+pub struct FailsafeConfigBuilder<'a>(&'a mut [u8]);
+
+impl<'a> FailsafeConfigBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// In milliseconds
+    pub fn min_window(&mut self, value : u16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In milliseconds
+    pub fn max_window(&mut self, value : u16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn jitter_factor(&mut self, value : u8) -> &mut Self {
+        self.0[4 .. 5].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn adaptive(&mut self, value : u8) -> &mut Self {
+        self.0[5 .. 6].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[6 .. 8].fill(0);
+        self
+    }
+}
+
+/// A velocity of the whole robot, converted into a `Movement` by the core (read only view)
+#[derive(Clone, Copy)]
+pub struct VelocityView<'a>(&'a [u8]);
+
+impl<'a> VelocityView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Forward speed in mm/s
+    pub fn linear(&self) -> i16 {
+        i16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// Rotation speed in mrad/s, positive turns left
+    pub fn angular(&self) -> i16 {
+        i16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+}
+
+/// A velocity of the whole robot, converted into a `Movement` by the core (in place encoder)
+pub struct VelocityBuilder<'a>(&'a mut [u8]);
+
+impl<'a> VelocityBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Forward speed in mm/s
+    pub fn linear(&mut self, value : i16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Rotation speed in mrad/s, positive turns left
+    pub fn angular(&mut self, value : i16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// A movement to be applied at a given time (read only view)
+#[derive(Clone, Copy)]
+pub struct ScheduledMoveView<'a>(&'a [u8]);
+
+impl<'a> ScheduledMoveView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Time in microseconds of the core clock
+    pub fn at(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn r#move(&self) -> MovementView<'a> {
+        MovementView(&self.0[4 .. 8])
+    }
+}
+
+/// A movement to be applied at a given time (in place encoder)
+pub struct ScheduledMoveBuilder<'a>(&'a mut [u8]);
+
+impl<'a> ScheduledMoveBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Time in microseconds of the core clock
+    pub fn at(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn r#move(&mut self) -> MovementBuilder<'_> {
+        MovementBuilder(&mut self.0[4 .. 8])
+    }
+}
+
+/// A velocity to drive with from a given time on (read only view)
+#[derive(Clone, Copy)]
+pub struct ScheduledVelocityView<'a>(&'a [u8]);
+
+impl<'a> ScheduledVelocityView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Time in microseconds of the core clock
+    pub fn at(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn vel(&self) -> VelocityView<'a> {
+        VelocityView(&self.0[4 .. 8])
+    }
+}
+
+/// A velocity to drive with from a given time on (in place encoder)
+pub struct ScheduledVelocityBuilder<'a>(&'a mut [u8]);
+
+impl<'a> ScheduledVelocityBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Time in microseconds of the core clock
+    pub fn at(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn vel(&mut self) -> VelocityBuilder<'_> {
+        VelocityBuilder(&mut self.0[4 .. 8])
+    }
+}
+
+/// Statistics of the scheduled movements of the core (read only view)
+#[derive(Clone, Copy)]
+pub struct ScheduleStatsView<'a>(&'a [u8]);
+
+impl<'a> ScheduleStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn scheduled(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn executed(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    pub fn rejected(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+
+    /// In microseconds
+    pub fn lateness_avg(&self) -> u16 {
+        u16::from_le_bytes([ self.0[12], self.0[13] ])
+    }
+
+    /// In microseconds
+    pub fn lateness_max(&self) -> u16 {
+        u16::from_le_bytes([ self.0[14], self.0[15] ])
+    }
+
+    pub fn pending(&self) -> u8 {
+        self.0[16] as u8
+    }
+}
+
+/// Statistics of the scheduled movements of the core (in place encoder)
+pub struct ScheduleStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> ScheduleStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn scheduled(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn executed(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn rejected(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn lateness_avg(&mut self, value : u16) -> &mut Self {
+        self.0[12 .. 14].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn lateness_max(&mut self, value : u16) -> &mut Self {
+        self.0[14 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn pending(&mut self, value : u8) -> &mut Self {
+        self.0[16 .. 17].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[17 .. 20].fill(0);
+        self
+    }
+}
+
+/// Calibration of the velocity drive mode (read only view)
+#[derive(Clone, Copy)]
+pub struct DriveCalibrationView<'a>(&'a [u8]);
+
+impl<'a> DriveCalibrationView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 38;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Speed of the chains at full duty in mm/s
+    pub fn max_speed(&self) -> u16 {
+        u16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// Distance between the chains in mm
+    pub fn track_width(&self) -> u16 {
+        u16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+
+    /// Duty linearization table of the left chain
+    pub fn left(&self) -> &'a [u8] {
+        &self.0[4 .. 21]
+    }
+
+    /// Duty linearization table of the right chain
+    pub fn right(&self) -> &'a [u8] {
+        &self.0[21 .. 38]
+    }
+}
+
+/// Calibration of the velocity drive mode (in place encoder)
+pub struct DriveCalibrationBuilder<'a>(&'a mut [u8]);
+
+impl<'a> DriveCalibrationBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 38;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Speed of the chains at full duty in mm/s
+    pub fn max_speed(&mut self, value : u16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Distance between the chains in mm
+    pub fn track_width(&mut self, value : u16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Duty linearization table of the left chain
+    pub fn left(&mut self, values : &[u8; 17]) -> &mut Self {
+        self.0[4 .. 21].copy_from_slice(values);
+        self
+    }
+
+    /// Duty linearization table of the right chain
+    pub fn right(&mut self, values : &[u8; 17]) -> &mut Self {
+        self.0[21 .. 38].copy_from_slice(values);
+        self
+    }
+}
+
+/// Gains of the chain speed controllers with 8 fractional bits (read only view)
+#[derive(Clone, Copy)]
+pub struct SpeedGainsView<'a>(&'a [u8]);
+
+impl<'a> SpeedGainsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn kp(&self) -> u16 {
+        u16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    pub fn ki(&self) -> u16 {
+        u16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+
+    pub fn kd(&self) -> u16 {
+        u16::from_le_bytes([ self.0[4], self.0[5] ])
+    }
+
+    pub fn enabled(&self) -> u8 {
+        self.0[6] as u8
+    }
+}
+
+/// Gains of the chain speed controllers with 8 fractional bits (in place encoder)
+pub struct SpeedGainsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> SpeedGainsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn kp(&mut self, value : u16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn ki(&mut self, value : u16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn kd(&mut self, value : u16) -> &mut Self {
+        self.0[4 .. 6].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn enabled(&mut self, value : u8) -> &mut Self {
+        self.0[6 .. 7].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[7 .. 8].fill(0);
+        self
+    }
+}
+
+/// State and statistics of the closed-loop chain speed control (read only view)
+#[derive(Clone, Copy)]
+pub struct SpeedStatsView<'a>(&'a [u8]);
+
+impl<'a> SpeedStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 24;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn ticks(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn jitter_avg(&self) -> u16 {
+        u16::from_le_bytes([ self.0[4], self.0[5] ])
+    }
+
+    pub fn jitter_max(&self) -> u16 {
+        u16::from_le_bytes([ self.0[6], self.0[7] ])
+    }
+
+    pub fn target_left(&self) -> i16 {
+        i16::from_le_bytes([ self.0[8], self.0[9] ])
+    }
+
+    pub fn target_right(&self) -> i16 {
+        i16::from_le_bytes([ self.0[10], self.0[11] ])
+    }
+
+    pub fn speed_left(&self) -> i16 {
+        i16::from_le_bytes([ self.0[12], self.0[13] ])
+    }
+
+    pub fn speed_right(&self) -> i16 {
+        i16::from_le_bytes([ self.0[14], self.0[15] ])
+    }
+
+    pub fn error_left(&self) -> u16 {
+        u16::from_le_bytes([ self.0[16], self.0[17] ])
+    }
+
+    pub fn error_right(&self) -> u16 {
+        u16::from_le_bytes([ self.0[18], self.0[19] ])
+    }
+
+    pub fn active(&self) -> u8 {
+        self.0[20] as u8
+    }
+
+    pub fn saturated(&self) -> u8 {
+        self.0[21] as u8
+    }
+}
+
+/// State and statistics of the closed-loop chain speed control (in place encoder)
+pub struct SpeedStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> SpeedStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 24;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn ticks(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn jitter_avg(&mut self, value : u16) -> &mut Self {
+        self.0[4 .. 6].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn jitter_max(&mut self, value : u16) -> &mut Self {
+        self.0[6 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn target_left(&mut self, value : i16) -> &mut Self {
+        self.0[8 .. 10].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn target_right(&mut self, value : i16) -> &mut Self {
+        self.0[10 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn speed_left(&mut self, value : i16) -> &mut Self {
+        self.0[12 .. 14].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn speed_right(&mut self, value : i16) -> &mut Self {
+        self.0[14 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn error_left(&mut self, value : u16) -> &mut Self {
+        self.0[16 .. 18].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn error_right(&mut self, value : u16) -> &mut Self {
+        self.0[18 .. 20].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn active(&mut self, value : u8) -> &mut Self {
+        self.0[20 .. 21].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn saturated(&mut self, value : u8) -> &mut Self {
+        self.0[21 .. 22].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[22 .. 24].fill(0);
+        self
+    }
+}
+
+/// Answer of the core to `SyncClock`, all times in microseconds (read only view)
+#[derive(Clone, Copy)]
+pub struct ClockSampleView<'a>(&'a [u8]);
+
+impl<'a> ClockSampleView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 12;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn client_send(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn core_receive(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    pub fn core_send(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+}
+
+/// Answer of the core to `SyncClock`, all times in microseconds (in place encoder)
+pub struct ClockSampleBuilder<'a>(&'a mut [u8]);
+
+impl<'a> ClockSampleBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 12;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn client_send(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn core_receive(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn core_send(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// The firmware image of an update (read only view)
+#[derive(Clone, Copy)]
+pub struct OtaImageView<'a>(&'a [u8]);
+
+impl<'a> OtaImageView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// In bytes
+    pub fn size(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    /// CRC-32 of the whole image
+    pub fn crc(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+}
+
+/// The firmware image of an update (in place encoder)
+pub struct OtaImageBuilder<'a>(&'a mut [u8]);
+
+impl<'a> OtaImageBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// In bytes
+    pub fn size(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// CRC-32 of the whole image
+    pub fn crc(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Progress of the firmware update of the core (read only view)
+#[derive(Clone, Copy)]
+pub struct OtaStatusView<'a>(&'a [u8]);
+
+impl<'a> OtaStatusView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 24;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Size of the image in bytes
+    pub fn size(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    /// CRC-32 of the image
+    pub fn crc(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    /// Bytes written to the flash
+    pub fn written(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+
+    /// Bit `i` set if chunk `next + i` has not been received
+    pub fn missing(&self) -> u32 {
+        u32::from_le_bytes([ self.0[12], self.0[13], self.0[14], self.0[15] ])
+    }
+
+    /// First chunk not received yet
+    pub fn next(&self) -> u16 {
+        u16::from_le_bytes([ self.0[16], self.0[17] ])
+    }
+
+    /// Amount of chunks of the image
+    pub fn chunks(&self) -> u16 {
+        u16::from_le_bytes([ self.0[18], self.0[19] ])
+    }
+
+    /// Chunks dropped (broken CRC, write queue full)
+    pub fn dropped(&self) -> u16 {
+        u16::from_le_bytes([ self.0[20], self.0[21] ])
+    }
+
+    /// Unknown values are returned as the error
+    pub fn state(&self) -> Result<OtaState, u8> {
+        OtaState::try_from(self.0[22])
+    }
+
+    /// Chunks the client may send before asking for the status
+    pub fn window(&self) -> u8 {
+        self.0[23] as u8
+    }
+}
+
+/// Progress of the firmware update of the core (in place encoder)
+pub struct OtaStatusBuilder<'a>(&'a mut [u8]);
+
+impl<'a> OtaStatusBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 24;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Size of the image in bytes
+    pub fn size(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// CRC-32 of the image
+    pub fn crc(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Bytes written to the flash
+    pub fn written(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Bit `i` set if chunk `next + i` has not been received
+    pub fn missing(&mut self, value : u32) -> &mut Self {
+        self.0[12 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// First chunk not received yet
+    pub fn next(&mut self, value : u16) -> &mut Self {
+        self.0[16 .. 18].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Amount of chunks of the image
+    pub fn chunks(&mut self, value : u16) -> &mut Self {
+        self.0[18 .. 20].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Chunks dropped (broken CRC, write queue full)
+    pub fn dropped(&mut self, value : u16) -> &mut Self {
+        self.0[20 .. 22].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn state(&mut self, value : OtaState) -> &mut Self {
+        self.0[22] = value as u8;
+        self
+    }
+
+    /// Chunks the client may send before asking for the status
+    pub fn window(&mut self, value : u8) -> &mut Self {
+        self.0[23 .. 24].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Negotiated baud rate and error counters of a link between the core and another MCU (read only view)
+#[derive(Clone, Copy)]
+pub struct BaudStatsView<'a>(&'a [u8]);
+
+impl<'a> BaudStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn baud(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    /// Test frames received while probing rates
+    pub fn test_frames(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    /// Test frames received with a broken CRC
+    pub fn test_errors(&self) -> u32 {
+        u32::from_le_bytes([ self.0[8], self.0[9], self.0[10], self.0[11] ])
+    }
+
+    /// Receive errors at the current rate
+    pub fn rx_errors(&self) -> u32 {
+        u32::from_le_bytes([ self.0[12], self.0[13], self.0[14], self.0[15] ])
+    }
+
+    pub fn negotiations(&self) -> u16 {
+        u16::from_le_bytes([ self.0[16], self.0[17] ])
+    }
+
+    /// Returns to the base rate
+    pub fn fallbacks(&self) -> u16 {
+        u16::from_le_bytes([ self.0[18], self.0[19] ])
+    }
+}
+
+/// Negotiated baud rate and error counters of a link between the core and another MCU (in place encoder)
+pub struct BaudStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> BaudStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 20;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn baud(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Test frames received while probing rates
+    pub fn test_frames(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Test frames received with a broken CRC
+    pub fn test_errors(&mut self, value : u32) -> &mut Self {
+        self.0[8 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Receive errors at the current rate
+    pub fn rx_errors(&mut self, value : u32) -> &mut Self {
+        self.0[12 .. 16].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn negotiations(&mut self, value : u16) -> &mut Self {
+        self.0[16 .. 18].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Returns to the base rate
+    pub fn fallbacks(&mut self, value : u16) -> &mut Self {
+        self.0[18 .. 20].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Moves a servo to a new angle (read only view)
+#[derive(Clone, Copy)]
+pub struct ServoMoveView<'a>(&'a [u8]);
+
+impl<'a> ServoMoveView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// Target angle in 0.1 degrees
+    pub fn angle(&self) -> u16 {
+        u16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// Time to reach the target in milliseconds
+    pub fn duration(&self) -> u16 {
+        u16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+
+    /// Unknown values are returned as the error
+    pub fn servo(&self) -> Result<Servo, u8> {
+        Servo::try_from(self.0[4])
+    }
+}
+
+/// Moves a servo to a new angle (in place encoder)
+pub struct ServoMoveBuilder<'a>(&'a mut [u8]);
+
+impl<'a> ServoMoveBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// Target angle in 0.1 degrees
+    pub fn angle(&mut self, value : u16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Time to reach the target in milliseconds
+    pub fn duration(&mut self, value : u16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn servo(&mut self, value : Servo) -> &mut Self {
+        self.0[4] = value as u8;
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[5 .. 8].fill(0);
+        self
+    }
+}
+
+/// State and latency statistics of the emergency stop line (read only view)
+#[derive(Clone, Copy)]
+pub struct EStopStatsView<'a>(&'a [u8]);
+
+impl<'a> EStopStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 16;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn triggers(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn violations(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    /// In microseconds
+    pub fn latency_last(&self) -> u16 {
+        u16::from_le_bytes([ self.0[8], self.0[9] ])
+    }
+
+    /// In microseconds
+    pub fn latency_max(&self) -> u16 {
+        u16::from_le_bytes([ self.0[10], self.0[11] ])
+    }
+
+    pub fn active(&self) -> u8 {
+        self.0[12] as u8
+    }
+}
+
+/// State and latency statistics of the emergency stop line (in place encoder)
+pub struct EStopStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> EStopStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 16;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn triggers(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn violations(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn latency_last(&mut self, value : u16) -> &mut Self {
+        self.0[8 .. 10].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn latency_max(&mut self, value : u16) -> &mut Self {
+        self.0[10 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn active(&mut self, value : u8) -> &mut Self {
+        self.0[12 .. 13].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[13 .. 16].fill(0);
+        self
+    }
+}
+
+/// The state of the battery pack as measured by the core (read only view)
+#[derive(Clone, Copy)]
+pub struct BatteryStateView<'a>(&'a [u8]);
+
+impl<'a> BatteryStateView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// In millivolts
+    pub fn voltage(&self) -> u16 {
+        u16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// In percent
+    pub fn charge(&self) -> u8 {
+        self.0[2] as u8
+    }
+
+    pub fn duty_limit(&self) -> u8 {
+        self.0[3] as u8
+    }
+}
+
+/// The state of the battery pack as measured by the core (in place encoder)
+pub struct BatteryStateBuilder<'a>(&'a mut [u8]);
+
+impl<'a> BatteryStateBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 4;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// In millivolts
+    pub fn voltage(&mut self, value : u16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In percent
+    pub fn charge(&mut self, value : u8) -> &mut Self {
+        self.0[2 .. 3].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn duty_limit(&mut self, value : u8) -> &mut Self {
+        self.0[3 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+}
+
+/// Statistics of the idle power management of the core (read only view)
+#[derive(Clone, Copy)]
+pub struct PowerStatsView<'a>(&'a [u8]);
+
+impl<'a> PowerStatsView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 16;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// In milliseconds
+    pub fn sleep_time(&self) -> u32 {
+        u32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn sleeps(&self) -> u32 {
+        u32::from_le_bytes([ self.0[4], self.0[5], self.0[6], self.0[7] ])
+    }
+
+    /// In microseconds
+    pub fn wake_latency_avg(&self) -> u16 {
+        u16::from_le_bytes([ self.0[8], self.0[9] ])
+    }
+
+    /// In microseconds
+    pub fn wake_latency_max(&self) -> u16 {
+        u16::from_le_bytes([ self.0[10], self.0[11] ])
+    }
+
+    pub fn low_power(&self) -> u8 {
+        self.0[12] as u8
+    }
+}
+
+/// Statistics of the idle power management of the core (in place encoder)
+pub struct PowerStatsBuilder<'a>(&'a mut [u8]);
+
+impl<'a> PowerStatsBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 16;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// In milliseconds
+    pub fn sleep_time(&mut self, value : u32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn sleeps(&mut self, value : u32) -> &mut Self {
+        self.0[4 .. 8].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn wake_latency_avg(&mut self, value : u16) -> &mut Self {
+        self.0[8 .. 10].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In microseconds
+    pub fn wake_latency_max(&mut self, value : u16) -> &mut Self {
+        self.0[10 .. 12].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn low_power(&mut self, value : u8) -> &mut Self {
+        self.0[12 .. 13].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[13 .. 16].fill(0);
+        self
+    }
+}
+
+/// Sensor data of the trader required for operating the robot (read only view)
+#[derive(Clone, Copy)]
+pub struct PrimarySensorDataView<'a>(&'a [u8]);
+
+impl<'a> PrimarySensorDataView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    pub fn encoder_position(&self) -> i32 {
+        i32::from_le_bytes([ self.0[0], self.0[1], self.0[2], self.0[3] ])
+    }
+
+    pub fn encoder_pressed(&self) -> u8 {
+        self.0[4] as u8
+    }
+
+    pub fn obstacle(&self) -> u8 {
+        self.0[5] as u8
+    }
+}
+
+/// Sensor data of the trader required for operating the robot (in place encoder)
+pub struct PrimarySensorDataBuilder<'a>(&'a mut [u8]);
+
+impl<'a> PrimarySensorDataBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    pub fn encoder_position(&mut self, value : i32) -> &mut Self {
+        self.0[0 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn encoder_pressed(&mut self, value : u8) -> &mut Self {
+        self.0[4 .. 5].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn obstacle(&mut self, value : u8) -> &mut Self {
+        self.0[5 .. 6].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[6 .. 8].fill(0);
+        self
+    }
+}
+
+/// Less important sensor data of the trader, sampled rarely (read only view)
+#[derive(Clone, Copy)]
+pub struct SecondarySensorDataView<'a>(&'a [u8]);
+
+impl<'a> SecondarySensorDataView<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Views the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a [u8]) -> Option<Self> {
+        data.get(.. Self::SIZE).map(Self)
+    }
+
+    /// The raw bytes of the message
+    pub fn bytes(&self) -> &'a [u8] {
+        self.0
+    }
+
+    /// In 0.1 degrees celsius
+    pub fn temperature(&self) -> i16 {
+        i16::from_le_bytes([ self.0[0], self.0[1] ])
+    }
+
+    /// In 0.1 percent
+    pub fn humidity(&self) -> u16 {
+        u16::from_le_bytes([ self.0[2], self.0[3] ])
+    }
+
+    /// Unknown values are returned as the error
+    pub fn dht_status(&self) -> Result<SensorStatus, u8> {
+        SensorStatus::try_from(self.0[4])
+    }
+}
+
+/// Less important sensor data of the trader, sampled rarely (in place encoder)
+pub struct SecondarySensorDataBuilder<'a>(&'a mut [u8]);
+
+impl<'a> SecondarySensorDataBuilder<'a> {
+    /// Size of the message on the wire
+    pub const SIZE : usize = 8;
+
+    /// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short
+    pub fn new(data : &'a mut [u8]) -> Option<Self> {
+        data.get_mut(.. Self::SIZE).map(Self)
+    }
+
+    /// In 0.1 degrees celsius
+    pub fn temperature(&mut self, value : i16) -> &mut Self {
+        self.0[0 .. 2].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    /// In 0.1 percent
+    pub fn humidity(&mut self, value : u16) -> &mut Self {
+        self.0[2 .. 4].copy_from_slice(&value.to_le_bytes());
+        self
+    }
+
+    pub fn dht_status(&mut self, value : SensorStatus) -> &mut Self {
+        self.0[4] = value as u8;
+        self
+    }
+
+    /// Zeroes the padding `reserved`
+    pub fn clear_reserved(&mut self) -> &mut Self {
+        self.0[5 .. 8].fill(0);
+        self
+    }
+}
@@ -0,0 +1,168 @@
+// #######################
+// #    BUGSY - BATCH    #
+// #######################
+//
+// Batch frames, carrying multiple commands in a single transfer, shared by the core firmware, the host simulation and
+// the clients
+//
+// The core reads every transfer as one command, so a client can not simply put several commands into one packet. A
+// `Command::Batch` frame contains the commands one after another, each prefixed with its length. The core executes them
+// in order and collects their answers, which are sent back as a single frame: the total length of the answers followed by
+// the answer of every command, again prefixed with its length (`0` for commands without an answer). A teleop client gets
+// a movement plus the state and sensor data with one round trip.
+//
+// Batches can not be nested. Answers that do not fit into `BUGSY_BATCH_ANSWER_SIZE` are dropped and marked with
+// `NO_ANSWER`, as are invalid commands. A `Command::SyncClock` in a batch is answered with the time it was parsed, not
+// the time the batch was sent, so it should be sent on its own.
+
+# pragma once
+
+# include <inttypes.h>
+# include <string.h>
+
+# include "core.hpp"
+
+/* BATCH */
+/// Maximum size of a batch frame including the command byte, the core reads at most this many bytes per transfer
+# define BUGSY_BATCH_FRAME_SIZE 48
+/// Maximum size of the answer of a batch (without the leading total length) in bytes, has to be less than 255
+# define BUGSY_BATCH_ANSWER_SIZE 128
+
+namespace bugsy {
+    namespace batch {
+        /// Length marking a command without an answer because the answer did not fit or the command was invalid
+        static const uint8_t NO_ANSWER = 0xFF;
+
+        /// @brief The most urgent class of the commands in a batch (see `bugsy::command_class()`)
+        /// @param data The commands of the batch (without the `Command::Batch` byte)
+        inline CommandClass batch_class(const uint8_t* data, size_t len);
+
+        /// Iterates over the length prefixed entries of a batch or its answer
+        class Reader {
+        public:
+            Reader(const uint8_t* data, size_t len) : data(data), len(len) { }
+
+            /// @brief Moves to the next entry
+            /// @param entry Receives the start of the entry
+            /// @param entry_len Receives the length of the entry, `NO_ANSWER` for entries of an answer without data
+            /// @return `false` at the end of the batch or if it is truncated (see `truncated()`)
+            bool next(const uint8_t** entry, size_t* entry_len) {
+                if (this->pos >= this->len) {
+                    return false;
+                }
+
+                uint8_t entry_size = this->data[this->pos];
+                size_t data_size = (entry_size == NO_ANSWER) ? 0 : entry_size;
+
+                if ((this->pos + 1 + data_size) > this->len) {
+                    this->broken = true;
+                    return false;
+                }
+
+                *entry = this->data + this->pos + 1;
+                *entry_len = entry_size;
+                this->pos += 1 + data_size;
+                return true;
+            }
+
+            /// @brief Whether the last entry claimed more bytes than available
+            bool truncated() const { return this->broken; }
+
+        private:
+            const uint8_t* data;
+            size_t len;
+            size_t pos = 0;
+            bool broken = false;
+        };
+
+        /// Writes length prefixed entries into a buffer
+        class Writer {
+        public:
+            Writer(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity) { }
+
+            /// @brief Starts a new entry, reserves its length
+            void begin() {
+                this->start = this->len;
+                this->overflow = (this->len >= this->capacity);
+
+                if (!this->overflow) {
+                    this->len++;
+                }
+            }
+
+            /// @brief Appends data to the current entry
+            void append(const void* data, size_t data_len) {
+                if (this->overflow || ((this->len + data_len) > this->capacity) || ((this->len + data_len - this->start - 1) >= NO_ANSWER)) {
+                    this->overflow = true;
+                    return;
+                }
+
+                memcpy(this->buffer + this->len, data, data_len);
+                this->len += data_len;
+            }
+
+            /// @brief Drops the data of the current entry, it is marked with `NO_ANSWER`
+            void drop() {
+                this->overflow = true;
+            }
+
+            /// @brief Finishes the current entry, an overflowing one is dropped and marked with `NO_ANSWER`. If not even its
+            /// length fits, the entry is missing
+            /// @return Whether the entry has been written completely
+            bool end() {
+                if (this->start >= this->capacity) {
+                    return false;
+                }
+
+                if (this->overflow) {
+                    this->len = this->start + 1;
+                    this->buffer[this->start] = NO_ANSWER;
+                    return false;
+                }
+
+                this->buffer[this->start] = (uint8_t)(this->len - this->start - 1);
+                return true;
+            }
+
+            /// @brief Writes a complete entry
+            /// @return Whether the entry fits
+            bool add(const void* data, size_t data_len) {
+                this->begin();
+                this->append(data, data_len);
+                return this->end();
+            }
+
+            size_t size() const { return this->len; }
+
+        private:
+            uint8_t* buffer;
+            size_t capacity;
+            size_t len = 0;
+
+            /// Start of the current entry (its length)
+            size_t start = 0;
+            bool overflow = false;
+        };
+
+        inline CommandClass batch_class(const uint8_t* data, size_t len) {
+            CommandClass result = CommandClass::MAINTENANCE;
+            Reader reader(data, len);
+            const uint8_t* entry;
+            size_t entry_len;
+
+            while (reader.next(&entry, &entry_len)) {
+                if ((entry_len == 0) || (entry_len == NO_ANSWER)) {
+                    continue;
+                }
+
+                CommandClass entry_class = command_class((Command)entry[0]);
+
+                if ((uint8_t)entry_class < (uint8_t)result) {
+                    result = entry_class;
+                }
+            }
+
+            return result;
+        }
+    }
+}
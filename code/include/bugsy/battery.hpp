@@ -0,0 +1,89 @@
+// #########################
+// #    BUGSY - BATTERY    #
+// #########################
+//
+// Model of the battery pack, shared by the core firmware and the host simulation so both derive the same state of
+// charge and duty limit from a measured voltage
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+
+/* PACK */
+/// Amount of LiPo cells in series
+# define BUGSY_BATTERY_CELLS 2
+/// Cell voltage in millivolts below which the pack counts as empty
+# define BUGSY_BATTERY_CELL_CUTOFF 3300
+/// Loaded cell voltage in millivolts below which the maximum duty starts to be reduced
+# define BUGSY_BATTERY_CELL_GOVERN 3600
+/// Voltage drop of a cell in millivolts with both chains driven at full duty, used to compensate the state of charge
+# define BUGSY_BATTERY_CELL_SAG 150
+/// Duty limit applied at (and below) the cutoff voltage
+# define BUGSY_BATTERY_MIN_DUTY_LIMIT 96
+
+namespace bugsy {
+    namespace battery {
+        /// Resting cell voltage in millivolts at 0%, 10%, ..., 100% charge
+        static const uint16_t CELL_CHARGE_CURVE [11] = {
+            3300, 3690, 3730, 3770, 3800, 3840, 3870, 3950, 4020, 4110, 4200
+        };
+
+        /// @brief Voltage drop of the pack in millivolts for the given sum of both chain duties (`0` - `510`)
+        inline uint16_t sag(uint16_t duty_sum) {
+            return (uint16_t)(((uint32_t)BUGSY_BATTERY_CELL_SAG * BUGSY_BATTERY_CELLS * duty_sum) / 510);
+        }
+
+        /// @brief Estimated state of charge in percent for the given resting pack voltage in millivolts
+        inline uint8_t charge(uint16_t voltage) {
+            uint16_t cell = voltage / BUGSY_BATTERY_CELLS;
+
+            if (cell <= CELL_CHARGE_CURVE[0]) {
+                return 0;
+            }
+
+            for (uint8_t i = 1; i < 11; i++) {
+                if (cell < CELL_CHARGE_CURVE[i]) {
+                    // Linear interpolation within the 10% step
+                    return (uint8_t)(((i - 1) * 10) + ((uint32_t)(cell - CELL_CHARGE_CURVE[i - 1]) * 10) / (CELL_CHARGE_CURVE[i] - CELL_CHARGE_CURVE[i - 1]));
+                }
+            }
+
+            return 100;
+        }
+
+        /// @brief The maximum duty for the given pack voltage under load in millivolts
+        ///
+        /// Unlimited above `BUGSY_BATTERY_CELL_GOVERN`, then reduced linearly down to `BUGSY_BATTERY_MIN_DUTY_LIMIT` at
+        /// the cutoff voltage, so the current draw drops before the pack browns out the electronics
+        inline uint8_t duty_limit(uint16_t voltage) {
+            uint16_t cell = voltage / BUGSY_BATTERY_CELLS;
+
+            if (cell >= BUGSY_BATTERY_CELL_GOVERN) {
+                return 0xFF;
+            }
+
+            if (cell <= BUGSY_BATTERY_CELL_CUTOFF) {
+                return BUGSY_BATTERY_MIN_DUTY_LIMIT;
+            }
+
+            return (uint8_t)(BUGSY_BATTERY_MIN_DUTY_LIMIT + ((uint32_t)(0xFF - BUGSY_BATTERY_MIN_DUTY_LIMIT) * (cell - BUGSY_BATTERY_CELL_CUTOFF))
+                / (BUGSY_BATTERY_CELL_GOVERN - BUGSY_BATTERY_CELL_CUTOFF));
+        }
+
+        /// @brief Derives the full battery state from the measured (loaded) pack voltage and the duty currently applied
+        inline BatteryState state(uint16_t voltage, uint16_t duty_sum) {
+            BatteryState state;
+            state.voltage = voltage;
+            state.charge = charge(voltage + sag(duty_sum));
+            state.duty_limit = duty_limit(voltage);
+            return state;
+        }
+
+        /// @brief Scales a duty by the given limit
+        inline uint8_t limit_duty(uint8_t duty, uint8_t limit) {
+            return (uint8_t)(((uint16_t)duty * limit) / 0xFF);
+        }
+    }
+}
@@ -0,0 +1,290 @@
+// ######################
+// #    BUGSY - BAUD    #
+// ######################
+//
+// Baud rate negotiation of the UART links between the core and the other MCUs (trader, RPi), shared by the core
+// firmware, the host simulation and the clients
+//
+// Every link starts at its base rate (`BUGSY_UART_CORE_TO_*_BAUD`). The client steps up the ladder of `RATES`: It
+// proposes the next rate (`Command::ProposeBaud`), both ends switch once the core answered, and `BUGSY_BAUD_TEST_FRAMES`
+// CRC-checked test frames are exchanged at the new rate (`Command::BaudTest`). If all of them come back intact the client
+// confirms the rate (`Command::ConfirmBaud`) and tries the next one, otherwise it returns to the previous rate, as does
+// the core once the confirmation does not arrive in time. The link ends up at the fastest rate its wiring supports.
+//
+// A link running at a negotiated rate falls back to the base rate on an error burst, `BUGSY_BAUD_ERROR_BURST` receive
+// errors within `BUGSY_BAUD_ERROR_WINDOW`. The other end notices by its requests timing out and falls back as well, the
+// client negotiates again after it reconnected.
+
+# pragma once
+
+# include <inttypes.h>
+# include <string.h>
+
+# include "core.hpp"
+# include "crc.hpp"
+# include "messages.hpp"
+
+/* BAUD */
+/// Test frames that have to be exchanged intact before a proposed rate is confirmed
+# define BUGSY_BAUD_TEST_FRAMES 16
+/// Size of a test frame in bytes, including the CRC
+# define BUGSY_BAUD_TEST_SIZE 32
+/// Time in milliseconds the client waits after the answer to a proposal until it uses the new rate, the core switches
+/// once the answer has left its UART
+# define BUGSY_BAUD_SWITCH_DELAY 5
+/// Time in milliseconds the core waits for the confirmation of a proposed rate until it returns to the previous one
+# define BUGSY_BAUD_CONFIRM_TIMEOUT 250
+/// Amount of receive errors within `BUGSY_BAUD_ERROR_WINDOW` making a link fall back to its base rate
+# define BUGSY_BAUD_ERROR_BURST 8
+/// Time window in milliseconds the errors of a burst have to occur in
+# define BUGSY_BAUD_ERROR_WINDOW 1000
+
+namespace bugsy {
+    namespace baud {
+        /// The ladder of baud rates probed, all of them are exact on the 16 MHz AVR (double speed) and the 80 MHz APB
+        /// clock of the ESP32, the RPi UART reaches them with its 48 MHz clock
+        static const uint32_t RATES [] = { 250000, 500000, 1000000, 2000000 };
+        /// Amount of rates of the ladder
+        static const uint8_t RATE_COUNT = sizeof(RATES) / sizeof(RATES[0]);
+
+        /// @brief Whether `baud` is a rate of the ladder between `base` and `max`
+        inline bool supported(uint32_t baud, uint32_t base, uint32_t max) {
+            for (uint8_t i = 0; i < RATE_COUNT; i++) {
+                if ((RATES[i] == baud) && (baud >= base) && (baud <= max)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /// @brief The next rate of the ladder above `baud`
+        /// @return `0` if there is none up to `max`
+        inline uint32_t next(uint32_t baud, uint32_t max) {
+            for (uint8_t i = 0; i < RATE_COUNT; i++) {
+                if (RATES[i] > baud) {
+                    return (RATES[i] <= max) ? RATES[i] : 0;
+                }
+            }
+
+            return 0;
+        }
+
+        /// Sequence number bit marking the answers of the core, so a looped back frame is never taken for an answer
+        static const uint8_t TEST_ANSWER = 0x80;
+
+        /// @brief Fills a test frame of `BUGSY_BAUD_TEST_SIZE` bytes: The sequence number, a pattern derived from it that
+        /// contains long runs of equal bits as well as alternating ones, and the CRC of both
+        inline void fill_test(uint8_t* frame, uint8_t seq) {
+            const size_t payload = BUGSY_BAUD_TEST_SIZE - sizeof(uint16_t);
+
+            frame[0] = seq;
+
+            for (size_t i = 1; i < payload; i++) {
+                switch (i & 3) {
+                    case 0: frame[i] = 0x00; break;
+                    case 1: frame[i] = 0x55; break;
+                    case 2: frame[i] = 0xFF; break;
+                    default: frame[i] = (uint8_t)((seq * 37) + (i * 73)); break;
+                }
+            }
+
+            msg::wire::put_u16(frame + payload, crc::crc16(frame, payload));
+        }
+
+        /// @brief Checks a test frame received
+        /// @param seq The sequence number the frame has to carry
+        /// @return Whether the frame has the right size, sequence number and an intact CRC
+        inline bool check_test(const uint8_t* frame, size_t len, uint8_t seq) {
+            const size_t payload = BUGSY_BAUD_TEST_SIZE - sizeof(uint16_t);
+
+            return (len == BUGSY_BAUD_TEST_SIZE) && (frame[0] == seq)
+                && (msg::wire::get_u16(frame + payload) == crc::crc16(frame, payload));
+        }
+
+        /// Detects bursts of errors, `BUGSY_BAUD_ERROR_BURST` errors within `BUGSY_BAUD_ERROR_WINDOW`
+        class Bursts {
+        public:
+            /// @brief Records an error
+            /// @param now The current time in milliseconds
+            /// @return `true` once the errors form a burst, the counting starts over afterwards
+            bool error(uint32_t now) {
+                if (!this->count || ((now - this->window_start) > BUGSY_BAUD_ERROR_WINDOW)) {
+                    this->window_start = now;
+                    this->count = 0;
+                }
+
+                if (++this->count < BUGSY_BAUD_ERROR_BURST) {
+                    return false;
+                }
+
+                this->count = 0;
+                return true;
+            }
+
+            void reset() { this->count = 0; }
+
+        private:
+            uint32_t window_start = 0;
+            uint8_t count = 0;
+        };
+
+        /// The core end of a link, decides the rate the core uses for it. The owner applies `rate()` to the UART
+        /// whenever it changed, after the answer to the command that changed it has been sent
+        class Port {
+        public:
+            Port(uint32_t base, uint32_t max) : base(base), max(max), previous(base) {
+                this->stats.baud = base;
+            }
+
+            /// @brief Handles a proposed rate (`Command::ProposeBaud`)
+            /// @param now The current time in milliseconds
+            /// @return Whether the rate is supported, `rate()` returns it from now on
+            bool propose(uint32_t baud, uint32_t now) {
+                if (!supported(baud, this->base, this->max)) {
+                    return false;
+                }
+
+                // A proposal replacing an unconfirmed one returns to the last confirmed rate on timeout
+                if (!this->pending) {
+                    this->previous = this->stats.baud;
+                }
+
+                this->stats.baud = baud;
+                this->pending = true;
+                this->deadline = now + BUGSY_BAUD_CONFIRM_TIMEOUT;
+                this->bursts.reset();
+                return true;
+            }
+
+            /// @brief Checks a test frame (`Command::BaudTest`)
+            /// @param answer Receives the answering test frame if the frame is intact (`BUGSY_BAUD_TEST_SIZE` bytes)
+            /// @return Whether the frame is intact and should be answered
+            bool test(const uint8_t* frame, size_t len, uint8_t* answer) {
+                this->stats.test_frames++;
+
+                if ((len != BUGSY_BAUD_TEST_SIZE) || !check_test(frame, len, frame[0]) || (frame[0] & TEST_ANSWER)) {
+                    this->stats.test_errors++;
+                    return false;
+                }
+
+                fill_test(answer, frame[0] | TEST_ANSWER);
+                return true;
+            }
+
+            /// @brief Keeps the proposed rate (`Command::ConfirmBaud`)
+            /// @return Whether a proposal was pending
+            bool confirm() {
+                if (!this->pending) {
+                    return false;
+                }
+
+                this->pending = false;
+                this->stats.negotiations++;
+                return true;
+            }
+
+            /// @brief Records a receive error of the link
+            /// @return Whether the error completed a burst and the port fell back to the base rate
+            bool error(uint32_t now) {
+                this->stats.rx_errors++;
+                return this->bursts.error(now) && this->fallback();
+            }
+
+            /// @brief Returns to the base rate, e.g. once the other MCU is gone
+            /// @return Whether the rate changed
+            bool fallback() {
+                this->pending = false;
+
+                if (this->stats.baud == this->base) {
+                    return false;
+                }
+
+                this->stats.baud = this->base;
+                this->stats.fallbacks++;
+                return true;
+            }
+
+            /// @brief Returns to the previous rate if a proposal has not been confirmed in time
+            /// @return Whether the rate changed
+            bool update(uint32_t now) {
+                if (!this->pending || ((int32_t)(now - this->deadline) < 0)) {
+                    return false;
+                }
+
+                this->pending = false;
+                this->stats.baud = this->previous;
+                return true;
+            }
+
+            /// @brief The rate the core has to use for the link
+            uint32_t rate() const { return this->stats.baud; }
+
+            BaudStats stats = { };
+
+        private:
+            uint32_t base;
+            uint32_t max;
+
+            /// The confirmed rate a pending proposal returns to
+            uint32_t previous;
+            bool pending = false;
+            uint32_t deadline = 0;
+
+            Bursts bursts;
+        };
+
+        /// @brief Negotiates the fastest rate of a link from the client end, starting at the rate it currently runs at
+        /// @tparam L The transport of the client, providing
+        /// - `bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len)`, sending a command and
+        ///   receiving an answer of exactly `answer_len` bytes
+        /// - `void set_baud(uint32_t baud)`, switching the local UART
+        /// - `void wait(uint32_t ms)`
+        /// @param current The rate the link currently runs at, usually the base rate
+        /// @param max The highest rate supported by the client end
+        /// @return The rate the link runs at afterwards
+        template<typename L>
+        uint32_t negotiate(L& link, uint32_t current, uint32_t max) {
+            for (uint32_t baud = next(current, max); baud; baud = next(current, max)) {
+                uint8_t request [sizeof(Command) + BUGSY_BAUD_TEST_SIZE];
+                uint8_t answer [BUGSY_BAUD_TEST_SIZE];
+
+                request[0] = (uint8_t)Command::ProposeBaud;
+                msg::wire::put_u32(request + sizeof(Command), baud);
+
+                if (!link.request(request, sizeof(Command) + sizeof(uint32_t), answer, 1) || !answer[0]) {
+                    break;
+                }
+
+                link.wait(BUGSY_BAUD_SWITCH_DELAY);
+                link.set_baud(baud);
+
+                bool intact = true;
+
+                for (uint8_t seq = 0; intact && (seq < BUGSY_BAUD_TEST_FRAMES); seq++) {
+                    request[0] = (uint8_t)Command::BaudTest;
+                    fill_test(request + sizeof(Command), seq);
+
+                    intact = link.request(request, sizeof(request), answer, BUGSY_BAUD_TEST_SIZE)
+                        && check_test(answer, BUGSY_BAUD_TEST_SIZE, seq | TEST_ANSWER);
+                }
+
+                if (intact) {
+                    request[0] = (uint8_t)Command::ConfirmBaud;
+                    intact = link.request(request, sizeof(Command), answer, 1) && answer[0];
+                }
+
+                if (!intact) {
+                    // The core returns to the previous rate on its own once the confirmation is missing
+                    link.set_baud(current);
+                    link.wait(BUGSY_BAUD_CONFIRM_TIMEOUT + BUGSY_BAUD_SWITCH_DELAY);
+                    break;
+                }
+
+                current = baud;
+            }
+
+            return current;
+        }
+    }
+}
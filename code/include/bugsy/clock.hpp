@@ -0,0 +1,254 @@
+// #######################
+// #    BUGSY - CLOCK    #
+// #######################
+//
+// Clock synchronization between clients and the core and scheduled movements, shared by the core firmware, the host
+// simulation and the clients
+//
+// A client sends `Command::SyncClock` with its send time, the core answers with the times it received the request and
+// sent the answer (NTP-style). Together with the receive time of the client every exchange yields the offset of the
+// core clock and the round trip time. The `Estimator` keeps the last samples, trusts the one with the shortest round trip
+// (least queuing, smallest error) and fits the drift between both clocks over all of them. A client then converts its
+// own time into core time and schedules movements ahead (`Command::ScheduleMove`), the core applies them when they are
+// due, no matter how long the link took to deliver them.
+//
+// All times are 32 bit microseconds, differences are taken signed, so the wrap of the clocks (~71 minutes) is handled.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+# include "mailbox.hpp"
+
+/* CLOCK */
+/// Amount of exchanges the estimator of a client keeps
+# define BUGSY_CLOCK_SAMPLES 8
+/// Maximum drift between the clocks in ppm (two crystals within 100 ppm each), larger fits are clamped
+# define BUGSY_CLOCK_MAX_DRIFT 200
+
+/* SCHEDULE */
+/// Amount of movements the core can hold scheduled at once
+# define BUGSY_SCHEDULE_SIZE 8
+/// Maximum time in microseconds a movement can be scheduled ahead
+# define BUGSY_SCHEDULE_MAX_AHEAD 5000000
+/// Maximum time in microseconds a movement can be past its time on arrival and still be applied (see `BUGSY_MOVE_MAX_AGE`)
+# define BUGSY_SCHEDULE_MAX_LATE (BUGSY_MOVE_MAX_AGE * 1000L)
+/// Strength of the IIR filter applied to the lateness average
+# define BUGSY_SCHEDULE_STATS_SHIFT 4
+
+namespace bugsy {
+    namespace clock {
+        /// Estimates the core clock from the `ClockSample`s received by a client
+        class Estimator {
+        public:
+            /// @brief Adds the result of one exchange
+            /// @param sample The answer of the core
+            /// @param received The time the client received the answer at (client clock)
+            void add(const ClockSample& sample, uint32_t received) {
+                uint32_t local_rtt = received - sample.client_send;
+                uint32_t core_time = sample.core_send - sample.core_receive;
+
+                Sample& entry = this->samples[this->next];
+                this->next = (this->next + 1) % BUGSY_CLOCK_SAMPLES;
+
+                if (this->count < BUGSY_CLOCK_SAMPLES) {
+                    this->count++;
+                }
+
+                // Both directions are assumed to take the same time, the offset is taken in the middle of the exchange
+                entry.local = sample.client_send + (local_rtt / 2);
+                entry.rtt = (local_rtt > core_time) ? (local_rtt - core_time) : 0;
+                this->last_rtt = entry.rtt;
+                entry.offset = (sample.core_receive - sample.client_send)
+                    - (uint32_t)((int32_t)((sample.core_receive - sample.client_send) - (sample.core_send - received)) / 2);
+
+                this->fit();
+            }
+
+            /// @brief Whether any exchange has been added
+            bool synced() const { return this->count > 0; }
+
+            /// @brief Converts a time of the client clock into the core clock
+            uint32_t to_core(uint32_t local) const {
+                int32_t elapsed = (int32_t)(local - this->ref_local);
+                return local + this->ref_offset + (uint32_t)(int32_t)(((int64_t)elapsed * this->drift) / 1000000);
+            }
+
+            /// @brief Round trip time of the best exchange in microseconds (the uncertainty of the offset is half of it)
+            uint32_t rtt() const { return this->best_rtt; }
+
+            /// @brief Round trip time of the last exchange in microseconds
+            uint32_t latest_rtt() const { return this->last_rtt; }
+
+            /// @brief Drift of the core clock relative to the client clock in ppm
+            int32_t drift_ppm() const { return this->drift; }
+
+        private:
+            struct Sample {
+                /// Client time of the exchange
+                uint32_t local;
+                /// Core clock minus client clock
+                uint32_t offset;
+                uint32_t rtt;
+            };
+
+            void fit() {
+                // The exchange with the shortest round trip waited the least in queues
+                const Sample* best = &this->samples[0];
+
+                for (uint8_t i = 1; i < this->count; i++) {
+                    if (this->samples[i].rtt < best->rtt) {
+                        best = &this->samples[i];
+                    }
+                }
+
+                this->ref_local = best->local;
+                this->ref_offset = best->offset;
+                this->best_rtt = best->rtt;
+
+                // Least squares fit of the offset over time, relative to the reference. The error of an offset is bounded
+                // by half the round trip, so every sample is weighted with the inverse of its squared round trip
+                double sum_w = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+
+                for (uint8_t i = 0; i < this->count; i++) {
+                    double x = (int32_t)(this->samples[i].local - best->local) / 1000000.0;
+                    double y = (int32_t)(this->samples[i].offset - best->offset);
+                    double w = 1.0 / (((double)this->samples[i].rtt + 100.0) * ((double)this->samples[i].rtt + 100.0));
+
+                    sum_w += w;
+                    sum_x += w * x;
+                    sum_y += w * y;
+                    sum_xx += w * x * x;
+                    sum_xy += w * x * y;
+                }
+
+                double denom = (sum_w * sum_xx) - (sum_x * sum_x);
+
+                // Needs samples spread over time (weighted variance of at least a second), a burst of exchanges says
+                // nothing about the drift
+                if ((this->count < 2) || (denom < (sum_w * sum_w))) {
+                    return;
+                }
+
+                // Microseconds of offset per second are ppm
+                double slope = ((sum_w * sum_xy) - (sum_x * sum_y)) / denom;
+                int32_t ppm = (int32_t)slope;
+
+                if (ppm > BUGSY_CLOCK_MAX_DRIFT) {
+                    ppm = BUGSY_CLOCK_MAX_DRIFT;
+                } else if (ppm < -BUGSY_CLOCK_MAX_DRIFT) {
+                    ppm = -BUGSY_CLOCK_MAX_DRIFT;
+                }
+
+                this->drift = ppm;
+            }
+
+            Sample samples [BUGSY_CLOCK_SAMPLES];
+            uint8_t count = 0;
+            uint8_t next = 0;
+
+            uint32_t ref_local = 0;
+            uint32_t ref_offset = 0;
+            uint32_t best_rtt = 0;
+            uint32_t last_rtt = 0;
+            int32_t drift = 0;
+        };
+
+        /// Movements scheduled on the core, ordered by their time
+        class Schedule {
+        public:
+            /// @brief Schedules a movement
+            /// @param src The remote the movement has been received from
+            /// @param at The time to apply the movement at
+            /// @param now The current time
+            /// @return Whether the movement has been accepted
+            bool add(Remote src, uint32_t at, const Movement& move, uint32_t now) {
+                int32_t ahead = (int32_t)(at - now);
+
+                if ((ahead > BUGSY_SCHEDULE_MAX_AHEAD) || (ahead < -BUGSY_SCHEDULE_MAX_LATE) || (this->count >= BUGSY_SCHEDULE_SIZE)) {
+                    this->stats.rejected++;
+                    return false;
+                }
+
+                // Insertion sort, later entries with the same time stay behind the ones already scheduled
+                uint8_t pos = this->count;
+
+                while ((pos > 0) && ((int32_t)(this->entries[pos - 1].at - at) > 0)) {
+                    this->entries[pos] = this->entries[pos - 1];
+                    pos--;
+                }
+
+                this->entries[pos] = { at, src, move };
+                this->count++;
+
+                this->stats.scheduled++;
+                this->stats.pending = this->count;
+                return true;
+            }
+
+            /// @brief Takes the next movement that is due
+            /// @return `false` if no movement is due
+            bool due(uint32_t now, Remote* src, Movement* move) {
+                if (!this->count || ((int32_t)(now - this->entries[0].at) < 0)) {
+                    return false;
+                }
+
+                uint32_t lateness = now - this->entries[0].at;
+                *src = this->entries[0].src;
+                *move = this->entries[0].move;
+
+                this->count--;
+
+                for (uint8_t i = 0; i < this->count; i++) {
+                    this->entries[i] = this->entries[i + 1];
+                }
+
+                if (lateness > UINT16_MAX) {
+                    lateness = UINT16_MAX;
+                }
+
+                this->lateness_filtered += (int32_t)((lateness << 8) - this->lateness_filtered) >> BUGSY_SCHEDULE_STATS_SHIFT;
+                this->stats.lateness_avg = (uint16_t)(this->lateness_filtered >> 8);
+
+                if (lateness > this->stats.lateness_max) {
+                    this->stats.lateness_max = (uint16_t)lateness;
+                }
+
+                this->stats.executed++;
+                this->stats.pending = this->count;
+                return true;
+            }
+
+            /// @brief The time of the next scheduled movement
+            /// @return `false` if nothing is scheduled
+            bool next(uint32_t* at) const {
+                if (!this->count) {
+                    return false;
+                }
+
+                *at = this->entries[0].at;
+                return true;
+            }
+
+            /// @brief Drops all scheduled movements (e.g. when stopping)
+            void clear() {
+                this->count = 0;
+                this->stats.pending = 0;
+            }
+
+            ScheduleStats stats = { };
+
+        private:
+            struct Entry {
+                uint32_t at;
+                Remote src;
+                Movement move;
+            };
+
+            Entry entries [BUGSY_SCHEDULE_SIZE];
+            uint8_t count = 0;
+            uint32_t lateness_filtered = 0;
+        };
+    }
+}
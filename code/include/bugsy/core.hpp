@@ -45,9 +45,54 @@ namespace bugsy {
         /// State command mainly for internal communication
         /// @return `0x00` - The current `State` (see `bugsy_core::State`)
         GetState = 0x01,
+        /// Returns the state of the battery measured by the core
+        /// @return `0x00-0x03` The current `BatteryState`
+        GetBattery = 0x02,
+        /// Returns the statistics of the idle power management
+        /// @return `0x00-0x0F` The current `PowerStats`
+        GetPowerStats = 0x03,
+        /// Returns the state and the measured latencies of the emergency stop line
+        /// @return `0x00-0x0F` The current `EStopStats`
+        GetEStopStats = 0x04,
+        /// One exchange of the clock synchronization (see `bugsy/clock.hpp`)
+        /// @param `0x00-0x03` The time the client sent the request at in microseconds of its own clock, echoed back
+        /// @param `0x04-0x07` Optionally the round trip of the previous exchange in microseconds (see `GetLinkStats`)
+        /// @return `0x00-0x0B` The `ClockSample`
+        SyncClock = 0x05,
+        /// Executes multiple commands in order and answers all of them in a single frame (see `bugsy/batch.hpp`)
+        /// @param `0x00-?` The commands, each prefixed with its length (command byte and arguments)
+        /// @return `0x00` The length of the following answers, `0x01-?` the answers, each prefixed with its length
+        Batch = 0x06,
+        /// Returns the link statistics of a remote sending movements (see `bugsy/link.hpp`)
+        /// @param `0x00` The `Remote`, a single one
+        /// @return `0x00-0x13` The `LinkStats`
+        GetLinkStats = 0x07,
+        /// Returns the bounds of the adaptive movement failsafe
+        /// @return `0x00-0x07` The current `FailsafeConfig`
+        GetFailsafeConfig = 0x08,
+        /// Sets the bounds of the adaptive movement failsafe, invalid ones are rejected (see `SaveConfig` to store them)
+        /// @param `0x00-0x07` The new `FailsafeConfig`
+        SetFailsafeConfig = 0x09,
+        /// Proposes a faster baud rate for the link the command is received on (see `bugsy/baud.hpp`), answered at the
+        /// current rate, the core switches right after. Not accepted within a batch
+        /// @param `0x00-0x03` The baud rate, one of `bugsy::baud::RATES`
+        /// @return `0x00` `1` if the core switched to the rate, `0` if it is not supported by the link
+        ProposeBaud = 0x0A,
+        /// Test frame exchanged at a proposed baud rate, answered only if its CRC is intact
+        /// @param `0x00-0x1F` The test frame (see `bugsy::baud::fill_test()`)
+        /// @return `0x00-0x1F` The answering test frame of the core
+        BaudTest = 0x0B,
+        /// Keeps the proposed baud rate, without it the core returns to the previous rate after `BUGSY_BAUD_CONFIRM_TIMEOUT`
+        /// @return `0x00` `1` if a proposed rate has been kept
+        ConfirmBaud = 0x0C,
+        /// Returns the negotiated baud rate and the error counters of a link
+        /// @param `0x00` The `Remote`, `Remote::TRADER` or `Remote::RPI`
+        /// @return `0x00-0x13` The `BaudStats`
+        GetBaudStats = 0x0D,
 
         /// Issue a new movement
         /// @param `0x00-0x03` 4 byte `Movement` struct, will be parsed and applied directly, every sequence of bytes is valid!
+        /// Alternatively a `MoveStamp` (`0x00-0x07`) followed by the `Movement` (`0x08-0x0B`), dropped if late or out of order
         Move = 0x10,
         
         /// Sets the current movement mode, changing fundamentally how the Bugsy behaves
@@ -60,6 +105,40 @@ namespace bugsy {
         GetMoveConfig = 0x13,
         /// Sets the current movement configuration
         SetMoveConfig = 0x14,
+        /// Returns the movement currently applied to the motors
+        /// @return `0x00-0x03` The current `Movement`, `MOVEMENT_NONE` if the failsafe stopped the robot
+        GetMovement = 0x15,
+        /// Moves a servo to a new angle, following a linear trajectory
+        /// @param `0x00-0x07` The `ServoMove` to perform, replaces the trajectory currently followed by the servo
+        MoveServo = 0x16,
+        /// Returns the current angle of a servo
+        /// @param `0x00` The `Servo`
+        /// @return `0x00-0x01` The angle in 0.1 degrees
+        GetServo = 0x17,
+        /// Drives with the given velocity, converted into a movement by the core (see `bugsy::drive`)
+        /// @param `0x00-0x03` The `Velocity` to drive with, held like a `Move` for the configured movement duration
+        /// Alternatively a `MoveStamp` (`0x00-0x07`) followed by the `Velocity` (`0x08-0x0B`), dropped if late or out of order
+        Drive = 0x18,
+        /// Returns the calibration of the velocity drive mode
+        /// @return `0x00-sizeof(DriveCalibration)` The current `DriveCalibration`
+        GetDriveCalibration = 0x19,
+        /// Sets the calibration of the velocity drive mode, invalid calibrations are rejected (see `SaveConfig` to store it)
+        /// @param `0x00-sizeof(DriveCalibration)` The new `DriveCalibration`
+        SetDriveCalibration = 0x1A,
+        /// Returns the state and statistics of the closed-loop chain speed control
+        /// @return `0x00-sizeof(SpeedStats)` The current `SpeedStats`
+        GetSpeedStats = 0x1B,
+        /// Returns the gains of the chain speed controllers
+        /// @return `0x00-0x07` The current `SpeedGains`
+        GetSpeedGains = 0x1C,
+        /// Sets the gains of the chain speed controllers, `enabled` switches between closed and open loop
+        /// @param `0x00-0x07` The new `SpeedGains` (see `SaveConfig` to store them)
+        SetSpeedGains = 0x1D,
+        /// Stops all movements immediately
+        Stop = 0x1E,
+        /// Returns the statistics of the movement mailbox
+        /// @return `0x00-0x13` The `MoveStats`
+        GetMoveStats = 0x1F,
 
 
         /// Internal command to set the stored state of the trader that will be communicated to external devices  
@@ -78,7 +157,10 @@ namespace bugsy {
         /// @return `bugsy_trader::PrimarySensorData`
         GetPrimarySensorData = 0x23,
         /// Internal command for publishing less important (secondary) sensor data to the core MCU
+        /// @param `0x00-sizeof(bugsy_trader::SecondarySensorData)` the data to store
         PublishSecondarySensorData = 0x24,
+        /// Returns the secondary sensor data stored in the core
+        /// @return `bugsy_trader::SecondarySensorData`
         GetSecondarySensorData = 0x25,
 
         /// Internal command to signal that the RPi is ready
@@ -86,31 +168,127 @@ namespace bugsy {
         /// Get whether the raspberry pi is ready or not
         IsRPiReady = 0x29,
 
+        /// Schedules a movement to be applied at the given time of the core clock (see `bugsy/clock.hpp`)
+        /// @param `0x00-0x07` The `ScheduledMove`
+        ScheduleMove = 0x30,
+        /// Schedules a velocity to drive with at the given time of the core clock, like `ScheduleMove`
+        /// @param `0x00-0x07` The `ScheduledVelocity`
+        ScheduleDrive = 0x31,
+        /// Returns the statistics of the scheduled movements
+        /// @return `0x00-0x13` The `ScheduleStats`
+        GetScheduleStats = 0x32,
+
         /// Returns the current remote configuration
         /// @return `0x00` - The current remote mode
         Remotes = 0x40,
-        /// Reconfigures the remote settings made
+        /// Reconfigures the remote settings made, runs as a background job
         /// @param 0x00 The new `Remotes`
+        /// @return `0x00-0x01` The `JobTicket` of the job
         RemoteConfigure = 0x41,
 
-        /// Safe the configuration to the EEPROM
+        /// Starts a firmware update or resumes the one of the same image (see `bugsy/ota.hpp`)
+        /// @param `0x00-0x07` The `OtaImage`
+        /// @return `0x00-0x17` The `OtaStatus`, `OtaState::ERASING` until the partition is ready for the chunks
+        OtaBegin = 0x50,
+        /// A chunk of the image, not answered (see `GetOtaStatus`). Read with its fixed length, so chunks can be sent back
+        /// to back
+        /// @param `0x00-0x01` The index of the chunk, `0x02-0x03` the CRC-16 of the index and the data, `0x04-0x83` the data
+        /// (the last chunk padded)
+        OtaChunk = 0x51,
+        /// Returns the progress of the firmware update
+        /// @return `0x00-0x17` The `OtaStatus`
+        GetOtaStatus = 0x52,
+        /// Verifies the image once all chunks have been received and boots it with the next restart
+        /// @param `0x00` `1` to restart right after
+        /// @return `0x00-0x17` The `OtaStatus`, `OtaState::VERIFYING` until done
+        OtaFinish = 0x53,
+        /// Cancels the firmware update, the image received so far is discarded
+        /// @return `0x00-0x17` The `OtaStatus`
+        OtaAbort = 0x54,
+
+        /// Safe the configuration to the EEPROM, runs as a background job
+        /// @return `0x00-0x01` The `JobTicket` of the job
         SaveConfig = 0x80,
+        /// Returns the state of a background job
+        /// @param `0x00` The ID of the job (see `JobTicket`)
+        /// @return `0x00` The `JobState` of the job
+        GetJobState = 0x81,
 
         /// Get the current SSID for the WiFi connection
         /// @return The WiFi SSID as null terminated string (for max len see `WIFI_BUFFER_SIZE`)
         GetWiFiSSID = 0xA0, 
-        /// Set the current SSID for the WiFi connection
+        /// Set the current SSID for the WiFi connection, runs as a background job
         /// @param 0x00-? The WiFi SSID as null terminated string (for max len see `WIFI_BUFFER_SIZE`)
+        /// @return `0x00-0x01` The `JobTicket` of the job
         SetWiFiSSID = 0xA1,
         
         /// Get the current password for the WiFi connection
         /// @return The WiFi password as null terminated string (for max len see `WIFI_BUFFER_SIZE`)
         GetWiFiPwd = 0xA2,
-        /// Set the current password for the WiFi connection
+        /// Set the current password for the WiFi connection, runs as a background job
         /// @param 0x00-? The WiFi password as null terminated string (for max len see `WIFI_BUFFER_SIZE`)
+        /// @return `0x00-0x01` The `JobTicket` of the job
         SetWiFiPwd = 0xA3
     }; 
 
+    /// Priority classes of the commands, deciding how the core handles them
+    enum class CommandClass : uint8_t {
+        /// Movements, stops and heartbeats, handled first whenever multiple commands arrive at once
+        CONTROL = 0x00,
+        /// Cheap commands (queries, settings in RAM), handled in arrival order after the control commands
+        ROUTINE = 0x01,
+        /// Slow work (flash writes, remote and WiFi changes), deferred to a background job that reports its completion
+        MAINTENANCE = 0x02
+    };
+
+    /// @brief The priority class of a command
+    inline CommandClass command_class(Command cmd) {
+        switch (cmd) {
+            case Command::SyncClock:
+            case Command::Move:
+            case Command::Drive:
+            case Command::Stop:
+            case Command::ScheduleMove:
+            case Command::ScheduleDrive:
+            case Command::MoveServo:
+            case Command::SetTraderState:
+            case Command::PublishPrimarySensorData:
+                return CommandClass::CONTROL;
+
+            case Command::RemoteConfigure:
+            case Command::SaveConfig:
+            case Command::SetWiFiSSID:
+            case Command::SetWiFiPwd:
+                return CommandClass::MAINTENANCE;
+
+            default:
+                return CommandClass::ROUTINE;
+        }
+    }
+
+    /// State of a background job
+    enum class JobState : uint8_t {
+        /// No job with the given ID is known (anymore)
+        UNKNOWN = 0x00,
+        /// Waiting for the background task
+        QUEUED = 0x01,
+        /// Currently executed
+        RUNNING = 0x02,
+        /// Finished successfully
+        DONE = 0x03,
+        /// Finished with an error
+        FAILED = 0x04,
+        /// Not accepted, too many jobs are queued
+        REJECTED = 0x05
+    };
+
+    /// Answer to a command that has been deferred to a background job
+    struct JobTicket {
+        /// ID to query the state with (`Command::GetJobState`), never `0`
+        uint8_t id;
+        JobState state;
+    };
+
     /// All the possible remotes, assigning them IDs  
     /// Used as a kind of network address to determine where a piece of data was retrieved from or where it has to be sent 
     enum class Remote : uint8_t {
@@ -182,6 +360,288 @@ namespace bugsy {
             /// The duty of the left chain motor, `0` means fully off while `0xFF` means fully on
             uint8_t chain_right_duty;
         };
+
+        /// Optional header in front of the arguments of `Command::Move` and `Command::Drive`, allows the core to drop
+        /// movements arriving out of order or late (see `bugsy/mailbox.hpp`)
+        struct MoveStamp {
+            /// Time the client sent the movement at in milliseconds of its own clock
+            uint32_t stamp;
+            /// Sequence number, incremented by the client for every movement
+            uint16_t seq;
+
+            uint8_t reserved [2];
+        };
+
+        /// Statistics of the movement mailbox of the core
+        struct MoveStats {
+            /// Amount of movements accepted into the mailbox
+            uint32_t accepted;
+            /// Amount of accepted movements replaced by a newer one before being applied
+            uint32_t superseded;
+            /// Amount of stamped movements dropped for arriving out of order
+            uint32_t out_of_order;
+            /// Amount of stamped movements dropped for being older than `BUGSY_MOVE_MAX_AGE`
+            uint32_t expired;
+            /// Sequence number of the last stamped movement
+            uint16_t last_seq;
+            /// Age of the last stamped movement in milliseconds
+            uint16_t last_age;
+        };
+
+        /// Link statistics of a remote, gathered from the movements it sends
+        struct LinkStats {
+            /// Movements received
+            uint32_t received;
+            /// Movements missing in the sequence of the stamped ones
+            uint32_t lost;
+            /// Last round trip reported by the client in microseconds, `0` if none has been reported
+            uint32_t rtt;
+            /// Average time between two movements in milliseconds
+            uint16_t interval;
+            /// Average deviation of the time between two movements from `interval` in milliseconds
+            uint16_t jitter;
+            /// The failsafe window the movements of the remote currently get in milliseconds
+            uint16_t window;
+
+            uint8_t reserved [2];
+        };
+
+        /// Bounds of the adaptive movement failsafe
+        struct FailsafeConfig {
+            /// Shortest window in milliseconds
+            uint16_t min_window;
+            /// Longest window in milliseconds
+            uint16_t max_window;
+            /// Amount of jitters added on top of the average interval of the remote
+            uint8_t jitter_factor;
+            /// `1` adapts the window to the link, `0` always uses the fixed movement duration of the configuration
+            uint8_t adaptive;
+
+            uint8_t reserved [2];
+        };
+
+        /// A velocity of the whole robot, converted into a `Movement` by the core
+        struct Velocity {
+            /// Forward speed in mm/s, negative values drive backwards
+            int16_t linear;
+            /// Rotation speed in mrad/s, positive values turn counter-clockwise (left)
+            int16_t angular;
+        };
+
+        /// A movement to be applied at a given time
+        struct ScheduledMove {
+            /// Time to apply the movement at in microseconds of the core clock
+            uint32_t at;
+            Movement move;
+        };
+
+        /// A velocity to drive with from a given time on
+        struct ScheduledVelocity {
+            /// Time to apply the velocity at in microseconds of the core clock
+            uint32_t at;
+            Velocity vel;
+        };
+
+        /// Statistics of the scheduled movements of the core
+        struct ScheduleStats {
+            /// Amount of movements scheduled
+            uint32_t scheduled;
+            /// Amount of movements applied
+            uint32_t executed;
+            /// Amount of movements rejected (too late, too far ahead or schedule full)
+            uint32_t rejected;
+            /// Average (filtered) and maximum time in microseconds the movements were applied after their time
+            uint16_t lateness_avg;
+            uint16_t lateness_max;
+            /// Amount of movements currently waiting
+            uint8_t pending;
+
+            uint8_t reserved [3];
+        };
+
+        /// Amount of points of the duty linearization tables
+        static const uint8_t DRIVE_LUT_POINTS = 17;
+
+        /// Calibration of the velocity drive mode, stored in the configuration
+        struct DriveCalibration {
+            /// Speed of the chains at full duty in mm/s
+            uint16_t max_speed;
+            /// Distance between the centers of both chains in mm
+            uint16_t track_width;
+            /// Duty of the left chain to reach `i / (DRIVE_LUT_POINTS - 1)` of `max_speed` for every point `i`
+            uint8_t left [DRIVE_LUT_POINTS];
+            /// Duty of the right chain to reach `i / (DRIVE_LUT_POINTS - 1)` of `max_speed` for every point `i`
+            uint8_t right [DRIVE_LUT_POINTS];
+        };
+
+        /// Gains of the chain speed controllers with 8 fractional bits, in duty per mm/s of error
+        struct SpeedGains {
+            /// Proportional gain
+            uint16_t kp;
+            /// Integral gain, applied once per control tick
+            uint16_t ki;
+            /// Derivative gain (on the measured speed), applied once per control tick
+            uint16_t kd;
+            /// `1` to track the chain speeds with the encoders, `0` for plain open-loop duties
+            uint8_t enabled;
+
+            uint8_t reserved;
+        };
+
+        /// State and statistics of the closed-loop chain speed control
+        struct SpeedStats {
+            /// Amount of control ticks run
+            uint32_t ticks;
+            /// Average (filtered) and maximum deviation of the tick period in microseconds
+            uint16_t jitter_avg;
+            uint16_t jitter_max;
+            /// Target speeds of the chains in mm/s
+            int16_t target_left;
+            int16_t target_right;
+            /// Measured speeds of the chains in mm/s
+            int16_t speed_left;
+            int16_t speed_right;
+            /// Filtered absolute tracking error of the chains in mm/s
+            uint16_t error_left;
+            uint16_t error_right;
+            /// Whether the closed loop is active
+            uint8_t active;
+            /// Bit 0 set if the left, bit 1 if the right controller is saturated at the duty limit
+            uint8_t saturated;
+
+            uint8_t reserved [2];
+        };
+    /**/
+
+    /* CLOCK */
+        /// Answer of the core to `Command::SyncClock`, all times in microseconds
+        struct ClockSample {
+            /// The time the client sent the request at (client clock, echoed)
+            uint32_t client_send;
+            /// The time the core received the request at (core clock)
+            uint32_t core_receive;
+            /// The time the core sent this answer at (core clock)
+            uint32_t core_send;
+        };
+    /**/
+
+    /* UPDATE */
+        /// State of a firmware update of the core
+        enum class OtaState : uint8_t {
+            /// No update has been started
+            IDLE = 0x00,
+            /// The partition is being erased, chunks are dropped
+            ERASING = 0x01,
+            /// Chunks are received and written
+            RECEIVING = 0x02,
+            /// All chunks have been received, the image is checked
+            VERIFYING = 0x03,
+            /// The image has been verified and boots with the next restart
+            READY = 0x04,
+            /// The image does not fit, a write failed or the verification failed
+            FAILED = 0x80
+        };
+
+        /// The firmware image of an update
+        struct OtaImage {
+            /// Size of the image in bytes
+            uint32_t size;
+            /// CRC-32 of the whole image, identifies the image when an update is resumed
+            uint32_t crc;
+        };
+
+        /// Progress of the firmware update of the core
+        struct OtaStatus {
+            /// The image being updated
+            uint32_t size;
+            uint32_t crc;
+            /// Bytes written to the flash
+            uint32_t written;
+            /// Bit `i` set if chunk `next + i` has not been received yet
+            uint32_t missing;
+            /// First chunk not received yet, `chunks` once all have been
+            uint16_t next;
+            /// Amount of chunks of the image
+            uint16_t chunks;
+            /// Chunks dropped for a broken CRC or a full write queue
+            uint16_t dropped;
+            OtaState state;
+            /// Chunks the client may send before asking for the status again, limited by the receive buffer of its remote
+            uint8_t window;
+        };
+    /**/
+
+    /* UART */
+        /// Negotiated baud rate and error counters of the link between the core and another MCU (see `bugsy/baud.hpp`)
+        struct BaudStats {
+            /// The baud rate currently used
+            uint32_t baud;
+            /// Test frames received while probing rates
+            uint32_t test_frames;
+            /// Test frames received with a broken CRC
+            uint32_t test_errors;
+            /// Receive errors at the current rate (framing errors, unknown commands)
+            uint32_t rx_errors;
+            /// Rates proposed and confirmed
+            uint16_t negotiations;
+            /// Returns to the base rate after an error burst, a missing confirmation or a lost connection
+            uint16_t fallbacks;
+        };
+    /**/
+
+    /* SERVOS */
+        /// The servos of the robot
+        enum class Servo : uint8_t {
+            /// Servo rotating the head
+            HEAD = 0x00
+        };
+
+        /// Amount of servos of the robot
+        static const uint8_t SERVO_COUNT = 1;
+
+        /// Maximum angle of a servo in 0.1 degrees
+        static const uint16_t SERVO_ANGLE_MAX = 1800;
+
+        /// Moves a servo to a new angle
+        struct ServoMove {
+            /// The target angle in 0.1 degrees (`0` - `SERVO_ANGLE_MAX`)
+            uint16_t angle;
+            /// Time in milliseconds to reach the target, `0` moves instantly
+            uint16_t duration;
+            /// The servo to move
+            Servo servo;
+
+            uint8_t reserved [3];
+        };
+    /**/
+
+    /* EMERGENCY STOP */
+        /// State and latency statistics of the emergency stop line between the trader and the core
+        struct EStopStats {
+            /// Amount of emergency stops
+            uint32_t triggers;
+            /// Amount of emergency stops that took longer than `BUGSY_ESTOP_MAX_LATENCY`
+            uint32_t violations;
+            /// Time in microseconds from the line being asserted until the motors were off (last and maximum)
+            uint16_t latency_last;
+            uint16_t latency_max;
+            /// Whether the emergency stop is currently engaged, movements are rejected until the line is released
+            uint8_t active;
+
+            uint8_t reserved [3];
+        };
+    /**/
+
+    /* BATTERY */
+        /// The state of the battery pack as measured by the core
+        struct BatteryState {
+            /// The filtered pack voltage under the current load in millivolts
+            uint16_t voltage;
+            /// Estimated state of charge in percent, compensated for the voltage sag of the current load
+            uint8_t charge;
+            /// Maximum duty the movements are scaled to, reduced by the core as the pack sags (`0xFF` means unlimited)
+            uint8_t duty_limit;
+        };
     /**/
 
     /* CONFIGURATION */
@@ -195,6 +655,13 @@ namespace bugsy {
             char wifi_ssid [BUGSY_WIFI_CRED_BUFFER_SIZE];
             /// The WIFI Password used, parsed from the configuration on setup
             char wifi_password [BUGSY_WIFI_CRED_BUFFER_SIZE];
+
+            /// Calibration of the velocity drive mode, reset to `bugsy::drive::DEFAULT_CALIBRATION` if invalid
+            bugsy::DriveCalibration drive;
+            /// Gains of the chain speed controllers, reset to `bugsy::speed::DEFAULT_GAINS` if invalid
+            bugsy::SpeedGains speed_gains;
+            /// Bounds of the adaptive movement failsafe, reset to `bugsy::link::DEFAULT_FAILSAFE` if invalid
+            bugsy::FailsafeConfig failsafe;
         };
     /**/
 
@@ -0,0 +1,45 @@
+// #####################
+// #    BUGSY - CRC    #
+// #####################
+//
+// Checksums of the protocol, shared by the core firmware, the trader, the host simulation and the clients. Both are
+// computed bitwise to spare the flash of the AVR, they only run over test frames and update chunks.
+
+# pragma once
+
+# include <inttypes.h>
+# include <stddef.h>
+
+namespace bugsy {
+    namespace crc {
+        /// @brief CRC-16/CCITT-FALSE of the given bytes
+        /// @param crc The CRC of the bytes before, to compute it piece by piece
+        inline uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF) {
+            for (size_t i = 0; i < len; i++) {
+                crc ^= (uint16_t)data[i] << 8;
+
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+                }
+            }
+
+            return crc;
+        }
+
+        /// @brief CRC-32 (IEEE 802.3, as used by zlib) of the given bytes
+        /// @param crc The CRC of the bytes before, to compute it piece by piece
+        inline uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+            crc = ~crc;
+
+            for (size_t i = 0; i < len; i++) {
+                crc ^= data[i];
+
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+                }
+            }
+
+            return ~crc;
+        }
+    }
+}
@@ -14,18 +14,43 @@
 # define BUGSY_DEVICE_NAME "bugsy"
 
 /* BAUD RATES */
-/// Baud rate between the core and the trader
+/// Baud rate between the core and the trader, the link starts at and falls back to it (see `bugsy/baud.hpp`)
 # define BUGSY_UART_CORE_TO_TRADER_BAUD 250000
+/// Highest baud rate negotiated between the core and the trader, limited by the RX interrupt of the AVR
+# define BUGSY_UART_CORE_TO_TRADER_MAX_BAUD 1000000
+/// Baud rate between the core and the RPi, the link starts at and falls back to it (see `bugsy/baud.hpp`)
+# define BUGSY_UART_CORE_TO_RPI_BAUD 250000
+/// Highest baud rate negotiated between the core and the RPi
+# define BUGSY_UART_CORE_TO_RPI_MAX_BAUD 2000000
 
 /* INTERVALS */
+/// Time between two state exchanges of the trader with the core (`Command::SetTraderState`). The publishes already keep
+/// the core from timing out the trader, but they are not answered. The exchange is the check-up of the trader, its
+/// answer tells whether the core is still operational and its absence that the link got lost
 # define BUGSY_STATE_INTERVAL 1000
 
 /// Minimum time between *any form of messages* between the trader and the core until the core issues the trader as disconnected
 # define BUGSY_TRADER_MIN_UPDATES 1000
-/// Time interval between measurements of the primary sensor data
+/// Maximum time between two publishes of the primary sensor data, even if nothing changed. As this is shorter than 
+/// `BUGSY_TRADER_MIN_UPDATES`, the publishes double as the heartbeat of the trader
 # define BUGSY_PRIMARY_SENSOR_INTERVAL 500
 /// Time interval between measurements of the secondary sensor data
 # define BUGSY_SECONDARY_SENSOR_INTERVAL 5000
+/// Maximum time between two publishes of the secondary sensor data, even if nothing changed
+# define BUGSY_SECONDARY_SENSOR_MAX_STALENESS 30000
+/// Minimum time between two publishes of the same sensor data, limits the load on the core when values change rapidly
+# define BUGSY_SENSOR_MIN_PUBLISH_INTERVAL 20
+
+# if BUGSY_PRIMARY_SENSOR_INTERVAL >= BUGSY_TRADER_MIN_UPDATES
+    # error "The primary sensor data has to be published more often than the trader timeout of the core!"
+# endif
+
+/* EMERGENCY STOP */
+/// Time in milliseconds the trader keeps the emergency stop line asserted after the obstacle cleared
+# define BUGSY_ESTOP_HOLD 200
+/// Worst-case time in microseconds from the emergency stop line being asserted until the motors are off, stops taking
+/// longer are counted as violations by the core
+# define BUGSY_ESTOP_MAX_LATENCY 500
 
 /* SIZES */
 /// The buffer size for WiFi credentials (SSID and Password each)
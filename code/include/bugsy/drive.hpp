@@ -0,0 +1,138 @@
+// #######################
+// #    BUGSY - DRIVE    #
+// #######################
+//
+// Differential drive kinematics of the chains, shared by the core firmware and the host simulation
+//
+// A `Velocity` (linear and angular speed of the robot) is split into the speeds of both chains, which are mapped to
+// duties through the linearization tables of the `DriveCalibration`. The tables compensate the deadband and the
+// non-linear speed curve of every motor, so the robot tracks the commanded speed no matter which chain is driven.
+// Everything is integer math, the default tables are generated at compile time.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+
+/* DRIVE */
+/// Default speed of a chain at full duty in mm/s
+# define BUGSY_DRIVE_DEFAULT_MAX_SPEED 400
+/// Default distance between the centers of both chains in mm
+# define BUGSY_DRIVE_DEFAULT_TRACK_WIDTH 150
+/// Default duty at which the motors start turning
+# define BUGSY_DRIVE_DEFAULT_DEADBAND 40
+
+namespace bugsy {
+    namespace drive {
+        // Table generation (compile time)
+            /// Default duty for the table point `i`, linear from the deadband up to full duty
+            constexpr uint8_t default_point(uint8_t i) {
+                return i ? (uint8_t)(BUGSY_DRIVE_DEFAULT_DEADBAND
+                    + (((255 - BUGSY_DRIVE_DEFAULT_DEADBAND) * i) + ((DRIVE_LUT_POINTS - 1) / 2)) / (DRIVE_LUT_POINTS - 1)) : 0;
+            }
+
+            template<uint8_t... I>
+            struct Indices { };
+
+            template<uint8_t N, uint8_t... I>
+            struct MakeIndices : MakeIndices<N - 1, N - 1, I...> { };
+
+            template<uint8_t... I>
+            struct MakeIndices<0, I...> {
+                typedef Indices<I...> type;
+            };
+
+            template<uint8_t... I>
+            constexpr DriveCalibration default_calibration(Indices<I...>) {
+                return DriveCalibration {
+                    BUGSY_DRIVE_DEFAULT_MAX_SPEED,
+                    BUGSY_DRIVE_DEFAULT_TRACK_WIDTH,
+                    { default_point(I)... },
+                    { default_point(I)... }
+                };
+            }
+        //
+
+        /// Calibration used until another one is stored in the configuration
+        static constexpr DriveCalibration DEFAULT_CALIBRATION = default_calibration(MakeIndices<DRIVE_LUT_POINTS>::type());
+
+        /// @brief Checks whether a calibration can be used (e.g. after loading an uninitialized EEPROM)
+        ///
+        /// Both tables have to start at `0` and rise monotonically, otherwise a higher speed could result in a lower duty
+        inline bool valid(const DriveCalibration& cal) {
+            if ((cal.max_speed == 0) || (cal.max_speed == 0xFFFF) || (cal.track_width == 0) || (cal.track_width == 0xFFFF)) {
+                return false;
+            }
+
+            if (cal.left[0] || cal.right[0]) {
+                return false;
+            }
+
+            for (uint8_t i = 1; i < DRIVE_LUT_POINTS; i++) {
+                if ((cal.left[i] < cal.left[i - 1]) || (cal.right[i] < cal.right[i - 1])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// @brief Maps a chain speed to a duty with the given table
+        /// @param speed The absolute speed in mm/s, has to be below or equal to `max_speed`
+        inline uint8_t lookup(const uint8_t* table, uint16_t speed, uint16_t max_speed) {
+            // Position in the table with 8 fractional bits
+            uint32_t pos = ((uint32_t)speed * ((DRIVE_LUT_POINTS - 1) << 8)) / max_speed;
+            uint8_t index = (uint8_t)(pos >> 8);
+
+            if (index >= (DRIVE_LUT_POINTS - 1)) {
+                return table[DRIVE_LUT_POINTS - 1];
+            }
+
+            uint8_t frac = (uint8_t)(pos & 0xFF);
+            return (uint8_t)(table[index] + ((((int16_t)table[index + 1] - table[index]) * frac) >> 8));
+        }
+
+        /// @brief Maps a duty back to the chain speed it results in with the given table, inverse of `lookup()`
+        /// @return The absolute speed in mm/s
+        inline uint16_t speed_of(const uint8_t* table, uint8_t duty, uint16_t max_speed) {
+            for (uint8_t i = 1; i < DRIVE_LUT_POINTS; i++) {
+                if (duty <= table[i]) {
+                    // Flat segments (deadband) map to their start, the duty does not move the chain any faster
+                    uint16_t span = table[i] - table[i - 1];
+                    uint32_t pos = ((uint32_t)(i - 1) << 8) + (span ? (((uint32_t)(duty - table[i - 1]) << 8) / span) : 0);
+                    return (uint16_t)((pos * max_speed) / ((DRIVE_LUT_POINTS - 1) << 8));
+                }
+            }
+
+            return max_speed;
+        }
+
+        /// @brief Converts a velocity into the duties and directions of both chains
+        ///
+        /// If a chain would have to run faster than `max_speed`, both chains are scaled down by the same factor, so the
+        /// robot still drives the commanded curve (just slower)
+        inline Movement to_movement(const Velocity& vel, const DriveCalibration& cal) {
+            // Speed difference of the chains, angular velocity (mrad/s) times half the track width (mm)
+            int32_t diff = ((int32_t)vel.angular * cal.track_width) / 2000;
+            int32_t left = (int32_t)vel.linear - diff;
+            int32_t right = (int32_t)vel.linear + diff;
+
+            uint32_t left_abs = (left < 0) ? -left : left;
+            uint32_t right_abs = (right < 0) ? -right : right;
+            uint32_t peak = (left_abs > right_abs) ? left_abs : right_abs;
+
+            if (peak > cal.max_speed) {
+                left_abs = (left_abs * cal.max_speed) / peak;
+                right_abs = (right_abs * cal.max_speed) / peak;
+            }
+
+            return Movement {
+                (left >= 0) ? Direction::CW : Direction::CCW,
+                (right >= 0) ? Direction::CW : Direction::CCW,
+                lookup(cal.left, (uint16_t)left_abs, cal.max_speed),
+                lookup(cal.right, (uint16_t)right_abs, cal.max_speed)
+            };
+        }
+    }
+}
@@ -0,0 +1,199 @@
+// ######################
+// #    BUGSY - LINK    #
+// ######################
+//
+// Link quality of the remotes sending movements and the adaptive movement failsafe, shared by the core firmware and the
+// host simulation
+//
+// Every movement received from a remote updates the statistics of its link: The inter-arrival interval and its jitter
+// (mean absolute deviation from the average interval) are filtered like the RFC 3550 jitter, gaps in the sequence numbers
+// of stamped movements count as lost movements and clients may report the round trip of their clock synchronization.
+// The failsafe window, the time a movement is held before the robot stops, follows the link: A remote sending every
+// 50 ms with little jitter gets a window slightly above 50 ms and the robot stops quickly after a dropout, a jittery link
+// gets a longer window, so the robot does not stop between two late movements. The window is bounded by the
+// `FailsafeConfig`, until enough movements have been received the fixed movement duration of the configuration is used.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+# include "mailbox.hpp"
+
+/* LINK */
+/// Strength of the IIR filters applied to the interval and the jitter (same gain as the RFC 3550 jitter)
+# define BUGSY_LINK_STATS_SHIFT 4
+/// Amount of movements a remote has to send before its failsafe window adapts
+# define BUGSY_LINK_MIN_SAMPLES 8
+/// Amount of remotes tracked, one for every flag of `Remote`
+# define BUGSY_LINK_REMOTES 8
+
+/* FAILSAFE */
+/// Default bounds of the adaptive failsafe window in milliseconds
+# define BUGSY_FAILSAFE_DEFAULT_MIN 60
+# define BUGSY_FAILSAFE_DEFAULT_MAX 500
+/// Default amount of jitters added on top of the average interval
+# define BUGSY_FAILSAFE_DEFAULT_JITTER_FACTOR 4
+
+namespace bugsy {
+    namespace link {
+        /// Bounds used until others are stored in the configuration
+        static constexpr FailsafeConfig DEFAULT_FAILSAFE = {
+            BUGSY_FAILSAFE_DEFAULT_MIN, BUGSY_FAILSAFE_DEFAULT_MAX, BUGSY_FAILSAFE_DEFAULT_JITTER_FACTOR, 1, { 0, 0 }
+        };
+
+        /// @brief Checks whether the failsafe configuration can be used (e.g. after loading an uninitialized EEPROM)
+        inline bool valid(const FailsafeConfig& config) {
+            return (config.min_window > 0) && (config.min_window <= config.max_window) && (config.adaptive <= 1);
+        }
+
+        /// @brief The index of a single remote in the statistics
+        /// @return `BUGSY_LINK_REMOTES` if `remote` is not a single remote
+        inline uint8_t index_of(Remote remote) {
+            uint8_t bits = (uint8_t)remote;
+
+            for (uint8_t i = 0; i < BUGSY_LINK_REMOTES; i++) {
+                if (bits == (1 << i)) {
+                    return i;
+                }
+            }
+
+            return BUGSY_LINK_REMOTES;
+        }
+
+        /// Statistics of the links of all remotes
+        class Monitor {
+        public:
+            /// @brief Records a movement received from a remote
+            /// @param stamp The sequence header sent with the movement, `nullptr` for plain movements
+            /// @param now The current time in milliseconds
+            void arrival(Remote src, const MoveStamp* stamp, uint32_t now) {
+                uint8_t index = index_of(src);
+
+                if (index >= BUGSY_LINK_REMOTES) {
+                    return;
+                }
+
+                Entry& entry = this->entries[index];
+                uint32_t interval = now - entry.last_arrival;
+
+                // A remote silent for a while starts over, its next movement continues neither the timing nor the sequence
+                bool resumed = entry.stats.received && (interval <= BUGSY_MOVE_SEQ_TIMEOUT);
+
+                entry.stats.received++;
+                entry.last_arrival = now;
+
+                if (resumed) {
+                    if (entry.samples < BUGSY_LINK_MIN_SAMPLES) {
+                        // Start the average at the first interval instead of zero
+                        if (!entry.samples) {
+                            entry.interval_filtered = interval << 8;
+                        }
+
+                        entry.samples++;
+                    }
+
+                    int32_t deviation = (int32_t)(interval << 8) - (int32_t)entry.interval_filtered;
+
+                    if (deviation < 0) {
+                        deviation = -deviation;
+                    }
+
+                    entry.interval_filtered += (int32_t)((interval << 8) - entry.interval_filtered) >> BUGSY_LINK_STATS_SHIFT;
+                    entry.jitter_filtered += (deviation - (int32_t)entry.jitter_filtered) >> BUGSY_LINK_STATS_SHIFT;
+
+                    entry.stats.interval = saturate(entry.interval_filtered >> 8);
+                    entry.stats.jitter = saturate(entry.jitter_filtered >> 8);
+                }
+
+                if (stamp) {
+                    int16_t gap = (int16_t)(stamp->seq - entry.seq);
+
+                    // Movements arriving late or twice are no losses, neither is the first one of a sequence
+                    if (resumed && entry.sequenced && (gap > 1)) {
+                        entry.stats.lost += gap - 1;
+                    }
+
+                    if (!(resumed && entry.sequenced) || (gap > 0)) {
+                        entry.seq = stamp->seq;
+                    }
+
+                    entry.sequenced = true;
+                } else if (!resumed) {
+                    entry.sequenced = false;
+                }
+            }
+
+            /// @brief Records the round trip a client measured (see `Command::SyncClock`)
+            /// @param rtt The round trip in microseconds
+            void report_rtt(Remote src, uint32_t rtt) {
+                uint8_t index = index_of(src);
+
+                if (index < BUGSY_LINK_REMOTES) {
+                    this->entries[index].stats.rtt = rtt;
+                }
+            }
+
+            /// @brief The failsafe window for the next movement of a remote
+            /// @param fallback The fixed duration used while adaptation is disabled or not enough movements have been received
+            /// @return The window in milliseconds
+            uint16_t window(Remote src, const FailsafeConfig& config, MoveDuration fallback) const {
+                uint8_t index = index_of(src);
+
+                if (!config.adaptive || (index >= BUGSY_LINK_REMOTES) || (this->entries[index].samples < BUGSY_LINK_MIN_SAMPLES)) {
+                    return saturate(fallback);
+                }
+
+                const Entry& entry = this->entries[index];
+                uint32_t window = (entry.interval_filtered + (entry.jitter_filtered * config.jitter_factor)) >> 8;
+
+                if (window < config.min_window) {
+                    return config.min_window;
+                }
+
+                if (window > config.max_window) {
+                    return config.max_window;
+                }
+
+                return (uint16_t)window;
+            }
+
+            /// @brief Copies the statistics of a remote
+            /// @return Zeroed statistics for unknown remotes
+            LinkStats stats(Remote src, const FailsafeConfig& config, MoveDuration fallback) const {
+                uint8_t index = index_of(src);
+
+                if (index >= BUGSY_LINK_REMOTES) {
+                    return LinkStats { };
+                }
+
+                LinkStats copy = this->entries[index].stats;
+                copy.window = this->window(src, config, fallback);
+                return copy;
+            }
+
+        private:
+            struct Entry {
+                LinkStats stats;
+
+                /// Time of the last movement in milliseconds
+                uint32_t last_arrival;
+                /// Filtered interval and jitter with 8 fractional bits
+                uint32_t interval_filtered;
+                uint32_t jitter_filtered;
+                /// Intervals measured, saturates at `BUGSY_LINK_MIN_SAMPLES`
+                uint8_t samples;
+
+                /// Whether `seq` holds the sequence number of the last stamped movement
+                bool sequenced;
+                uint16_t seq;
+            };
+
+            static uint16_t saturate(uint32_t value) {
+                return (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+            }
+
+            Entry entries [BUGSY_LINK_REMOTES] = { };
+        };
+    }
+}
@@ -0,0 +1,121 @@
+// #########################
+// #    BUGSY - MAILBOX    #
+// #########################
+//
+// Latest-wins mailbox for movement commands, shared by the core firmware and the host simulation
+//
+// The mailbox holds a single movement, a newer one replaces the one that has not been applied yet. Clients may send a
+// `MoveStamp` in front of the movement, the mailbox then drops movements arriving out of order (sequence number not newer
+// than the last one of the same source) and movements that are older than `BUGSY_MOVE_MAX_AGE`. The clocks of the client
+// and the robot are not synchronized, the age is the transit delay (arrival time minus the stamp of the client) above
+// the smallest delay seen from the source, which follows a slow drift between both clocks. After a radio stall the
+// buffered movements arrive in a burst with growing ages, so only the newest ones are applied.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+
+/* MOVE MAILBOX */
+/// Maximum age of a stamped movement in milliseconds, older movements are dropped
+# define BUGSY_MOVE_MAX_AGE 100
+/// Time in milliseconds without stamped movements after which the sequence of a source starts over (client restart)
+# define BUGSY_MOVE_SEQ_TIMEOUT 1000
+
+namespace bugsy {
+    namespace mailbox {
+        class Mailbox {
+        public:
+            /// @brief Posts a new movement, replacing the one not applied yet
+            /// @param src The remote the movement has been received from
+            /// @param stamp The sequence header sent with the movement, `nullptr` for plain movements (always accepted)
+            /// @param now The current time in milliseconds
+            /// @return Whether the movement has been accepted, dropped ones are counted in the statistics
+            bool post(Remote src, const MoveStamp* stamp, const Movement& move, uint32_t now) {
+                if (stamp) {
+                    int32_t delay = (int32_t)(now - stamp->stamp);
+
+                    // A new source (or one that has been silent for a while) starts a new sequence
+                    if (!this->tracking || (src != this->src) || ((now - this->last_post) > BUGSY_MOVE_SEQ_TIMEOUT)) {
+                        this->tracking = true;
+                        this->src = src;
+                        this->seq = stamp->seq - 1;
+                        this->min_delay = delay;
+                    }
+
+                    this->last_post = now;
+
+                    if ((int16_t)(stamp->seq - this->seq) <= 0) {
+                        this->stats.out_of_order++;
+                        return false;
+                    }
+
+                    this->seq = stamp->seq;
+                    this->stats.last_seq = stamp->seq;
+
+                    if (delay < this->min_delay) {
+                        this->min_delay = delay;
+                    }
+
+                    uint32_t age = (uint32_t)(delay - this->min_delay);
+                    this->stats.last_age = (age > UINT16_MAX) ? UINT16_MAX : (uint16_t)age;
+
+                    if (age > BUGSY_MOVE_MAX_AGE) {
+                        this->stats.expired++;
+                        return false;
+                    }
+
+                    // Follow the drift of the client clock by at most 1 ms per movement
+                    if (age) {
+                        this->min_delay++;
+                    }
+                }
+
+                if (this->full) {
+                    this->stats.superseded++;
+                }
+
+                this->slot = move;
+                this->slot_src = src;
+                this->full = true;
+                this->stats.accepted++;
+                return true;
+            }
+
+            /// @brief Takes the newest movement out of the mailbox
+            /// @param src Set to the remote the movement has been received from
+            /// @return `false` if no movement has been posted since the last call
+            bool take(Movement* move, Remote* src) {
+                if (!this->full) {
+                    return false;
+                }
+
+                *move = this->slot;
+                *src = this->slot_src;
+                this->full = false;
+                return true;
+            }
+
+            /// @brief Drops the movement not applied yet (e.g. when stopping)
+            void clear() {
+                this->full = false;
+            }
+
+            MoveStats stats = { };
+
+        private:
+            Movement slot;
+            Remote slot_src = Remote::NONE;
+            bool full = false;
+
+            /// Whether a sequence is being tracked
+            bool tracking = false;
+            Remote src = Remote::NONE;
+            uint16_t seq = 0;
+            uint32_t last_post = 0;
+            /// Smallest transit delay seen from the source (including the clock offset) in milliseconds
+            int32_t min_delay = 0;
+        };
+    }
+}
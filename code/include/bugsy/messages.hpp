@@ -0,0 +1,2377 @@
+// #########################
+// #    BUGSY - MESSAGES    #
+// #########################
+//
+// GENERATED by `schema/generate.py` from `schema/messages.json`, do not edit!
+//
+// Wire format of all messages exchanged with the core, little endian and without any implicit padding.
+//
+// Every message has a view, decoding it in place from a received buffer (bounds checked once when constructed, no
+// copies, no alignment requirements) and a builder, encoding it in place into a send buffer.
+// The hand-written types of `core.hpp`, `trader.hpp` and `power.hpp` are checked against the schema below, so their
+// layout can not drift from the wire format unnoticed.
+
+# pragma once
+
+# include <inttypes.h>
+# include <stddef.h>
+
+# include "core.hpp"
+# include "power.hpp"
+# include "trader.hpp"
+
+namespace bugsy {
+    /// Zero-copy views and builders of all messages
+    namespace msg {
+        /// Little endian access to unaligned bytes
+        namespace wire {
+            static inline uint16_t get_u16(const uint8_t* p) {
+                return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+            }
+
+            static inline uint32_t get_u32(const uint8_t* p) {
+                return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+            }
+
+            static inline void put_u16(uint8_t* p, uint16_t value) {
+                p[0] = (uint8_t)value;
+                p[1] = (uint8_t)(value >> 8);
+            }
+
+            static inline void put_u32(uint8_t* p, uint32_t value) {
+                p[0] = (uint8_t)value;
+                p[1] = (uint8_t)(value >> 8);
+                p[2] = (uint8_t)(value >> 16);
+                p[3] = (uint8_t)(value >> 24);
+            }
+        }
+
+        /* JOB TICKET */
+            /// Answer to a command that has been deferred to a background job (read only view)
+            class JobTicketView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 2;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                JobTicketView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// ID to query the state with, never `0`
+                uint8_t id() const { return this->data[0]; }
+
+                bugsy::JobState state() const { return (bugsy::JobState)this->data[1]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::JobTicket get() const {
+                    bugsy::JobTicket value;
+                    value.id = this->id();
+                    value.state = this->state();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Answer to a command that has been deferred to a background job (in place encoder)
+            class JobTicketBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 2;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                JobTicketBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// ID to query the state with, never `0`
+                JobTicketBuilder& id(uint8_t value) {
+                    this->data[0] = value;
+                    return *this;
+                }
+
+                JobTicketBuilder& state(bugsy::JobState value) {
+                    this->data[1] = (uint8_t)value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                JobTicketBuilder& set(const bugsy::JobTicket& value) {
+                    this->id(value.id);
+                    this->state(value.state);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* MOVEMENT */
+            /// A movement with all the information how to adjust the PWM signals (read only view)
+            class MovementView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MovementView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                ::Direction chain_left_dir() const { return (::Direction)(this->data[0] != 0); }
+
+                ::Direction chain_right_dir() const { return (::Direction)(this->data[1] != 0); }
+
+                /// `0` means fully off while `0xFF` means fully on
+                uint8_t chain_left_duty() const { return this->data[2]; }
+
+                /// `0` means fully off while `0xFF` means fully on
+                uint8_t chain_right_duty() const { return this->data[3]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::Movement get() const {
+                    bugsy::Movement value;
+                    value.chain_left_dir = this->chain_left_dir();
+                    value.chain_right_dir = this->chain_right_dir();
+                    value.chain_left_duty = this->chain_left_duty();
+                    value.chain_right_duty = this->chain_right_duty();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// A movement with all the information how to adjust the PWM signals (in place encoder)
+            class MovementBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MovementBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                MovementBuilder& chain_left_dir(::Direction value) {
+                    this->data[0] = (uint8_t)value;
+                    return *this;
+                }
+
+                MovementBuilder& chain_right_dir(::Direction value) {
+                    this->data[1] = (uint8_t)value;
+                    return *this;
+                }
+
+                /// `0` means fully off while `0xFF` means fully on
+                MovementBuilder& chain_left_duty(uint8_t value) {
+                    this->data[2] = value;
+                    return *this;
+                }
+
+                /// `0` means fully off while `0xFF` means fully on
+                MovementBuilder& chain_right_duty(uint8_t value) {
+                    this->data[3] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                MovementBuilder& set(const bugsy::Movement& value) {
+                    this->chain_left_dir(value.chain_left_dir);
+                    this->chain_right_dir(value.chain_right_dir);
+                    this->chain_left_duty(value.chain_left_duty);
+                    this->chain_right_duty(value.chain_right_duty);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* MOVE STAMP */
+            /// Optional header in front of the arguments of `Move` and `Drive` (read only view)
+            class MoveStampView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MoveStampView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Send time in milliseconds of the client clock
+                uint32_t stamp() const { return wire::get_u32(this->data + 0); }
+
+                /// Sequence number, incremented for every movement
+                uint16_t seq() const { return wire::get_u16(this->data + 4); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::MoveStamp get() const {
+                    bugsy::MoveStamp value;
+                    value.stamp = this->stamp();
+                    value.seq = this->seq();
+                    for (uint8_t i = 0; i < 2; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Optional header in front of the arguments of `Move` and `Drive` (in place encoder)
+            class MoveStampBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MoveStampBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Send time in milliseconds of the client clock
+                MoveStampBuilder& stamp(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                /// Sequence number, incremented for every movement
+                MoveStampBuilder& seq(uint16_t value) {
+                    wire::put_u16(this->data + 4, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                MoveStampBuilder& set(const bugsy::MoveStamp& value) {
+                    this->stamp(value.stamp);
+                    this->seq(value.seq);
+                    for (uint8_t i = 0; i < 2; i++) { this->data[6 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* MOVE STATS */
+            /// Statistics of the movement mailbox of the core (read only view)
+            class MoveStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MoveStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t accepted() const { return wire::get_u32(this->data + 0); }
+
+                uint32_t superseded() const { return wire::get_u32(this->data + 4); }
+
+                uint32_t out_of_order() const { return wire::get_u32(this->data + 8); }
+
+                uint32_t expired() const { return wire::get_u32(this->data + 12); }
+
+                uint16_t last_seq() const { return wire::get_u16(this->data + 16); }
+
+                /// Age of the last stamped movement in milliseconds
+                uint16_t last_age() const { return wire::get_u16(this->data + 18); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::MoveStats get() const {
+                    bugsy::MoveStats value;
+                    value.accepted = this->accepted();
+                    value.superseded = this->superseded();
+                    value.out_of_order = this->out_of_order();
+                    value.expired = this->expired();
+                    value.last_seq = this->last_seq();
+                    value.last_age = this->last_age();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Statistics of the movement mailbox of the core (in place encoder)
+            class MoveStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                MoveStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                MoveStatsBuilder& accepted(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                MoveStatsBuilder& superseded(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                MoveStatsBuilder& out_of_order(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                MoveStatsBuilder& expired(uint32_t value) {
+                    wire::put_u32(this->data + 12, value);
+                    return *this;
+                }
+
+                MoveStatsBuilder& last_seq(uint16_t value) {
+                    wire::put_u16(this->data + 16, value);
+                    return *this;
+                }
+
+                /// Age of the last stamped movement in milliseconds
+                MoveStatsBuilder& last_age(uint16_t value) {
+                    wire::put_u16(this->data + 18, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                MoveStatsBuilder& set(const bugsy::MoveStats& value) {
+                    this->accepted(value.accepted);
+                    this->superseded(value.superseded);
+                    this->out_of_order(value.out_of_order);
+                    this->expired(value.expired);
+                    this->last_seq(value.last_seq);
+                    this->last_age(value.last_age);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* LINK STATS */
+            /// Link statistics of a remote, gathered from the movements it sends (read only view)
+            class LinkStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                LinkStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t received() const { return wire::get_u32(this->data + 0); }
+
+                /// Movements missing in the sequence of the stamped ones
+                uint32_t lost() const { return wire::get_u32(this->data + 4); }
+
+                /// Last round trip reported by the client in microseconds
+                uint32_t rtt() const { return wire::get_u32(this->data + 8); }
+
+                /// Average time between two movements in milliseconds
+                uint16_t interval() const { return wire::get_u16(this->data + 12); }
+
+                /// Average deviation from the interval in milliseconds
+                uint16_t jitter() const { return wire::get_u16(this->data + 14); }
+
+                /// Current failsafe window in milliseconds
+                uint16_t window() const { return wire::get_u16(this->data + 16); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::LinkStats get() const {
+                    bugsy::LinkStats value;
+                    value.received = this->received();
+                    value.lost = this->lost();
+                    value.rtt = this->rtt();
+                    value.interval = this->interval();
+                    value.jitter = this->jitter();
+                    value.window = this->window();
+                    for (uint8_t i = 0; i < 2; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Link statistics of a remote, gathered from the movements it sends (in place encoder)
+            class LinkStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                LinkStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                LinkStatsBuilder& received(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                /// Movements missing in the sequence of the stamped ones
+                LinkStatsBuilder& lost(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// Last round trip reported by the client in microseconds
+                LinkStatsBuilder& rtt(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                /// Average time between two movements in milliseconds
+                LinkStatsBuilder& interval(uint16_t value) {
+                    wire::put_u16(this->data + 12, value);
+                    return *this;
+                }
+
+                /// Average deviation from the interval in milliseconds
+                LinkStatsBuilder& jitter(uint16_t value) {
+                    wire::put_u16(this->data + 14, value);
+                    return *this;
+                }
+
+                /// Current failsafe window in milliseconds
+                LinkStatsBuilder& window(uint16_t value) {
+                    wire::put_u16(this->data + 16, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                LinkStatsBuilder& set(const bugsy::LinkStats& value) {
+                    this->received(value.received);
+                    this->lost(value.lost);
+                    this->rtt(value.rtt);
+                    this->interval(value.interval);
+                    this->jitter(value.jitter);
+                    this->window(value.window);
+                    for (uint8_t i = 0; i < 2; i++) { this->data[18 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* FAILSAFE CONFIG */
+            /// Bounds of the adaptive movement failsafe (read only view)
+            class FailsafeConfigView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                FailsafeConfigView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// In milliseconds
+                uint16_t min_window() const { return wire::get_u16(this->data + 0); }
+
+                /// In milliseconds
+                uint16_t max_window() const { return wire::get_u16(this->data + 2); }
+
+                uint8_t jitter_factor() const { return this->data[4]; }
+
+                uint8_t adaptive() const { return this->data[5]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::FailsafeConfig get() const {
+                    bugsy::FailsafeConfig value;
+                    value.min_window = this->min_window();
+                    value.max_window = this->max_window();
+                    value.jitter_factor = this->jitter_factor();
+                    value.adaptive = this->adaptive();
+                    for (uint8_t i = 0; i < 2; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Bounds of the adaptive movement failsafe (in place encoder)
+            class FailsafeConfigBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                FailsafeConfigBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// In milliseconds
+                FailsafeConfigBuilder& min_window(uint16_t value) {
+                    wire::put_u16(this->data + 0, value);
+                    return *this;
+                }
+
+                /// In milliseconds
+                FailsafeConfigBuilder& max_window(uint16_t value) {
+                    wire::put_u16(this->data + 2, value);
+                    return *this;
+                }
+
+                FailsafeConfigBuilder& jitter_factor(uint8_t value) {
+                    this->data[4] = value;
+                    return *this;
+                }
+
+                FailsafeConfigBuilder& adaptive(uint8_t value) {
+                    this->data[5] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                FailsafeConfigBuilder& set(const bugsy::FailsafeConfig& value) {
+                    this->min_window(value.min_window);
+                    this->max_window(value.max_window);
+                    this->jitter_factor(value.jitter_factor);
+                    this->adaptive(value.adaptive);
+                    for (uint8_t i = 0; i < 2; i++) { this->data[6 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* VELOCITY */
+            /// A velocity of the whole robot, converted into a `Movement` by the core (read only view)
+            class VelocityView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                VelocityView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Forward speed in mm/s
+                int16_t linear() const { return (int16_t)wire::get_u16(this->data + 0); }
+
+                /// Rotation speed in mrad/s, positive turns left
+                int16_t angular() const { return (int16_t)wire::get_u16(this->data + 2); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::Velocity get() const {
+                    bugsy::Velocity value;
+                    value.linear = this->linear();
+                    value.angular = this->angular();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// A velocity of the whole robot, converted into a `Movement` by the core (in place encoder)
+            class VelocityBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                VelocityBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Forward speed in mm/s
+                VelocityBuilder& linear(int16_t value) {
+                    wire::put_u16(this->data + 0, (uint16_t)value);
+                    return *this;
+                }
+
+                /// Rotation speed in mrad/s, positive turns left
+                VelocityBuilder& angular(int16_t value) {
+                    wire::put_u16(this->data + 2, (uint16_t)value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                VelocityBuilder& set(const bugsy::Velocity& value) {
+                    this->linear(value.linear);
+                    this->angular(value.angular);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SCHEDULED MOVE */
+            /// A movement to be applied at a given time (read only view)
+            class ScheduledMoveView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduledMoveView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Time in microseconds of the core clock
+                uint32_t at() const { return wire::get_u32(this->data + 0); }
+
+                MovementView move() const { return MovementView(this->data + 4, 4); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::ScheduledMove get() const {
+                    bugsy::ScheduledMove value;
+                    value.at = this->at();
+                    value.move = this->move().get();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// A movement to be applied at a given time (in place encoder)
+            class ScheduledMoveBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduledMoveBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Time in microseconds of the core clock
+                ScheduledMoveBuilder& at(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                MovementBuilder move() { return MovementBuilder(this->data + 4, 4); }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                ScheduledMoveBuilder& set(const bugsy::ScheduledMove& value) {
+                    this->at(value.at);
+                    this->move().set(value.move);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SCHEDULED VELOCITY */
+            /// A velocity to drive with from a given time on (read only view)
+            class ScheduledVelocityView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduledVelocityView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Time in microseconds of the core clock
+                uint32_t at() const { return wire::get_u32(this->data + 0); }
+
+                VelocityView vel() const { return VelocityView(this->data + 4, 4); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::ScheduledVelocity get() const {
+                    bugsy::ScheduledVelocity value;
+                    value.at = this->at();
+                    value.vel = this->vel().get();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// A velocity to drive with from a given time on (in place encoder)
+            class ScheduledVelocityBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduledVelocityBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Time in microseconds of the core clock
+                ScheduledVelocityBuilder& at(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                VelocityBuilder vel() { return VelocityBuilder(this->data + 4, 4); }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                ScheduledVelocityBuilder& set(const bugsy::ScheduledVelocity& value) {
+                    this->at(value.at);
+                    this->vel().set(value.vel);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SCHEDULE STATS */
+            /// Statistics of the scheduled movements of the core (read only view)
+            class ScheduleStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduleStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t scheduled() const { return wire::get_u32(this->data + 0); }
+
+                uint32_t executed() const { return wire::get_u32(this->data + 4); }
+
+                uint32_t rejected() const { return wire::get_u32(this->data + 8); }
+
+                /// In microseconds
+                uint16_t lateness_avg() const { return wire::get_u16(this->data + 12); }
+
+                /// In microseconds
+                uint16_t lateness_max() const { return wire::get_u16(this->data + 14); }
+
+                uint8_t pending() const { return this->data[16]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::ScheduleStats get() const {
+                    bugsy::ScheduleStats value;
+                    value.scheduled = this->scheduled();
+                    value.executed = this->executed();
+                    value.rejected = this->rejected();
+                    value.lateness_avg = this->lateness_avg();
+                    value.lateness_max = this->lateness_max();
+                    value.pending = this->pending();
+                    for (uint8_t i = 0; i < 3; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Statistics of the scheduled movements of the core (in place encoder)
+            class ScheduleStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ScheduleStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                ScheduleStatsBuilder& scheduled(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                ScheduleStatsBuilder& executed(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                ScheduleStatsBuilder& rejected(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                ScheduleStatsBuilder& lateness_avg(uint16_t value) {
+                    wire::put_u16(this->data + 12, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                ScheduleStatsBuilder& lateness_max(uint16_t value) {
+                    wire::put_u16(this->data + 14, value);
+                    return *this;
+                }
+
+                ScheduleStatsBuilder& pending(uint8_t value) {
+                    this->data[16] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                ScheduleStatsBuilder& set(const bugsy::ScheduleStats& value) {
+                    this->scheduled(value.scheduled);
+                    this->executed(value.executed);
+                    this->rejected(value.rejected);
+                    this->lateness_avg(value.lateness_avg);
+                    this->lateness_max(value.lateness_max);
+                    this->pending(value.pending);
+                    for (uint8_t i = 0; i < 3; i++) { this->data[17 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* DRIVE CALIBRATION */
+            /// Calibration of the velocity drive mode (read only view)
+            class DriveCalibrationView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 38;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                DriveCalibrationView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Speed of the chains at full duty in mm/s
+                uint16_t max_speed() const { return wire::get_u16(this->data + 0); }
+
+                /// Distance between the chains in mm
+                uint16_t track_width() const { return wire::get_u16(this->data + 2); }
+
+                /// Duty linearization table of the left chain
+                const uint8_t* left() const { return this->data + 4; }
+
+                /// Duty linearization table of the right chain
+                const uint8_t* right() const { return this->data + 21; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::DriveCalibration get() const {
+                    bugsy::DriveCalibration value;
+                    value.max_speed = this->max_speed();
+                    value.track_width = this->track_width();
+                    for (uint8_t i = 0; i < 17; i++) { value.left[i] = this->data[4 + i]; }
+                    for (uint8_t i = 0; i < 17; i++) { value.right[i] = this->data[21 + i]; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Calibration of the velocity drive mode (in place encoder)
+            class DriveCalibrationBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 38;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                DriveCalibrationBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Speed of the chains at full duty in mm/s
+                DriveCalibrationBuilder& max_speed(uint16_t value) {
+                    wire::put_u16(this->data + 0, value);
+                    return *this;
+                }
+
+                /// Distance between the chains in mm
+                DriveCalibrationBuilder& track_width(uint16_t value) {
+                    wire::put_u16(this->data + 2, value);
+                    return *this;
+                }
+
+                /// Duty linearization table of the left chain
+                DriveCalibrationBuilder& left(const uint8_t* values) {
+                    for (uint8_t i = 0; i < 17; i++) { this->data[4 + i] = values[i]; }
+                    return *this;
+                }
+
+                /// Duty linearization table of the right chain
+                DriveCalibrationBuilder& right(const uint8_t* values) {
+                    for (uint8_t i = 0; i < 17; i++) { this->data[21 + i] = values[i]; }
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                DriveCalibrationBuilder& set(const bugsy::DriveCalibration& value) {
+                    this->max_speed(value.max_speed);
+                    this->track_width(value.track_width);
+                    this->left(value.left);
+                    this->right(value.right);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SPEED GAINS */
+            /// Gains of the chain speed controllers with 8 fractional bits (read only view)
+            class SpeedGainsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SpeedGainsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint16_t kp() const { return wire::get_u16(this->data + 0); }
+
+                uint16_t ki() const { return wire::get_u16(this->data + 2); }
+
+                uint16_t kd() const { return wire::get_u16(this->data + 4); }
+
+                uint8_t enabled() const { return this->data[6]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::SpeedGains get() const {
+                    bugsy::SpeedGains value;
+                    value.kp = this->kp();
+                    value.ki = this->ki();
+                    value.kd = this->kd();
+                    value.enabled = this->enabled();
+                    value.reserved = 0;
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Gains of the chain speed controllers with 8 fractional bits (in place encoder)
+            class SpeedGainsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SpeedGainsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                SpeedGainsBuilder& kp(uint16_t value) {
+                    wire::put_u16(this->data + 0, value);
+                    return *this;
+                }
+
+                SpeedGainsBuilder& ki(uint16_t value) {
+                    wire::put_u16(this->data + 2, value);
+                    return *this;
+                }
+
+                SpeedGainsBuilder& kd(uint16_t value) {
+                    wire::put_u16(this->data + 4, value);
+                    return *this;
+                }
+
+                SpeedGainsBuilder& enabled(uint8_t value) {
+                    this->data[6] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                SpeedGainsBuilder& set(const bugsy::SpeedGains& value) {
+                    this->kp(value.kp);
+                    this->ki(value.ki);
+                    this->kd(value.kd);
+                    this->enabled(value.enabled);
+                    for (uint8_t i = 0; i < 1; i++) { this->data[7 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SPEED STATS */
+            /// State and statistics of the closed-loop chain speed control (read only view)
+            class SpeedStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 24;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SpeedStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t ticks() const { return wire::get_u32(this->data + 0); }
+
+                uint16_t jitter_avg() const { return wire::get_u16(this->data + 4); }
+
+                uint16_t jitter_max() const { return wire::get_u16(this->data + 6); }
+
+                int16_t target_left() const { return (int16_t)wire::get_u16(this->data + 8); }
+
+                int16_t target_right() const { return (int16_t)wire::get_u16(this->data + 10); }
+
+                int16_t speed_left() const { return (int16_t)wire::get_u16(this->data + 12); }
+
+                int16_t speed_right() const { return (int16_t)wire::get_u16(this->data + 14); }
+
+                uint16_t error_left() const { return wire::get_u16(this->data + 16); }
+
+                uint16_t error_right() const { return wire::get_u16(this->data + 18); }
+
+                uint8_t active() const { return this->data[20]; }
+
+                uint8_t saturated() const { return this->data[21]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::SpeedStats get() const {
+                    bugsy::SpeedStats value;
+                    value.ticks = this->ticks();
+                    value.jitter_avg = this->jitter_avg();
+                    value.jitter_max = this->jitter_max();
+                    value.target_left = this->target_left();
+                    value.target_right = this->target_right();
+                    value.speed_left = this->speed_left();
+                    value.speed_right = this->speed_right();
+                    value.error_left = this->error_left();
+                    value.error_right = this->error_right();
+                    value.active = this->active();
+                    value.saturated = this->saturated();
+                    for (uint8_t i = 0; i < 2; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// State and statistics of the closed-loop chain speed control (in place encoder)
+            class SpeedStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 24;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SpeedStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                SpeedStatsBuilder& ticks(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& jitter_avg(uint16_t value) {
+                    wire::put_u16(this->data + 4, value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& jitter_max(uint16_t value) {
+                    wire::put_u16(this->data + 6, value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& target_left(int16_t value) {
+                    wire::put_u16(this->data + 8, (uint16_t)value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& target_right(int16_t value) {
+                    wire::put_u16(this->data + 10, (uint16_t)value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& speed_left(int16_t value) {
+                    wire::put_u16(this->data + 12, (uint16_t)value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& speed_right(int16_t value) {
+                    wire::put_u16(this->data + 14, (uint16_t)value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& error_left(uint16_t value) {
+                    wire::put_u16(this->data + 16, value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& error_right(uint16_t value) {
+                    wire::put_u16(this->data + 18, value);
+                    return *this;
+                }
+
+                SpeedStatsBuilder& active(uint8_t value) {
+                    this->data[20] = value;
+                    return *this;
+                }
+
+                SpeedStatsBuilder& saturated(uint8_t value) {
+                    this->data[21] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                SpeedStatsBuilder& set(const bugsy::SpeedStats& value) {
+                    this->ticks(value.ticks);
+                    this->jitter_avg(value.jitter_avg);
+                    this->jitter_max(value.jitter_max);
+                    this->target_left(value.target_left);
+                    this->target_right(value.target_right);
+                    this->speed_left(value.speed_left);
+                    this->speed_right(value.speed_right);
+                    this->error_left(value.error_left);
+                    this->error_right(value.error_right);
+                    this->active(value.active);
+                    this->saturated(value.saturated);
+                    for (uint8_t i = 0; i < 2; i++) { this->data[22 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* CLOCK SAMPLE */
+            /// Answer of the core to `SyncClock`, all times in microseconds (read only view)
+            class ClockSampleView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 12;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ClockSampleView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t client_send() const { return wire::get_u32(this->data + 0); }
+
+                uint32_t core_receive() const { return wire::get_u32(this->data + 4); }
+
+                uint32_t core_send() const { return wire::get_u32(this->data + 8); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::ClockSample get() const {
+                    bugsy::ClockSample value;
+                    value.client_send = this->client_send();
+                    value.core_receive = this->core_receive();
+                    value.core_send = this->core_send();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Answer of the core to `SyncClock`, all times in microseconds (in place encoder)
+            class ClockSampleBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 12;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ClockSampleBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                ClockSampleBuilder& client_send(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                ClockSampleBuilder& core_receive(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                ClockSampleBuilder& core_send(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                ClockSampleBuilder& set(const bugsy::ClockSample& value) {
+                    this->client_send(value.client_send);
+                    this->core_receive(value.core_receive);
+                    this->core_send(value.core_send);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* OTA IMAGE */
+            /// The firmware image of an update (read only view)
+            class OtaImageView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                OtaImageView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// In bytes
+                uint32_t size() const { return wire::get_u32(this->data + 0); }
+
+                /// CRC-32 of the whole image
+                uint32_t crc() const { return wire::get_u32(this->data + 4); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::OtaImage get() const {
+                    bugsy::OtaImage value;
+                    value.size = this->size();
+                    value.crc = this->crc();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// The firmware image of an update (in place encoder)
+            class OtaImageBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                OtaImageBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// In bytes
+                OtaImageBuilder& size(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                /// CRC-32 of the whole image
+                OtaImageBuilder& crc(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                OtaImageBuilder& set(const bugsy::OtaImage& value) {
+                    this->size(value.size);
+                    this->crc(value.crc);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* OTA STATUS */
+            /// Progress of the firmware update of the core (read only view)
+            class OtaStatusView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 24;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                OtaStatusView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Size of the image in bytes
+                uint32_t size() const { return wire::get_u32(this->data + 0); }
+
+                /// CRC-32 of the image
+                uint32_t crc() const { return wire::get_u32(this->data + 4); }
+
+                /// Bytes written to the flash
+                uint32_t written() const { return wire::get_u32(this->data + 8); }
+
+                /// Bit `i` set if chunk `next + i` has not been received
+                uint32_t missing() const { return wire::get_u32(this->data + 12); }
+
+                /// First chunk not received yet
+                uint16_t next() const { return wire::get_u16(this->data + 16); }
+
+                /// Amount of chunks of the image
+                uint16_t chunks() const { return wire::get_u16(this->data + 18); }
+
+                /// Chunks dropped (broken CRC, write queue full)
+                uint16_t dropped() const { return wire::get_u16(this->data + 20); }
+
+                bugsy::OtaState state() const { return (bugsy::OtaState)this->data[22]; }
+
+                /// Chunks the client may send before asking for the status
+                uint8_t window() const { return this->data[23]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::OtaStatus get() const {
+                    bugsy::OtaStatus value;
+                    value.size = this->size();
+                    value.crc = this->crc();
+                    value.written = this->written();
+                    value.missing = this->missing();
+                    value.next = this->next();
+                    value.chunks = this->chunks();
+                    value.dropped = this->dropped();
+                    value.state = this->state();
+                    value.window = this->window();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Progress of the firmware update of the core (in place encoder)
+            class OtaStatusBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 24;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                OtaStatusBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Size of the image in bytes
+                OtaStatusBuilder& size(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                /// CRC-32 of the image
+                OtaStatusBuilder& crc(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// Bytes written to the flash
+                OtaStatusBuilder& written(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                /// Bit `i` set if chunk `next + i` has not been received
+                OtaStatusBuilder& missing(uint32_t value) {
+                    wire::put_u32(this->data + 12, value);
+                    return *this;
+                }
+
+                /// First chunk not received yet
+                OtaStatusBuilder& next(uint16_t value) {
+                    wire::put_u16(this->data + 16, value);
+                    return *this;
+                }
+
+                /// Amount of chunks of the image
+                OtaStatusBuilder& chunks(uint16_t value) {
+                    wire::put_u16(this->data + 18, value);
+                    return *this;
+                }
+
+                /// Chunks dropped (broken CRC, write queue full)
+                OtaStatusBuilder& dropped(uint16_t value) {
+                    wire::put_u16(this->data + 20, value);
+                    return *this;
+                }
+
+                OtaStatusBuilder& state(bugsy::OtaState value) {
+                    this->data[22] = (uint8_t)value;
+                    return *this;
+                }
+
+                /// Chunks the client may send before asking for the status
+                OtaStatusBuilder& window(uint8_t value) {
+                    this->data[23] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                OtaStatusBuilder& set(const bugsy::OtaStatus& value) {
+                    this->size(value.size);
+                    this->crc(value.crc);
+                    this->written(value.written);
+                    this->missing(value.missing);
+                    this->next(value.next);
+                    this->chunks(value.chunks);
+                    this->dropped(value.dropped);
+                    this->state(value.state);
+                    this->window(value.window);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* BAUD STATS */
+            /// Negotiated baud rate and error counters of a link between the core and another MCU (read only view)
+            class BaudStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                BaudStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t baud() const { return wire::get_u32(this->data + 0); }
+
+                /// Test frames received while probing rates
+                uint32_t test_frames() const { return wire::get_u32(this->data + 4); }
+
+                /// Test frames received with a broken CRC
+                uint32_t test_errors() const { return wire::get_u32(this->data + 8); }
+
+                /// Receive errors at the current rate
+                uint32_t rx_errors() const { return wire::get_u32(this->data + 12); }
+
+                uint16_t negotiations() const { return wire::get_u16(this->data + 16); }
+
+                /// Returns to the base rate
+                uint16_t fallbacks() const { return wire::get_u16(this->data + 18); }
+
+                /// @brief Copies the message into the native struct
+                bugsy::BaudStats get() const {
+                    bugsy::BaudStats value;
+                    value.baud = this->baud();
+                    value.test_frames = this->test_frames();
+                    value.test_errors = this->test_errors();
+                    value.rx_errors = this->rx_errors();
+                    value.negotiations = this->negotiations();
+                    value.fallbacks = this->fallbacks();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Negotiated baud rate and error counters of a link between the core and another MCU (in place encoder)
+            class BaudStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 20;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                BaudStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                BaudStatsBuilder& baud(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                /// Test frames received while probing rates
+                BaudStatsBuilder& test_frames(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// Test frames received with a broken CRC
+                BaudStatsBuilder& test_errors(uint32_t value) {
+                    wire::put_u32(this->data + 8, value);
+                    return *this;
+                }
+
+                /// Receive errors at the current rate
+                BaudStatsBuilder& rx_errors(uint32_t value) {
+                    wire::put_u32(this->data + 12, value);
+                    return *this;
+                }
+
+                BaudStatsBuilder& negotiations(uint16_t value) {
+                    wire::put_u16(this->data + 16, value);
+                    return *this;
+                }
+
+                /// Returns to the base rate
+                BaudStatsBuilder& fallbacks(uint16_t value) {
+                    wire::put_u16(this->data + 18, value);
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                BaudStatsBuilder& set(const bugsy::BaudStats& value) {
+                    this->baud(value.baud);
+                    this->test_frames(value.test_frames);
+                    this->test_errors(value.test_errors);
+                    this->rx_errors(value.rx_errors);
+                    this->negotiations(value.negotiations);
+                    this->fallbacks(value.fallbacks);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SERVO MOVE */
+            /// Moves a servo to a new angle (read only view)
+            class ServoMoveView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ServoMoveView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// Target angle in 0.1 degrees
+                uint16_t angle() const { return wire::get_u16(this->data + 0); }
+
+                /// Time to reach the target in milliseconds
+                uint16_t duration() const { return wire::get_u16(this->data + 2); }
+
+                bugsy::Servo servo() const { return (bugsy::Servo)this->data[4]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::ServoMove get() const {
+                    bugsy::ServoMove value;
+                    value.angle = this->angle();
+                    value.duration = this->duration();
+                    value.servo = this->servo();
+                    for (uint8_t i = 0; i < 3; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Moves a servo to a new angle (in place encoder)
+            class ServoMoveBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                ServoMoveBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// Target angle in 0.1 degrees
+                ServoMoveBuilder& angle(uint16_t value) {
+                    wire::put_u16(this->data + 0, value);
+                    return *this;
+                }
+
+                /// Time to reach the target in milliseconds
+                ServoMoveBuilder& duration(uint16_t value) {
+                    wire::put_u16(this->data + 2, value);
+                    return *this;
+                }
+
+                ServoMoveBuilder& servo(bugsy::Servo value) {
+                    this->data[4] = (uint8_t)value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                ServoMoveBuilder& set(const bugsy::ServoMove& value) {
+                    this->angle(value.angle);
+                    this->duration(value.duration);
+                    this->servo(value.servo);
+                    for (uint8_t i = 0; i < 3; i++) { this->data[5 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* ESTOP STATS */
+            /// State and latency statistics of the emergency stop line (read only view)
+            class EStopStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 16;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                EStopStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                uint32_t triggers() const { return wire::get_u32(this->data + 0); }
+
+                uint32_t violations() const { return wire::get_u32(this->data + 4); }
+
+                /// In microseconds
+                uint16_t latency_last() const { return wire::get_u16(this->data + 8); }
+
+                /// In microseconds
+                uint16_t latency_max() const { return wire::get_u16(this->data + 10); }
+
+                uint8_t active() const { return this->data[12]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::EStopStats get() const {
+                    bugsy::EStopStats value;
+                    value.triggers = this->triggers();
+                    value.violations = this->violations();
+                    value.latency_last = this->latency_last();
+                    value.latency_max = this->latency_max();
+                    value.active = this->active();
+                    for (uint8_t i = 0; i < 3; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// State and latency statistics of the emergency stop line (in place encoder)
+            class EStopStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 16;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                EStopStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                EStopStatsBuilder& triggers(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                EStopStatsBuilder& violations(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                EStopStatsBuilder& latency_last(uint16_t value) {
+                    wire::put_u16(this->data + 8, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                EStopStatsBuilder& latency_max(uint16_t value) {
+                    wire::put_u16(this->data + 10, value);
+                    return *this;
+                }
+
+                EStopStatsBuilder& active(uint8_t value) {
+                    this->data[12] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                EStopStatsBuilder& set(const bugsy::EStopStats& value) {
+                    this->triggers(value.triggers);
+                    this->violations(value.violations);
+                    this->latency_last(value.latency_last);
+                    this->latency_max(value.latency_max);
+                    this->active(value.active);
+                    for (uint8_t i = 0; i < 3; i++) { this->data[13 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* BATTERY STATE */
+            /// The state of the battery pack as measured by the core (read only view)
+            class BatteryStateView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                BatteryStateView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// In millivolts
+                uint16_t voltage() const { return wire::get_u16(this->data + 0); }
+
+                /// In percent
+                uint8_t charge() const { return this->data[2]; }
+
+                uint8_t duty_limit() const { return this->data[3]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::BatteryState get() const {
+                    bugsy::BatteryState value;
+                    value.voltage = this->voltage();
+                    value.charge = this->charge();
+                    value.duty_limit = this->duty_limit();
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// The state of the battery pack as measured by the core (in place encoder)
+            class BatteryStateBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 4;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                BatteryStateBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// In millivolts
+                BatteryStateBuilder& voltage(uint16_t value) {
+                    wire::put_u16(this->data + 0, value);
+                    return *this;
+                }
+
+                /// In percent
+                BatteryStateBuilder& charge(uint8_t value) {
+                    this->data[2] = value;
+                    return *this;
+                }
+
+                BatteryStateBuilder& duty_limit(uint8_t value) {
+                    this->data[3] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                BatteryStateBuilder& set(const bugsy::BatteryState& value) {
+                    this->voltage(value.voltage);
+                    this->charge(value.charge);
+                    this->duty_limit(value.duty_limit);
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* POWER STATS */
+            /// Statistics of the idle power management of the core (read only view)
+            class PowerStatsView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 16;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                PowerStatsView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// In milliseconds
+                uint32_t sleep_time() const { return wire::get_u32(this->data + 0); }
+
+                uint32_t sleeps() const { return wire::get_u32(this->data + 4); }
+
+                /// In microseconds
+                uint16_t wake_latency_avg() const { return wire::get_u16(this->data + 8); }
+
+                /// In microseconds
+                uint16_t wake_latency_max() const { return wire::get_u16(this->data + 10); }
+
+                uint8_t low_power() const { return this->data[12]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::PowerStats get() const {
+                    bugsy::PowerStats value;
+                    value.sleep_time = this->sleep_time();
+                    value.sleeps = this->sleeps();
+                    value.wake_latency_avg = this->wake_latency_avg();
+                    value.wake_latency_max = this->wake_latency_max();
+                    value.low_power = this->low_power();
+                    for (uint8_t i = 0; i < 3; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Statistics of the idle power management of the core (in place encoder)
+            class PowerStatsBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 16;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                PowerStatsBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// In milliseconds
+                PowerStatsBuilder& sleep_time(uint32_t value) {
+                    wire::put_u32(this->data + 0, value);
+                    return *this;
+                }
+
+                PowerStatsBuilder& sleeps(uint32_t value) {
+                    wire::put_u32(this->data + 4, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                PowerStatsBuilder& wake_latency_avg(uint16_t value) {
+                    wire::put_u16(this->data + 8, value);
+                    return *this;
+                }
+
+                /// In microseconds
+                PowerStatsBuilder& wake_latency_max(uint16_t value) {
+                    wire::put_u16(this->data + 10, value);
+                    return *this;
+                }
+
+                PowerStatsBuilder& low_power(uint8_t value) {
+                    this->data[12] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                PowerStatsBuilder& set(const bugsy::PowerStats& value) {
+                    this->sleep_time(value.sleep_time);
+                    this->sleeps(value.sleeps);
+                    this->wake_latency_avg(value.wake_latency_avg);
+                    this->wake_latency_max(value.wake_latency_max);
+                    this->low_power(value.low_power);
+                    for (uint8_t i = 0; i < 3; i++) { this->data[13 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* PRIMARY SENSOR DATA */
+            /// Sensor data of the trader required for operating the robot (read only view)
+            class PrimarySensorDataView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                PrimarySensorDataView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                int32_t encoder_position() const { return (int32_t)wire::get_u32(this->data + 0); }
+
+                uint8_t encoder_pressed() const { return this->data[4]; }
+
+                uint8_t obstacle() const { return this->data[5]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::PrimarySensorData get() const {
+                    bugsy::PrimarySensorData value;
+                    value.encoder_position = this->encoder_position();
+                    value.encoder_pressed = this->encoder_pressed();
+                    value.obstacle = this->obstacle();
+                    for (uint8_t i = 0; i < 2; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Sensor data of the trader required for operating the robot (in place encoder)
+            class PrimarySensorDataBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                PrimarySensorDataBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                PrimarySensorDataBuilder& encoder_position(int32_t value) {
+                    wire::put_u32(this->data + 0, (uint32_t)value);
+                    return *this;
+                }
+
+                PrimarySensorDataBuilder& encoder_pressed(uint8_t value) {
+                    this->data[4] = value;
+                    return *this;
+                }
+
+                PrimarySensorDataBuilder& obstacle(uint8_t value) {
+                    this->data[5] = value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                PrimarySensorDataBuilder& set(const bugsy::PrimarySensorData& value) {
+                    this->encoder_position(value.encoder_position);
+                    this->encoder_pressed(value.encoder_pressed);
+                    this->obstacle(value.obstacle);
+                    for (uint8_t i = 0; i < 2; i++) { this->data[6 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* SECONDARY SENSOR DATA */
+            /// Less important sensor data of the trader, sampled rarely (read only view)
+            class SecondarySensorDataView {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SecondarySensorDataView(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer holds the whole message, the accessors must only be used if it does
+                bool valid() const { return this->data != nullptr; }
+
+                /// @brief The raw bytes of the message
+                const uint8_t* bytes() const { return this->data; }
+
+                /// In 0.1 degrees celsius
+                int16_t temperature() const { return (int16_t)wire::get_u16(this->data + 0); }
+
+                /// In 0.1 percent
+                uint16_t humidity() const { return wire::get_u16(this->data + 2); }
+
+                bugsy::SensorStatus dht_status() const { return (bugsy::SensorStatus)this->data[4]; }
+
+                /// @brief Copies the message into the native struct
+                bugsy::SecondarySensorData get() const {
+                    bugsy::SecondarySensorData value;
+                    value.temperature = this->temperature();
+                    value.humidity = this->humidity();
+                    value.dht_status = this->dht_status();
+                    for (uint8_t i = 0; i < 3; i++) { value.reserved[i] = 0; }
+                    return value;
+                }
+
+            private:
+                const uint8_t* data;
+            };
+
+            /// Less important sensor data of the trader, sampled rarely (in place encoder)
+            class SecondarySensorDataBuilder {
+            public:
+                /// Size of the message on the wire
+                static const size_t SIZE = 8;
+
+                /// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short
+                SecondarySensorDataBuilder(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }
+
+                /// @brief Whether the buffer can hold the whole message, the setters must only be used if it can
+                bool valid() const { return this->data != nullptr; }
+
+                /// In 0.1 degrees celsius
+                SecondarySensorDataBuilder& temperature(int16_t value) {
+                    wire::put_u16(this->data + 0, (uint16_t)value);
+                    return *this;
+                }
+
+                /// In 0.1 percent
+                SecondarySensorDataBuilder& humidity(uint16_t value) {
+                    wire::put_u16(this->data + 2, value);
+                    return *this;
+                }
+
+                SecondarySensorDataBuilder& dht_status(bugsy::SensorStatus value) {
+                    this->data[4] = (uint8_t)value;
+                    return *this;
+                }
+
+                /// @brief Encodes the whole native struct, padding is zeroed
+                SecondarySensorDataBuilder& set(const bugsy::SecondarySensorData& value) {
+                    this->temperature(value.temperature);
+                    this->humidity(value.humidity);
+                    this->dht_status(value.dht_status);
+                    for (uint8_t i = 0; i < 3; i++) { this->data[5 + i] = 0; }
+                    return *this;
+                }
+
+            private:
+                uint8_t* data;
+            };
+        /**/
+
+        /* CHECKS */
+            // The native structs are copied to and from the wire as a whole on the (little endian) targets, their layout has
+            // to match the schema exactly
+            static_assert(sizeof(bugsy::Command) == 1, "Command must be a single byte");
+            static_assert((uint8_t)bugsy::Command::Test == 0x00, "Command::Test differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetState == 0x01, "Command::GetState differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetBattery == 0x02, "Command::GetBattery differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetPowerStats == 0x03, "Command::GetPowerStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetEStopStats == 0x04, "Command::GetEStopStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SyncClock == 0x05, "Command::SyncClock differs from the schema");
+            static_assert((uint8_t)bugsy::Command::Batch == 0x06, "Command::Batch differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetLinkStats == 0x07, "Command::GetLinkStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetFailsafeConfig == 0x08, "Command::GetFailsafeConfig differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetFailsafeConfig == 0x09, "Command::SetFailsafeConfig differs from the schema");
+            static_assert((uint8_t)bugsy::Command::ProposeBaud == 0x0A, "Command::ProposeBaud differs from the schema");
+            static_assert((uint8_t)bugsy::Command::BaudTest == 0x0B, "Command::BaudTest differs from the schema");
+            static_assert((uint8_t)bugsy::Command::ConfirmBaud == 0x0C, "Command::ConfirmBaud differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetBaudStats == 0x0D, "Command::GetBaudStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::Move == 0x10, "Command::Move differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetMoveMode == 0x11, "Command::SetMoveMode differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetMoveMode == 0x12, "Command::GetMoveMode differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetMoveConfig == 0x13, "Command::GetMoveConfig differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetMoveConfig == 0x14, "Command::SetMoveConfig differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetMovement == 0x15, "Command::GetMovement differs from the schema");
+            static_assert((uint8_t)bugsy::Command::MoveServo == 0x16, "Command::MoveServo differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetServo == 0x17, "Command::GetServo differs from the schema");
+            static_assert((uint8_t)bugsy::Command::Drive == 0x18, "Command::Drive differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetDriveCalibration == 0x19, "Command::GetDriveCalibration differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetDriveCalibration == 0x1A, "Command::SetDriveCalibration differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetSpeedStats == 0x1B, "Command::GetSpeedStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetSpeedGains == 0x1C, "Command::GetSpeedGains differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetSpeedGains == 0x1D, "Command::SetSpeedGains differs from the schema");
+            static_assert((uint8_t)bugsy::Command::Stop == 0x1E, "Command::Stop differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetMoveStats == 0x1F, "Command::GetMoveStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetTraderState == 0x20, "Command::SetTraderState differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetTraderState == 0x21, "Command::GetTraderState differs from the schema");
+            static_assert((uint8_t)bugsy::Command::PublishPrimarySensorData == 0x22, "Command::PublishPrimarySensorData differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetPrimarySensorData == 0x23, "Command::GetPrimarySensorData differs from the schema");
+            static_assert((uint8_t)bugsy::Command::PublishSecondarySensorData == 0x24, "Command::PublishSecondarySensorData differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetSecondarySensorData == 0x25, "Command::GetSecondarySensorData differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetRPiReady == 0x28, "Command::SetRPiReady differs from the schema");
+            static_assert((uint8_t)bugsy::Command::IsRPiReady == 0x29, "Command::IsRPiReady differs from the schema");
+            static_assert((uint8_t)bugsy::Command::ScheduleMove == 0x30, "Command::ScheduleMove differs from the schema");
+            static_assert((uint8_t)bugsy::Command::ScheduleDrive == 0x31, "Command::ScheduleDrive differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetScheduleStats == 0x32, "Command::GetScheduleStats differs from the schema");
+            static_assert((uint8_t)bugsy::Command::Remotes == 0x40, "Command::Remotes differs from the schema");
+            static_assert((uint8_t)bugsy::Command::RemoteConfigure == 0x41, "Command::RemoteConfigure differs from the schema");
+            static_assert((uint8_t)bugsy::Command::OtaBegin == 0x50, "Command::OtaBegin differs from the schema");
+            static_assert((uint8_t)bugsy::Command::OtaChunk == 0x51, "Command::OtaChunk differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetOtaStatus == 0x52, "Command::GetOtaStatus differs from the schema");
+            static_assert((uint8_t)bugsy::Command::OtaFinish == 0x53, "Command::OtaFinish differs from the schema");
+            static_assert((uint8_t)bugsy::Command::OtaAbort == 0x54, "Command::OtaAbort differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SaveConfig == 0x80, "Command::SaveConfig differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetJobState == 0x81, "Command::GetJobState differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetWiFiSSID == 0xA0, "Command::GetWiFiSSID differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetWiFiSSID == 0xA1, "Command::SetWiFiSSID differs from the schema");
+            static_assert((uint8_t)bugsy::Command::GetWiFiPwd == 0xA2, "Command::GetWiFiPwd differs from the schema");
+            static_assert((uint8_t)bugsy::Command::SetWiFiPwd == 0xA3, "Command::SetWiFiPwd differs from the schema");
+            static_assert(sizeof(bugsy::CoreState) == 1, "CoreState must be a single byte");
+            static_assert((uint8_t)bugsy::CoreState::NONE == 0x00, "CoreState::NONE differs from the schema");
+            static_assert((uint8_t)bugsy::CoreState::SETUP == 0x10, "CoreState::SETUP differs from the schema");
+            static_assert((uint8_t)bugsy::CoreState::STANDBY == 0x11, "CoreState::STANDBY differs from the schema");
+            static_assert((uint8_t)bugsy::CoreState::ACTIVE == 0x20, "CoreState::ACTIVE differs from the schema");
+            static_assert((uint8_t)bugsy::CoreState::DRIVING == 0x21, "CoreState::DRIVING differs from the schema");
+            static_assert((uint8_t)bugsy::CoreState::ERROR == 0xF0, "CoreState::ERROR differs from the schema");
+            static_assert(sizeof(bugsy::Remote) == 1, "Remote must be a single byte");
+            static_assert((uint8_t)bugsy::Remote::NONE == 0x00, "Remote::NONE differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::BLUETOOTH == 0x01, "Remote::BLUETOOTH differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::LORA == 0x02, "Remote::LORA differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::USB == 0x04, "Remote::USB differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::TRADER == 0x08, "Remote::TRADER differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::RPI == 0x10, "Remote::RPI differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::WIFI_TCP == 0x20, "Remote::WIFI_TCP differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::WIFI_MQTT == 0x40, "Remote::WIFI_MQTT differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::ANY_WIFI == 0x60, "Remote::ANY_WIFI differs from the schema");
+            static_assert((uint8_t)bugsy::Remote::MOD == 0x80, "Remote::MOD differs from the schema");
+            static_assert(sizeof(::Direction) == 1, "Direction must be a single byte");
+            static_assert((uint8_t)::Direction::CCW == 0x00, "Direction::CCW differs from the schema");
+            static_assert((uint8_t)::Direction::CW == 0x01, "Direction::CW differs from the schema");
+            static_assert(sizeof(bugsy::Servo) == 1, "Servo must be a single byte");
+            static_assert((uint8_t)bugsy::Servo::HEAD == 0x00, "Servo::HEAD differs from the schema");
+            static_assert(sizeof(bugsy::JobState) == 1, "JobState must be a single byte");
+            static_assert((uint8_t)bugsy::JobState::UNKNOWN == 0x00, "JobState::UNKNOWN differs from the schema");
+            static_assert((uint8_t)bugsy::JobState::QUEUED == 0x01, "JobState::QUEUED differs from the schema");
+            static_assert((uint8_t)bugsy::JobState::RUNNING == 0x02, "JobState::RUNNING differs from the schema");
+            static_assert((uint8_t)bugsy::JobState::DONE == 0x03, "JobState::DONE differs from the schema");
+            static_assert((uint8_t)bugsy::JobState::FAILED == 0x04, "JobState::FAILED differs from the schema");
+            static_assert((uint8_t)bugsy::JobState::REJECTED == 0x05, "JobState::REJECTED differs from the schema");
+            static_assert(sizeof(bugsy::OtaState) == 1, "OtaState must be a single byte");
+            static_assert((uint8_t)bugsy::OtaState::IDLE == 0x00, "OtaState::IDLE differs from the schema");
+            static_assert((uint8_t)bugsy::OtaState::ERASING == 0x01, "OtaState::ERASING differs from the schema");
+            static_assert((uint8_t)bugsy::OtaState::RECEIVING == 0x02, "OtaState::RECEIVING differs from the schema");
+            static_assert((uint8_t)bugsy::OtaState::VERIFYING == 0x03, "OtaState::VERIFYING differs from the schema");
+            static_assert((uint8_t)bugsy::OtaState::READY == 0x04, "OtaState::READY differs from the schema");
+            static_assert((uint8_t)bugsy::OtaState::FAILED == 0x80, "OtaState::FAILED differs from the schema");
+            static_assert(sizeof(bugsy::TraderState) == 1, "TraderState must be a single byte");
+            static_assert((uint8_t)bugsy::TraderState::DISCONNECTED == 0x00, "TraderState::DISCONNECTED differs from the schema");
+            static_assert((uint8_t)bugsy::TraderState::SETUP == 0x10, "TraderState::SETUP differs from the schema");
+            static_assert((uint8_t)bugsy::TraderState::CONNECTING == 0x11, "TraderState::CONNECTING differs from the schema");
+            static_assert((uint8_t)bugsy::TraderState::ACTIVE == 0x20, "TraderState::ACTIVE differs from the schema");
+            static_assert((uint8_t)bugsy::TraderState::ERROR == 0x80, "TraderState::ERROR differs from the schema");
+            static_assert(sizeof(bugsy::SensorStatus) == 1, "SensorStatus must be a single byte");
+            static_assert((uint8_t)bugsy::SensorStatus::NONE == 0x00, "SensorStatus::NONE differs from the schema");
+            static_assert((uint8_t)bugsy::SensorStatus::OK == 0x01, "SensorStatus::OK differs from the schema");
+            static_assert((uint8_t)bugsy::SensorStatus::TIMEOUT == 0x10, "SensorStatus::TIMEOUT differs from the schema");
+            static_assert((uint8_t)bugsy::SensorStatus::CHECKSUM_ERROR == 0x11, "SensorStatus::CHECKSUM_ERROR differs from the schema");
+            static_assert(sizeof(bugsy::JobTicket) == 2, "JobTicket differs from the schema");
+            static_assert(offsetof(bugsy::JobTicket, id) == 0, "JobTicket::id differs from the schema");
+            static_assert(offsetof(bugsy::JobTicket, state) == 1, "JobTicket::state differs from the schema");
+            static_assert(sizeof(bugsy::Movement) == 4, "Movement differs from the schema");
+            static_assert(offsetof(bugsy::Movement, chain_left_dir) == 0, "Movement::chain_left_dir differs from the schema");
+            static_assert(offsetof(bugsy::Movement, chain_right_dir) == 1, "Movement::chain_right_dir differs from the schema");
+            static_assert(offsetof(bugsy::Movement, chain_left_duty) == 2, "Movement::chain_left_duty differs from the schema");
+            static_assert(offsetof(bugsy::Movement, chain_right_duty) == 3, "Movement::chain_right_duty differs from the schema");
+            static_assert(sizeof(bugsy::MoveStamp) == 8, "MoveStamp differs from the schema");
+            static_assert(offsetof(bugsy::MoveStamp, stamp) == 0, "MoveStamp::stamp differs from the schema");
+            static_assert(offsetof(bugsy::MoveStamp, seq) == 4, "MoveStamp::seq differs from the schema");
+            static_assert(offsetof(bugsy::MoveStamp, reserved) == 6, "MoveStamp::reserved differs from the schema");
+            static_assert(sizeof(bugsy::MoveStats) == 20, "MoveStats differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, accepted) == 0, "MoveStats::accepted differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, superseded) == 4, "MoveStats::superseded differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, out_of_order) == 8, "MoveStats::out_of_order differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, expired) == 12, "MoveStats::expired differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, last_seq) == 16, "MoveStats::last_seq differs from the schema");
+            static_assert(offsetof(bugsy::MoveStats, last_age) == 18, "MoveStats::last_age differs from the schema");
+            static_assert(sizeof(bugsy::LinkStats) == 20, "LinkStats differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, received) == 0, "LinkStats::received differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, lost) == 4, "LinkStats::lost differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, rtt) == 8, "LinkStats::rtt differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, interval) == 12, "LinkStats::interval differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, jitter) == 14, "LinkStats::jitter differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, window) == 16, "LinkStats::window differs from the schema");
+            static_assert(offsetof(bugsy::LinkStats, reserved) == 18, "LinkStats::reserved differs from the schema");
+            static_assert(sizeof(bugsy::FailsafeConfig) == 8, "FailsafeConfig differs from the schema");
+            static_assert(offsetof(bugsy::FailsafeConfig, min_window) == 0, "FailsafeConfig::min_window differs from the schema");
+            static_assert(offsetof(bugsy::FailsafeConfig, max_window) == 2, "FailsafeConfig::max_window differs from the schema");
+            static_assert(offsetof(bugsy::FailsafeConfig, jitter_factor) == 4, "FailsafeConfig::jitter_factor differs from the schema");
+            static_assert(offsetof(bugsy::FailsafeConfig, adaptive) == 5, "FailsafeConfig::adaptive differs from the schema");
+            static_assert(offsetof(bugsy::FailsafeConfig, reserved) == 6, "FailsafeConfig::reserved differs from the schema");
+            static_assert(sizeof(bugsy::Velocity) == 4, "Velocity differs from the schema");
+            static_assert(offsetof(bugsy::Velocity, linear) == 0, "Velocity::linear differs from the schema");
+            static_assert(offsetof(bugsy::Velocity, angular) == 2, "Velocity::angular differs from the schema");
+            static_assert(sizeof(bugsy::ScheduledMove) == 8, "ScheduledMove differs from the schema");
+            static_assert(offsetof(bugsy::ScheduledMove, at) == 0, "ScheduledMove::at differs from the schema");
+            static_assert(offsetof(bugsy::ScheduledMove, move) == 4, "ScheduledMove::move differs from the schema");
+            static_assert(sizeof(bugsy::ScheduledVelocity) == 8, "ScheduledVelocity differs from the schema");
+            static_assert(offsetof(bugsy::ScheduledVelocity, at) == 0, "ScheduledVelocity::at differs from the schema");
+            static_assert(offsetof(bugsy::ScheduledVelocity, vel) == 4, "ScheduledVelocity::vel differs from the schema");
+            static_assert(sizeof(bugsy::ScheduleStats) == 20, "ScheduleStats differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, scheduled) == 0, "ScheduleStats::scheduled differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, executed) == 4, "ScheduleStats::executed differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, rejected) == 8, "ScheduleStats::rejected differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, lateness_avg) == 12, "ScheduleStats::lateness_avg differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, lateness_max) == 14, "ScheduleStats::lateness_max differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, pending) == 16, "ScheduleStats::pending differs from the schema");
+            static_assert(offsetof(bugsy::ScheduleStats, reserved) == 17, "ScheduleStats::reserved differs from the schema");
+            static_assert(sizeof(bugsy::DriveCalibration) == 38, "DriveCalibration differs from the schema");
+            static_assert(offsetof(bugsy::DriveCalibration, max_speed) == 0, "DriveCalibration::max_speed differs from the schema");
+            static_assert(offsetof(bugsy::DriveCalibration, track_width) == 2, "DriveCalibration::track_width differs from the schema");
+            static_assert(offsetof(bugsy::DriveCalibration, left) == 4, "DriveCalibration::left differs from the schema");
+            static_assert(offsetof(bugsy::DriveCalibration, right) == 21, "DriveCalibration::right differs from the schema");
+            static_assert(sizeof(bugsy::SpeedGains) == 8, "SpeedGains differs from the schema");
+            static_assert(offsetof(bugsy::SpeedGains, kp) == 0, "SpeedGains::kp differs from the schema");
+            static_assert(offsetof(bugsy::SpeedGains, ki) == 2, "SpeedGains::ki differs from the schema");
+            static_assert(offsetof(bugsy::SpeedGains, kd) == 4, "SpeedGains::kd differs from the schema");
+            static_assert(offsetof(bugsy::SpeedGains, enabled) == 6, "SpeedGains::enabled differs from the schema");
+            static_assert(offsetof(bugsy::SpeedGains, reserved) == 7, "SpeedGains::reserved differs from the schema");
+            static_assert(sizeof(bugsy::SpeedStats) == 24, "SpeedStats differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, ticks) == 0, "SpeedStats::ticks differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, jitter_avg) == 4, "SpeedStats::jitter_avg differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, jitter_max) == 6, "SpeedStats::jitter_max differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, target_left) == 8, "SpeedStats::target_left differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, target_right) == 10, "SpeedStats::target_right differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, speed_left) == 12, "SpeedStats::speed_left differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, speed_right) == 14, "SpeedStats::speed_right differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, error_left) == 16, "SpeedStats::error_left differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, error_right) == 18, "SpeedStats::error_right differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, active) == 20, "SpeedStats::active differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, saturated) == 21, "SpeedStats::saturated differs from the schema");
+            static_assert(offsetof(bugsy::SpeedStats, reserved) == 22, "SpeedStats::reserved differs from the schema");
+            static_assert(sizeof(bugsy::ClockSample) == 12, "ClockSample differs from the schema");
+            static_assert(offsetof(bugsy::ClockSample, client_send) == 0, "ClockSample::client_send differs from the schema");
+            static_assert(offsetof(bugsy::ClockSample, core_receive) == 4, "ClockSample::core_receive differs from the schema");
+            static_assert(offsetof(bugsy::ClockSample, core_send) == 8, "ClockSample::core_send differs from the schema");
+            static_assert(sizeof(bugsy::OtaImage) == 8, "OtaImage differs from the schema");
+            static_assert(offsetof(bugsy::OtaImage, size) == 0, "OtaImage::size differs from the schema");
+            static_assert(offsetof(bugsy::OtaImage, crc) == 4, "OtaImage::crc differs from the schema");
+            static_assert(sizeof(bugsy::OtaStatus) == 24, "OtaStatus differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, size) == 0, "OtaStatus::size differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, crc) == 4, "OtaStatus::crc differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, written) == 8, "OtaStatus::written differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, missing) == 12, "OtaStatus::missing differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, next) == 16, "OtaStatus::next differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, chunks) == 18, "OtaStatus::chunks differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, dropped) == 20, "OtaStatus::dropped differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, state) == 22, "OtaStatus::state differs from the schema");
+            static_assert(offsetof(bugsy::OtaStatus, window) == 23, "OtaStatus::window differs from the schema");
+            static_assert(sizeof(bugsy::BaudStats) == 20, "BaudStats differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, baud) == 0, "BaudStats::baud differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, test_frames) == 4, "BaudStats::test_frames differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, test_errors) == 8, "BaudStats::test_errors differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, rx_errors) == 12, "BaudStats::rx_errors differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, negotiations) == 16, "BaudStats::negotiations differs from the schema");
+            static_assert(offsetof(bugsy::BaudStats, fallbacks) == 18, "BaudStats::fallbacks differs from the schema");
+            static_assert(sizeof(bugsy::ServoMove) == 8, "ServoMove differs from the schema");
+            static_assert(offsetof(bugsy::ServoMove, angle) == 0, "ServoMove::angle differs from the schema");
+            static_assert(offsetof(bugsy::ServoMove, duration) == 2, "ServoMove::duration differs from the schema");
+            static_assert(offsetof(bugsy::ServoMove, servo) == 4, "ServoMove::servo differs from the schema");
+            static_assert(offsetof(bugsy::ServoMove, reserved) == 5, "ServoMove::reserved differs from the schema");
+            static_assert(sizeof(bugsy::EStopStats) == 16, "EStopStats differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, triggers) == 0, "EStopStats::triggers differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, violations) == 4, "EStopStats::violations differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, latency_last) == 8, "EStopStats::latency_last differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, latency_max) == 10, "EStopStats::latency_max differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, active) == 12, "EStopStats::active differs from the schema");
+            static_assert(offsetof(bugsy::EStopStats, reserved) == 13, "EStopStats::reserved differs from the schema");
+            static_assert(sizeof(bugsy::BatteryState) == 4, "BatteryState differs from the schema");
+            static_assert(offsetof(bugsy::BatteryState, voltage) == 0, "BatteryState::voltage differs from the schema");
+            static_assert(offsetof(bugsy::BatteryState, charge) == 2, "BatteryState::charge differs from the schema");
+            static_assert(offsetof(bugsy::BatteryState, duty_limit) == 3, "BatteryState::duty_limit differs from the schema");
+            static_assert(sizeof(bugsy::PowerStats) == 16, "PowerStats differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, sleep_time) == 0, "PowerStats::sleep_time differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, sleeps) == 4, "PowerStats::sleeps differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, wake_latency_avg) == 8, "PowerStats::wake_latency_avg differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, wake_latency_max) == 10, "PowerStats::wake_latency_max differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, low_power) == 12, "PowerStats::low_power differs from the schema");
+            static_assert(offsetof(bugsy::PowerStats, reserved) == 13, "PowerStats::reserved differs from the schema");
+            static_assert(sizeof(bugsy::PrimarySensorData) == 8, "PrimarySensorData differs from the schema");
+            static_assert(offsetof(bugsy::PrimarySensorData, encoder_position) == 0, "PrimarySensorData::encoder_position differs from the schema");
+            static_assert(offsetof(bugsy::PrimarySensorData, encoder_pressed) == 4, "PrimarySensorData::encoder_pressed differs from the schema");
+            static_assert(offsetof(bugsy::PrimarySensorData, obstacle) == 5, "PrimarySensorData::obstacle differs from the schema");
+            static_assert(offsetof(bugsy::PrimarySensorData, reserved) == 6, "PrimarySensorData::reserved differs from the schema");
+            static_assert(sizeof(bugsy::SecondarySensorData) == 8, "SecondarySensorData differs from the schema");
+            static_assert(offsetof(bugsy::SecondarySensorData, temperature) == 0, "SecondarySensorData::temperature differs from the schema");
+            static_assert(offsetof(bugsy::SecondarySensorData, humidity) == 2, "SecondarySensorData::humidity differs from the schema");
+            static_assert(offsetof(bugsy::SecondarySensorData, dht_status) == 4, "SecondarySensorData::dht_status differs from the schema");
+            static_assert(offsetof(bugsy::SecondarySensorData, reserved) == 5, "SecondarySensorData::reserved differs from the schema");
+        /**/
+    }
+}
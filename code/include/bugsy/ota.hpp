@@ -0,0 +1,313 @@
+// #####################
+// #    BUGSY - OTA    #
+// #####################
+//
+// Firmware updates of the core over the command protocol, shared by the core firmware, the host simulation and the
+// clients
+//
+// The client announces the image (`Command::OtaBegin`), the core erases the inactive partition in the background and
+// starts receiving chunks of `BUGSY_OTA_CHUNK_SIZE` bytes. Chunks carry their index and a CRC-16, they are not answered
+// and are sent back to back, up to `OtaStatus::window` of them before the client asks for the status again. The status
+// tells the first chunk missing and which of the following ones are missing as well, so only lost or broken chunks are
+// sent again (selective repeat). Intact chunks are queued for the background writer, the loop never waits for the flash.
+//
+// The session stays in memory after a disconnect, announcing the same image again (same size and CRC-32) resumes it,
+// from any remote. Once all chunks have been received `Command::OtaFinish` verifies the CRC-32 of the written partition
+// and makes it the boot partition.
+//
+// The core reads a chunk by its fixed length, a lost byte shifts all chunks after it until the next pause of the client.
+// While a remote streams chunks, its other commands are therefore dropped, so a shifted chunk is never taken for a
+// movement. The remote is released by `OtaFinish` / `OtaAbort` or `BUGSY_OTA_OWNER_TIMEOUT` without chunks.
+
+# pragma once
+
+# include <inttypes.h>
+# include <string.h>
+
+# include "core.hpp"
+# include "crc.hpp"
+# include "messages.hpp"
+
+/* OTA */
+/// Size of the data of a chunk in bytes
+# define BUGSY_OTA_CHUNK_SIZE 128
+/// Largest image accepted, the size of an app partition of the default partition table of the ESP32
+# define BUGSY_OTA_MAX_SIZE 0x140000
+/// Time in milliseconds without chunks until the streaming remote may send other commands again
+# define BUGSY_OTA_OWNER_TIMEOUT 2000
+/// Time in milliseconds the core waits after the image has been verified until it restarts (if requested), so the
+/// client can still fetch the status
+# define BUGSY_OTA_RESTART_DELAY 500
+/// Time in milliseconds the client waits between two status requests while the core erases or verifies
+# define BUGSY_OTA_POLL_INTERVAL 50
+
+namespace bugsy {
+    namespace ota {
+        /// Size of a chunk frame, including the command byte, index and CRC
+        static const size_t FRAME_SIZE = sizeof(Command) + (2 * sizeof(uint16_t)) + BUGSY_OTA_CHUNK_SIZE;
+        /// Largest amount of chunks of an image
+        static const uint16_t MAX_CHUNKS = (BUGSY_OTA_MAX_SIZE + BUGSY_OTA_CHUNK_SIZE - 1) / BUGSY_OTA_CHUNK_SIZE;
+        /// Chunks after `OtaStatus::next` covered by `OtaStatus::missing`
+        static const uint8_t MISSING_SPAN = 32;
+
+        /// @brief Whether a command belongs to the update and is accepted from the streaming remote
+        inline bool is_update(Command cmd) {
+            return (cmd == Command::OtaBegin) || (cmd == Command::OtaChunk) || (cmd == Command::GetOtaStatus)
+                || (cmd == Command::OtaFinish) || (cmd == Command::OtaAbort);
+        }
+
+        /// @brief Amount of chunks of an image of `size` bytes
+        inline uint16_t chunks_of(uint32_t size) {
+            return (uint16_t)((size + BUGSY_OTA_CHUNK_SIZE - 1) / BUGSY_OTA_CHUNK_SIZE);
+        }
+
+        /// @brief The CRC-16 of a chunk, covers the index as well, so a broken index never places intact data wrong
+        inline uint16_t chunk_crc(const uint8_t* index, const uint8_t* data) {
+            return crc::crc16(data, BUGSY_OTA_CHUNK_SIZE, crc::crc16(index, sizeof(uint16_t)));
+        }
+
+        /// @brief Builds the frame of a chunk (`FRAME_SIZE` bytes), the last chunk of the image is padded with `0xFF`
+        inline void fill_chunk(uint8_t* frame, const uint8_t* image, uint32_t size, uint16_t index) {
+            uint8_t* data = frame + sizeof(Command) + (2 * sizeof(uint16_t));
+            uint32_t offset = (uint32_t)index * BUGSY_OTA_CHUNK_SIZE;
+            uint32_t len = ((size - offset) < BUGSY_OTA_CHUNK_SIZE) ? (size - offset) : BUGSY_OTA_CHUNK_SIZE;
+
+            memcpy(data, image + offset, len);
+            memset(data + len, 0xFF, BUGSY_OTA_CHUNK_SIZE - len);
+
+            frame[0] = (uint8_t)Command::OtaChunk;
+            msg::wire::put_u16(frame + sizeof(Command), index);
+            msg::wire::put_u16(frame + sizeof(Command) + sizeof(uint16_t), chunk_crc(frame + sizeof(Command), data));
+        }
+
+        /// The bookkeeping of an update on the core end, the owner erases, writes and verifies the partition
+        class Session {
+        public:
+            /// @brief Starts an update of `image` or resumes it if it is the current one
+            /// @param window The chunks `src` may send before asking for the status
+            /// @return Whether an update of the same image has been resumed, the owner only has to prepare the partition
+            /// otherwise
+            bool begin(const OtaImage& image, Remote src, uint32_t now, uint8_t window) {
+                this->owner = src;
+                this->last_chunk = now;
+                this->status.window = window;
+
+                if ((image.size == this->status.size) && (image.crc == this->status.crc)
+                    && (this->status.state != OtaState::IDLE) && (this->status.state != OtaState::FAILED)) {
+                    return true;
+                }
+
+                this->status = OtaStatus { };
+                this->status.size = image.size;
+                this->status.crc = image.crc;
+                this->status.chunks = chunks_of(image.size);
+                this->status.window = window;
+                this->status.state = ((image.size > 0) && (image.size <= BUGSY_OTA_MAX_SIZE)) ? OtaState::ERASING : OtaState::FAILED;
+
+                memset(this->received, 0, sizeof(this->received));
+                return false;
+            }
+
+            /// @brief Checks a chunk frame (without the command byte)
+            /// @param index Receives the index of the chunk
+            /// @return The amount of bytes of the image in the chunk, `0` if the chunk has to be dropped (broken, not
+            /// expected or received before)
+            uint16_t accept(Remote src, const uint8_t* args, size_t len, uint32_t now, uint16_t* index) {
+                if ((this->status.state != OtaState::RECEIVING) || (src != this->owner)) {
+                    return 0;
+                }
+
+                const uint8_t* data = args + (2 * sizeof(uint16_t));
+                *index = msg::wire::get_u16(args);
+
+                if ((len != (FRAME_SIZE - sizeof(Command))) || (*index >= this->status.chunks)
+                    || (msg::wire::get_u16(args + sizeof(uint16_t)) != chunk_crc(args, data))) {
+                    this->status.dropped++;
+                    return 0;
+                }
+
+                this->last_chunk = now;
+
+                // Retransmitted, as its answer was lost
+                if (this->has(*index)) {
+                    return 0;
+                }
+
+                uint32_t offset = (uint32_t)*index * BUGSY_OTA_CHUNK_SIZE;
+                return ((this->status.size - offset) < BUGSY_OTA_CHUNK_SIZE) ? (this->status.size - offset) : BUGSY_OTA_CHUNK_SIZE;
+            }
+
+            /// @brief Marks a chunk as received once it has been handed to the writer
+            void receive(uint16_t index) {
+                this->received[index >> 3] |= (1 << (index & 7));
+
+                while ((this->status.next < this->status.chunks) && this->has(this->status.next)) {
+                    this->status.next++;
+                }
+            }
+
+            /// @brief Counts a chunk accepted but dropped by the owner (e.g. because its write queue was full)
+            void drop() { this->status.dropped++; }
+
+            /// @brief Counts the bytes written to the partition
+            void written(uint32_t bytes) { this->status.written += bytes; }
+
+            /// @brief Whether all chunks have been received
+            bool complete() const { return this->status.next == this->status.chunks; }
+
+            /// @brief Whether the commands of `src` are limited to the update (see above)
+            bool owns(Remote src, uint32_t now) const {
+                return (this->status.state == OtaState::RECEIVING) && (src == this->owner)
+                    && ((now - this->last_chunk) < BUGSY_OTA_OWNER_TIMEOUT);
+            }
+
+            OtaState state() const { return this->status.state; }
+
+            void set_state(OtaState state) { this->status.state = state; }
+
+            /// @brief The image of the update
+            OtaImage image() const { return OtaImage { this->status.size, this->status.crc }; }
+
+            /// @brief The current status, including the chunks missing after `next`
+            OtaStatus get() const {
+                OtaStatus copy = this->status;
+                copy.missing = 0;
+
+                for (uint8_t i = 0; (i < MISSING_SPAN) && ((copy.next + i) < copy.chunks); i++) {
+                    if (!this->has(copy.next + i)) {
+                        copy.missing |= (uint32_t)1 << i;
+                    }
+                }
+
+                return copy;
+            }
+
+        private:
+            bool has(uint16_t index) const {
+                return this->received[index >> 3] & (1 << (index & 7));
+            }
+
+            OtaStatus status = { };
+            Remote owner = Remote::NONE;
+            /// Time of the last chunk of the owner in milliseconds
+            uint32_t last_chunk = 0;
+            /// Bit set for every chunk received
+            uint8_t received [(MAX_CHUNKS + 7) / 8] = { };
+        };
+
+        /// Statistics of an upload
+        struct UploadStats {
+            /// Chunks sent, including the retransmitted ones
+            uint32_t sent;
+            /// Chunks sent again after being lost or broken
+            uint32_t retransmitted;
+            /// Status requests while receiving, every one ends a window
+            uint32_t rounds;
+        };
+
+        /// @brief Uploads an image to the core from the client end, resumes an update of the same image
+        /// @tparam L The transport of the client, providing
+        /// - `bool send(const uint8_t* data, size_t len)`, sending a command without an answer
+        /// - `bool request(const uint8_t* cmd, size_t len, uint8_t* answer, size_t answer_len)`, sending a command and
+        ///   receiving an answer of exactly `answer_len` bytes
+        /// - `void wait(uint32_t ms)`
+        /// @param restart Whether the core should restart into the new image once it has been verified
+        /// @param status Receives the last status of the core
+        /// @return Whether the image has been verified and boots with the next restart, `false` if the core stopped
+        /// answering (resume by calling again) or failed (see `status->state`)
+        template<typename L>
+        bool upload(L& link, const uint8_t* image, uint32_t size, bool restart, OtaStatus* status, UploadStats* stats) {
+            uint8_t frame [FRAME_SIZE];
+            uint8_t answer [msg::OtaStatusView::SIZE];
+            const uint8_t status_cmd = (uint8_t)Command::GetOtaStatus;
+
+            OtaImage ota_image = { size, crc::crc32(image, size) };
+
+            frame[0] = (uint8_t)Command::OtaBegin;
+            msg::OtaImageBuilder(frame + sizeof(Command), msg::OtaImageBuilder::SIZE).set(ota_image);
+
+            if (!link.request(frame, sizeof(Command) + msg::OtaImageBuilder::SIZE, answer, sizeof(answer))) {
+                return false;
+            }
+
+            *status = msg::OtaStatusView(answer, sizeof(answer)).get();
+
+            // Chunks up to this one have been sent by this call before, sending them again is a retransmission
+            uint32_t fresh = status->next;
+
+            while (status->state == OtaState::ERASING) {
+                link.wait(BUGSY_OTA_POLL_INTERVAL);
+
+                if (!link.request(&status_cmd, sizeof(status_cmd), answer, sizeof(answer))) {
+                    return false;
+                }
+
+                *status = msg::OtaStatusView(answer, sizeof(answer)).get();
+            }
+
+            while ((status->state == OtaState::RECEIVING) && (status->next < status->chunks)) {
+                uint8_t budget = status->window ? status->window : 1;
+                uint32_t progress = status->next;
+
+                for (uint8_t i = 0; budget && (i < MISSING_SPAN) && ((status->next + i) < status->chunks); i++) {
+                    if (!(status->missing & ((uint32_t)1 << i))) {
+                        continue;
+                    }
+
+                    uint16_t index = status->next + i;
+                    fill_chunk(frame, image, size, index);
+
+                    if (!link.send(frame, sizeof(frame))) {
+                        return false;
+                    }
+
+                    if (index < fresh) {
+                        stats->retransmitted++;
+                    } else {
+                        fresh = index + 1;
+                    }
+
+                    stats->sent++;
+                    budget--;
+                }
+
+                stats->rounds++;
+
+                if (!link.request(&status_cmd, sizeof(status_cmd), answer, sizeof(answer))) {
+                    return false;
+                }
+
+                *status = msg::OtaStatusView(answer, sizeof(answer)).get();
+
+                // The writer of the core is behind, give it time instead of flooding its queue
+                if (status->next == progress) {
+                    link.wait(1);
+                }
+            }
+
+            // A verified image is finished again, so the core still restarts if requested
+            if ((status->state == OtaState::RECEIVING) || (status->state == OtaState::READY)) {
+                frame[0] = (uint8_t)Command::OtaFinish;
+                frame[1] = restart ? 1 : 0;
+
+                if (!link.request(frame, sizeof(Command) + sizeof(uint8_t), answer, sizeof(answer))) {
+                    return false;
+                }
+
+                *status = msg::OtaStatusView(answer, sizeof(answer)).get();
+            }
+
+            while (status->state == OtaState::VERIFYING) {
+                link.wait(BUGSY_OTA_POLL_INTERVAL);
+
+                if (!link.request(&status_cmd, sizeof(status_cmd), answer, sizeof(answer))) {
+                    return false;
+                }
+
+                *status = msg::OtaStatusView(answer, sizeof(answer)).get();
+            }
+
+            return status->state == OtaState::READY;
+        }
+    }
+}
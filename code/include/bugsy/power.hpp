@@ -0,0 +1,129 @@
+// #######################
+// #    BUGSY - POWER    #
+// #######################
+//
+// Idle power management of the core, shared by the firmware and the host simulation
+//
+// The `Governor` only decides, the caller applies its decisions: While a movement is active or a command arrived less
+// than `BUGSY_POWER_IDLE_DELAY` ago the core runs at full speed. Otherwise it drops into the low power level, where the
+// CPU clock is reduced and the main loop sleeps instead of spinning. Received bytes wake the core right away, sleeps are
+// only capped by `BUGSY_POWER_MAX_SLEEP` and the next deadline to keep up the periodic work.
+
+# pragma once
+
+# include <inttypes.h>
+
+/* POWER */
+/// Time without any commands or movements in milliseconds until the core switches to the low power level
+# define BUGSY_POWER_IDLE_DELAY 500
+/// Maximum duration of a single sleep in milliseconds, bounds the delay of the periodic work (battery, timeouts) while idle
+# define BUGSY_POWER_MAX_SLEEP 20
+
+namespace bugsy {
+    /// Statistics of the idle power management of the core
+    struct PowerStats {
+        /// Total time spent sleeping in milliseconds
+        uint32_t sleep_time;
+        /// Amount of sleeps
+        uint32_t sleeps;
+        /// Average and maximum time in microseconds from receiving a movement until it is applied, including the wake-up
+        /// and the clock switch while idle
+        uint16_t wake_latency_avg;
+        uint16_t wake_latency_max;
+        /// Whether the core currently is at the low power level
+        uint8_t low_power;
+
+        uint8_t reserved [3];
+    };
+
+    namespace power {
+        /// Power levels of the core
+        enum class Level : uint8_t {
+            /// Full CPU clock, the loop never sleeps
+            FULL = 0x00,
+            /// Reduced CPU clock, the loop sleeps between polls
+            REDUCED = 0x01
+        };
+
+        /// Decides when the core may save power
+        class Governor {
+        public:
+            /// @brief Marks activity (a command has been received), switches back to the full power level
+            /// @return Whether the level changed and has to be applied
+            bool activity(uint32_t now) {
+                this->last_activity = now;
+                return this->set_level(Level::FULL);
+            }
+
+            /// @brief Plans the next loop iteration
+            /// @param now The current time in milliseconds
+            /// @param moving Whether a movement is currently active
+            /// @param deadline The time the next scheduled work is due at in milliseconds
+            /// @param level_changed Set if the level changed and has to be applied
+            /// @return The time to sleep in milliseconds, `0` to run the next iteration right away
+            uint32_t plan(uint32_t now, bool moving, uint32_t deadline, bool* level_changed) {
+                if (moving) {
+                    this->last_activity = now;
+                }
+
+                if ((now - this->last_activity) < BUGSY_POWER_IDLE_DELAY) {
+                    *level_changed = this->set_level(Level::FULL);
+                    return 0;
+                }
+
+                *level_changed = this->set_level(Level::REDUCED);
+
+                // Deadline already passed (signed distance handles the timer overflow)
+                if ((int32_t)(deadline - now) <= 0) {
+                    return 0;
+                }
+
+                return ((deadline - now) < BUGSY_POWER_MAX_SLEEP) ? (deadline - now) : BUGSY_POWER_MAX_SLEEP;
+            }
+
+            /// @brief Records a finished sleep
+            /// @param slept The time actually slept in milliseconds
+            void record_sleep(uint32_t slept) {
+                this->stats.sleep_time += slept;
+                this->stats.sleeps++;
+            }
+
+            /// @brief Records the latency of a received movement
+            /// @param latency The time in microseconds from receiving the movement until it has been applied
+            void record_latency(uint32_t latency) {
+                if (latency > UINT16_MAX) {
+                    latency = UINT16_MAX;
+                }
+
+                this->latencies++;
+                this->latency_sum += latency;
+                this->stats.wake_latency_avg = (uint16_t)(this->latency_sum / this->latencies);
+
+                if (latency > this->stats.wake_latency_max) {
+                    this->stats.wake_latency_max = (uint16_t)latency;
+                }
+            }
+
+            Level level() const { return this->current; }
+
+            /// Statistics to be reported
+            PowerStats stats = { };
+
+        private:
+            bool set_level(Level level) {
+                if (level == this->current) {
+                    return false;
+                }
+
+                this->current = level;
+                this->stats.low_power = (level == Level::REDUCED);
+                return true;
+            }
+
+            Level current = Level::FULL;
+            uint32_t last_activity = 0;
+            uint32_t latencies = 0;
+            uint64_t latency_sum = 0;
+        };
+    }
+}
@@ -0,0 +1,213 @@
+// #######################
+// #    BUGSY - SPEED    #
+// #######################
+//
+// Closed-loop speed control of the chains, shared by the core firmware and the host simulation
+//
+// Every control tick the edges counted by the chain encoders are turned into a filtered speed, which a PID controller
+// per chain drives towards the target speed. The linearization table of the `DriveCalibration` provides the feed-forward
+// duty, so the controller only has to correct the deviation from the calibration (load, battery, terrain). The integral
+// stops growing while the output is saturated in the direction of the error (anti-windup). Everything is integer math
+// with 8 fractional bits.
+
+# pragma once
+
+# include <inttypes.h>
+
+# include "core.hpp"
+# include "drive.hpp"
+
+/* SPEED CONTROL */
+/// Rate of the control ticks in Hz
+# define BUGSY_SPEED_CONTROL_RATE 200
+/// Encoder edges counted per meter of chain travel (quadrature, all four edges)
+# define BUGSY_SPEED_ENCODER_EDGES_PER_M 20000
+/// Strength of the IIR filter applied to the measured speed, a new measurement is weighted with `1 / 2^shift`
+# define BUGSY_SPEED_FILTER_SHIFT 2
+/// Strength of the IIR filter applied to the tracking error and jitter statistics
+# define BUGSY_SPEED_STATS_SHIFT 4
+
+/// Default gains, tuned with the motor model of the host simulation (see `speed_tune` of the RPi project)
+# define BUGSY_SPEED_DEFAULT_KP 256
+# define BUGSY_SPEED_DEFAULT_KI 8
+# define BUGSY_SPEED_DEFAULT_KD 0
+
+namespace bugsy {
+    namespace speed {
+        /// Period of the control ticks in microseconds
+        static const uint32_t TICK_PERIOD = 1000000 / BUGSY_SPEED_CONTROL_RATE;
+
+        /// Gains used until others are stored in the configuration
+        static constexpr SpeedGains DEFAULT_GAINS = {
+            BUGSY_SPEED_DEFAULT_KP, BUGSY_SPEED_DEFAULT_KI, BUGSY_SPEED_DEFAULT_KD, 1, 0
+        };
+
+        /// @brief Checks whether the gains can be used (e.g. after loading an uninitialized EEPROM)
+        inline bool valid(const SpeedGains& gains) {
+            return gains.enabled <= 1;
+        }
+
+        /// @brief Converts the encoder edges counted during one tick into a speed in mm/s
+        inline int32_t edges_to_speed(int32_t edges) {
+            return (edges * (1000L * BUGSY_SPEED_CONTROL_RATE)) / BUGSY_SPEED_ENCODER_EDGES_PER_M;
+        }
+
+        /// @brief The signed duty the calibration expects to reach the given signed chain speed
+        inline int16_t feed_forward(const uint8_t* table, int16_t speed, uint16_t max_speed) {
+            uint16_t speed_abs = (speed < 0) ? -speed : speed;
+
+            if (speed_abs > max_speed) {
+                speed_abs = max_speed;
+            }
+
+            int16_t duty = drive::lookup(table, speed_abs, max_speed);
+            return (speed < 0) ? -duty : duty;
+        }
+
+        /// @brief The target speeds (mm/s) of both chains for a movement, the speeds its duties reach with the calibration
+        inline void targets_of(const Movement& move, const DriveCalibration& cal, int16_t* left, int16_t* right) {
+            int16_t left_abs = (int16_t)drive::speed_of(cal.left, move.chain_left_duty, cal.max_speed);
+            int16_t right_abs = (int16_t)drive::speed_of(cal.right, move.chain_right_duty, cal.max_speed);
+
+            *left = (bool)move.chain_left_dir ? left_abs : -left_abs;
+            *right = (bool)move.chain_right_dir ? right_abs : -right_abs;
+        }
+
+        /// PID controller of a single chain
+        class Pid {
+        public:
+            /// @brief Runs the controller for one tick
+            /// @param feed_forward The signed duty expected to reach the target
+            /// @param limit The maximum absolute duty (battery duty limit)
+            /// @return The signed duty to apply
+            int16_t update(int16_t target, int16_t measured, int16_t feed_forward, uint8_t limit, const SpeedGains& gains) {
+                int32_t error = (int32_t)target - measured;
+                int32_t max = (int32_t)limit << 8;
+
+                // Derivative on the measurement, so target steps do not kick the output
+                int32_t derivative = -(int32_t)gains.kd * (measured - this->last_measured);
+                this->last_measured = measured;
+
+                int32_t out = ((int32_t)feed_forward << 8) + ((int32_t)gains.kp * error) + this->integral + derivative;
+
+                // Anti-windup: Only integrate if it does not push a saturated output any further
+                if (!((out >= max) && (error > 0)) && !((out <= -max) && (error < 0))) {
+                    this->integral += (int32_t)gains.ki * error;
+
+                    if (this->integral > max) {
+                        this->integral = max;
+                    } else if (this->integral < -max) {
+                        this->integral = -max;
+                    }
+                }
+
+                this->saturated = (out >= max) || (out <= -max);
+
+                if (out > max) {
+                    out = max;
+                } else if (out < -max) {
+                    out = -max;
+                }
+
+                return (int16_t)(out / 256);
+            }
+
+            /// @brief Clears the integral, e.g. once the chain stopped
+            void reset() {
+                this->integral = 0;
+                this->saturated = false;
+            }
+
+            bool saturated = false;
+
+        private:
+            int32_t integral = 0;
+            int16_t last_measured = 0;
+        };
+
+        /// Speed control of both chains including the statistics reported by `Command::GetSpeedStats`
+        class Controller {
+        public:
+            /// @brief Runs a control tick
+            /// @param stamp The time of the tick in microseconds
+            /// @param edges_left Edges counted by the left encoder since the last tick (signed, forward is positive)
+            /// @param edges_right Edges counted by the right encoder since the last tick
+            /// @param limit The maximum absolute duty (battery duty limit)
+            /// @param duty_left Receives the signed duty of the left chain
+            /// @param duty_right Receives the signed duty of the right chain
+            void step(uint32_t stamp, int32_t edges_left, int32_t edges_right,
+                const DriveCalibration& cal, const SpeedGains& gains, uint8_t limit, int16_t* duty_left, int16_t* duty_right
+            ) {
+                // Jitter of the tick period, the first tick has no reference
+                if (this->stats.ticks) {
+                    uint32_t period = stamp - this->last_stamp;
+                    uint32_t jitter = (period > TICK_PERIOD) ? (period - TICK_PERIOD) : (TICK_PERIOD - period);
+
+                    if (jitter > UINT16_MAX) {
+                        jitter = UINT16_MAX;
+                    }
+
+                    this->jitter_filtered += (int32_t)((jitter << 8) - this->jitter_filtered) >> BUGSY_SPEED_STATS_SHIFT;
+                    this->stats.jitter_avg = (uint16_t)(this->jitter_filtered >> 8);
+
+                    if (jitter > this->stats.jitter_max) {
+                        this->stats.jitter_max = (uint16_t)jitter;
+                    }
+                }
+
+                this->last_stamp = stamp;
+                this->stats.ticks++;
+                this->stats.active = gains.enabled;
+
+                *duty_left = this->chain(0, edges_left, this->stats.target_left, cal.left, cal.max_speed, gains, limit,
+                    &this->stats.speed_left, &this->stats.error_left);
+                *duty_right = this->chain(1, edges_right, this->stats.target_right, cal.right, cal.max_speed, gains, limit,
+                    &this->stats.speed_right, &this->stats.error_right);
+
+                this->stats.saturated = (this->pid[0].saturated ? 0x01 : 0x00) | (this->pid[1].saturated ? 0x02 : 0x00);
+            }
+
+            /// @brief Sets the target speeds of the chains in mm/s
+            void set_targets(int16_t left, int16_t right) {
+                this->stats.target_left = left;
+                this->stats.target_right = right;
+            }
+
+            SpeedStats stats = { };
+
+        private:
+            int16_t chain(uint8_t index, int32_t edges, int16_t target, const uint8_t* table, uint16_t max_speed,
+                const SpeedGains& gains, uint8_t limit, int16_t* speed, uint16_t* error
+            ) {
+                int32_t measured = edges_to_speed(edges) << 8;
+                this->filtered[index] += (measured - this->filtered[index]) >> BUGSY_SPEED_FILTER_SHIFT;
+                *speed = (int16_t)(this->filtered[index] / 256);
+
+                uint32_t error_abs = (target > *speed) ? (target - *speed) : (*speed - target);
+                this->error_filtered[index] += (int32_t)((error_abs << 8) - this->error_filtered[index]) >> BUGSY_SPEED_STATS_SHIFT;
+                *error = (uint16_t)(this->error_filtered[index] >> 8);
+
+                // Standing still (or reversing) starts from a clean integral, no holding torque is required
+                if ((target == 0) || ((target < 0) != (this->last_target[index] < 0))) {
+                    this->pid[index].reset();
+                }
+
+                this->last_target[index] = target;
+
+                if (target == 0) {
+                    return 0;
+                }
+
+                return this->pid[index].update(target, *speed, feed_forward(table, target, max_speed), limit, gains);
+            }
+
+            Pid pid [2];
+            int32_t filtered [2] = { 0, 0 };
+            uint32_t error_filtered [2] = { 0, 0 };
+            int16_t last_target [2] = { 0, 0 };
+
+            uint32_t last_stamp = 0;
+            uint32_t jitter_filtered = 0;
+        };
+    }
+}
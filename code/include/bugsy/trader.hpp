@@ -13,11 +13,44 @@ namespace bugsy {
         ERROR = 0x80
     };
 
-    struct PrimarySensorData {
+    /// Result of the last measurement of a sensor
+    enum class SensorStatus : uint8_t {
+        /// No measurement has been done yet
+        NONE = 0x00,
+        /// The last measurement succeeded
+        OK = 0x01,
+
+        /// The sensor did not answer (completely)
+        TIMEOUT = 0x10,
+        /// The received data was corrupted
+        CHECKSUM_ERROR = 0x11
+    };
 
+    /// Sensor data required for operating the robot, sampled frequently
+    ///
+    /// Fields are ordered by size and padded explicitly, so the layout is the same on the AVR trader and the ESP32 core
+    struct PrimarySensorData {
+        /// Position of the rotary encoder in steps since the trader started
+        int32_t encoder_position;
+        /// Whether the switch of the rotary encoder is pressed
+        uint8_t encoder_pressed;
+        /// Whether the obstacle sensor detects an obstacle, the emergency stop line is asserted in this case
+        uint8_t obstacle;
+
+        uint8_t reserved [2];
     };
 
+    /// Less important sensor data, sampled rarely
+    ///
+    /// Fields are ordered by size and padded explicitly, so the layout is the same on the AVR trader and the ESP32 core
     struct SecondarySensorData {
-
+        /// Temperature in 0.1 degrees celsius
+        int16_t temperature;
+        /// Relative humidity in 0.1 percent
+        uint16_t humidity;
+        /// Status of the DHT measurement the values above are from
+        SensorStatus dht_status;
+
+        uint8_t reserved [3];
     };
 }
\ No newline at end of file
@@ -0,0 +1,659 @@
+#!/usr/bin/env python3
+#
+# ###############################
+# #    BUGSY - MESSAGE SCHEMA    #
+# ###############################
+#
+# Generates the zero-copy message views and builders from `messages.json`
+#
+# - `include/bugsy/messages.hpp` for the core, the trader and the RPi (C++11, no standard library required)
+# - `clients/rustbug/src/messages.rs` for the Rust client
+#
+# Usage: `python3 schema/generate.py` (regenerates both files) or `python3 schema/generate.py --check` (fails if one of
+# them is out of date), run from the `code` directory or anywhere else
+
+import json
+import re
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SCHEMA = os.path.join(ROOT, "schema", "messages.json")
+CPP_OUT = os.path.join(ROOT, "include", "bugsy", "messages.hpp")
+RUST_OUT = os.path.join(ROOT, "clients", "rustbug", "src", "messages.rs")
+
+# Primitive types: (size, C++ type, Rust type)
+PRIMITIVES = {
+    "u8": (1, "uint8_t", "u8"),
+    "i8": (1, "int8_t", "i8"),
+    "u16": (2, "uint16_t", "u16"),
+    "i16": (2, "int16_t", "i16"),
+    "u32": (4, "uint32_t", "u32"),
+    "i32": (4, "int32_t", "i32"),
+}
+
+RUST_KEYWORDS = { "as", "fn", "impl", "loop", "match", "mod", "move", "ref", "self", "static", "type", "use", "where" }
+
+
+# Schema
+class Field:
+    def __init__(self, raw, offset, schema):
+        self.name = raw["name"]
+        self.type = raw["type"]
+        self.count = raw.get("count")
+        self.doc = raw.get("doc")
+        self.offset = offset
+
+        if self.type == "pad":
+            self.kind = "pad"
+            self.size = self.count
+        elif self.type in PRIMITIVES:
+            self.kind = "array" if self.count else "prim"
+            self.size = PRIMITIVES[self.type][0] * (self.count or 1)
+
+            if self.count and self.type != "u8":
+                raise ValueError("%s: only byte arrays are supported" % self.name)
+        elif self.type in schema.enums:
+            self.kind = "enum"
+            self.enum = schema.enums[self.type]
+            self.size = 1
+        elif self.type in schema.structs:
+            self.kind = "struct"
+            self.struct = schema.structs[self.type]
+            self.size = self.struct.size
+        else:
+            raise ValueError("%s: unknown type '%s'" % (self.name, self.type))
+
+        # Natural alignment, so the native structs have no implicit padding on any of the targets
+        align = PRIMITIVES[self.type][0] if self.kind == "prim" else (self.struct.align if self.kind == "struct" else 1)
+
+        if self.offset % align:
+            raise ValueError("%s: misaligned at offset %d, add explicit padding" % (self.name, self.offset))
+
+        self.align = align
+
+
+class Struct:
+    def __init__(self, raw, schema):
+        self.name = raw["name"]
+        self.doc = raw.get("doc")
+        self.fields = []
+
+        offset = 0
+
+        for raw_field in raw["fields"]:
+            field = Field(raw_field, offset, schema)
+            self.fields.append(field)
+            offset += field.size
+
+        self.size = offset
+        self.align = max(field.align for field in self.fields)
+
+        if self.size % self.align:
+            raise ValueError("%s: size %d is not a multiple of its alignment, add explicit padding" % (self.name, self.size))
+
+
+class Enum:
+    def __init__(self, raw):
+        self.name = raw["name"]
+        self.doc = raw.get("doc")
+        self.flags = raw.get("flags", False)
+        self.bool = raw.get("bool", False)
+        self.native = raw.get("native", "bugsy::" + self.name)
+        self.values = [ (name, int(value, 0)) for name, value in raw["values"] ]
+
+        for name, value in self.values:
+            if not (0 <= value <= 0xFF):
+                raise ValueError("%s::%s: value does not fit into a byte" % (self.name, name))
+
+
+class Schema:
+    def __init__(self, raw):
+        self.doc = raw.get("doc")
+        self.enums = { }
+        self.structs = { }
+        self.struct_list = [ ]
+
+        for raw_enum in raw["enums"]:
+            self.enums[raw_enum["name"]] = Enum(raw_enum)
+
+        # Structs may only contain structs defined before them
+        for raw_struct in raw["structs"]:
+            struct = Struct(raw_struct, self)
+            self.structs[struct.name] = struct
+            self.struct_list.append(struct)
+
+        self.enum_list = [ self.enums[raw_enum["name"]] for raw_enum in raw["enums"] ]
+#
+
+
+# C++
+def cpp_type(field):
+    if field.kind == "enum":
+        return field.enum.native
+    if field.kind == "struct":
+        return "bugsy::" + field.struct.name
+
+    return PRIMITIVES[field.type][1]
+
+
+def cpp_read(field, ptr):
+    if field.kind == "enum":
+        if field.enum.bool:
+            return "(%s)(%s[%d] != 0)" % (field.enum.native, ptr, field.offset)
+        return "(%s)%s[%d]" % (field.enum.native, ptr, field.offset)
+
+    size = PRIMITIVES[field.type][0]
+
+    if field.type == "u8":
+        return "%s[%d]" % (ptr, field.offset)
+    if size == 1:
+        return "(%s)%s[%d]" % (cpp_type(field), ptr, field.offset)
+
+    read = "wire::get_u%d(%s + %d)" % (size * 8, ptr, field.offset)
+    return read if field.type.startswith("u") else "(%s)%s" % (cpp_type(field), read)
+
+
+def cpp_write(field, ptr, value):
+    if field.type == "u8":
+        return "%s[%d] = %s;" % (ptr, field.offset, value)
+    if field.kind == "enum" or PRIMITIVES[field.type][0] == 1:
+        return "%s[%d] = (uint8_t)%s;" % (ptr, field.offset, value)
+
+    size = PRIMITIVES[field.type][0]
+    cast = "" if field.type.startswith("u") else "(uint%d_t)" % (size * 8)
+    return "wire::put_u%d(%s + %d, %s%s);" % (size * 8, ptr, field.offset, cast, value)
+
+
+def cpp_doc(lines, indent, doc):
+    if doc:
+        lines.append(indent + "/// " + doc)
+
+
+def generate_cpp(schema):
+    out = [ ]
+    i1, i2, i3, i4 = "    ", "        ", "            ", "                "
+
+    out += [
+        "// #########################",
+        "// #    BUGSY - MESSAGES    #",
+        "// #########################",
+        "//",
+        "// GENERATED by `schema/generate.py` from `schema/messages.json`, do not edit!",
+        "//",
+        "// %s." % schema.doc,
+        "//",
+        "// Every message has a view, decoding it in place from a received buffer (bounds checked once when constructed, no",
+        "// copies, no alignment requirements) and a builder, encoding it in place into a send buffer.",
+        "// The hand-written types of `core.hpp`, `trader.hpp` and `power.hpp` are checked against the schema below, so their",
+        "// layout can not drift from the wire format unnoticed.",
+        "",
+        "# pragma once",
+        "",
+        "# include <inttypes.h>",
+        "# include <stddef.h>",
+        "",
+        "# include \"core.hpp\"",
+        "# include \"power.hpp\"",
+        "# include \"trader.hpp\"",
+        "",
+        "namespace bugsy {",
+        i1 + "/// Zero-copy views and builders of all messages",
+        i1 + "namespace msg {",
+        i2 + "/// Little endian access to unaligned bytes",
+        i2 + "namespace wire {",
+        i3 + "static inline uint16_t get_u16(const uint8_t* p) {",
+        i4 + "return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));",
+        i3 + "}",
+        "",
+        i3 + "static inline uint32_t get_u32(const uint8_t* p) {",
+        i4 + "return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);",
+        i3 + "}",
+        "",
+        i3 + "static inline void put_u16(uint8_t* p, uint16_t value) {",
+        i4 + "p[0] = (uint8_t)value;",
+        i4 + "p[1] = (uint8_t)(value >> 8);",
+        i3 + "}",
+        "",
+        i3 + "static inline void put_u32(uint8_t* p, uint32_t value) {",
+        i4 + "p[0] = (uint8_t)value;",
+        i4 + "p[1] = (uint8_t)(value >> 8);",
+        i4 + "p[2] = (uint8_t)(value >> 16);",
+        i4 + "p[3] = (uint8_t)(value >> 24);",
+        i3 + "}",
+        i2 + "}",
+    ]
+
+    for struct in schema.struct_list:
+        view = struct.name + "View"
+        builder = struct.name + "Builder"
+        native = "bugsy::" + struct.name
+
+        # View
+        out.append("")
+        out.append(i2 + "/* %s */" % re.sub(r"(?<=[a-z])(?=[A-Z])", " ", struct.name).upper())
+        cpp_doc(out, i3, "%s (read only view)" % struct.doc)
+        out += [
+            i3 + "class %s {" % view,
+            i3 + "public:",
+            i4 + "/// Size of the message on the wire",
+            i4 + "static const size_t SIZE = %d;" % struct.size,
+            "",
+            i4 + "/// @brief Views the first `SIZE` bytes of `data`, invalid if `len` is too short",
+            i4 + "%s(const void* data, size_t len) : data((len >= SIZE) ? (const uint8_t*)data : nullptr) { }" % view,
+            "",
+            i4 + "/// @brief Whether the buffer holds the whole message, the accessors must only be used if it does",
+            i4 + "bool valid() const { return this->data != nullptr; }",
+            "",
+            i4 + "/// @brief The raw bytes of the message",
+            i4 + "const uint8_t* bytes() const { return this->data; }",
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                continue
+
+            out.append("")
+            cpp_doc(out, i4, field.doc)
+
+            if field.kind == "struct":
+                out.append(i4 + "%sView %s() const { return %sView(this->data + %d, %d); }" % (
+                    field.struct.name, field.name, field.struct.name, field.offset, field.size))
+            elif field.kind == "array":
+                out.append(i4 + "const uint8_t* %s() const { return this->data + %d; }" % (field.name, field.offset))
+            else:
+                out.append(i4 + "%s %s() const { return %s; }" % (cpp_type(field), field.name, cpp_read(field, "this->data")))
+
+        out += [
+            "",
+            i4 + "/// @brief Copies the message into the native struct",
+            i4 + "%s get() const {" % native,
+            i4 + i1 + "%s value;" % native,
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                out.append(i4 + i1 + "for (uint8_t i = 0; i < %d; i++) { value.%s[i] = 0; }" % (field.count, field.name)
+                    if field.count > 1 else i4 + i1 + "value.%s = 0;" % field.name)
+            elif field.kind == "struct":
+                out.append(i4 + i1 + "value.%s = this->%s().get();" % (field.name, field.name))
+            elif field.kind == "array":
+                out.append(i4 + i1 + "for (uint8_t i = 0; i < %d; i++) { value.%s[i] = this->data[%d + i]; }" % (
+                    field.count, field.name, field.offset))
+            else:
+                out.append(i4 + i1 + "value.%s = this->%s();" % (field.name, field.name))
+
+        out += [
+            i4 + i1 + "return value;",
+            i4 + "}",
+            "",
+            i3 + "private:",
+            i4 + "const uint8_t* data;",
+            i3 + "};",
+            "",
+        ]
+
+        # Builder
+        cpp_doc(out, i3, "%s (in place encoder)" % struct.doc)
+        out += [
+            i3 + "class %s {" % builder,
+            i3 + "public:",
+            i4 + "/// Size of the message on the wire",
+            i4 + "static const size_t SIZE = %d;" % struct.size,
+            "",
+            i4 + "/// @brief Encodes into the first `SIZE` bytes of `data`, invalid if `len` is too short",
+            i4 + "%s(void* data, size_t len) : data((len >= SIZE) ? (uint8_t*)data : nullptr) { }" % builder,
+            "",
+            i4 + "/// @brief Whether the buffer can hold the whole message, the setters must only be used if it can",
+            i4 + "bool valid() const { return this->data != nullptr; }",
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                continue
+
+            out.append("")
+            cpp_doc(out, i4, field.doc)
+
+            if field.kind == "struct":
+                out.append(i4 + "%sBuilder %s() { return %sBuilder(this->data + %d, %d); }" % (
+                    field.struct.name, field.name, field.struct.name, field.offset, field.size))
+            elif field.kind == "array":
+                out += [
+                    i4 + "%s& %s(const uint8_t* values) {" % (builder, field.name),
+                    i4 + i1 + "for (uint8_t i = 0; i < %d; i++) { this->data[%d + i] = values[i]; }" % (field.count, field.offset),
+                    i4 + i1 + "return *this;",
+                    i4 + "}",
+                ]
+            else:
+                out += [
+                    i4 + "%s& %s(%s value) {" % (builder, field.name, cpp_type(field)),
+                    i4 + i1 + cpp_write(field, "this->data", "value"),
+                    i4 + i1 + "return *this;",
+                    i4 + "}",
+                ]
+
+        out += [
+            "",
+            i4 + "/// @brief Encodes the whole native struct, padding is zeroed",
+            i4 + "%s& set(const %s& value) {" % (builder, native),
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                out.append(i4 + i1 + "for (uint8_t i = 0; i < %d; i++) { this->data[%d + i] = 0; }" % (field.count, field.offset))
+            elif field.kind == "struct":
+                out.append(i4 + i1 + "this->%s().set(value.%s);" % (field.name, field.name))
+            else:
+                out.append(i4 + i1 + "this->%s(value.%s);" % (field.name, field.name))
+
+        out += [
+            i4 + i1 + "return *this;",
+            i4 + "}",
+            "",
+            i3 + "private:",
+            i4 + "uint8_t* data;",
+            i3 + "};",
+            i2 + "/**/",
+        ]
+
+    # Layout checks
+    out += [
+        "",
+        i2 + "/* CHECKS */",
+        i3 + "// The native structs are copied to and from the wire as a whole on the (little endian) targets, their layout has",
+        i3 + "// to match the schema exactly",
+    ]
+
+    for enum in schema.enum_list:
+        out.append(i3 + "static_assert(sizeof(%s) == 1, \"%s must be a single byte\");" % (enum.native, enum.name))
+
+        for name, value in enum.values:
+            out.append(i3 + "static_assert((uint8_t)%s::%s == 0x%02X, \"%s::%s differs from the schema\");" % (
+                enum.native, name, value, enum.name, name))
+
+    for struct in schema.struct_list:
+        native = "bugsy::" + struct.name
+        out.append(i3 + "static_assert(sizeof(%s) == %d, \"%s differs from the schema\");" % (native, struct.size, struct.name))
+
+        for field in struct.fields:
+            out.append(i3 + "static_assert(offsetof(%s, %s) == %d, \"%s::%s differs from the schema\");" % (
+                native, field.name, field.offset, struct.name, field.name))
+
+    out += [
+        i2 + "/**/",
+        i1 + "}",
+        "}",
+        "",
+    ]
+
+    return "\n".join(out)
+#
+
+
+# Rust
+def rust_name(name):
+    return ("r#" + name) if name in RUST_KEYWORDS else name
+
+
+def rust_doc(lines, indent, doc):
+    if doc:
+        lines.append(indent + "/// " + doc)
+
+
+def generate_rust(schema):
+    out = [ ]
+    i1, i2, i3 = "    ", "        ", "            "
+
+    out += [
+        "// #########################",
+        "// #    BUGSY - MESSAGES    #",
+        "// #########################",
+        "//",
+        "// GENERATED by `schema/generate.py` from `schema/messages.json`, do not edit!",
+        "//",
+        "// %s." % schema.doc,
+        "//",
+        "// Views decode a message in place from a received buffer, builders encode it in place into a send buffer, both check",
+        "// the length once when created.",
+        "",
+        "#![allow(dead_code)]",
+        "",
+    ]
+
+    for enum in schema.enum_list:
+        rust_doc(out, "", enum.doc)
+
+        if enum.flags:
+            out += [
+                "#[derive(Clone, Copy, Debug, PartialEq, Eq, Default)]",
+                "pub struct %s(pub u8);" % enum.name,
+                "",
+                "impl %s {" % enum.name,
+            ]
+
+            for name, value in enum.values:
+                out.append(i1 + "pub const %s : Self = Self(0x%02X);" % (name, value))
+
+            out += [
+                "",
+                i1 + "/// Whether all flags of `other` are set",
+                i1 + "pub fn contains(self, other : Self) -> bool {",
+                i2 + "(self.0 & other.0) == other.0",
+                i1 + "}",
+                "}",
+                "",
+            ]
+            continue
+
+        out += [
+            "#[repr(u8)]",
+            "#[derive(Clone, Copy, Debug, PartialEq, Eq)]",
+            "#[allow(non_camel_case_types, clippy::upper_case_acronyms)]",
+            "pub enum %s {" % enum.name,
+        ]
+
+        for name, value in enum.values:
+            out.append(i1 + "%s = 0x%02X," % (name, value))
+
+        out += [
+            "}",
+            "",
+            "impl TryFrom<u8> for %s {" % enum.name,
+            i1 + "type Error = u8;",
+            "",
+            i1 + "fn try_from(value : u8) -> Result<Self, u8> {",
+            i2 + "match value {",
+        ]
+
+        for name, value in enum.values:
+            out.append(i3 + "0x%02X => Ok(Self::%s)," % (value, name))
+
+        out += [
+            i3 + "_ => Err(value)",
+            i2 + "}",
+            i1 + "}",
+            "}",
+            "",
+        ]
+
+    for struct in schema.struct_list:
+        view = struct.name + "View"
+        builder = struct.name + "Builder"
+
+        # View
+        rust_doc(out, "", "%s (read only view)" % struct.doc)
+        out += [
+            "#[derive(Clone, Copy)]",
+            "pub struct %s<'a>(&'a [u8]);" % view,
+            "",
+            "impl<'a> %s<'a> {" % view,
+            i1 + "/// Size of the message on the wire",
+            i1 + "pub const SIZE : usize = %d;" % struct.size,
+            "",
+            i1 + "/// Views the first `SIZE` bytes of `data`, `None` if it is too short",
+            i1 + "pub fn new(data : &'a [u8]) -> Option<Self> {",
+            i2 + "data.get(.. Self::SIZE).map(Self)",
+            i1 + "}",
+            "",
+            i1 + "/// The raw bytes of the message",
+            i1 + "pub fn bytes(&self) -> &'a [u8] {",
+            i2 + "self.0",
+            i1 + "}",
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                continue
+
+            name = rust_name(field.name)
+            end = field.offset + field.size
+            out.append("")
+            rust_doc(out, i1, field.doc)
+
+            if field.kind == "struct":
+                out += [
+                    i1 + "pub fn %s(&self) -> %sView<'a> {" % (name, field.struct.name),
+                    i2 + "%sView(&self.0[%d .. %d])" % (field.struct.name, field.offset, end),
+                    i1 + "}",
+                ]
+            elif field.kind == "array":
+                out += [
+                    i1 + "pub fn %s(&self) -> &'a [u8] {" % name,
+                    i2 + "&self.0[%d .. %d]" % (field.offset, end),
+                    i1 + "}",
+                ]
+            elif field.kind == "enum" and field.enum.flags:
+                out += [
+                    i1 + "pub fn %s(&self) -> %s {" % (name, field.enum.name),
+                    i2 + "%s(self.0[%d])" % (field.enum.name, field.offset),
+                    i1 + "}",
+                ]
+            elif field.kind == "enum" and field.enum.bool:
+                out += [
+                    i1 + "pub fn %s(&self) -> %s {" % (name, field.enum.name),
+                    i2 + "if self.0[%d] != 0 { %s::%s } else { %s::%s }" % (
+                        field.offset, field.enum.name, field.enum.values[1][0], field.enum.name, field.enum.values[0][0]),
+                    i1 + "}",
+                ]
+            elif field.kind == "enum":
+                out += [
+                    i1 + "/// Unknown values are returned as the error",
+                    i1 + "pub fn %s(&self) -> Result<%s, u8> {" % (name, field.enum.name),
+                    i2 + "%s::try_from(self.0[%d])" % (field.enum.name, field.offset),
+                    i1 + "}",
+                ]
+            else:
+                rtype = PRIMITIVES[field.type][2]
+                out.append(i1 + "pub fn %s(&self) -> %s {" % (name, rtype))
+
+                if field.size == 1:
+                    out.append(i2 + "self.0[%d] as %s" % (field.offset, rtype))
+                else:
+                    out.append(i2 + "%s::from_le_bytes([ %s ])" % (
+                        rtype, ", ".join("self.0[%d]" % (field.offset + i) for i in range(field.size))))
+
+                out.append(i1 + "}")
+
+        out += [
+            "}",
+            "",
+        ]
+
+        # Builder
+        rust_doc(out, "", "%s (in place encoder)" % struct.doc)
+        out += [
+            "pub struct %s<'a>(&'a mut [u8]);" % builder,
+            "",
+            "impl<'a> %s<'a> {" % builder,
+            i1 + "/// Size of the message on the wire",
+            i1 + "pub const SIZE : usize = %d;" % struct.size,
+            "",
+            i1 + "/// Encodes into the first `SIZE` bytes of `data`, `None` if it is too short",
+            i1 + "pub fn new(data : &'a mut [u8]) -> Option<Self> {",
+            i2 + "data.get_mut(.. Self::SIZE).map(Self)",
+            i1 + "}",
+        ]
+
+        for field in struct.fields:
+            if field.kind == "pad":
+                out += [
+                    "",
+                    i1 + "/// Zeroes the padding `%s`" % field.name,
+                    i1 + "pub fn clear_%s(&mut self) -> &mut Self {" % field.name,
+                    i2 + "self.0[%d .. %d].fill(0);" % (field.offset, field.offset + field.size),
+                    i2 + "self",
+                    i1 + "}",
+                ]
+                continue
+
+            name = rust_name(field.name)
+            end = field.offset + field.size
+            out.append("")
+            rust_doc(out, i1, field.doc)
+
+            if field.kind == "struct":
+                out += [
+                    i1 + "pub fn %s(&mut self) -> %sBuilder<'_> {" % (name, field.struct.name),
+                    i2 + "%sBuilder(&mut self.0[%d .. %d])" % (field.struct.name, field.offset, end),
+                    i1 + "}",
+                ]
+            elif field.kind == "array":
+                out += [
+                    i1 + "pub fn %s(&mut self, values : &[u8; %d]) -> &mut Self {" % (name, field.count),
+                    i2 + "self.0[%d .. %d].copy_from_slice(values);" % (field.offset, end),
+                    i2 + "self",
+                    i1 + "}",
+                ]
+            elif field.kind == "enum":
+                value = "value.0" if field.enum.flags else "value as u8"
+                out += [
+                    i1 + "pub fn %s(&mut self, value : %s) -> &mut Self {" % (name, field.enum.name),
+                    i2 + "self.0[%d] = %s;" % (field.offset, value),
+                    i2 + "self",
+                    i1 + "}",
+                ]
+            else:
+                rtype = PRIMITIVES[field.type][2]
+                out += [
+                    i1 + "pub fn %s(&mut self, value : %s) -> &mut Self {" % (name, rtype),
+                    i2 + "self.0[%d .. %d].copy_from_slice(&value.to_le_bytes());" % (field.offset, end),
+                    i2 + "self",
+                    i1 + "}",
+                ]
+
+        out += [
+            "}",
+            "",
+        ]
+
+    return "\n".join(out)
+#
+
+
+def main():
+    with open(SCHEMA) as file:
+        schema = Schema(json.load(file))
+
+    outputs = [ (CPP_OUT, generate_cpp(schema)), (RUST_OUT, generate_rust(schema)) ]
+
+    if "--check" in sys.argv[1:]:
+        stale = [ path for path, text in outputs if not os.path.exists(path) or open(path).read() != text ]
+
+        for path in stale:
+            print("> Out of date: %s" % os.path.relpath(path, ROOT))
+
+        return 1 if stale else 0
+
+    for path, text in outputs:
+        with open(path, "w") as file:
+            file.write(text)
+
+        print("> Generated %s" % os.path.relpath(path, ROOT))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())